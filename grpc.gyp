@@ -218,7 +218,6 @@
       ],
       'sources': [
         'src/core/lib/gpr/alloc.cc',
-        'src/core/lib/gpr/arena.cc',
         'src/core/lib/gpr/atm.cc',
         'src/core/lib/gpr/cpu_iphone.cc',
         'src/core/lib/gpr/cpu_linux.cc',
@@ -235,6 +234,7 @@
         'src/core/lib/gpr/log_windows.cc',
         'src/core/lib/gpr/mpscq.cc',
         'src/core/lib/gpr/murmur_hash.cc',
+        'src/core/lib/gpr/spmcq.cc',
         'src/core/lib/gpr/string.cc',
         'src/core/lib/gpr/string_posix.cc',
         'src/core/lib/gpr/string_util_windows.cc',
@@ -251,6 +251,7 @@
         'src/core/lib/gpr/tmpfile_posix.cc',
         'src/core/lib/gpr/tmpfile_windows.cc',
         'src/core/lib/gpr/wrap_memcpy.cc',
+        'src/core/lib/gprpp/arena.cc',
         'src/core/lib/gprpp/fork.cc',
         'src/core/lib/gprpp/thd_posix.cc',
         'src/core/lib/gprpp/thd_windows.cc',
@@ -375,6 +376,7 @@
         'src/core/lib/iomgr/timer_heap.cc',
         'src/core/lib/iomgr/timer_manager.cc',
         'src/core/lib/iomgr/timer_uv.cc',
+        'src/core/lib/iomgr/timer_wheel.cc',
         'src/core/lib/iomgr/udp_server.cc',
         'src/core/lib/iomgr/unix_sockets_posix.cc',
         'src/core/lib/iomgr/unix_sockets_posix_noop.cc',
@@ -407,6 +409,7 @@
         'src/core/lib/surface/completion_queue_factory.cc',
         'src/core/lib/surface/event_string.cc',
         'src/core/lib/surface/lame_client.cc',
+        'src/core/lib/surface/message_object.cc',
         'src/core/lib/surface/metadata_array.cc',
         'src/core/lib/surface/server.cc',
         'src/core/lib/surface/validate_metadata.cc',
@@ -427,6 +430,7 @@
         'src/core/lib/transport/transport_op_string.cc',
         'src/core/lib/debug/trace.cc',
         'src/core/ext/transport/chttp2/server/secure/server_secure_chttp2.cc',
+        'src/core/ext/transport/chttp2/transport/base64_simd.cc',
         'src/core/ext/transport/chttp2/transport/bin_decoder.cc',
         'src/core/ext/transport/chttp2/transport/bin_encoder.cc',
         'src/core/ext/transport/chttp2/transport/chttp2_plugin.cc',
@@ -442,12 +446,14 @@
         'src/core/ext/transport/chttp2/transport/hpack_parser.cc',
         'src/core/ext/transport/chttp2/transport/hpack_table.cc',
         'src/core/ext/transport/chttp2/transport/http2_settings.cc',
+        'src/core/ext/transport/chttp2/transport/huffman_decoder.cc',
         'src/core/ext/transport/chttp2/transport/huffsyms.cc',
         'src/core/ext/transport/chttp2/transport/incoming_metadata.cc',
         'src/core/ext/transport/chttp2/transport/parsing.cc',
         'src/core/ext/transport/chttp2/transport/stream_lists.cc',
         'src/core/ext/transport/chttp2/transport/stream_map.cc',
         'src/core/ext/transport/chttp2/transport/varint.cc',
+        'src/core/ext/transport/chttp2/transport/write_scheduler.cc',
         'src/core/ext/transport/chttp2/transport/writing.cc',
         'src/core/ext/transport/chttp2/alpn/alpn.cc',
         'src/core/ext/filters/http/client/http_client_filter.cc',
@@ -628,6 +634,7 @@
         'test/core/util/port.cc',
         'test/core/util/port_isolated_runtime_environment.cc',
         'test/core/util/port_server_client.cc',
+        'test/core/util/recording_endpoint.cc',
         'test/core/util/slice_splitter.cc',
         'test/core/util/subprocess_posix.cc',
         'test/core/util/subprocess_windows.cc',
@@ -733,6 +740,7 @@
         'src/core/lib/iomgr/timer_heap.cc',
         'src/core/lib/iomgr/timer_manager.cc',
         'src/core/lib/iomgr/timer_uv.cc',
+        'src/core/lib/iomgr/timer_wheel.cc',
         'src/core/lib/iomgr/udp_server.cc',
         'src/core/lib/iomgr/unix_sockets_posix.cc',
         'src/core/lib/iomgr/unix_sockets_posix_noop.cc',
@@ -765,6 +773,7 @@
         'src/core/lib/surface/completion_queue_factory.cc',
         'src/core/lib/surface/event_string.cc',
         'src/core/lib/surface/lame_client.cc',
+        'src/core/lib/surface/message_object.cc',
         'src/core/lib/surface/metadata_array.cc',
         'src/core/lib/surface/server.cc',
         'src/core/lib/surface/validate_metadata.cc',
@@ -807,6 +816,7 @@
         'src/core/ext/filters/client_channel/subchannel_index.cc',
         'src/core/ext/filters/client_channel/uri_parser.cc',
         'src/core/ext/filters/deadline/deadline_filter.cc',
+        'src/core/ext/transport/chttp2/transport/base64_simd.cc',
         'src/core/ext/transport/chttp2/transport/bin_decoder.cc',
         'src/core/ext/transport/chttp2/transport/bin_encoder.cc',
         'src/core/ext/transport/chttp2/transport/chttp2_plugin.cc',
@@ -822,12 +832,14 @@
         'src/core/ext/transport/chttp2/transport/hpack_parser.cc',
         'src/core/ext/transport/chttp2/transport/hpack_table.cc',
         'src/core/ext/transport/chttp2/transport/http2_settings.cc',
+        'src/core/ext/transport/chttp2/transport/huffman_decoder.cc',
         'src/core/ext/transport/chttp2/transport/huffsyms.cc',
         'src/core/ext/transport/chttp2/transport/incoming_metadata.cc',
         'src/core/ext/transport/chttp2/transport/parsing.cc',
         'src/core/ext/transport/chttp2/transport/stream_lists.cc',
         'src/core/ext/transport/chttp2/transport/stream_map.cc',
         'src/core/ext/transport/chttp2/transport/varint.cc',
+        'src/core/ext/transport/chttp2/transport/write_scheduler.cc',
         'src/core/ext/transport/chttp2/transport/writing.cc',
         'src/core/ext/transport/chttp2/alpn/alpn.cc',
         'src/core/ext/filters/http/client/http_client_filter.cc',
@@ -861,6 +873,7 @@
         'test/core/util/port.cc',
         'test/core/util/port_isolated_runtime_environment.cc',
         'test/core/util/port_server_client.cc',
+        'test/core/util/recording_endpoint.cc',
         'test/core/util/slice_splitter.cc',
         'test/core/util/subprocess_posix.cc',
         'test/core/util/subprocess_windows.cc',
@@ -966,6 +979,7 @@
         'src/core/lib/iomgr/timer_heap.cc',
         'src/core/lib/iomgr/timer_manager.cc',
         'src/core/lib/iomgr/timer_uv.cc',
+        'src/core/lib/iomgr/timer_wheel.cc',
         'src/core/lib/iomgr/udp_server.cc',
         'src/core/lib/iomgr/unix_sockets_posix.cc',
         'src/core/lib/iomgr/unix_sockets_posix_noop.cc',
@@ -998,6 +1012,7 @@
         'src/core/lib/surface/completion_queue_factory.cc',
         'src/core/lib/surface/event_string.cc',
         'src/core/lib/surface/lame_client.cc',
+        'src/core/lib/surface/message_object.cc',
         'src/core/lib/surface/metadata_array.cc',
         'src/core/lib/surface/server.cc',
         'src/core/lib/surface/validate_metadata.cc',
@@ -1040,6 +1055,7 @@
         'src/core/ext/filters/client_channel/subchannel_index.cc',
         'src/core/ext/filters/client_channel/uri_parser.cc',
         'src/core/ext/filters/deadline/deadline_filter.cc',
+        'src/core/ext/transport/chttp2/transport/base64_simd.cc',
         'src/core/ext/transport/chttp2/transport/bin_decoder.cc',
         'src/core/ext/transport/chttp2/transport/bin_encoder.cc',
         'src/core/ext/transport/chttp2/transport/chttp2_plugin.cc',
@@ -1055,12 +1071,14 @@
         'src/core/ext/transport/chttp2/transport/hpack_parser.cc',
         'src/core/ext/transport/chttp2/transport/hpack_table.cc',
         'src/core/ext/transport/chttp2/transport/http2_settings.cc',
+        'src/core/ext/transport/chttp2/transport/huffman_decoder.cc',
         'src/core/ext/transport/chttp2/transport/huffsyms.cc',
         'src/core/ext/transport/chttp2/transport/incoming_metadata.cc',
         'src/core/ext/transport/chttp2/transport/parsing.cc',
         'src/core/ext/transport/chttp2/transport/stream_lists.cc',
         'src/core/ext/transport/chttp2/transport/stream_map.cc',
         'src/core/ext/transport/chttp2/transport/varint.cc',
+        'src/core/ext/transport/chttp2/transport/write_scheduler.cc',
         'src/core/ext/transport/chttp2/transport/writing.cc',
         'src/core/ext/transport/chttp2/alpn/alpn.cc',
         'src/core/ext/filters/http/client/http_client_filter.cc',
@@ -1177,6 +1195,7 @@
         'src/core/lib/iomgr/timer_heap.cc',
         'src/core/lib/iomgr/timer_manager.cc',
         'src/core/lib/iomgr/timer_uv.cc',
+        'src/core/lib/iomgr/timer_wheel.cc',
         'src/core/lib/iomgr/udp_server.cc',
         'src/core/lib/iomgr/unix_sockets_posix.cc',
         'src/core/lib/iomgr/unix_sockets_posix_noop.cc',
@@ -1209,6 +1228,7 @@
         'src/core/lib/surface/completion_queue_factory.cc',
         'src/core/lib/surface/event_string.cc',
         'src/core/lib/surface/lame_client.cc',
+        'src/core/lib/surface/message_object.cc',
         'src/core/lib/surface/metadata_array.cc',
         'src/core/lib/surface/server.cc',
         'src/core/lib/surface/validate_metadata.cc',
@@ -1230,6 +1250,7 @@
         'src/core/lib/debug/trace.cc',
         'src/core/ext/transport/chttp2/server/insecure/server_chttp2.cc',
         'src/core/ext/transport/chttp2/server/insecure/server_chttp2_posix.cc',
+        'src/core/ext/transport/chttp2/transport/base64_simd.cc',
         'src/core/ext/transport/chttp2/transport/bin_decoder.cc',
         'src/core/ext/transport/chttp2/transport/bin_encoder.cc',
         'src/core/ext/transport/chttp2/transport/chttp2_plugin.cc',
@@ -1245,12 +1266,14 @@
         'src/core/ext/transport/chttp2/transport/hpack_parser.cc',
         'src/core/ext/transport/chttp2/transport/hpack_table.cc',
         'src/core/ext/transport/chttp2/transport/http2_settings.cc',
+        'src/core/ext/transport/chttp2/transport/huffman_decoder.cc',
         'src/core/ext/transport/chttp2/transport/huffsyms.cc',
         'src/core/ext/transport/chttp2/transport/incoming_metadata.cc',
         'src/core/ext/transport/chttp2/transport/parsing.cc',
         'src/core/ext/transport/chttp2/transport/stream_lists.cc',
         'src/core/ext/transport/chttp2/transport/stream_map.cc',
         'src/core/ext/transport/chttp2/transport/varint.cc',
+        'src/core/ext/transport/chttp2/transport/write_scheduler.cc',
         'src/core/ext/transport/chttp2/transport/writing.cc',
         'src/core/ext/transport/chttp2/alpn/alpn.cc',
         'src/core/ext/filters/http/client/http_client_filter.cc',
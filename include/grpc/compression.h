@@ -68,6 +68,39 @@ GRPCAPI void grpc_compression_options_disable_algorithm(
 GRPCAPI int grpc_compression_options_is_algorithm_enabled(
     const grpc_compression_options* opts, grpc_compression_algorithm algorithm);
 
+/** EXPERIMENTAL. A message compression algorithm supplied by the
+ * application, see grpc_compression_algorithm_register(). Its functions may
+ * be called concurrently. */
+typedef struct grpc_message_compressor_vtable {
+  /** The name the algorithm is negotiated under in grpc-encoding and
+   * grpc-accept-encoding. May contain only lowercase letters, digits, '-',
+   * '.' and '_', and must stay valid for the lifetime of the process. */
+  const char* name;
+  /** Appends the compressed form of \a input to \a output and returns 1, or
+   * returns 0 with \a output unchanged if \a input should be sent
+   * uncompressed, e.g. because compressing it did not make it smaller. */
+  int (*compress)(void* user_data, grpc_slice_buffer* input,
+                  grpc_slice_buffer* output);
+  /** Appends the decompressed form of \a input to \a output and returns 1, or
+   * returns 0 with \a output unchanged if \a input is malformed. */
+  int (*decompress)(void* user_data, grpc_slice_buffer* input,
+                    grpc_slice_buffer* output);
+  /** Passed to \a compress and \a decompress. */
+  void* user_data;
+} grpc_message_compressor_vtable;
+
+/** EXPERIMENTAL. Adds \a compressor (which is copied) as a message
+ * compression algorithm. Like the built in ones it is enabled by default, and
+ * can be disabled, made a channel's default or requested for a call; it is
+ * never picked for a compression level. On success, sets \a algorithm to the
+ * value that selects it and returns 1. Returns 0 if the name is invalid or
+ * taken, or if too many algorithms have been registered. Should be called
+ * before grpc_init(), and must be called before creating any channel or
+ * server that is to use the algorithm. */
+GRPCAPI int grpc_compression_algorithm_register(
+    const grpc_message_compressor_vtable* compressor,
+    grpc_compression_algorithm* algorithm);
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,13 @@ GRPCAPI grpc_completion_queue* grpc_completion_queue_create_for_next(
 GRPCAPI grpc_completion_queue* grpc_completion_queue_create_for_pluck(
     void* reserved);
 
+/** EXPERIMENTAL: Helper function to create a completion queue with
+    grpc_cq_completion_type of GRPC_CQ_CALLBACK and grpc_cq_polling_type of
+    GRPC_CQ_DEFAULT_POLLING. \a callback is invoked with each event of the
+    completion queue. */
+GRPCAPI grpc_completion_queue* grpc_completion_queue_create_for_callback(
+    grpc_completion_queue_functor* callback, void* reserved);
+
 /** Create a completion queue */
 GRPCAPI grpc_completion_queue* grpc_completion_queue_create(
     const grpc_completion_queue_factory* factory,
@@ -108,7 +115,11 @@ GRPCAPI grpc_completion_queue* grpc_completion_queue_create(
     otherwise a grpc_event describing the event that occurred.
 
     Callers must not call grpc_completion_queue_next and
-    grpc_completion_queue_pluck simultaneously on the same completion queue. */
+    grpc_completion_queue_pluck simultaneously on the same completion queue.
+
+    On a GRPC_CQ_CALLBACK completion queue this only polls: events are passed
+    to the completion queue's callback, possibly from the calling thread, and
+    only GRPC_QUEUE_TIMEOUT or GRPC_QUEUE_SHUTDOWN is returned. */
 GRPCAPI grpc_event grpc_completion_queue_next(grpc_completion_queue* cq,
                                               gpr_timespec deadline,
                                               void* reserved);
@@ -248,6 +259,11 @@ GRPCAPI grpc_call_error grpc_call_start_batch(grpc_call* call,
     functionality. Instead, use grpc_auth_context. */
 GRPCAPI char* grpc_call_get_peer(grpc_call* call);
 
+/** Returns non-zero if \a call hands the objects of message object byte
+    buffers (see grpc_message_object_byte_buffer_create) to its peer without
+    serializing them. */
+GRPCAPI int grpc_call_carries_message_objects(grpc_call* call);
+
 struct census_context;
 
 /** Set census context for a call; Must be called before first call to
@@ -450,6 +466,13 @@ GRPCAPI void grpc_resource_quota_unref(grpc_resource_quota* resource_quota);
 GRPCAPI void grpc_resource_quota_resize(grpc_resource_quota* resource_quota,
                                         size_t new_size);
 
+/** Update the maximum number of threads that servers using this resource quota
+    may create in total. Threads that are already running are not stopped: if
+    \a new_max_threads is lower than the number of allocated threads, no new
+    thread is granted until enough of them have exited */
+GRPCAPI void grpc_resource_quota_set_max_threads(
+    grpc_resource_quota* resource_quota, int new_max_threads);
+
 /** Fetch a vtable for a grpc_channel_arg that points to a grpc_resource_quota
  */
 GRPCAPI const grpc_arg_pointer_vtable* grpc_resource_quota_arg_vtable(void);
@@ -43,6 +43,26 @@ GRPCAPI grpc_byte_buffer* grpc_raw_byte_buffer_create(grpc_slice* slices,
 GRPCAPI grpc_byte_buffer* grpc_raw_compressed_byte_buffer_create(
     grpc_slice* slices, size_t nslices, grpc_compression_algorithm compression);
 
+/** Returns a RAW byte buffer that carries \a object, an opaque message of type
+ * \a type (any address that identifies the type), rather than its bytes.
+ *
+ * Calls for which grpc_call_carries_message_objects is true hand the object
+ * itself to the receiving side; elsewhere, and for byte buffer readers, it is
+ * serialized with \a vtable. Takes ownership of \a object, which is destroyed
+ * with \a vtable once the last buffer referring to it is. The user is
+ * responsible for invoking grpc_byte_buffer_destroy on the returned instance.*/
+GRPCAPI grpc_byte_buffer* grpc_message_object_byte_buffer_create(
+    void* object, const void* type, const grpc_message_object_vtable* vtable);
+
+/** If \a bb carries a message object of type \a type, returns it and sets
+ * \a exclusive to whether \a bb holds the only reference to it, in which case
+ * the caller may take the object's contents. Otherwise returns NULL.
+ *
+ * The object remains owned by \a bb. */
+GRPCAPI void* grpc_byte_buffer_get_message_object(grpc_byte_buffer* bb,
+                                                  const void* type,
+                                                  int* exclusive);
+
 /** Copies input byte buffer \a bb.
  *
  * Increases the reference count of all the source slices. The user is
@@ -50,6 +50,16 @@ extern "C" {
  * be ignored). */
 #define GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET \
   "grpc.compression_enabled_algorithms_bitset"
+/** If non-zero, message compression keeps track of how much compressing saves
+ * for each method and stops compressing the messages of methods for which it
+ * does not pay off, trying again from time to time. Int valued, defaults to 0
+ * (compress every message). */
+#define GRPC_COMPRESSION_CHANNEL_ADAPTIVE "grpc.compression_adaptive"
+/** The minimum percentage of the size of its messages that compressing must
+ * save on average for adaptive compression to keep compressing the messages of
+ * a method. Int valued, between 1 and 100, defaults to 10. */
+#define GRPC_COMPRESSION_CHANNEL_ADAPTIVE_MIN_SAVINGS \
+  "grpc.compression_adaptive_min_savings"
 /** \} */
 
 /** The various compression algorithms supported by gRPC */
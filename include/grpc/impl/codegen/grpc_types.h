@@ -51,6 +51,16 @@ typedef struct grpc_byte_buffer {
   } data;
 } grpc_byte_buffer;
 
+/** Operations on the object carried by a message object byte buffer (see
+    grpc_message_object_byte_buffer_create) */
+typedef struct grpc_message_object_vtable {
+  /** Append the serialized form of \a object to \a out, for the transports
+      and readers that need bytes. Returns 0 on failure. */
+  int (*serialize)(void* object, grpc_slice_buffer* out);
+  /** Destroy \a object once no byte buffer refers to it anymore. */
+  void (*destroy)(void* object);
+} grpc_message_object_vtable;
+
 /** Completion Queues enable notification of the completion of
  * asynchronous actions. */
 typedef struct grpc_completion_queue grpc_completion_queue;
@@ -142,6 +152,11 @@ typedef struct {
 #define GRPC_ARG_ENABLE_CENSUS "grpc.census"
 /** If non-zero, enable load reporting. */
 #define GRPC_ARG_ENABLE_LOAD_REPORTING "grpc.loadreporting"
+/** If non-zero, an in-process channel (see grpc_inproc_channel_create) hands
+    message objects (see grpc_message_object_byte_buffer_create) to the other
+    side without serializing them. Honored on the arguments of the channel or
+    of its server. Defaults to 0. */
+#define GRPC_ARG_INPROC_MESSAGE_OBJECTS "grpc.inproc_message_objects"
 /** Request that optional features default to off (regardless of what they
     usually default to) - to enable tight control over what gets enabled */
 #define GRPC_ARG_MINIMAL_STACK "grpc.minimal_stack"
@@ -214,6 +229,27 @@ typedef struct {
 /** How much data are we willing to queue up per stream if
     GRPC_WRITE_BUFFER_HINT is set? This is an upper bound */
 #define GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE "grpc.http2.write_buffer_size"
+/** How should the streams of an http2 connection share its writes? String
+    valued: "fifo" (the default) lets each stream send all it can before the
+    next one, "drr" (deficit round robin) interleaves streams in turns of
+    GRPC_ARG_HTTP2_WRITE_QUANTUM bytes, scaled by their weight, so that small
+    messages are not held up behind bulk transfers. */
+#define GRPC_ARG_HTTP2_WRITE_SCHEDULER "grpc.http2.write_scheduler"
+/** Bytes of DATA a stream of default weight may send per turn of the "drr"
+    write scheduler. Int valued, defaults to 16384. */
+#define GRPC_ARG_HTTP2_WRITE_QUANTUM "grpc.http2.write_quantum"
+/** Should the "drr" write scheduler weigh streams by the HTTP/2 priority
+    weight of the HEADERS frames that opened them? Stream dependencies are
+    ignored. Defaults to off (0) */
+#define GRPC_ARG_HTTP2_HONOR_STREAM_PRIORITY "grpc.http2.honor_stream_priority"
+/** Upper bound, in microseconds, on how long chttp2 may hold back the start of
+    a write so that frames queued by other streams shortly after can share its
+    syscall. The actual delay adapts to how often writes start, to the round
+    trip time measured by BDP probe pings (there is no delay without them) and
+    to whether holding writes back has been gathering frames; it is zero under
+    light load. Int valued, at most 1000. Defaults to 0 (never delay). */
+#define GRPC_ARG_HTTP2_WRITE_COALESCING_MAX_DELAY_US \
+  "grpc.http2.write_coalescing_max_delay_us"
 /** Should we allow receipt of true-binary data on http2 connections?
     Defaults to on (1) */
 #define GRPC_ARG_HTTP2_ENABLE_TRUE_BINARY "grpc.http2.true_binary"
@@ -244,6 +280,11 @@ typedef struct {
 /** The time between the first and second connection attempts, in ms */
 #define GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS \
   "grpc.initial_reconnect_backoff_ms"
+/** The number of connections a subchannel keeps to its address. New calls
+    are placed on the connection with the fewest active calls, which spreads
+    them past one connection's concurrent stream limit and transport lock.
+    Defaults to 1. */
+#define GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS "grpc.subchannel_max_connections"
 /** Minimum amount of time between DNS resolutions, in ms */
 #define GRPC_ARG_DNS_MIN_TIME_BETWEEN_RESOLUTIONS_MS \
   "grpc.dns_min_time_between_resolutions_ms"
@@ -308,6 +349,14 @@ typedef struct {
   "grpc.experimental.tcp_min_read_chunk_size"
 #define GRPC_ARG_TCP_MAX_READ_CHUNK_SIZE \
   "grpc.experimental.tcp_max_read_chunk_size"
+/** Channel arg (integer) enabling zero-copy sends (MSG_ZEROCOPY) on POSIX TCP
+   endpoints. Each sendmsg covering at least this many bytes is issued with
+   MSG_ZEROCOPY, and the written slices are kept alive until the kernel
+   reports completion on the socket error queue. Requires a polling engine
+   that tracks errors separately (e.g. epoll1). 0 (the default) disables
+   zero-copy sends. */
+#define GRPC_ARG_TCP_TX_ZEROCOPY_THRESHOLD \
+  "grpc.experimental.tcp_tx_zerocopy_threshold"
 /* Timeout in milliseconds to use for calls to the grpclb load balancer.
    If 0 or unset, the balancer calls will have no deadline. */
 #define GRPC_ARG_GRPCLB_CALL_TIMEOUT_MS "grpc.grpclb_call_timeout_ms"
@@ -651,10 +700,30 @@ typedef enum {
   GRPC_CQ_NEXT,
 
   /** Events are popped out by calling grpc_completion_queue_pluck() API ONLY*/
-  GRPC_CQ_PLUCK
+  GRPC_CQ_PLUCK,
+
+  /** EXPERIMENTAL: Events are not popped out: each one is passed to the
+      completion queue's callback (cq_callback in the attributes) as soon as
+      it completes. grpc_completion_queue_next() only polls such a completion
+      queue and never returns GRPC_OP_COMPLETE events. */
+  GRPC_CQ_CALLBACK
 } grpc_cq_completion_type;
 
-#define GRPC_CQ_CURRENT_VERSION 1
+/** EXPERIMENTAL: The callback of a GRPC_CQ_CALLBACK completion queue. Embed it
+    in a larger structure to give the callback some context. */
+typedef struct grpc_completion_queue_functor {
+  /** Invoked with every GRPC_OP_COMPLETE event of the completion queue, and
+      then with a single GRPC_QUEUE_SHUTDOWN event once the completion queue
+      has been shut down and all the other invocations have returned. The
+      functor must stay valid until then. */
+  void (*run)(struct grpc_completion_queue_functor* functor, grpc_event event);
+  /** If non-zero, run is invoked directly from the thread and ExecCtx that
+      completed the operation, so it must not block. If zero, run is offloaded
+      to an executor thread. */
+  int inlineable;
+} grpc_completion_queue_functor;
+
+#define GRPC_CQ_CURRENT_VERSION 2
 typedef struct grpc_completion_queue_attributes {
   /** The version number of this structure. More fields might be added to this
      structure in future. */
@@ -663,6 +732,12 @@ typedef struct grpc_completion_queue_attributes {
   grpc_cq_completion_type cq_completion_type;
 
   grpc_cq_polling_type cq_polling_type;
+
+  /* END OF VERSION 1 CQ ATTRIBUTES */
+
+  /** EXPERIMENTAL: The callback of a GRPC_CQ_CALLBACK completion queue,
+      ignored for the other completion types */
+  grpc_completion_queue_functor* cq_callback;
 } grpc_completion_queue_attributes;
 
 /** The completion queue factory structure is opaque to the callers of grpc */
@@ -149,6 +149,8 @@ class ByteBuffer final {
   friend class ProtoBufferReader;
   friend class ProtoBufferWriter;
   friend class internal::GrpcByteBufferPeer;
+  template <class Message, class UnusedButHereForPartialTemplateSpecialization>
+  friend class MessageObjectTraits;
 
   grpc_byte_buffer* buffer_;
 
@@ -24,6 +24,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <type_traits>
 
 #include <grpcpp/impl/codegen/byte_buffer.h>
 #include <grpcpp/impl/codegen/call_hook.h>
@@ -278,6 +279,12 @@ class CallOpSendMessage {
   template <class M>
   Status SendMessage(const M& message) GRPC_MUST_USE_RESULT;
 
+  /// Send \a message, or just a copy of it if \a call carries message
+  /// objects and M supports them (see MessageObjectTraits).
+  template <class M>
+  Status SendMessageOrObject(const M& message,
+                             grpc_call* call) GRPC_MUST_USE_RESULT;
+
  protected:
   void AddOp(grpc_op* ops, size_t* nops) {
     if (!send_buf_.Valid()) return;
@@ -292,6 +299,15 @@ class CallOpSendMessage {
   void FinishOp(bool* status) { send_buf_.Clear(); }
 
  private:
+  template <class M>
+  Status SendMessageOrObject(const M& message, grpc_call* call,
+                             std::true_type supported);
+  template <class M>
+  Status SendMessageOrObject(const M& message, grpc_call* call,
+                             std::false_type supported) {
+    return SendMessage(message);
+  }
+
   ByteBuffer send_buf_;
   WriteOptions write_options_;
 };
@@ -317,6 +333,24 @@ Status CallOpSendMessage::SendMessage(const M& message) {
   return SendMessage(message, WriteOptions());
 }
 
+template <class M>
+Status CallOpSendMessage::SendMessageOrObject(const M& message,
+                                              grpc_call* call) {
+  return SendMessageOrObject(
+      message, call,
+      std::integral_constant<bool, MessageObjectTraits<M>::kSupported>());
+}
+
+template <class M>
+Status CallOpSendMessage::SendMessageOrObject(const M& message, grpc_call* call,
+                                              std::true_type supported) {
+  if (!g_core_codegen_interface->grpc_call_carries_message_objects(call)) {
+    return SendMessage(message);
+  }
+  write_options_ = WriteOptions();
+  return MessageObjectTraits<M>::Create(message, send_buf_.bbuf_ptr());
+}
+
 template <class R>
 class CallOpRecvMessage {
  public:
@@ -87,6 +87,24 @@ class BlockingUnaryCallImpl;
 
 extern CoreCodegenInterface* g_core_codegen_interface;
 
+namespace experimental {
+/// EXPERIMENTAL
+/// Receives the events of a callback completion queue (see
+/// \a CompletionQueue::CompletionQueue(CompletionQueueHandler*, bool)).
+/// Events are delivered as soon as the operation that produced them
+/// completes, possibly concurrently from several threads.
+class CompletionQueueHandler {
+ public:
+  virtual ~CompletionQueueHandler() {}
+  /// Called for every event that \a Next would have returned, with the same
+  /// \a tag and \a ok.
+  virtual void OnEvent(void* tag, bool ok) = 0;
+  /// Called once, after the last event, when the queue has been shut down and
+  /// fully drained. The completion queue may be destroyed from here on.
+  virtual void OnShutdown() {}
+};
+}  // namespace experimental
+
 /// A thin wrapper around \ref grpc_completion_queue (see \ref
 /// src/core/lib/surface/completion_queue.h).
 /// See \ref doc/cpp/perf_notes.md for notes on best practices for high
@@ -97,7 +115,29 @@ class CompletionQueue : private GrpcLibraryCodegen {
   /// instance.
   CompletionQueue()
       : CompletionQueue(grpc_completion_queue_attributes{
-            GRPC_CQ_CURRENT_VERSION, GRPC_CQ_NEXT, GRPC_CQ_DEFAULT_POLLING}) {}
+            GRPC_CQ_CURRENT_VERSION, GRPC_CQ_NEXT, GRPC_CQ_DEFAULT_POLLING,
+            nullptr}) {}
+
+  /// EXPERIMENTAL
+  /// Creates a callback completion queue: rather than being returned by
+  /// \a Next, events are handed to \a handler straight from the thread that
+  /// completed the operation. If \a inline_handler is false, the handler is
+  /// run on an executor thread instead, which is required if it may block.
+  /// \a Next and \a AsyncNext only poll such a queue (so that the handler
+  /// runs on the polling thread) and never return \a GOT_EVENT.
+  /// \a handler must outlive the queue.
+  CompletionQueue(experimental::CompletionQueueHandler* handler,
+                  bool inline_handler)
+      : callback_functor_(handler, inline_handler) {
+    grpc_completion_queue_attributes attributes{
+        GRPC_CQ_CURRENT_VERSION, GRPC_CQ_CALLBACK, GRPC_CQ_DEFAULT_POLLING,
+        &callback_functor_};
+    cq_ = g_core_codegen_interface->grpc_completion_queue_create(
+        g_core_codegen_interface->grpc_completion_queue_factory_lookup(
+            &attributes),
+        &attributes, NULL);
+    InitialAvalanching();  // reserve this for the future shutdown
+  }
 
   /// Wrap \a take, taking ownership of the instance.
   ///
@@ -354,9 +394,39 @@ class CompletionQueue : private GrpcLibraryCodegen {
   }
   void CompleteAvalanching();
 
+  /// Adapts the events of a callback completion queue to a
+  /// \a CompletionQueueHandler
+  struct CallbackFunctor : public grpc_completion_queue_functor {
+    CallbackFunctor() : handler(nullptr) {
+      run = nullptr;
+      inlineable = 0;
+    }
+    CallbackFunctor(experimental::CompletionQueueHandler* h, bool inline_h)
+        : handler(h) {
+      run = &CallbackFunctor::Run;
+      inlineable = inline_h ? 1 : 0;
+    }
+    static void Run(grpc_completion_queue_functor* functor, grpc_event ev) {
+      auto* handler = static_cast<CallbackFunctor*>(functor)->handler;
+      if (ev.type == GRPC_QUEUE_SHUTDOWN) {
+        handler->OnShutdown();
+        return;
+      }
+      auto cq_tag = static_cast<internal::CompletionQueueTag*>(ev.tag);
+      void* tag = cq_tag;
+      bool ok = ev.success != 0;
+      if (cq_tag->FinalizeResult(&tag, &ok)) {
+        handler->OnEvent(tag, ok);
+      }
+    }
+    experimental::CompletionQueueHandler* handler;
+  };
+
   grpc_completion_queue* cq_;  // owned
 
   gpr_atm avalanches_in_flight_;
+
+  CallbackFunctor callback_functor_;
 };
 
 /// A specific type of completion queue used by the processing of notifications
@@ -376,7 +446,7 @@ class ServerCompletionQueue : public CompletionQueue {
   /// frequently polled.
   ServerCompletionQueue(grpc_cq_polling_type polling_type)
       : CompletionQueue(grpc_completion_queue_attributes{
-            GRPC_CQ_CURRENT_VERSION, GRPC_CQ_NEXT, polling_type}),
+            GRPC_CQ_CURRENT_VERSION, GRPC_CQ_NEXT, polling_type, nullptr}),
         polling_type_(polling_type) {}
 
   grpc_cq_polling_type polling_type_;
@@ -70,10 +70,17 @@ class CoreCodegen final : public CoreCodegenInterface {
   void grpc_call_ref(grpc_call* call) override;
   void grpc_call_unref(grpc_call* call) override;
   virtual void* grpc_call_arena_alloc(grpc_call* call, size_t length) override;
+  int grpc_call_carries_message_objects(grpc_call* call) override;
 
   grpc_byte_buffer* grpc_byte_buffer_copy(grpc_byte_buffer* bb) override;
   void grpc_byte_buffer_destroy(grpc_byte_buffer* bb) override;
   size_t grpc_byte_buffer_length(grpc_byte_buffer* bb) override;
+  grpc_byte_buffer* grpc_message_object_byte_buffer_create(
+      void* object, const void* type,
+      const grpc_message_object_vtable* vtable) override;
+  void* grpc_byte_buffer_get_message_object(grpc_byte_buffer* bb,
+                                            const void* type,
+                                            int* exclusive) override;
 
   int grpc_byte_buffer_reader_init(grpc_byte_buffer_reader* reader,
                                    grpc_byte_buffer* buffer) override;
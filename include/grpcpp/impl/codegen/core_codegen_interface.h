@@ -83,6 +83,12 @@ class CoreCodegenInterface {
   virtual void grpc_byte_buffer_destroy(grpc_byte_buffer* bb) = 0;
   virtual size_t grpc_byte_buffer_length(grpc_byte_buffer* bb)
       GRPC_MUST_USE_RESULT = 0;
+  virtual grpc_byte_buffer* grpc_message_object_byte_buffer_create(
+      void* object, const void* type,
+      const grpc_message_object_vtable* vtable) = 0;
+  virtual void* grpc_byte_buffer_get_message_object(grpc_byte_buffer* bb,
+                                                    const void* type,
+                                                    int* exclusive) = 0;
 
   virtual int grpc_byte_buffer_reader_init(grpc_byte_buffer_reader* reader,
                                            grpc_byte_buffer* buffer)
@@ -107,6 +113,7 @@ class CoreCodegenInterface {
   virtual void grpc_call_ref(grpc_call* call) = 0;
   virtual void grpc_call_unref(grpc_call* call) = 0;
   virtual void* grpc_call_arena_alloc(grpc_call* call, size_t length) = 0;
+  virtual int grpc_call_carries_message_objects(grpc_call* call) = 0;
   virtual grpc_slice grpc_empty_slice() = 0;
   virtual grpc_slice grpc_slice_malloc(size_t length) = 0;
   virtual void grpc_slice_unref(grpc_slice slice) = 0;
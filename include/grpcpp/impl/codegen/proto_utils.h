@@ -95,6 +95,60 @@ Status GenericDeserialize(ByteBuffer* buffer, grpc::protobuf::Message* msg) {
   return result;
 }
 
+// The message object type of protobuf message type T (see
+// grpc_message_object_byte_buffer_create): the address of tag.
+template <class T>
+struct ProtoMessageObjectType {
+  static const char tag;
+};
+
+template <class T>
+const char ProtoMessageObjectType<T>::tag = 0;
+
+template <class T>
+int SerializeProtoMessageObject(void* object, grpc_slice_buffer* out) {
+  const T* msg = static_cast<const T*>(object);
+  grpc_slice slice =
+      g_core_codegen_interface->grpc_slice_malloc(msg->ByteSizeLong());
+  GPR_CODEGEN_ASSERT(GRPC_SLICE_END_PTR(slice) ==
+                     msg->SerializeWithCachedSizesToArray(
+                         GRPC_SLICE_START_PTR(slice)));
+  g_core_codegen_interface->grpc_slice_buffer_add(out, slice);
+  return 1;
+}
+
+template <class T>
+void DestroyProtoMessageObject(void* object) {
+  delete static_cast<T*>(object);
+}
+
+// Sets *bb to a message object byte buffer carrying a copy of msg.
+template <class T>
+Status GenericCreateMessageObject(const T& msg, grpc_byte_buffer** bb) {
+  static const grpc_message_object_vtable vtable = {
+      SerializeProtoMessageObject<T>, DestroyProtoMessageObject<T>};
+  *bb = g_core_codegen_interface->grpc_message_object_byte_buffer_create(
+      new T(msg), &ProtoMessageObjectType<T>::tag, &vtable);
+  return g_core_codegen_interface->ok();
+}
+
+// If bb carries a message object of type T, moves (or copies, if it is
+// shared) it to msg and returns true.
+template <class T>
+bool GenericTakeMessageObject(grpc_byte_buffer* bb, T* msg) {
+  int exclusive;
+  T* object = static_cast<T*>(
+      g_core_codegen_interface->grpc_byte_buffer_get_message_object(
+          bb, &ProtoMessageObjectType<T>::tag, &exclusive));
+  if (object == nullptr) return false;
+  if (exclusive) {
+    msg->Swap(object);
+  } else {
+    msg->CopyFrom(*object);
+  }
+  return true;
+}
+
 // this is needed so the following class does not conflict with protobuf
 // serializers that utilize internal-only tools.
 #ifdef GRPC_OPEN_SOURCE_PROTO
@@ -111,9 +165,35 @@ class SerializationTraits<T, typename std::enable_if<std::is_base_of<
   }
 
   static Status Deserialize(ByteBuffer* buffer, grpc::protobuf::Message* msg) {
+    if (MessageObjectTraits<T>::Take(buffer, static_cast<T*>(msg))) {
+      return g_core_codegen_interface->ok();
+    }
     return GenericDeserialize<ProtoBufferReader, T>(buffer, msg);
   }
 };
+
+// Protobuf messages can be handed over as message objects.
+template <class T>
+class MessageObjectTraits<T, typename std::enable_if<std::is_base_of<
+                                 grpc::protobuf::Message, T>::value>::type> {
+ public:
+  static constexpr bool kSupported = true;
+
+  static Status Create(const T& msg, ByteBuffer* bb) {
+    bb->Clear();
+    return GenericCreateMessageObject<T>(msg, bb->c_buffer_ptr());
+  }
+
+  // Takes the message object of buffer, if it carries one of type T.
+  static bool Take(ByteBuffer* buffer, T* msg) {
+    if (buffer == nullptr || !buffer->Valid() ||
+        !GenericTakeMessageObject<T>(buffer->c_buffer(), msg)) {
+      return false;
+    }
+    buffer->Clear();
+    return true;
+  }
+};
 #endif
 
 }  // namespace grpc
@@ -57,6 +57,26 @@ template <class Message,
           class UnusedButHereForPartialTemplateSpecialization = void>
 class SerializationTraits;
 
+/// Lets calls that carry message objects (see
+/// grpc_call_carries_message_objects) hand a copy of some type to the
+/// receiving side instead of its serialized form.
+///
+/// Types are serialized unless MessageObjectTraits<Message> is specialized
+/// with kSupported = true and the following function:
+///
+///   static Status Create(const Message& msg, ByteBuffer* buffer);
+///
+/// which sets *buffer to a message object byte buffer (see
+/// grpc_message_object_byte_buffer_create) carrying a copy of msg. The
+/// SerializationTraits<Message>::Deserialize of such types must then accept
+/// these buffers as well as serialized ones.
+template <class Message,
+          class UnusedButHereForPartialTemplateSpecialization = void>
+class MessageObjectTraits {
+ public:
+  static constexpr bool kSupported = false;
+};
+
 }  // namespace grpc
 
 #endif  // GRPCPP_IMPL_CODEGEN_SERIALIZATION_TRAITS_H
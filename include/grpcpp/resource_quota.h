@@ -44,6 +44,14 @@ class ResourceQuota final : private GrpcLibraryCodegen {
   /// No time bound is given for this to occur however.
   ResourceQuota& Resize(size_t new_size);
 
+  /// Set the maximum number of threads that synchronous servers using this
+  /// \a ResourceQuota may create, summed over all of them. A server that has
+  /// reached the limit queues incoming work for its existing threads instead
+  /// of creating new ones. If \a new_max_threads is smaller than the number of
+  /// threads in use, no thread is stopped: new threads are only granted once
+  /// enough of the current ones have exited.
+  ResourceQuota& SetMaxThreads(int new_max_threads);
+
   grpc_resource_quota* c_resource_quota() const { return impl_; }
 
  private:
@@ -45,6 +45,7 @@
 #include "src/core/lib/channel/connected_channel.h"
 #include "src/core/lib/channel/status_util.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gprpp/arena.h"
 #include "src/core/lib/gprpp/inlined_vector.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/iomgr/combiner.h"
@@ -907,7 +908,7 @@ typedef struct client_channel_call_data {
   grpc_slice path;  // Request path.
   gpr_timespec call_start_time;
   grpc_millis deadline;
-  gpr_arena* arena;
+  grpc_core::Arena* arena;
   grpc_call_stack* owning_call;
   grpc_call_combiner* call_combiner;
 
@@ -1002,9 +1003,10 @@ static void maybe_cache_send_ops_for_batch(call_data* calld,
     GPR_ASSERT(calld->send_initial_metadata_storage == nullptr);
     grpc_metadata_batch* send_initial_metadata =
         batch->payload->send_initial_metadata.send_initial_metadata;
-    calld->send_initial_metadata_storage = (grpc_linked_mdelem*)gpr_arena_alloc(
-        calld->arena,
-        sizeof(grpc_linked_mdelem) * send_initial_metadata->list.count);
+    calld->send_initial_metadata_storage =
+        static_cast<grpc_linked_mdelem*>(calld->arena->Alloc(
+            sizeof(grpc_linked_mdelem) * send_initial_metadata->list.count,
+            alignof(grpc_linked_mdelem)));
     grpc_metadata_batch_copy(send_initial_metadata,
                              &calld->send_initial_metadata,
                              calld->send_initial_metadata_storage);
@@ -1014,11 +1016,11 @@ static void maybe_cache_send_ops_for_batch(call_data* calld,
   }
   // Set up cache for send_message ops.
   if (batch->send_message) {
+    // The arena runs the cache's destructor when the call is destroyed, in
+    // case it is never freed by free_cached_send_message().
     grpc_core::ByteStreamCache* cache =
-        static_cast<grpc_core::ByteStreamCache*>(
-            gpr_arena_alloc(calld->arena, sizeof(grpc_core::ByteStreamCache)));
-    new (cache) grpc_core::ByteStreamCache(
-        std::move(batch->payload->send_message.send_message));
+        calld->arena->New<grpc_core::ByteStreamCache>(
+            std::move(batch->payload->send_message.send_message));
     calld->send_messages->push_back(cache);
   }
   // Save metadata batch for send_trailing_metadata ops.
@@ -1028,9 +1030,9 @@ static void maybe_cache_send_ops_for_batch(call_data* calld,
     grpc_metadata_batch* send_trailing_metadata =
         batch->payload->send_trailing_metadata.send_trailing_metadata;
     calld->send_trailing_metadata_storage =
-        (grpc_linked_mdelem*)gpr_arena_alloc(
-            calld->arena,
-            sizeof(grpc_linked_mdelem) * send_trailing_metadata->list.count);
+        static_cast<grpc_linked_mdelem*>(calld->arena->Alloc(
+            sizeof(grpc_linked_mdelem) * send_trailing_metadata->list.count,
+            alignof(grpc_linked_mdelem)));
     grpc_metadata_batch_copy(send_trailing_metadata,
                              &calld->send_trailing_metadata,
                              calld->send_trailing_metadata_storage);
@@ -1538,8 +1540,8 @@ static subchannel_batch_data* batch_data_create(grpc_call_element* elem,
       static_cast<subchannel_call_retry_state*>(
           grpc_connected_subchannel_call_get_parent_data(
               calld->subchannel_call));
-  subchannel_batch_data* batch_data = static_cast<subchannel_batch_data*>(
-      gpr_arena_alloc(calld->arena, sizeof(*batch_data)));
+  subchannel_batch_data* batch_data =
+      calld->arena->New<subchannel_batch_data>();
   batch_data->elem = elem;
   batch_data->subchannel_call =
       GRPC_SUBCHANNEL_CALL_REF(calld->subchannel_call, "batch_data_create");
@@ -2169,10 +2171,11 @@ static void add_retriable_send_initial_metadata_op(
   // If we've already completed one or more attempts, add the
   // grpc-retry-attempts header.
   retry_state->send_initial_metadata_storage =
-      static_cast<grpc_linked_mdelem*>(gpr_arena_alloc(
-          calld->arena, sizeof(grpc_linked_mdelem) *
-                            (calld->send_initial_metadata.list.count +
-                             (calld->num_attempts_completed > 0))));
+      static_cast<grpc_linked_mdelem*>(calld->arena->Alloc(
+          sizeof(grpc_linked_mdelem) *
+              (calld->send_initial_metadata.list.count +
+               (calld->num_attempts_completed > 0)),
+          alignof(grpc_linked_mdelem)));
   grpc_metadata_batch_copy(&calld->send_initial_metadata,
                            &retry_state->send_initial_metadata,
                            retry_state->send_initial_metadata_storage);
@@ -2235,9 +2238,9 @@ static void add_retriable_send_trailing_metadata_op(
   // the filters in the subchannel stack may modify this batch, and we don't
   // want those modifications to be passed forward to subsequent attempts.
   retry_state->send_trailing_metadata_storage =
-      static_cast<grpc_linked_mdelem*>(gpr_arena_alloc(
-          calld->arena, sizeof(grpc_linked_mdelem) *
-                            calld->send_trailing_metadata.list.count));
+      static_cast<grpc_linked_mdelem*>(calld->arena->Alloc(
+          sizeof(grpc_linked_mdelem) * calld->send_trailing_metadata.list.count,
+          alignof(grpc_linked_mdelem)));
   grpc_metadata_batch_copy(&calld->send_trailing_metadata,
                            &retry_state->send_trailing_metadata,
                            retry_state->send_trailing_metadata_storage);
@@ -40,6 +40,7 @@
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/alloc.h"
 #include "src/core/lib/gprpp/debug_location.h"
+#include "src/core/lib/gprpp/inlined_vector.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/iomgr/sockaddr_utils.h"
@@ -59,10 +60,103 @@
 #define GRPC_SUBCHANNEL_RECONNECT_MAX_BACKOFF_SECONDS 120
 #define GRPC_SUBCHANNEL_RECONNECT_JITTER 0.2
 
+namespace grpc_core {
+
+// The connections of a subchannel that keeps several to its address (see
+// GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS). A call created on any of them is
+// placed on the one with the fewest active calls. The subchannel removes a
+// connection once it fails, and all of them when it disconnects.
+class ConnectedSubchannelPool : public RefCounted<ConnectedSubchannelPool> {
+ public:
+  ConnectedSubchannelPool() { gpr_mu_init(&mu_); }
+  ~ConnectedSubchannelPool() { gpr_mu_destroy(&mu_); }
+
+  void Add(RefCountedPtr<ConnectedSubchannel> connection) {
+    gpr_mu_lock(&mu_);
+    connections_.push_back(std::move(connection));
+    gpr_mu_unlock(&mu_);
+  }
+
+  void Remove(ConnectedSubchannel* connection) {
+    RefCountedPtr<ConnectedSubchannel> removed;
+    gpr_mu_lock(&mu_);
+    for (size_t i = 0; i < connections_.size(); i++) {
+      if (connections_[i].get() == connection) {
+        removed = std::move(connections_[i]);
+        connections_[i] = std::move(connections_[connections_.size() - 1]);
+        connections_.pop_back();
+        break;
+      }
+    }
+    gpr_mu_unlock(&mu_);
+    // removed may be the last ref to the connection, whose destruction would
+    // reach back into this pool: release it unlocked
+  }
+
+  void Clear() {
+    InlinedVector<RefCountedPtr<ConnectedSubchannel>, 4> removed;
+    gpr_mu_lock(&mu_);
+    removed = std::move(connections_);
+    gpr_mu_unlock(&mu_);
+  }
+
+  bool Contains(ConnectedSubchannel* connection) {
+    bool found = false;
+    gpr_mu_lock(&mu_);
+    for (size_t i = 0; i < connections_.size(); i++) {
+      if (connections_[i].get() == connection) found = true;
+    }
+    gpr_mu_unlock(&mu_);
+    return found;
+  }
+
+  size_t size() {
+    gpr_mu_lock(&mu_);
+    size_t size = connections_.size();
+    gpr_mu_unlock(&mu_);
+    return size;
+  }
+
+  // Returns the connection with the fewest active calls, or null if the pool
+  // is empty.
+  RefCountedPtr<ConnectedSubchannel> PickLeastLoaded() {
+    RefCountedPtr<ConnectedSubchannel> picked;
+    gpr_atm picked_calls = 0;
+    gpr_mu_lock(&mu_);
+    for (size_t i = 0; i < connections_.size(); i++) {
+      gpr_atm calls =
+          gpr_atm_no_barrier_load(&connections_[i]->active_calls_);
+      if (picked == nullptr || calls < picked_calls) {
+        picked = connections_[i];
+        picked_calls = calls;
+      }
+    }
+    gpr_mu_unlock(&mu_);
+    return picked;
+  }
+
+  // Returns any of the connections, or null if the pool is empty.
+  RefCountedPtr<ConnectedSubchannel> First() {
+    RefCountedPtr<ConnectedSubchannel> first;
+    gpr_mu_lock(&mu_);
+    if (!connections_.empty()) first = connections_[0];
+    gpr_mu_unlock(&mu_);
+    return first;
+  }
+
+ private:
+  gpr_mu mu_;
+  InlinedVector<RefCountedPtr<ConnectedSubchannel>, 4> connections_;
+};
+
+}  // namespace grpc_core
+
 namespace {
 struct state_watcher {
   grpc_closure closure;
   grpc_subchannel* subchannel;
+  /** the connection watched; only dereferenced while the subchannel uses it */
+  grpc_core::ConnectedSubchannel* connection;
   grpc_connectivity_state connectivity_state;
 };
 }  // namespace
@@ -114,6 +208,12 @@ struct grpc_subchannel {
    */
   grpc_core::RefCountedPtr<grpc_core::ConnectedSubchannel> connected_subchannel;
 
+  /** number of connections to keep to the address */
+  size_t max_connections;
+  /** if max_connections > 1, all the active connections (including
+      connected_subchannel, the one handed out) */
+  grpc_core::RefCountedPtr<grpc_core::ConnectedSubchannelPool> pool;
+
   /** have we seen a disconnection? */
   bool disconnected;
   /** are we connecting */
@@ -182,6 +282,8 @@ static void connection_destroy(void* arg, grpc_error* error) {
 static void subchannel_destroy(void* arg, grpc_error* error) {
   grpc_subchannel* c = static_cast<grpc_subchannel*>(arg);
   c->channelz_subchannel.reset();
+  if (c->pool != nullptr) c->pool->Clear();
+  c->pool.reset();
   gpr_free((void*)c->filters);
   grpc_channel_args_destroy(c->args);
   grpc_connectivity_state_destroy(&c->state_tracker);
@@ -247,6 +349,7 @@ static void disconnect(grpc_subchannel* c) {
   grpc_connector_shutdown(c->connector, GRPC_ERROR_CREATE_FROM_STATIC_STRING(
                                             "Subchannel disconnected"));
   c->connected_subchannel.reset();
+  if (c->pool != nullptr) c->pool->Clear();
   gpr_mu_unlock(&c->mu);
 }
 
@@ -376,6 +479,12 @@ grpc_subchannel* grpc_subchannel_create(grpc_connector* connector,
   parse_args_for_backoff_values(args->args, &backoff_options,
                                 &c->min_connect_timeout_ms);
   c->backoff.Init(backoff_options);
+  c->max_connections = static_cast<size_t>(grpc_channel_arg_get_integer(
+      grpc_channel_args_find(c->args, GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS),
+      {1, 1, INT_MAX}));
+  if (c->max_connections > 1) {
+    c->pool = grpc_core::MakeRefCounted<grpc_core::ConnectedSubchannelPool>();
+  }
   gpr_mu_init(&c->mu);
 
   const grpc_arg* arg =
@@ -452,6 +561,12 @@ static void on_alarm(void* arg, grpc_error* error) {
   GRPC_ERROR_UNREF(error);
 }
 
+/* Is every connection the subchannel should keep open? */
+static bool fully_connected_locked(grpc_subchannel* c) {
+  if (c->connected_subchannel == nullptr) return false;
+  return c->pool == nullptr || c->pool->size() >= c->max_connections;
+}
+
 static void maybe_start_connecting_locked(grpc_subchannel* c) {
   if (c->disconnected) {
     /* Don't try to connect if we're already disconnected */
@@ -461,7 +576,7 @@ static void maybe_start_connecting_locked(grpc_subchannel* c) {
     /* Already connecting: don't restart */
     return;
   }
-  if (c->connected_subchannel != nullptr) {
+  if (fully_connected_locked(c)) {
     /* Already connected: don't restart */
     return;
   }
@@ -471,10 +586,15 @@ static void maybe_start_connecting_locked(grpc_subchannel* c) {
   }
   c->connecting = true;
   GRPC_SUBCHANNEL_WEAK_REF(c, "connecting");
+  /* Connecting more connections to the pool of a connected subchannel leaves
+     it READY */
+  const bool connected = c->connected_subchannel != nullptr;
   if (!c->backoff_begun) {
     c->backoff_begun = true;
-    grpc_connectivity_state_set(&c->state_tracker, GRPC_CHANNEL_CONNECTING,
-                                GRPC_ERROR_NONE, "connecting");
+    if (!connected) {
+      grpc_connectivity_state_set(&c->state_tracker, GRPC_CHANNEL_CONNECTING,
+                                  GRPC_ERROR_NONE, "connecting");
+    }
     continue_connect_locked(c);
   } else {
     GPR_ASSERT(!c->have_alarm);
@@ -492,8 +612,10 @@ static void maybe_start_connecting_locked(grpc_subchannel* c) {
     // During backoff, we prefer the connectivity state of CONNECTING instead of
     // TRANSIENT_FAILURE in order to prevent triggering re-resolution
     // continuously in pick_first.
-    grpc_connectivity_state_set(&c->state_tracker, GRPC_CHANNEL_CONNECTING,
-                                GRPC_ERROR_NONE, "backoff");
+    if (!connected) {
+      grpc_connectivity_state_set(&c->state_tracker, GRPC_CHANNEL_CONNECTING,
+                                  GRPC_ERROR_NONE, "backoff");
+    }
   }
 }
 
@@ -534,10 +656,38 @@ void grpc_subchannel_notify_on_state_change(
   }
 }
 
+/* Is \a connection one of the subchannel's active connections? */
+static bool uses_connection_locked(grpc_subchannel* c,
+                                   grpc_core::ConnectedSubchannel* connection) {
+  if (c->pool != nullptr) return c->pool->Contains(connection);
+  return c->connected_subchannel.get() == connection;
+}
+
+/* Stop using a failed connection. The subchannel only leaves READY when it
+   was its last one. */
+static void drop_connection_locked(grpc_subchannel* c,
+                                   grpc_core::ConnectedSubchannel* connection,
+                                   grpc_error* error) {
+  if (c->pool != nullptr) {
+    c->pool->Remove(connection);
+    if (c->connected_subchannel.get() == connection) {
+      c->connected_subchannel = c->pool->First();
+    }
+    if (c->connected_subchannel != nullptr) return;
+  }
+  c->connected_subchannel.reset();
+  grpc_connectivity_state_set(&c->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+                              GRPC_ERROR_REF(error), "reflect_child");
+  c->backoff_begun = false;
+  c->backoff->Reset();
+}
+
 static void on_connected_subchannel_connectivity_changed(void* p,
                                                          grpc_error* error) {
   state_watcher* connected_subchannel_watcher = static_cast<state_watcher*>(p);
   grpc_subchannel* c = connected_subchannel_watcher->subchannel;
+  grpc_core::ConnectedSubchannel* connection =
+      connected_subchannel_watcher->connection;
   gpr_mu* mu = &c->mu;
 
   gpr_mu_lock(mu);
@@ -545,21 +695,16 @@ static void on_connected_subchannel_connectivity_changed(void* p,
   switch (connected_subchannel_watcher->connectivity_state) {
     case GRPC_CHANNEL_TRANSIENT_FAILURE:
     case GRPC_CHANNEL_SHUTDOWN: {
-      if (!c->disconnected && c->connected_subchannel != nullptr) {
+      if (!c->disconnected && uses_connection_locked(c, connection)) {
         if (grpc_trace_stream_refcount.enabled()) {
           gpr_log(GPR_INFO,
                   "Connected subchannel %p of subchannel %p has gone into %s. "
                   "Attempting to reconnect.",
-                  c->connected_subchannel.get(), c,
+                  connection, c,
                   grpc_connectivity_state_name(
                       connected_subchannel_watcher->connectivity_state));
         }
-        c->connected_subchannel.reset();
-        grpc_connectivity_state_set(&c->state_tracker,
-                                    GRPC_CHANNEL_TRANSIENT_FAILURE,
-                                    GRPC_ERROR_REF(error), "reflect_child");
-        c->backoff_begun = false;
-        c->backoff->Reset();
+        drop_connection_locked(c, connection, error);
         maybe_start_connecting_locked(c);
       } else {
         connected_subchannel_watcher->connectivity_state =
@@ -568,11 +713,13 @@ static void on_connected_subchannel_connectivity_changed(void* p,
       break;
     }
     default: {
-      grpc_connectivity_state_set(
-          &c->state_tracker, connected_subchannel_watcher->connectivity_state,
-          GRPC_ERROR_REF(error), "reflect_child");
+      if (connection == c->connected_subchannel.get()) {
+        grpc_connectivity_state_set(
+            &c->state_tracker, connected_subchannel_watcher->connectivity_state,
+            GRPC_ERROR_REF(error), "reflect_child");
+      }
       GRPC_SUBCHANNEL_WEAK_REF(c, "state_watcher");
-      c->connected_subchannel->NotifyOnStateChange(
+      connection->NotifyOnStateChange(
           nullptr, &connected_subchannel_watcher->connectivity_state,
           &connected_subchannel_watcher->closure);
       connected_subchannel_watcher = nullptr;
@@ -625,22 +772,34 @@ static bool publish_transport_locked(grpc_subchannel* c) {
   }
 
   /* publish */
-  c->connected_subchannel.reset(
-      grpc_core::New<grpc_core::ConnectedSubchannel>(stk));
+  grpc_core::RefCountedPtr<grpc_core::ConnectedSubchannel> connection(
+      grpc_core::New<grpc_core::ConnectedSubchannel>(stk, c->pool));
   gpr_log(GPR_INFO, "New connected subchannel at %p for subchannel %p",
-          c->connected_subchannel.get(), c);
+          connection.get(), c);
+  connected_subchannel_watcher->connection = connection.get();
+  const bool was_connected = c->connected_subchannel != nullptr;
+  if (c->pool != nullptr) c->pool->Add(connection);
+  if (!was_connected) c->connected_subchannel = std::move(connection);
 
   /* setup subchannel watching connected subchannel for changes; subchannel
      ref for connecting is donated to the state watcher */
   GRPC_SUBCHANNEL_WEAK_REF(c, "state_watcher");
   GRPC_SUBCHANNEL_WEAK_UNREF(c, "connecting");
-  c->connected_subchannel->NotifyOnStateChange(
+  connected_subchannel_watcher->connection->NotifyOnStateChange(
       c->pollset_set, &connected_subchannel_watcher->connectivity_state,
       &connected_subchannel_watcher->closure);
 
   /* signal completion */
-  grpc_connectivity_state_set(&c->state_tracker, GRPC_CHANNEL_READY,
-                              GRPC_ERROR_NONE, "connected");
+  if (!was_connected) {
+    grpc_connectivity_state_set(&c->state_tracker, GRPC_CHANNEL_READY,
+                                GRPC_ERROR_NONE, "connected");
+  }
+  if (c->pool != nullptr) {
+    /* go on to open the rest of the pool's connections right away */
+    c->backoff_begun = false;
+    c->backoff->Reset();
+    maybe_start_connecting_locked(c);
+  }
   return true;
 }
 
@@ -657,12 +816,15 @@ static void on_subchannel_connected(void* arg, grpc_error* error) {
   } else if (c->disconnected) {
     GRPC_SUBCHANNEL_WEAK_UNREF(c, "connecting");
   } else {
-    grpc_connectivity_state_set(
-        &c->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
-        grpc_error_set_int(GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
-                               "Connect Failed", &error, 1),
-                           GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE),
-        "connect_failed");
+    if (c->connected_subchannel == nullptr) {
+      grpc_connectivity_state_set(
+          &c->state_tracker, GRPC_CHANNEL_TRANSIENT_FAILURE,
+          grpc_error_set_int(
+              GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
+                  "Connect Failed", &error, 1),
+              GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE),
+          "connect_failed");
+    }
 
     const char* errmsg = grpc_error_string(error);
     gpr_log(GPR_INFO, "Connect failed: %s", errmsg);
@@ -685,7 +847,7 @@ static void subchannel_call_destroy(void* call, grpc_error* error) {
   grpc_core::ConnectedSubchannel* connection = c->connection;
   grpc_call_stack_destroy(SUBCHANNEL_CALL_TO_CALL_STACK(c), nullptr,
                           c->schedule_closure_after_destroy);
-  connection->Unref(DEBUG_LOCATION, "subchannel_call");
+  connection->ReleaseCall();
 }
 
 void grpc_subchannel_call_set_cleanup_closure(grpc_subchannel_call* call,
@@ -773,9 +935,12 @@ grpc_arg grpc_create_subchannel_address_arg(const grpc_resolved_address* addr) {
 
 namespace grpc_core {
 
-ConnectedSubchannel::ConnectedSubchannel(grpc_channel_stack* channel_stack)
+ConnectedSubchannel::ConnectedSubchannel(
+    grpc_channel_stack* channel_stack,
+    RefCountedPtr<ConnectedSubchannelPool> pool)
     : RefCountedWithTracing<ConnectedSubchannel>(&grpc_trace_stream_refcount),
-      channel_stack_(channel_stack) {}
+      channel_stack_(channel_stack),
+      pool_(std::move(pool)) {}
 
 ConnectedSubchannel::~ConnectedSubchannel() {
   GRPC_CHANNEL_STACK_UNREF(channel_stack_, "connected_subchannel_dtor");
@@ -805,22 +970,31 @@ void ConnectedSubchannel::Ping(grpc_closure* on_initiate,
 
 grpc_error* ConnectedSubchannel::CreateCall(const CallArgs& args,
                                             grpc_subchannel_call** call) {
+  // In a pool, place the call on the least loaded connection; this one may
+  // even have failed and left the pool already.
+  RefCountedPtr<ConnectedSubchannel> connection;
+  if (pool_ != nullptr) connection = pool_->PickLeastLoaded();
+  if (connection == nullptr) {
+    connection = Ref(DEBUG_LOCATION, "subchannel_call");
+  }
+  if (connection->pool_ != nullptr) {
+    gpr_atm_no_barrier_fetch_add(&connection->active_calls_, 1);
+  }
+  grpc_channel_stack* channel_stack = connection->channel_stack_;
   size_t allocation_size =
       GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(grpc_subchannel_call));
   if (args.parent_data_size > 0) {
     allocation_size +=
-        GPR_ROUND_UP_TO_ALIGNMENT_SIZE(channel_stack_->call_stack_size) +
+        GPR_ROUND_UP_TO_ALIGNMENT_SIZE(channel_stack->call_stack_size) +
         args.parent_data_size;
   } else {
-    allocation_size += channel_stack_->call_stack_size;
+    allocation_size += channel_stack->call_stack_size;
   }
   *call = static_cast<grpc_subchannel_call*>(
       gpr_arena_alloc(args.arena, allocation_size));
   grpc_call_stack* callstk = SUBCHANNEL_CALL_TO_CALL_STACK(*call);
-  RefCountedPtr<ConnectedSubchannel> connection =
-      Ref(DEBUG_LOCATION, "subchannel_call");
-  connection.release();  // Ref is passed to the grpc_subchannel_call object.
-  (*call)->connection = this;
+  // Ref is passed to the grpc_subchannel_call object.
+  (*call)->connection = connection.release();
   const grpc_call_element_args call_args = {
       callstk,           /* call_stack */
       nullptr,           /* server_transport_data */
@@ -832,7 +1006,7 @@ grpc_error* ConnectedSubchannel::CreateCall(const CallArgs& args,
       args.call_combiner /* call_combiner */
   };
   grpc_error* error = grpc_call_stack_init(
-      channel_stack_, 1, subchannel_call_destroy, *call, &call_args);
+      channel_stack, 1, subchannel_call_destroy, *call, &call_args);
   if (GPR_UNLIKELY(error != GRPC_ERROR_NONE)) {
     const char* error_string = grpc_error_string(error);
     gpr_log(GPR_ERROR, "error: %s", error_string);
@@ -842,4 +1016,11 @@ grpc_error* ConnectedSubchannel::CreateCall(const CallArgs& args,
   return GRPC_ERROR_NONE;
 }
 
+void ConnectedSubchannel::ReleaseCall() {
+  if (pool_ != nullptr) {
+    gpr_atm_no_barrier_fetch_add(&active_calls_, -1);
+  }
+  Unref(DEBUG_LOCATION, "subchannel_call");
+}
+
 }  // namespace grpc_core
@@ -72,6 +72,8 @@ typedef struct grpc_subchannel_key grpc_subchannel_key;
 
 namespace grpc_core {
 
+class ConnectedSubchannelPool;
+
 class ConnectedSubchannel : public RefCountedWithTracing<ConnectedSubchannel> {
  public:
   struct CallArgs {
@@ -85,7 +87,11 @@ class ConnectedSubchannel : public RefCountedWithTracing<ConnectedSubchannel> {
     size_t parent_data_size;
   };
 
-  explicit ConnectedSubchannel(grpc_channel_stack* channel_stack);
+  // If \a pool is given, the connection is one of several a subchannel keeps
+  // to its address, and calls created on it may be placed on another one.
+  explicit ConnectedSubchannel(
+      grpc_channel_stack* channel_stack,
+      RefCountedPtr<ConnectedSubchannelPool> pool = nullptr);
   ~ConnectedSubchannel();
 
   grpc_channel_stack* channel_stack() { return channel_stack_; }
@@ -94,9 +100,16 @@ class ConnectedSubchannel : public RefCountedWithTracing<ConnectedSubchannel> {
                            grpc_closure* closure);
   void Ping(grpc_closure* on_initiate, grpc_closure* on_ack);
   grpc_error* CreateCall(const CallArgs& args, grpc_subchannel_call** call);
+  // Called when a call created by CreateCall on this connection is destroyed.
+  void ReleaseCall();
 
  private:
+  friend class ConnectedSubchannelPool;
+
   grpc_channel_stack* channel_stack_;
+  RefCountedPtr<ConnectedSubchannelPool> pool_;
+  // Calls on this connection not yet destroyed; only counted in a pool.
+  gpr_atm active_calls_ = 0;
 };
 
 }  // namespace grpc_core
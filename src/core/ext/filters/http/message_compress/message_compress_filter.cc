@@ -31,7 +31,9 @@
 #include "src/core/lib/compression/algorithm_metadata.h"
 #include "src/core/lib/compression/compression_internal.h"
 #include "src/core/lib/compression/message_compress.h"
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
@@ -39,7 +41,35 @@
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/transport/static_metadata.h"
 
+/* Adaptive compression keeps, for each method, a moving average of the
+   fraction of their size that compressing its messages saved. While that is
+   below the channel's minimum, the method's messages are sent without trying
+   to compress them, except for a probe now and then that notices when its
+   payloads change: the first probe comes after ADAPTIVE_MIN_PROBE_INTERVAL
+   messages, and the interval doubles while probes keep failing, up to
+   ADAPTIVE_MAX_PROBE_INTERVAL. */
+#define ADAPTIVE_MIN_PROBE_INTERVAL 16
+#define ADAPTIVE_MAX_PROBE_INTERVAL 1024
+/* Methods tracked per channel; the messages of further methods are always
+   compressed */
+#define ADAPTIVE_MAX_METHODS 64
+#define ADAPTIVE_DEFAULT_MIN_SAVINGS_PERCENT 10
+
 namespace {
+struct method_compression_state {
+  grpc_slice path;
+  uint32_t hash;
+  /** Messages left to send uncompressed before the next probe */
+  gpr_atm skip;
+  gpr_mu mu;
+  /** Moving average of the savings, in 1024ths of the message size */
+  int savings;
+  bool has_savings;
+  /** Messages to skip if the next probe fails too; zero while compressing
+   * pays off */
+  int probe_interval;
+};
+
 enum initial_metadata_state {
   // Initial metadata not yet seen.
   INITIAL_METADATA_UNSEEN = 0,
@@ -68,6 +98,11 @@ struct call_data {
   grpc_closure* original_send_message_on_complete;
   grpc_closure send_message_on_complete;
   grpc_closure on_send_message_next_done;
+  /** Adaptive compression state of the call's method, if any */
+  method_compression_state* method;
+  grpc_closure* original_recv_initial_metadata_ready;
+  grpc_closure recv_initial_metadata_ready;
+  grpc_metadata_batch* recv_initial_metadata;
 };
 
 struct channel_data {
@@ -79,9 +114,119 @@ struct channel_data {
   uint32_t supported_message_compression_algorithms;
   /** Supported stream compression algorithms */
   uint32_t supported_stream_compression_algorithms;
+  /** grpc-accept-encoding element listing the supported message compression
+   * algorithms, when some of them are registered ones and it therefore can't
+   * be a static element; GRPC_MDNULL otherwise */
+  grpc_mdelem accept_encoding;
+  /** Whether compression adapts to how much it saves for each method */
+  bool adaptive;
+  /** Minimum average savings, in 1024ths of the message size, for adaptive
+   * compression to keep compressing the messages of a method */
+  int adaptive_min_savings;
+  /** Serializes adding methods */
+  gpr_mu methods_mu;
+  /** Adaptive compression state of the methods seen so far. Entries are
+   * written under methods_mu before num_methods is (release) bumped past
+   * them, and never change afterwards, so lookups need no lock. */
+  method_compression_state* methods[ADAPTIVE_MAX_METHODS];
+  gpr_atm num_methods;
 };
 }  // namespace
 
+/* Returns the method with \a path among methods [\a begin, \a n) of
+   \a channeld, or NULL */
+static method_compression_state* lookup_method(channel_data* channeld,
+                                               size_t begin, size_t n,
+                                               grpc_slice path, uint32_t hash) {
+  for (size_t i = begin; i < n; i++) {
+    if (channeld->methods[i]->hash == hash &&
+        grpc_slice_eq(channeld->methods[i]->path, path)) {
+      return channeld->methods[i];
+    }
+  }
+  return nullptr;
+}
+
+/* Returns the adaptive compression state of the method at \a path, or NULL if
+   the channel already tracks as many methods as it can. Only adding a method
+   takes methods_mu. */
+static method_compression_state* find_method(channel_data* channeld,
+                                             grpc_slice path) {
+  uint32_t hash = grpc_slice_hash(path);
+  size_t n = static_cast<size_t>(gpr_atm_acq_load(&channeld->num_methods));
+  method_compression_state* m = lookup_method(channeld, 0, n, path, hash);
+  if (m != nullptr || n == ADAPTIVE_MAX_METHODS) return m;
+  gpr_mu_lock(&channeld->methods_mu);
+  /* another call may have added methods since */
+  size_t seen = n;
+  n = static_cast<size_t>(gpr_atm_no_barrier_load(&channeld->num_methods));
+  m = lookup_method(channeld, seen, n, path, hash);
+  if (m == nullptr && n < ADAPTIVE_MAX_METHODS) {
+    m = static_cast<method_compression_state*>(gpr_zalloc(sizeof(*m)));
+    m->path = grpc_slice_dup(path);
+    m->hash = hash;
+    gpr_mu_init(&m->mu);
+    channeld->methods[n] = m;
+    gpr_atm_rel_store(&channeld->num_methods, static_cast<gpr_atm>(n + 1));
+  }
+  gpr_mu_unlock(&channeld->methods_mu);
+  return m;
+}
+
+/* Compresses \a input into \a output unless compression is not paying off
+   for method \a m, and updates what is known about \a m with the outcome.
+   Returns whether \a output holds the compressed message. */
+static bool adaptive_compress(channel_data* channeld,
+                              method_compression_state* m,
+                              grpc_message_compression_algorithm algorithm,
+                              grpc_slice_buffer* input,
+                              grpc_slice_buffer* output) {
+  if (gpr_atm_no_barrier_load(&m->skip) > 0 &&
+      gpr_atm_no_barrier_fetch_add(&m->skip, -1) > 0) {
+    GRPC_STATS_INC_ADAPTIVE_COMPRESSION_SKIPPED();
+    return false;
+  }
+  bool did_compress = grpc_msg_compress(algorithm, input, output);
+  if (input->length == 0) return did_compress;
+  /* application supplied algorithms may report compressing a message into
+     more bytes than it had */
+  int savings = did_compress && output->length < input->length
+                    ? static_cast<int>((input->length - output->length) *
+                                       1024 / input->length)
+                    : 0;
+  GRPC_STATS_INC_ADAPTIVE_COMPRESSION_ATTEMPTS();
+  GRPC_STATS_INC_ADAPTIVE_COMPRESSION_SAVINGS(savings * 100 / 1024);
+  gpr_mu_lock(&m->mu);
+  m->savings = m->has_savings ? (m->savings + savings) / 2 : savings;
+  m->has_savings = true;
+  bool was_stopped = m->probe_interval > 0;
+  if (m->savings >= channeld->adaptive_min_savings) {
+    m->probe_interval = 0;
+    if (was_stopped) {
+      GRPC_STATS_INC_ADAPTIVE_COMPRESSION_RESUMED();
+    }
+  } else {
+    m->probe_interval = was_stopped ? GPR_MIN(2 * m->probe_interval,
+                                              ADAPTIVE_MAX_PROBE_INTERVAL)
+                                    : ADAPTIVE_MIN_PROBE_INTERVAL;
+    gpr_atm_no_barrier_store(&m->skip, m->probe_interval);
+    if (!was_stopped) {
+      GRPC_STATS_INC_ADAPTIVE_COMPRESSION_STOPPED();
+    }
+  }
+  bool is_stopped = m->probe_interval > 0;
+  int average_savings = m->savings;
+  gpr_mu_unlock(&m->mu);
+  if (was_stopped != is_stopped && grpc_compression_trace.enabled()) {
+    char* path = grpc_slice_to_c_string(m->path);
+    gpr_log(GPR_INFO, "%s compressing %s (%.2f%% average savings)",
+            is_stopped ? "Stopped" : "Resumed", path,
+            100 * average_savings / 1024.0);
+    gpr_free(path);
+  }
+  return did_compress;
+}
+
 static bool skip_compression(grpc_call_element* elem, uint32_t flags,
                              bool has_compression_algorithm) {
   call_data* calld = static_cast<call_data*>(elem->call_data);
@@ -180,8 +325,10 @@ static grpc_error* process_send_initial_metadata(
   /* convey supported compression algorithms */
   error = grpc_metadata_batch_add_tail(
       initial_metadata, &calld->accept_encoding_storage,
-      GRPC_MDELEM_ACCEPT_ENCODING_FOR_ALGORITHMS(
-          channeld->supported_message_compression_algorithms));
+      GRPC_MDISNULL(channeld->accept_encoding)
+          ? GRPC_MDELEM_ACCEPT_ENCODING_FOR_ALGORITHMS(
+                channeld->supported_message_compression_algorithms)
+          : GRPC_MDELEM_REF(channeld->accept_encoding));
 
   if (error != GRPC_ERROR_NONE) return error;
 
@@ -223,8 +370,13 @@ static void finish_send_message(grpc_call_element* elem) {
   grpc_slice_buffer_init(&tmp);
   uint32_t send_flags =
       calld->send_message_batch->payload->send_message.send_message->flags();
-  bool did_compress = grpc_msg_compress(calld->message_compression_algorithm,
-                                        &calld->slices, &tmp);
+  bool did_compress =
+      calld->method != nullptr
+          ? adaptive_compress(
+                static_cast<channel_data*>(elem->channel_data), calld->method,
+                calld->message_compression_algorithm, &calld->slices, &tmp)
+          : grpc_msg_compress(calld->message_compression_algorithm,
+                              &calld->slices, &tmp);
   if (did_compress) {
     if (grpc_compression_trace.enabled()) {
       const char* algo_name;
@@ -347,6 +499,18 @@ static void start_send_message_batch(void* arg, grpc_error* unused) {
   }
 }
 
+static void recv_initial_metadata_ready(void* arg, grpc_error* error) {
+  grpc_call_element* elem = static_cast<grpc_call_element*>(arg);
+  call_data* calld = static_cast<call_data*>(elem->call_data);
+  grpc_linked_mdelem* path = calld->recv_initial_metadata->idx.named.path;
+  if (error == GRPC_ERROR_NONE && path != nullptr) {
+    calld->method = find_method(static_cast<channel_data*>(elem->channel_data),
+                                GRPC_MDVALUE(path->md));
+  }
+  GRPC_CLOSURE_RUN(calld->original_recv_initial_metadata_ready,
+                   GRPC_ERROR_REF(error));
+}
+
 static void compress_start_transport_stream_op_batch(
     grpc_call_element* elem, grpc_transport_stream_op_batch* batch) {
   GPR_TIMER_SCOPE("compress_start_transport_stream_op_batch", 0);
@@ -373,6 +537,18 @@ static void compress_start_transport_stream_op_batch(
         batch, GRPC_ERROR_REF(calld->cancel_error), calld->call_combiner);
     return;
   }
+  // On servers, find out the call's method for adaptive compression from
+  // the client's initial metadata.
+  if (batch->recv_initial_metadata &&
+      static_cast<channel_data*>(elem->channel_data)->adaptive &&
+      calld->method == nullptr) {
+    calld->recv_initial_metadata =
+        batch->payload->recv_initial_metadata.recv_initial_metadata;
+    calld->original_recv_initial_metadata_ready =
+        batch->payload->recv_initial_metadata.recv_initial_metadata_ready;
+    batch->payload->recv_initial_metadata.recv_initial_metadata_ready =
+        &calld->recv_initial_metadata_ready;
+  }
   // Handle send_initial_metadata.
   if (batch->send_initial_metadata) {
     GPR_ASSERT(calld->send_initial_metadata_state == INITIAL_METADATA_UNSEEN);
@@ -425,8 +601,13 @@ static void compress_start_transport_stream_op_batch(
 static grpc_error* init_call_elem(grpc_call_element* elem,
                                   const grpc_call_element_args* args) {
   call_data* calld = static_cast<call_data*>(elem->call_data);
+  channel_data* channeld = static_cast<channel_data*>(elem->channel_data);
   calld->call_combiner = args->call_combiner;
   calld->cancel_error = GRPC_ERROR_NONE;
+  calld->method = nullptr;
+  if (channeld->adaptive && !GRPC_SLICE_IS_EMPTY(args->path)) {
+    calld->method = find_method(channeld, args->path);
+  }
   grpc_slice_buffer_init(&calld->slices);
   GRPC_CLOSURE_INIT(&calld->start_send_message_batch_in_call_combiner,
                     start_send_message_batch, elem, grpc_schedule_on_exec_ctx);
@@ -434,6 +615,9 @@ static grpc_error* init_call_elem(grpc_call_element* elem,
                     on_send_message_next_done, elem, grpc_schedule_on_exec_ctx);
   GRPC_CLOSURE_INIT(&calld->send_message_on_complete, send_message_on_complete,
                     elem, grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_INIT(&calld->recv_initial_metadata_ready,
+                    recv_initial_metadata_ready, elem,
+                    grpc_schedule_on_exec_ctx);
   return GRPC_ERROR_NONE;
 }
 
@@ -446,6 +630,27 @@ static void destroy_call_elem(grpc_call_element* elem,
   GRPC_ERROR_UNREF(calld->cancel_error);
 }
 
+/* Builds the grpc-accept-encoding element for a set of message compression
+   algorithms that includes registered ones */
+static grpc_mdelem accept_encoding_mdelem(uint32_t message_algorithms) {
+  const char* names[32];
+  size_t num_names = 0;
+  for (int i = 0; i < 32; i++) {
+    if (GPR_BITGET(message_algorithms, i) &&
+        grpc_message_compression_algorithm_name(
+            static_cast<grpc_message_compression_algorithm>(i),
+            &names[num_names])) {
+      num_names++;
+    }
+  }
+  char* value = gpr_strjoin_sep(names, num_names, ",", nullptr);
+  grpc_mdelem md = grpc_mdelem_from_slices(
+      GRPC_MDSTR_GRPC_ACCEPT_ENCODING,
+      grpc_slice_intern(grpc_slice_from_static_string(value)));
+  gpr_free(value);
+  return md;
+}
+
 /* Constructor for channel_data */
 static grpc_error* init_channel_elem(grpc_channel_element* elem,
                                      grpc_channel_element_args* args) {
@@ -466,7 +671,7 @@ static grpc_error* init_channel_elem(grpc_channel_element* elem,
   }
 
   uint32_t supported_compression_algorithms =
-      (((1u << GRPC_COMPRESS_ALGORITHMS_COUNT) - 1) &
+      (grpc_compression_all_algorithms_bitset() &
        channeld->enabled_algorithms_bitset) |
       1u;
 
@@ -478,12 +683,43 @@ static grpc_error* init_channel_elem(grpc_channel_element* elem,
       grpc_compression_bitset_to_stream_bitset(
           supported_compression_algorithms);
 
+  channeld->accept_encoding = GRPC_MDNULL;
+  if (channeld->supported_message_compression_algorithms >=
+      (1u << GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT)) {
+    channeld->accept_encoding = accept_encoding_mdelem(
+        channeld->supported_message_compression_algorithms);
+  }
+
+  channeld->adaptive = grpc_channel_arg_get_bool(
+      grpc_channel_args_find(args->channel_args,
+                             GRPC_COMPRESSION_CHANNEL_ADAPTIVE),
+      false);
+  channeld->adaptive_min_savings =
+      grpc_channel_arg_get_integer(
+          grpc_channel_args_find(args->channel_args,
+                                 GRPC_COMPRESSION_CHANNEL_ADAPTIVE_MIN_SAVINGS),
+          {ADAPTIVE_DEFAULT_MIN_SAVINGS_PERCENT, 1, 100}) *
+      1024 / 100;
+  gpr_mu_init(&channeld->methods_mu);
+  gpr_atm_no_barrier_store(&channeld->num_methods, 0);
+
   GPR_ASSERT(!args->is_last);
   return GRPC_ERROR_NONE;
 }
 
 /* Destructor for channel data */
-static void destroy_channel_elem(grpc_channel_element* elem) {}
+static void destroy_channel_elem(grpc_channel_element* elem) {
+  channel_data* channeld = static_cast<channel_data*>(elem->channel_data);
+  GRPC_MDELEM_UNREF(channeld->accept_encoding);
+  size_t num_methods =
+      static_cast<size_t>(gpr_atm_no_barrier_load(&channeld->num_methods));
+  for (size_t i = 0; i < num_methods; i++) {
+    grpc_slice_unref_internal(channeld->methods[i]->path);
+    gpr_mu_destroy(&channeld->methods[i]->mu);
+    gpr_free(channeld->methods[i]);
+  }
+  gpr_mu_destroy(&channeld->methods_mu);
+}
 
 const grpc_channel_filter grpc_message_compress_filter = {
     compress_start_transport_stream_op_batch,
@@ -43,13 +43,13 @@ void grpc_server_add_insecure_channel_from_fd(grpc_server* server,
   char* name;
   gpr_asprintf(&name, "fd:%d", fd);
 
-  grpc_endpoint* server_endpoint =
-      grpc_tcp_create(grpc_fd_create(fd, name, false),
-                      grpc_server_get_channel_args(server), name);
+  const grpc_channel_args* server_args = grpc_server_get_channel_args(server);
+  grpc_endpoint* server_endpoint = grpc_tcp_create(
+      grpc_fd_create(fd, name, grpc_tcp_needs_error_tracking(server_args)),
+      server_args, name);
 
   gpr_free(name);
 
-  const grpc_channel_args* server_args = grpc_server_get_channel_args(server);
   grpc_transport* transport = grpc_create_chttp2_transport(
       server_args, server_endpoint, false /* is_client */);
 
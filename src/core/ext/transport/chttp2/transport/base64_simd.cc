@@ -0,0 +1,401 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/transport/chttp2/transport/base64_simd.h"
+
+#include <string.h>
+
+#include <grpc/support/atm.h>
+#include <grpc/support/log.h>
+
+/* The vector kernels are compiled with per-function target attributes and
+   only called after checking the CPU at runtime, so the rest of the library
+   keeps its baseline instruction set. That needs __builtin_cpu_supports and
+   intrinsics usable from target("...") functions: gcc 4.9 or clang 3.8.
+   Older compilers get the portable code only. */
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__clang__)
+#if defined(__has_builtin) && defined(__has_attribute)
+#if __has_builtin(__builtin_cpu_supports) && __has_attribute(target) && \
+    (__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8))
+#define GRPC_CHTTP2_BASE64_X86_SIMD 1
+#endif
+#endif
+#elif defined(__GNUC__)
+#if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define GRPC_CHTTP2_BASE64_X86_SIMD 1
+#endif
+#endif
+#endif
+
+#ifdef GRPC_CHTTP2_BASE64_X86_SIMD
+#include <immintrin.h>
+#endif
+
+static const uint8_t alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* 0x40 marks characters outside of the alphabet */
+static const uint8_t decode_table[256] = {
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 62,   0x40, 0x40, 0x40, 63,
+    52,   53,   54,   55,   56,   57,   58,   59,   60,   61,   0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0,    1,    2,    3,    4,    5,    6,
+    7,    8,    9,    10,   11,   12,   13,   14,   15,   16,   17,   18,
+    19,   20,   21,   22,   23,   24,   25,   0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,
+    37,   38,   39,   40,   41,   42,   43,   44,   45,   46,   47,   48,
+    49,   50,   51,   0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40};
+
+/*******************************************************************************
+ * Portable kernels: also finish the blocks the vector kernels leave over
+ */
+
+static size_t encode_blocks_scalar(const uint8_t* in, size_t length,
+                                   uint8_t* out) {
+  const uint8_t* const start = in;
+  for (const uint8_t* end = in + length / 3 * 3; in != end; in += 3) {
+    out[0] = alphabet[in[0] >> 2];
+    out[1] = alphabet[((in[0] & 0x3) << 4) | (in[1] >> 4)];
+    out[2] = alphabet[((in[1] & 0xf) << 2) | (in[2] >> 6)];
+    out[3] = alphabet[in[2] & 0x3f];
+    out += 4;
+  }
+  return static_cast<size_t>(in - start);
+}
+
+static size_t decode_blocks_scalar(const uint8_t* in, size_t length,
+                                   uint8_t* out) {
+  const uint8_t* const start = in;
+  for (const uint8_t* end = in + length / 4 * 4; in != end; in += 4) {
+    uint32_t a = decode_table[in[0]];
+    uint32_t b = decode_table[in[1]];
+    uint32_t c = decode_table[in[2]];
+    uint32_t d = decode_table[in[3]];
+    if ((a | b | c | d) & 0x40) break;
+    uint32_t bits = (a << 18) | (b << 12) | (c << 6) | d;
+    out[0] = static_cast<uint8_t>(bits >> 16);
+    out[1] = static_cast<uint8_t>(bits >> 8);
+    out[2] = static_cast<uint8_t>(bits);
+    out += 3;
+  }
+  return static_cast<size_t>(in - start);
+}
+
+#ifdef GRPC_CHTTP2_BASE64_X86_SIMD
+
+/* The vector kernels follow W. Mula and D. Lemire, "Faster Base64 Encoding and
+   Decoding Using AVX2 Instructions" (2018). */
+
+/*******************************************************************************
+ * SSE4.1 kernels: 12 bytes to 16 characters per step
+ */
+
+/* Map 16 sextets to their characters */
+__attribute__((target("sse4.1"))) static inline __m128i sextets_to_chars_sse(
+    __m128i indices) {
+  const __m128i shift_lut = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  /* 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12 */
+  __m128i lut_index = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  lut_index =
+      _mm_or_si128(lut_index, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+  return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, lut_index), indices);
+}
+
+__attribute__((target("sse4.1"))) static size_t encode_blocks_sse4(
+    const uint8_t* in, size_t length, uint8_t* out) {
+  const uint8_t* const start = in;
+  /* each step loads 16 bytes but only consumes 12 of them */
+  for (; length - static_cast<size_t>(in - start) >= 16; in += 12, out += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    /* put the three bytes of each block in a 32 bit lane as [b1 b0 b2 b1] */
+    v = _mm_shuffle_epi8(
+        v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    /* move the four sextets of each lane to the low bits of its bytes */
+    const __m128i t0 = _mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(v, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     sextets_to_chars_sse(_mm_or_si128(t1, t3)));
+  }
+  size_t done = static_cast<size_t>(in - start);
+  return done + encode_blocks_scalar(in, length - done, out);
+}
+
+/* Map 16 characters to their sextets, returning false if any of them is
+   outside of the alphabet */
+__attribute__((target("sse4.1"))) static inline bool chars_to_sextets_sse(
+    __m128i chars, __m128i* sextets) {
+  const __m128i shift_lut =
+      _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  /* bit h of entry l is set if character 16 * h + l is in the alphabet */
+  const __m128i mask_lut = _mm_setr_epi8(
+      static_cast<char>(0xa8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+  const __m128i bitpos_lut =
+      _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+                    static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i hi_nibbles =
+      _mm_and_si128(_mm_srli_epi32(chars, 4), _mm_set1_epi8(0x0f));
+  const __m128i lo_nibbles = _mm_and_si128(chars, _mm_set1_epi8(0x0f));
+  const __m128i valid =
+      _mm_and_si128(_mm_shuffle_epi8(mask_lut, lo_nibbles),
+                    _mm_shuffle_epi8(bitpos_lut, hi_nibbles));
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128())) != 0) {
+    return false;
+  }
+  /* '+' and '/' share a high nibble but not an offset */
+  const __m128i is_slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+  const __m128i shift = _mm_blendv_epi8(
+      _mm_shuffle_epi8(shift_lut, hi_nibbles), _mm_set1_epi8(16), is_slash);
+  *sextets = _mm_add_epi8(chars, shift);
+  return true;
+}
+
+/* Pack the four sextets of each 32 bit lane into its three low bytes, most
+   significant first */
+__attribute__((target("sse4.1"))) static inline __m128i pack_sextets_sse(
+    __m128i sextets) {
+  const __m128i pairs =
+      _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+  return _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+}
+
+__attribute__((target("sse4.1"))) static size_t decode_blocks_sse4(
+    const uint8_t* in, size_t length, uint8_t* out) {
+  const uint8_t* const start = in;
+  for (; length - static_cast<size_t>(in - start) >= 16; in += 16, out += 12) {
+    __m128i sextets;
+    if (!chars_to_sextets_sse(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)),
+            &sextets)) {
+      break;
+    }
+    const __m128i bytes = _mm_shuffle_epi8(
+        pack_sextets_sse(sextets),
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+    uint32_t last = static_cast<uint32_t>(
+        _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+    memcpy(out + 8, &last, sizeof(last));
+  }
+  size_t done = static_cast<size_t>(in - start);
+  return done + decode_blocks_scalar(in, length - done, out);
+}
+
+/*******************************************************************************
+ * AVX2 kernels: 24 bytes to 32 characters per step, with the SSE4.1 kernels
+ * finishing up. Waking up the 256 bit units costs a few hundred nanoseconds,
+ * which only pays for itself on long inputs: anything shorter than
+ * AVX2_MIN_LENGTH goes straight to the SSE4.1 kernels.
+ */
+
+#define AVX2_MIN_LENGTH 2048
+
+__attribute__((target("avx2"))) static size_t encode_blocks_avx2(
+    const uint8_t* in, size_t length, uint8_t* out) {
+  if (length < AVX2_MIN_LENGTH) return encode_blocks_sse4(in, length, out);
+  const uint8_t* const start = in;
+  const __m256i shuffle = _mm256_set_epi8(
+      10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7, 8, 6,
+      7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m256i shift_lut = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  /* each step loads bytes [0, 16) and [12, 28) but only consumes 24 */
+  for (; length - static_cast<size_t>(in - start) >= 28; in += 24, out += 32) {
+    __m256i v = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 12)), 1);
+    v = _mm256_shuffle_epi8(v, shuffle);
+    const __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t1, t3);
+    __m256i lut_index = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    lut_index = _mm256_or_si256(
+        lut_index, _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(out),
+        _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, lut_index), indices));
+  }
+  size_t done = static_cast<size_t>(in - start);
+  return done + encode_blocks_sse4(in, length - done, out);
+}
+
+__attribute__((target("avx2"))) static size_t decode_blocks_avx2(
+    const uint8_t* in, size_t length, uint8_t* out) {
+  if (length < AVX2_MIN_LENGTH) return decode_blocks_sse4(in, length, out);
+  const uint8_t* const start = in;
+  const __m256i shift_lut = _mm256_setr_epi8(
+      0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 4, -65,
+      -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i mask_lut = _mm256_setr_epi8(
+      static_cast<char>(0xa8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54,
+      static_cast<char>(0xa8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54);
+  const __m256i bitpos_lut = _mm256_setr_epi8(
+      0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0,
+      0, 0, 0, 0, 0, 0, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+      static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i pack_shuffle = _mm256_setr_epi8(
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4,
+      10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  for (; length - static_cast<size_t>(in - start) >= 32; in += 32, out += 24) {
+    const __m256i chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    const __m256i hi_nibbles =
+        _mm256_and_si256(_mm256_srli_epi32(chars, 4), _mm256_set1_epi8(0x0f));
+    const __m256i lo_nibbles = _mm256_and_si256(chars, _mm256_set1_epi8(0x0f));
+    const __m256i valid =
+        _mm256_and_si256(_mm256_shuffle_epi8(mask_lut, lo_nibbles),
+                         _mm256_shuffle_epi8(bitpos_lut, hi_nibbles));
+    if (_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(valid, _mm256_setzero_si256())) != 0) {
+      break;
+    }
+    const __m256i shift = _mm256_blendv_epi8(
+        _mm256_shuffle_epi8(shift_lut, hi_nibbles), _mm256_set1_epi8(16),
+        _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/')));
+    const __m256i sextets = _mm256_add_epi8(chars, shift);
+    const __m256i pairs =
+        _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x01400140));
+    const __m256i lanes =
+        _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    /* 12 bytes at the start of each 128 bit half: gather them */
+    const __m256i bytes = _mm256_permutevar8x32_epi32(
+        _mm256_shuffle_epi8(lanes, pack_shuffle),
+        _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm256_castsi256_si128(bytes));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16),
+                     _mm256_extracti128_si256(bytes, 1));
+  }
+  size_t done = static_cast<size_t>(in - start);
+  return done + decode_blocks_sse4(in, length - done, out);
+}
+
+#endif /* GRPC_CHTTP2_BASE64_X86_SIMD */
+
+/*******************************************************************************
+ * Dispatch
+ */
+
+typedef struct {
+  size_t (*encode_blocks)(const uint8_t* in, size_t length, uint8_t* out);
+  size_t (*decode_blocks)(const uint8_t* in, size_t length, uint8_t* out);
+} base64_kernels;
+
+static const base64_kernels kernels[] = {
+    {encode_blocks_scalar, decode_blocks_scalar},
+#ifdef GRPC_CHTTP2_BASE64_X86_SIMD
+    {encode_blocks_sse4, decode_blocks_sse4},
+    {encode_blocks_avx2, decode_blocks_avx2},
+#endif
+};
+
+/* the kernels in use, or 0 until the first call picks them */
+static gpr_atm g_kernels;
+
+bool grpc_chttp2_base64_impl_supported(grpc_chttp2_base64_impl impl) {
+  switch (impl) {
+    case GRPC_CHTTP2_BASE64_SCALAR:
+      return true;
+#ifdef GRPC_CHTTP2_BASE64_X86_SIMD
+    case GRPC_CHTTP2_BASE64_SSE4:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.1");
+    case GRPC_CHTTP2_BASE64_AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#else
+    case GRPC_CHTTP2_BASE64_SSE4:
+    case GRPC_CHTTP2_BASE64_AVX2:
+      return false;
+#endif
+  }
+  return false;
+}
+
+void grpc_chttp2_base64_set_impl(grpc_chttp2_base64_impl impl) {
+  GPR_ASSERT(grpc_chttp2_base64_impl_supported(impl));
+  gpr_atm_rel_store(&g_kernels, reinterpret_cast<gpr_atm>(&kernels[impl]));
+}
+
+static const base64_kernels* get_kernels() {
+  gpr_atm k = gpr_atm_acq_load(&g_kernels);
+  if (GPR_UNLIKELY(k == 0)) {
+    /* racing callers all pick the same kernels */
+    grpc_chttp2_base64_impl impl = GRPC_CHTTP2_BASE64_SCALAR;
+    if (grpc_chttp2_base64_impl_supported(GRPC_CHTTP2_BASE64_AVX2)) {
+      impl = GRPC_CHTTP2_BASE64_AVX2;
+    } else if (grpc_chttp2_base64_impl_supported(GRPC_CHTTP2_BASE64_SSE4)) {
+      impl = GRPC_CHTTP2_BASE64_SSE4;
+    }
+    k = reinterpret_cast<gpr_atm>(&kernels[impl]);
+    gpr_atm_rel_store(&g_kernels, k);
+  }
+  return reinterpret_cast<const base64_kernels*>(k);
+}
+
+size_t grpc_chttp2_base64_encode_blocks(const uint8_t* in, size_t length,
+                                        uint8_t* out) {
+  return get_kernels()->encode_blocks(in, length, out);
+}
+
+size_t grpc_chttp2_base64_decode_blocks(const uint8_t* in, size_t length,
+                                        uint8_t* out) {
+  return get_kernels()->decode_blocks(in, length, out);
+}
@@ -0,0 +1,61 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_BASE64_SIMD_H
+#define GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_BASE64_SIMD_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Bulk base64 kernels for -bin metadata, shared by bin_encoder.cc,
+   bin_decoder.cc and the HPACK parser. They only handle whole blocks (three
+   bytes to four characters); padding, tails and errors are left to the
+   callers' scalar code.
+
+   The implementation is picked the first time a kernel runs, from the
+   features of the CPU: AVX2, then SSE4.1, then portable code. */
+
+typedef enum {
+  GRPC_CHTTP2_BASE64_SCALAR,
+  GRPC_CHTTP2_BASE64_SSE4,
+  GRPC_CHTTP2_BASE64_AVX2,
+} grpc_chttp2_base64_impl;
+
+/* Returns whether \a impl can run on this machine */
+bool grpc_chttp2_base64_impl_supported(grpc_chttp2_base64_impl impl);
+
+/* Force the kernels to use \a impl, which must be supported: for tests and
+   benchmarks */
+void grpc_chttp2_base64_set_impl(grpc_chttp2_base64_impl impl);
+
+/* Encode the leading length / 3 * 3 bytes of \a in into length / 3 * 4
+   characters at \a out. Returns the number of bytes of \a in consumed. */
+size_t grpc_chttp2_base64_encode_blocks(const uint8_t* in, size_t length,
+                                        uint8_t* out);
+
+/* Decode the longest prefix of \a in made of whole four character blocks
+   from the base64 alphabet (no padding) into three bytes per block at
+   \a out. Returns the number of characters of \a in consumed; decoding stops
+   before the first block holding any other character. */
+size_t grpc_chttp2_base64_decode_blocks(const uint8_t* in, size_t length,
+                                        uint8_t* out);
+
+#endif /* GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_BASE64_SIMD_H */
@@ -20,8 +20,10 @@
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include "src/core/ext/transport/chttp2/transport/base64_simd.h"
 #include "src/core/ext/transport/chttp2/transport/bin_decoder.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 
@@ -110,6 +112,18 @@ bool grpc_base64_decode_partial(struct grpc_base64_decode_context* ctx) {
     return false;
   }
 
+  // Process as many blocks as possible with the bulk kernels; they stop at
+  // the first block holding padding or an invalid character, which is left to
+  // the loop below
+  size_t blocks =
+      GPR_MIN(static_cast<size_t>(ctx->input_end - ctx->input_cur) / 4,
+              static_cast<size_t>(ctx->output_end - ctx->output_cur) / 3);
+  size_t consumed =
+      grpc_chttp2_base64_decode_blocks(ctx->input_cur, blocks * 4,
+                                       ctx->output_cur);
+  ctx->input_cur += consumed;
+  ctx->output_cur += consumed / 4 * 3;
+
   // Process a block of 4 input characters and 3 output bytes
   while (ctx->input_end >= ctx->input_cur + 4 &&
          ctx->output_end >= ctx->output_cur + 3) {
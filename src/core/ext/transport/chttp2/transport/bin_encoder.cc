@@ -23,29 +23,13 @@
 #include <string.h>
 
 #include <grpc/support/log.h>
+#include "src/core/ext/transport/chttp2/transport/base64_simd.h"
 #include "src/core/ext/transport/chttp2/transport/huffsyms.h"
+#include "src/core/lib/gpr/useful.h"
 
 static const char alphabet[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-typedef struct {
-  uint16_t bits;
-  uint8_t length;
-} b64_huff_sym;
-
-static const b64_huff_sym huff_alphabet[64] = {
-    {0x21, 6}, {0x5d, 7}, {0x5e, 7},   {0x5f, 7}, {0x60, 7}, {0x61, 7},
-    {0x62, 7}, {0x63, 7}, {0x64, 7},   {0x65, 7}, {0x66, 7}, {0x67, 7},
-    {0x68, 7}, {0x69, 7}, {0x6a, 7},   {0x6b, 7}, {0x6c, 7}, {0x6d, 7},
-    {0x6e, 7}, {0x6f, 7}, {0x70, 7},   {0x71, 7}, {0x72, 7}, {0xfc, 8},
-    {0x73, 7}, {0xfd, 8}, {0x3, 5},    {0x23, 6}, {0x4, 5},  {0x24, 6},
-    {0x5, 5},  {0x25, 6}, {0x26, 6},   {0x27, 6}, {0x6, 5},  {0x74, 7},
-    {0x75, 7}, {0x28, 6}, {0x29, 6},   {0x2a, 6}, {0x7, 5},  {0x2b, 6},
-    {0x76, 7}, {0x2c, 6}, {0x8, 5},    {0x9, 5},  {0x2d, 6}, {0x77, 7},
-    {0x78, 7}, {0x79, 7}, {0x7a, 7},   {0x7b, 7}, {0x0, 5},  {0x1, 5},
-    {0x2, 5},  {0x19, 6}, {0x1a, 6},   {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
-    {0x1e, 6}, {0x1f, 6}, {0x7fb, 11}, {0x18, 6}};
-
 static const uint8_t tail_xtra[3] = {0, 2, 3};
 
 grpc_slice grpc_chttp2_base64_encode(grpc_slice input) {
@@ -56,17 +40,11 @@ grpc_slice grpc_chttp2_base64_encode(grpc_slice input) {
   grpc_slice output = GRPC_SLICE_MALLOC(output_length);
   uint8_t* in = GRPC_SLICE_START_PTR(input);
   char* out = reinterpret_cast<char*> GRPC_SLICE_START_PTR(output);
-  size_t i;
 
   /* encode full triplets */
-  for (i = 0; i < input_triplets; i++) {
-    out[0] = alphabet[in[0] >> 2];
-    out[1] = alphabet[((in[0] & 0x3) << 4) | (in[1] >> 4)];
-    out[2] = alphabet[((in[1] & 0xf) << 2) | (in[2] >> 6)];
-    out[3] = alphabet[in[2] & 0x3f];
-    out += 4;
-    in += 3;
-  }
+  in += grpc_chttp2_base64_encode_blocks(in, input_length,
+                                         reinterpret_cast<uint8_t*>(out));
+  out += input_triplets * 4;
 
   /* encode the remaining bytes */
   switch (tail_case) {
@@ -137,34 +115,41 @@ grpc_slice grpc_chttp2_huffman_compress(grpc_slice input) {
 }
 
 typedef struct {
-  uint32_t temp;
+  uint64_t temp;
   uint32_t temp_length;
   uint8_t* out;
 } huff_out;
 
-static void enc_flush_some(huff_out* out) {
-  while (out->temp_length > 8) {
-    out->temp_length -= 8;
-    *out->out++ = static_cast<uint8_t>(out->temp >> out->temp_length);
+/* huffman compress n characters, writing out 32 bits at a time: no base64
+   character has a code longer than 11 bits, so the 64 bit accumulator never
+   overflows */
+static void enc_add_chars(huff_out* out, const uint8_t* chars, size_t n) {
+  uint64_t temp = out->temp;
+  uint32_t temp_length = out->temp_length;
+  uint8_t* p = out->out;
+  for (size_t i = 0; i < n; i++) {
+    const grpc_chttp2_huffsym* sym = &grpc_chttp2_huffsyms[chars[i]];
+    temp = (temp << sym->length) | sym->bits;
+    temp_length += sym->length;
+    if (temp_length >= 32) {
+      temp_length -= 32;
+      const uint32_t word = static_cast<uint32_t>(temp >> temp_length);
+      p[0] = static_cast<uint8_t>(word >> 24);
+      p[1] = static_cast<uint8_t>(word >> 16);
+      p[2] = static_cast<uint8_t>(word >> 8);
+      p[3] = static_cast<uint8_t>(word);
+      p += 4;
+    }
   }
+  out->temp = temp;
+  out->temp_length = temp_length;
+  out->out = p;
 }
 
-static void enc_add2(huff_out* out, uint8_t a, uint8_t b) {
-  b64_huff_sym sa = huff_alphabet[a];
-  b64_huff_sym sb = huff_alphabet[b];
-  out->temp = (out->temp << (sa.length + sb.length)) |
-              (static_cast<uint32_t>(sa.bits) << sb.length) | sb.bits;
-  out->temp_length +=
-      static_cast<uint32_t>(sa.length) + static_cast<uint32_t>(sb.length);
-  enc_flush_some(out);
-}
-
-static void enc_add1(huff_out* out, uint8_t a) {
-  b64_huff_sym sa = huff_alphabet[a];
-  out->temp = (out->temp << sa.length) | sa.bits;
-  out->temp_length += sa.length;
-  enc_flush_some(out);
-}
+/* number of input bytes base64 encoded into a buffer on the stack at a time
+   before being huffman compressed: a multiple of the block size of the
+   base64 kernels, small enough for the buffer to stay in the L1 cache */
+#define HUFF_CHUNK_BYTES 384
 
 grpc_slice grpc_chttp2_base64_encode_and_huffman_compress(grpc_slice input) {
   size_t input_length = GRPC_SLICE_LENGTH(input);
@@ -175,24 +160,20 @@ grpc_slice grpc_chttp2_base64_encode_and_huffman_compress(grpc_slice input) {
   size_t max_output_length = max_output_bits / 8 + (max_output_bits % 8 != 0);
   grpc_slice output = GRPC_SLICE_MALLOC(max_output_length);
   uint8_t* in = GRPC_SLICE_START_PTR(input);
+  uint8_t* end = in + input_triplets * 3;
   uint8_t* start_out = GRPC_SLICE_START_PTR(output);
+  uint8_t chars[HUFF_CHUNK_BYTES / 3 * 4];
   huff_out out;
-  size_t i;
 
   out.temp = 0;
   out.temp_length = 0;
   out.out = start_out;
 
   /* encode full triplets */
-  for (i = 0; i < input_triplets; i++) {
-    const uint8_t low_to_high = static_cast<uint8_t>((in[0] & 0x3) << 4);
-    const uint8_t high_to_low = in[1] >> 4;
-    enc_add2(&out, in[0] >> 2, low_to_high | high_to_low);
-
-    const uint8_t a = static_cast<uint8_t>((in[1] & 0xf) << 2);
-    const uint8_t b = (in[2] >> 6);
-    enc_add2(&out, a | b, in[2] & 0x3f);
-    in += 3;
+  while (in != end) {
+    size_t chunk = GPR_MIN(static_cast<size_t>(end - in), HUFF_CHUNK_BYTES);
+    in += grpc_chttp2_base64_encode_blocks(in, chunk, chars);
+    enc_add_chars(&out, chars, chunk / 3 * 4);
   }
 
   /* encode the remaining bytes */
@@ -200,19 +181,24 @@ grpc_slice grpc_chttp2_base64_encode_and_huffman_compress(grpc_slice input) {
     case 0:
       break;
     case 1:
-      enc_add2(&out, in[0] >> 2, static_cast<uint8_t>((in[0] & 0x3) << 4));
+      chars[0] = alphabet[in[0] >> 2];
+      chars[1] = alphabet[(in[0] & 0x3) << 4];
+      enc_add_chars(&out, chars, 2);
       in += 1;
       break;
-    case 2: {
-      const uint8_t low_to_high = static_cast<uint8_t>((in[0] & 0x3) << 4);
-      const uint8_t high_to_low = in[1] >> 4;
-      enc_add2(&out, in[0] >> 2, low_to_high | high_to_low);
-      enc_add1(&out, static_cast<uint8_t>((in[1] & 0xf) << 2));
+    case 2:
+      chars[0] = alphabet[in[0] >> 2];
+      chars[1] = alphabet[((in[0] & 0x3) << 4) | (in[1] >> 4)];
+      chars[2] = alphabet[(in[1] & 0xf) << 2];
+      enc_add_chars(&out, chars, 3);
       in += 2;
       break;
-    }
   }
 
+  while (out.temp_length > 8) {
+    out.temp_length -= 8;
+    *out.out++ = static_cast<uint8_t>(out.temp >> out.temp_length);
+  }
   if (out.temp_length) {
     /* NB: the following integer arithmetic operation needs to be in its
      * expanded form due to the "integral promotion" performed (see section
@@ -58,6 +58,10 @@
 #define MAX_WINDOW 0x7fffffffu
 #define MAX_WRITE_BUFFER_SIZE (64 * 1024 * 1024)
 #define DEFAULT_MAX_HEADER_LIST_SIZE (8 * 1024)
+#define DEFAULT_WRITE_QUANTUM 16384
+#define MAX_WRITE_COALESCING_DELAY_US 1000
+/* a held back write waits for about this many more streams' frames */
+#define WRITE_COALESCING_FRAMES 4
 
 #define DEFAULT_CLIENT_KEEPALIVE_TIME_MS INT_MAX
 #define DEFAULT_CLIENT_KEEPALIVE_TIMEOUT_MS 20000 /* 20 seconds */
@@ -191,6 +195,7 @@ static void destruct_transport(grpc_chttp2_transport* t) {
   }
 
   t->flow_control.Destroy();
+  t->write_scheduler.Destroy();
 
   GRPC_ERROR_UNREF(t->closed_with_error);
   gpr_free(t->ping_acks);
@@ -359,6 +364,8 @@ static void init_transport(grpc_chttp2_transport* t,
   t->opt_target = GRPC_CHTTP2_OPTIMIZE_FOR_LATENCY;
 
   bool enable_bdp = true;
+  bool use_drr_write_scheduler = false;
+  int write_quantum = DEFAULT_WRITE_QUANTUM;
 
   if (channel_args) {
     for (i = 0; i < channel_args->num_args; i++) {
@@ -419,6 +426,32 @@ static void init_transport(grpc_chttp2_transport* t,
         t->write_buffer_size =
             static_cast<uint32_t>(grpc_channel_arg_get_integer(
                 &channel_args->args[i], {0, 0, MAX_WRITE_BUFFER_SIZE}));
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_HTTP2_WRITE_SCHEDULER)) {
+        if (channel_args->args[i].type != GRPC_ARG_STRING) {
+          gpr_log(GPR_ERROR, "%s should be a string",
+                  GRPC_ARG_HTTP2_WRITE_SCHEDULER);
+        } else if (0 == strcmp(channel_args->args[i].value.string, "fifo")) {
+          use_drr_write_scheduler = false;
+        } else if (0 == strcmp(channel_args->args[i].value.string, "drr")) {
+          use_drr_write_scheduler = true;
+        } else {
+          gpr_log(GPR_ERROR, "%s value '%s' unknown, assuming 'fifo'",
+                  GRPC_ARG_HTTP2_WRITE_SCHEDULER,
+                  channel_args->args[i].value.string);
+        }
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_HTTP2_WRITE_QUANTUM)) {
+        write_quantum = grpc_channel_arg_get_integer(
+            &channel_args->args[i], {DEFAULT_WRITE_QUANTUM, 1, INT_MAX});
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_HTTP2_HONOR_STREAM_PRIORITY)) {
+        t->honor_stream_priority =
+            grpc_channel_arg_get_bool(&channel_args->args[i], false);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_HTTP2_WRITE_COALESCING_MAX_DELAY_US)) {
+        t->write_coalescing_max_delay_us = grpc_channel_arg_get_integer(
+            &channel_args->args[i], {0, 0, MAX_WRITE_COALESCING_DELAY_US});
       } else if (0 ==
                  strcmp(channel_args->args[i].key, GRPC_ARG_HTTP2_BDP_PROBE)) {
         enable_bdp = grpc_channel_arg_get_bool(&channel_args->args[i], true);
@@ -523,6 +556,19 @@ static void init_transport(grpc_chttp2_transport* t,
     enable_bdp = false;
   }
 
+  if (use_drr_write_scheduler) {
+    t->write_scheduler
+        .Init<grpc_core::chttp2::DeficitRoundRobinWriteScheduler>(
+            static_cast<uint32_t>(write_quantum));
+  } else {
+    t->write_scheduler.Init<grpc_core::chttp2::FifoWriteScheduler>();
+  }
+  /* until writes are observed, assume they start too rarely to be worth
+     coalescing */
+  t->idle_write_interval_us =
+      WRITE_COALESCING_FRAMES * t->write_coalescing_max_delay_us;
+  t->write_coalescing_yield = 1;
+
   /* No pings allowed before receiving a header or data frame. */
   t->ping_state.pings_before_data_required = 0;
   t->ping_state.is_delayed_ping_timer_set = false;
@@ -582,6 +628,9 @@ static void close_transport_locked(grpc_chttp2_transport* t,
       error = grpc_error_set_int(error, GRPC_ERROR_INT_GRPC_STATUS,
                                  GRPC_STATUS_UNAVAILABLE);
     }
+    if (t->write_coalescing_held) {
+      grpc_timer_cancel(&t->write_coalescing_timer);
+    }
     if (t->write_state != GRPC_CHTTP2_WRITE_STATE_IDLE) {
       if (t->close_transport_on_writes_finished == nullptr) {
         t->close_transport_on_writes_finished =
@@ -665,6 +714,8 @@ static int init_stream(grpc_transport* gt, grpc_stream* gs,
   grpc_chttp2_incoming_metadata_buffer_init(&s->metadata_buffer[1], arena);
   grpc_chttp2_data_parser_init(&s->data_parser);
   grpc_slice_buffer_init(&s->flow_controlled_buffer);
+  s->write_state.weight = grpc_core::chttp2::kDefaultStreamWeight;
+  s->write_state.deficit = 0;
   s->deadline = GRPC_MILLIS_INF_FUTURE;
   GRPC_CLOSURE_INIT(&s->complete_fetch_locked, complete_fetch_locked, s,
                     grpc_schedule_on_exec_ctx);
@@ -892,16 +943,85 @@ static void inc_initiate_write_reason(
   }
 }
 
+static int64_t now_micros() {
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  return static_cast<int64_t>(now.tv_sec) * GPR_US_PER_SEC +
+         now.tv_nsec / GPR_NS_PER_US;
+}
+
+/* Returns for how many microseconds a write requested from idle for \a reason
+   should be held back so that frames other streams queue shortly after can
+   share its syscall, or 0 if it should start right away.
+   Only writes requested for stream data are held back (control frames go out
+   as soon as possible), only while other streams are open, and only once the
+   round trip time is known: writes that start from idle more often than
+   every quarter round trip must come from several streams at once, since a
+   stream waiting for replies starts one per round trip. The delay is then
+   sized to gather a few more streams at the rate writes have been starting,
+   and kept below a quarter round trip so that it stays small next to the
+   network.
+   Whether other streams really queue frames while a write is held back also
+   depends on how many threads feed the transport, so writes stop being held
+   back once that mostly fails to gather anything, and are tried again only
+   once in a while. */
+static int64_t write_coalescing_delay(
+    grpc_chttp2_transport* t, grpc_chttp2_initiate_write_reason reason) {
+  if (t->write_coalescing_max_delay_us == 0) return 0;
+  switch (reason) {
+    case GRPC_CHTTP2_INITIATE_WRITE_START_NEW_STREAM:
+    case GRPC_CHTTP2_INITIATE_WRITE_SEND_MESSAGE:
+    case GRPC_CHTTP2_INITIATE_WRITE_SEND_INITIAL_METADATA:
+    case GRPC_CHTTP2_INITIATE_WRITE_SEND_TRAILING_METADATA:
+      break;
+    default:
+      return 0;
+  }
+  const int64_t now = now_micros();
+  /* gaps longer than this all mean 'nothing to coalesce': clamping them lets
+     the average recover within a few writes after an idle period */
+  const int64_t max_interval =
+      WRITE_COALESCING_FRAMES * t->write_coalescing_max_delay_us;
+  const int64_t interval =
+      GPR_CLAMP(now - t->last_idle_write_us, 0, max_interval);
+  t->last_idle_write_us = now;
+  t->idle_write_interval_us =
+      0.875 * t->idle_write_interval_us + 0.125 * interval;
+  grpc_core::BdpEstimator* bdp_est = t->flow_control->bdp_estimator();
+  if (bdp_est == nullptr || bdp_est->EstimateRtt() == 0 ||
+      grpc_chttp2_stream_map_size(&t->stream_map) < 2) {
+    return 0;
+  }
+  const double max_delay = GPR_MIN(t->write_coalescing_max_delay_us,
+                                   bdp_est->EstimateRtt() * GPR_US_PER_SEC / 4);
+  if (t->idle_write_interval_us >= max_delay) return 0;
+  if (t->write_coalescing_yield < 0.5) {
+    t->write_coalescing_yield += (1 - t->write_coalescing_yield) / 256;
+    return 0;
+  }
+  return static_cast<int64_t>(GPR_MIN(
+      max_delay, WRITE_COALESCING_FRAMES * t->idle_write_interval_us));
+}
+
 void grpc_chttp2_initiate_write(grpc_chttp2_transport* t,
                                 grpc_chttp2_initiate_write_reason reason) {
   GPR_TIMER_SCOPE("grpc_chttp2_initiate_write", 0);
 
+  if (t->write_coalescing_held &&
+      ++t->write_requests_while_held == WRITE_COALESCING_FRAMES) {
+    /* the held back write has gathered enough: start it now */
+    grpc_timer_cancel(&t->write_coalescing_timer);
+  }
   switch (t->write_state) {
-    case GRPC_CHTTP2_WRITE_STATE_IDLE:
+    case GRPC_CHTTP2_WRITE_STATE_IDLE: {
+      const int64_t delay = write_coalescing_delay(t, reason);
       inc_initiate_write_reason(reason);
       set_write_state(t, GRPC_CHTTP2_WRITE_STATE_WRITING,
                       grpc_chttp2_initiate_write_reason_string(reason));
       t->is_first_write_in_batch = true;
+      if (delay > 0) {
+        GRPC_STATS_INC_HTTP2_WRITES_COALESCED();
+        t->write_coalescing_delay_us = delay;
+      }
       GRPC_CHTTP2_REF_TRANSPORT(t, "writing");
       GRPC_CLOSURE_SCHED(
           GRPC_CLOSURE_INIT(&t->write_action_begin_locked,
@@ -909,6 +1029,7 @@ void grpc_chttp2_initiate_write(grpc_chttp2_transport* t,
                             grpc_combiner_finally_scheduler(t->combiner)),
           GRPC_ERROR_NONE);
       break;
+    }
     case GRPC_CHTTP2_WRITE_STATE_WRITING:
       set_write_state(t, GRPC_CHTTP2_WRITE_STATE_WRITING_WITH_MORE,
                       grpc_chttp2_initiate_write_reason_string(reason));
@@ -972,6 +1093,30 @@ static void write_action_begin_locked(void* gt, grpc_error* error_ignored) {
   GPR_TIMER_SCOPE("write_action_begin_locked", 0);
   grpc_chttp2_transport* t = static_cast<grpc_chttp2_transport*>(gt);
   GPR_ASSERT(t->write_state != GRPC_CHTTP2_WRITE_STATE_IDLE);
+  if (t->write_coalescing_delay_us != 0) {
+    const int64_t delay = t->write_coalescing_delay_us;
+    t->write_coalescing_delay_us = 0;
+    if (t->closed_with_error == GRPC_ERROR_NONE) {
+      /* hold the write back, releasing the combiner so that operations on
+         other streams can add their frames to it. Timers only have
+         millisecond resolution: under the load that makes holding worthwhile,
+         grpc_chttp2_initiate_write cancels the timer as soon as enough
+         frames have been gathered, well before it fires */
+      t->write_coalescing_held = true;
+      t->write_requests_while_held = 0;
+      grpc_timer_init(&t->write_coalescing_timer,
+                      grpc_core::ExecCtx::Get()->Now() +
+                          GPR_MAX(1, (delay + GPR_US_PER_MS - 1) /
+                                         GPR_US_PER_MS),
+                      &t->write_action_begin_locked);
+      return;
+    }
+  }
+  if (t->write_coalescing_held) {
+    t->write_coalescing_held = false;
+    t->write_coalescing_yield = 0.75 * t->write_coalescing_yield +
+                                0.25 * (t->write_requests_while_held > 0);
+  }
   grpc_chttp2_begin_write_result r;
   if (t->closed_with_error != GRPC_ERROR_NONE) {
     r.writing = false;
@@ -1312,10 +1457,10 @@ static void do_nothing(void* arg, grpc_error* error) {}
 
 static void log_metadata(const grpc_metadata_batch* md_batch, uint32_t id,
                          bool is_client, bool is_initial) {
-  for (grpc_linked_mdelem* md = md_batch->list.head; md != nullptr;
-       md = md->next) {
-    char* key = grpc_slice_to_c_string(GRPC_MDKEY(md->md));
-    char* value = grpc_slice_to_c_string(GRPC_MDVALUE(md->md));
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(md_batch);
+  for (size_t i = 0; i < md_batch->list.count; i++) {
+    char* key = grpc_slice_to_c_string(GRPC_MDKEY(elems[i]->md));
+    char* value = grpc_slice_to_c_string(GRPC_MDVALUE(elems[i]->md));
     gpr_log(GPR_INFO, "HTTP:%d:%s:%s: %s: %s", id, is_initial ? "HDR" : "TRL",
             is_client ? "CLI" : "SVR", key, value);
     gpr_free(key);
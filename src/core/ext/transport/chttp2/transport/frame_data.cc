@@ -97,6 +97,19 @@ void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
   stats->data_bytes += write_bytes;
 }
 
+/* grpc_slice_sub_no_ref(), passing the caller's reference to slice on to the
+   result. Unlike grpc_slice_sub() this never copies, however short the
+   result: payloads keep referencing the endpoint's read slices. */
+static grpc_slice take_sub_slice(grpc_slice slice, size_t begin, size_t end) {
+  grpc_slice sub = grpc_slice_sub_no_ref(slice, begin, end);
+  if (slice.refcount != nullptr &&
+      slice.refcount->sub_refcount != slice.refcount) {
+    grpc_slice_ref_internal(sub);
+    grpc_slice_unref_internal(slice);
+  }
+  return sub;
+}
+
 grpc_error* grpc_deframe_unprocessed_incoming_frames(
     grpc_chttp2_data_parser* p, grpc_chttp2_stream* s,
     grpc_slice_buffer* slices, grpc_slice* slice_out,
@@ -209,10 +222,11 @@ grpc_error* grpc_deframe_unprocessed_incoming_frames(
 
         if (cur != end) {
           grpc_slice_buffer_undo_take_first(
-              slices, grpc_slice_sub(slice, static_cast<size_t>(cur - beg),
+              slices, take_sub_slice(slice, static_cast<size_t>(cur - beg),
                                      static_cast<size_t>(end - beg)));
+        } else {
+          grpc_slice_unref_internal(slice);
         }
-        grpc_slice_unref_internal(slice);
         return GRPC_ERROR_NONE;
       case GRPC_CHTTP2_DATA_FRAME: {
         GPR_ASSERT(p->parsing_frame != nullptr);
@@ -226,42 +240,38 @@ grpc_error* grpc_deframe_unprocessed_incoming_frames(
           s->stats.incoming.data_bytes += remaining;
           if (GRPC_ERROR_NONE !=
               (error = p->parsing_frame->Push(
-                   grpc_slice_sub(slice, static_cast<size_t>(cur - beg),
+                   take_sub_slice(slice, static_cast<size_t>(cur - beg),
                                   static_cast<size_t>(end - beg)),
                    slice_out))) {
-            grpc_slice_unref_internal(slice);
             return error;
           }
           if (GRPC_ERROR_NONE !=
               (error = p->parsing_frame->Finished(GRPC_ERROR_NONE, true))) {
-            grpc_slice_unref_internal(slice);
             return error;
           }
           p->parsing_frame = nullptr;
           p->state = GRPC_CHTTP2_DATA_FH_0;
-          grpc_slice_unref_internal(slice);
           return GRPC_ERROR_NONE;
         } else if (remaining < p->frame_size) {
           s->stats.incoming.data_bytes += remaining;
           if (GRPC_ERROR_NONE !=
               (error = p->parsing_frame->Push(
-                   grpc_slice_sub(slice, static_cast<size_t>(cur - beg),
+                   take_sub_slice(slice, static_cast<size_t>(cur - beg),
                                   static_cast<size_t>(end - beg)),
                    slice_out))) {
             return error;
           }
           p->frame_size -= remaining;
-          grpc_slice_unref_internal(slice);
           return GRPC_ERROR_NONE;
         } else {
           GPR_ASSERT(remaining > p->frame_size);
           s->stats.incoming.data_bytes += p->frame_size;
           if (GRPC_ERROR_NONE !=
-              p->parsing_frame->Push(
-                  grpc_slice_sub(
-                      slice, static_cast<size_t>(cur - beg),
-                      static_cast<size_t>(cur + p->frame_size - beg)),
-                  slice_out)) {
+              (error = p->parsing_frame->Push(
+                   grpc_slice_ref_internal(grpc_slice_sub_no_ref(
+                       slice, static_cast<size_t>(cur - beg),
+                       static_cast<size_t>(cur + p->frame_size - beg))),
+                   slice_out))) {
             grpc_slice_unref_internal(slice);
             return error;
           }
@@ -274,9 +284,8 @@ grpc_error* grpc_deframe_unprocessed_incoming_frames(
           p->state = GRPC_CHTTP2_DATA_FH_0;
           cur += p->frame_size;
           grpc_slice_buffer_undo_take_first(
-              slices, grpc_slice_sub(slice, static_cast<size_t>(cur - beg),
+              slices, take_sub_slice(slice, static_cast<size_t>(cur - beg),
                                      static_cast<size_t>(end - beg)));
-          grpc_slice_unref_internal(slice);
           return GRPC_ERROR_NONE;
         }
       }
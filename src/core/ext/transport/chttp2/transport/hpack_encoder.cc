@@ -78,6 +78,9 @@ typedef struct {
   /* maximum size of a frame */
   size_t max_frame_size;
   bool use_true_binary_metadata;
+  /* if non-null, the block being encoded may be cached: the indexed fields
+     emitted so far are recorded here. Emitting anything else resets it. */
+  grpc_chttp2_hpack_cached_block* recording;
 } framer_state;
 
 /* fills p (which is expected to be 9 bytes long) with a data frame header */
@@ -194,6 +197,7 @@ static uint32_t prepare_space_for_new_elem(grpc_chttp2_hpack_compressor* c,
     while (c->table_size > 0) {
       evict_entry(c);
     }
+    c->table_epoch++;
     return 0;
   }
 
@@ -208,6 +212,7 @@ static uint32_t prepare_space_for_new_elem(grpc_chttp2_hpack_compressor* c,
       static_cast<uint16_t>(elem_size);
   c->table_size = static_cast<uint16_t>(c->table_size + elem_size);
   c->table_elems++;
+  c->table_epoch++;
 
   return new_index;
 }
@@ -313,12 +318,36 @@ static void add_key(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
   add_key_with_index(c, elem, new_index);
 }
 
+/* note that elem is about to be emitted as an indexed field, in the block
+   being recorded */
+static void record_indexed_elem(framer_state* st, grpc_mdelem elem,
+                                uint32_t filter_index) {
+  grpc_chttp2_hpack_cached_block* b = st->recording;
+  if (b == nullptr) return;
+  if (b->num_elems == GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_ELEMS) {
+    st->recording = nullptr;
+    return;
+  }
+  b->elems[b->num_elems] = elem;
+  b->filter_indices[b->num_elems] = static_cast<uint8_t>(filter_index);
+  b->num_elems++;
+}
+
 static void emit_indexed(grpc_chttp2_hpack_compressor* c, uint32_t elem_index,
                          framer_state* st) {
   GRPC_STATS_INC_HPACK_SEND_INDEXED();
   uint32_t len = GRPC_CHTTP2_VARINT_LENGTH(elem_index, 1);
-  GRPC_CHTTP2_WRITE_VARINT(elem_index, 1, 0x80, add_tiny_header_data(st, len),
-                           len);
+  uint8_t* p = add_tiny_header_data(st, len);
+  GRPC_CHTTP2_WRITE_VARINT(elem_index, 1, 0x80, p, len);
+  grpc_chttp2_hpack_cached_block* b = st->recording;
+  if (b != nullptr) {
+    if (b->length + len > GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_BYTES) {
+      st->recording = nullptr;
+    } else {
+      memcpy(b->bytes + b->length, p, len);
+      b->length = static_cast<uint8_t>(b->length + len);
+    }
+  }
 }
 
 typedef struct {
@@ -488,6 +517,7 @@ static void hpack_enc(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
 
   // Key is not interned, emit literals.
   if (!key_interned) {
+    st->recording = nullptr;
     emit_lithdr_noidx_v(c, 0, elem, st);
     return;
   }
@@ -507,6 +537,7 @@ static void hpack_enc(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
     if (grpc_mdelem_eq(c->entries_elems[HASH_FRAGMENT_2(elem_hash)], elem) &&
         c->indices_elems[HASH_FRAGMENT_2(elem_hash)] > c->tail_remote_index) {
       /* HIT: complete element (first cuckoo hash) */
+      record_indexed_elem(st, elem, HASH_FRAGMENT_1(elem_hash));
       emit_indexed(c, dynidx(c, c->indices_elems[HASH_FRAGMENT_2(elem_hash)]),
                    st);
       return;
@@ -515,12 +546,16 @@ static void hpack_enc(grpc_chttp2_hpack_compressor* c, grpc_mdelem elem,
     if (grpc_mdelem_eq(c->entries_elems[HASH_FRAGMENT_3(elem_hash)], elem) &&
         c->indices_elems[HASH_FRAGMENT_3(elem_hash)] > c->tail_remote_index) {
       /* HIT: complete element (second cuckoo hash) */
+      record_indexed_elem(st, elem, HASH_FRAGMENT_1(elem_hash));
       emit_indexed(c, dynidx(c, c->indices_elems[HASH_FRAGMENT_3(elem_hash)]),
                    st);
       return;
     }
   }
 
+  /* a literal depends on more than the decoder's table: don't cache */
+  st->recording = nullptr;
+
   uint32_t indices_key;
 
   /* should this elem be in the table? */
@@ -608,6 +643,12 @@ void grpc_chttp2_hpack_compressor_destroy(grpc_chttp2_hpack_compressor* c) {
     }
     GRPC_MDELEM_UNREF(c->entries_elems[i]);
   }
+  for (i = 0; i < GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS; i++) {
+    grpc_chttp2_hpack_cached_block* b = &c->cached_blocks[i];
+    for (size_t j = 0; j < b->num_elems; j++) {
+      GRPC_MDELEM_UNREF(b->elems[j]);
+    }
+  }
   gpr_free(c->table_elem_size);
 }
 
@@ -646,6 +687,7 @@ void grpc_chttp2_hpack_compressor_set_max_table_size(
   while (c->table_size > 0 && c->table_size > max_table_size) {
     evict_entry(c);
   }
+  c->table_epoch++;
   c->max_table_size = max_table_size;
   c->max_table_elems = elems_for_bytes(max_table_size);
   if (c->max_table_elems > c->cap_table_elems) {
@@ -662,6 +704,76 @@ void grpc_chttp2_hpack_compressor_set_max_table_size(
   }
 }
 
+/* Gather the elements of a header block into elems, if the block could be
+   cached: all interned (so that they outlive the block, and can be compared
+   by identity), and few enough. Returns the number of elements, 0 if not. */
+static size_t gather_cacheable_elems(grpc_mdelem** extra_headers,
+                                     size_t extra_headers_size,
+                                     grpc_metadata_batch* metadata,
+                                     grpc_mdelem* elems) {
+  if (extra_headers_size + metadata->list.count >
+      GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_ELEMS) {
+    return 0;
+  }
+  size_t n = 0;
+  for (size_t i = 0; i < extra_headers_size; ++i) {
+    elems[n++] = *extra_headers[i];
+  }
+  grpc_linked_mdelem* const* batch_elems = grpc_metadata_batch_elems(metadata);
+  for (size_t i = 0; i < metadata->list.count; ++i) {
+    elems[n++] = batch_elems[i]->md;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (!GRPC_MDELEM_IS_INTERNED(elems[i])) return 0;
+  }
+  return n;
+}
+
+static grpc_chttp2_hpack_cached_block* cached_block_slot(
+    grpc_chttp2_hpack_compressor* c, const grpc_mdelem* elems, size_t n) {
+  uint32_t hash = 0;
+  for (size_t i = 0; i < n; i++) {
+    hash = (hash ^ static_cast<uint32_t>(elems[i].payload >> 3)) * 0x9e3779b1u;
+  }
+  return &c->cached_blocks[(hash >> 16) % GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS];
+}
+
+static bool cached_block_matches(const grpc_chttp2_hpack_cached_block* b,
+                                 const grpc_mdelem* elems, size_t n) {
+  if (b->num_elems != n) return false;
+  for (size_t i = 0; i < n; i++) {
+    if (b->elems[i].payload != elems[i].payload) return false;
+  }
+  return true;
+}
+
+/* emit a cached block, and make the same changes to the compressor as
+   encoding its elements would have */
+static void replay_cached_block(grpc_chttp2_hpack_compressor* c,
+                                const grpc_chttp2_hpack_cached_block* b,
+                                framer_state* st) {
+  GRPC_STATS_INC_HPACK_SEND_CACHED_BLOCK();
+  for (size_t i = 0; i < b->num_elems; i++) {
+    inc_filter(b->filter_indices[i], &c->filter_elems_sum, c->filter_elems);
+  }
+  memcpy(add_tiny_header_data(st, b->length), b->bytes, b->length);
+  st->seen_regular_header =
+      GRPC_SLICE_START_PTR(GRPC_MDKEY(b->elems[b->num_elems - 1]))[0] != ':';
+}
+
+static void store_cached_block(grpc_chttp2_hpack_compressor* c,
+                               const grpc_chttp2_hpack_cached_block* recorded,
+                               grpc_chttp2_hpack_cached_block* slot) {
+  for (size_t i = 0; i < slot->num_elems; i++) {
+    GRPC_MDELEM_UNREF(slot->elems[i]);
+  }
+  *slot = *recorded;
+  for (size_t i = 0; i < slot->num_elems; i++) {
+    GRPC_MDELEM_REF(slot->elems[i]);
+  }
+  slot->table_epoch = c->table_epoch;
+}
+
 void grpc_chttp2_encode_header(grpc_chttp2_hpack_compressor* c,
                                grpc_mdelem** extra_headers,
                                size_t extra_headers_size,
@@ -678,6 +790,7 @@ void grpc_chttp2_encode_header(grpc_chttp2_hpack_compressor* c,
   st.stats = options->stats;
   st.max_frame_size = options->max_frame_size;
   st.use_true_binary_metadata = options->use_true_binary_metadata;
+  st.recording = nullptr;
 
   /* Encode a metadata batch; store the returned values, representing
      a metadata element that needs to be unreffed back into the metadata
@@ -687,13 +800,50 @@ void grpc_chttp2_encode_header(grpc_chttp2_hpack_compressor* c,
   if (c->advertise_table_size_change != 0) {
     emit_advertise_table_size_change(c, &st);
   }
-  for (size_t i = 0; i < extra_headers_size; ++i) {
-    hpack_enc(c, *extra_headers[i], &st);
-  }
   grpc_metadata_batch_assert_ok(metadata);
-  for (grpc_linked_mdelem* l = metadata->list.head; l; l = l->next) {
-    hpack_enc(c, l->md, &st);
+
+  /* Replay the block from the cache if it was encoded before, and the
+     decoder's table hasn't changed since. Otherwise encode it, recording it
+     if it ends up fully indexed. The deadline is never part of the block. */
+  grpc_mdelem elems[GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_ELEMS];
+  size_t num_elems =
+      grpc_http_trace.enabled()
+          ? 0
+          : gather_cacheable_elems(extra_headers, extra_headers_size,
+                                   metadata, elems);
+  grpc_chttp2_hpack_cached_block* slot = nullptr;
+  grpc_chttp2_hpack_cached_block recorded;
+  bool replayed = false;
+  if (num_elems > 0) {
+    slot = cached_block_slot(c, elems, num_elems);
+    if (slot->table_epoch == c->table_epoch &&
+        cached_block_matches(slot, elems, num_elems) &&
+        st.output->length - st.output_length_at_start_of_frame +
+                slot->length <=
+            st.max_frame_size) {
+      replay_cached_block(c, slot, &st);
+      replayed = true;
+    } else {
+      recorded.num_elems = 0;
+      recorded.length = 0;
+      st.recording = &recorded;
+    }
   }
+  if (!replayed) {
+    for (size_t i = 0; i < extra_headers_size; ++i) {
+      hpack_enc(c, *extra_headers[i], &st);
+    }
+    grpc_linked_mdelem* const* batch_elems =
+        grpc_metadata_batch_elems(metadata);
+    for (size_t i = 0; i < metadata->list.count; ++i) {
+      hpack_enc(c, batch_elems[i]->md, &st);
+    }
+    if (st.recording != nullptr) {
+      store_cached_block(c, &recorded, slot);
+      st.recording = nullptr;
+    }
+  }
+
   grpc_millis deadline = metadata->deadline;
   if (deadline != GRPC_MILLIS_INF_FUTURE) {
     deadline_enc(c, deadline, &st);
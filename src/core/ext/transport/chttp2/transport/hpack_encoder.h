@@ -36,8 +36,31 @@
 /* maximum table size we'll actually use */
 #define GRPC_CHTTP2_HPACKC_MAX_TABLE_SIZE (1024 * 1024)
 
+/* number of header blocks the compressor remembers for replaying */
+#define GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS 4
+/* maximum number of fields in a cached header block */
+#define GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_ELEMS 16
+/* maximum encoded size of a cached header block */
+#define GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_BYTES 48
+
 extern grpc_core::TraceFlag grpc_http_trace;
 
+/* A header block whose fields were all encoded as indexed fields: as long as
+   the decoder's table is unchanged, encoding the same elements again produces
+   the same bytes, so they can be replayed instead. */
+typedef struct {
+  /* refs to the (interned) elements encoded, in order; num_elems is zero if
+     the slot is unused */
+  grpc_mdelem elems[GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_ELEMS];
+  /* filter slot bumped by each element, see filter_elems */
+  uint8_t filter_indices[GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_ELEMS];
+  uint8_t bytes[GRPC_CHTTP2_HPACKC_CACHED_BLOCK_MAX_BYTES];
+  uint8_t num_elems;
+  uint8_t length;
+  /* table_epoch of the compressor when the block was encoded */
+  uint32_t table_epoch;
+} grpc_chttp2_hpack_cached_block;
+
 typedef struct {
   uint32_t filter_elems_sum;
   uint32_t max_table_size;
@@ -69,6 +92,12 @@ typedef struct {
   uint32_t indices_elems[GRPC_CHTTP2_HPACKC_NUM_VALUES];
 
   uint16_t* table_elem_size;
+
+  /* bumped whenever the decoder's table changes, invalidating cached_blocks */
+  uint32_t table_epoch;
+  /* recently encoded header blocks, indexed by a hash of their elements */
+  grpc_chttp2_hpack_cached_block
+      cached_blocks[GRPC_CHTTP2_HPACKC_NUM_CACHED_BLOCKS];
 } grpc_chttp2_hpack_compressor;
 
 void grpc_chttp2_hpack_compressor_init(grpc_chttp2_hpack_compressor* c);
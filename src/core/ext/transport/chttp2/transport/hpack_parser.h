@@ -74,7 +74,7 @@ struct grpc_chttp2_hpack_parser {
   /* number of source bytes read for the currently parsing string */
   uint32_t strgot;
   /* huffman decoding state */
-  int16_t huff_state;
+  uint8_t huff_state;
   /* is the string being decoded binary? */
   uint8_t binary;
   /* is the current string huffman encoded? */
@@ -85,6 +85,9 @@ struct grpc_chttp2_hpack_parser {
      it should append a metadata boundary at the end of frame */
   uint8_t is_boundary;
   uint8_t is_eof;
+  /* weight (1 to 256) of the HTTP/2 priority of the frame being parsed, or 0
+     if it has none */
+  uint16_t stream_weight;
   uint32_t base64_buffer;
 
   /* hpack table */
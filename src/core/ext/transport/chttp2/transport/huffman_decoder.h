@@ -0,0 +1,57 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HUFFMAN_DECODER_H
+#define GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HUFFMAN_DECODER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* HPACK static huffman decoding (RFC 7541 appendix B).
+
+   The decoder walks the huffman tree; its state is the node reached by the
+   bits consumed so far, 0 being the root. Strings may be decoded in pieces by
+   passing the state of one call to the next. The EOS symbol is consumed
+   without being emitted, and padding is not validated. */
+
+/* Upper bound on the number of bytes decoded from \a encoded_length encoded
+   bytes: no code is shorter than five bits, so a byte completes at most two
+   symbols */
+#define GRPC_CHTTP2_HUFFMAN_MAX_DECODED_LENGTH(encoded_length) \
+  (2 * (encoded_length))
+
+/* Build the decoding tables; must be called before grpc_chttp2_huffman_decode.
+   Safe to call more than once. */
+void grpc_chttp2_huffman_decoder_init(void);
+
+/* Decode [cur, end) starting from *state, writing the decoded bytes to out,
+   which must have room for GRPC_CHTTP2_HUFFMAN_MAX_DECODED_LENGTH(end - cur)
+   bytes. Updates *state and returns the number of bytes written.
+   Consumes a byte per table lookup. */
+size_t grpc_chttp2_huffman_decode(uint8_t* state, const uint8_t* cur,
+                                  const uint8_t* end, uint8_t* out);
+
+/* Same contract as grpc_chttp2_huffman_decode, but consumes a nibble per
+   table lookup. This is the decoder grpc_chttp2_huffman_decode's tables are
+   derived from, kept as a reference for tests and benchmarks. */
+size_t grpc_chttp2_huffman_decode_by_nibble(uint8_t* state, const uint8_t* cur,
+                                            const uint8_t* end, uint8_t* out);
+
+#endif /* GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HUFFMAN_DECODER_H */
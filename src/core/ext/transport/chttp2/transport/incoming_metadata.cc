@@ -42,17 +42,21 @@ void grpc_chttp2_incoming_metadata_buffer_destroy(
 grpc_error* grpc_chttp2_incoming_metadata_buffer_add(
     grpc_chttp2_incoming_metadata_buffer* buffer, grpc_mdelem elem) {
   buffer->size += GRPC_MDELEM_LENGTH(elem);
-  return grpc_metadata_batch_add_tail(
-      &buffer->batch,
-      static_cast<grpc_linked_mdelem*>(
-          gpr_arena_alloc(buffer->arena, sizeof(grpc_linked_mdelem))),
-      elem);
+  grpc_linked_mdelem* storage;
+  if (buffer->count < GRPC_CHTTP2_INCOMING_METADATA_PREALLOCATED) {
+    storage = &buffer->preallocated_mdelems[buffer->count++];
+  } else {
+    storage = static_cast<grpc_linked_mdelem*>(
+        gpr_arena_alloc(buffer->arena, sizeof(grpc_linked_mdelem)));
+  }
+  return grpc_metadata_batch_add_tail(&buffer->batch, storage, elem);
 }
 
 grpc_error* grpc_chttp2_incoming_metadata_buffer_replace_or_add(
     grpc_chttp2_incoming_metadata_buffer* buffer, grpc_mdelem elem) {
-  for (grpc_linked_mdelem* l = buffer->batch.list.head; l != nullptr;
-       l = l->next) {
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(&buffer->batch);
+  for (size_t i = 0; i < buffer->batch.list.count; i++) {
+    grpc_linked_mdelem* l = elems[i];
     if (grpc_slice_eq(GRPC_MDKEY(l->md), GRPC_MDKEY(elem))) {
       GRPC_MDELEM_UNREF(l->md);
       l->md = elem;
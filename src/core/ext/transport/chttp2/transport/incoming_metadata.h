@@ -23,10 +23,17 @@
 
 #include "src/core/lib/transport/transport.h"
 
+/** Number of elements stored in the buffer itself before falling back to the
+    arena */
+#define GRPC_CHTTP2_INCOMING_METADATA_PREALLOCATED 16
+
 typedef struct {
   gpr_arena* arena;
   grpc_metadata_batch batch;
   size_t size;  // total size of metadata
+  size_t count;  // number of preallocated_mdelems in use
+  grpc_linked_mdelem
+      preallocated_mdelems[GRPC_CHTTP2_INCOMING_METADATA_PREALLOCATED];
 } grpc_chttp2_incoming_metadata_buffer;
 
 /** assumes everything initially zeroed */
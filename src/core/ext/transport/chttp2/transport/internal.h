@@ -36,6 +36,7 @@
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
 #include "src/core/ext/transport/chttp2/transport/incoming_metadata.h"
 #include "src/core/ext/transport/chttp2/transport/stream_map.h"
+#include "src/core/ext/transport/chttp2/transport/write_scheduler.h"
 #include "src/core/lib/compression/stream_compression.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/iomgr/combiner.h"
@@ -295,6 +296,23 @@ struct grpc_chttp2_transport {
       initiate writing from writing+more */
   bool is_first_write_in_batch;
 
+  /** write coalescing: how long (in microseconds) the start of a write may be
+      held back to gather frames from other streams (0 disables it) */
+  int64_t write_coalescing_max_delay_us;
+  /** when did a write for stream data last start from idle, and a moving
+      average of the time between such writes (both in microseconds) */
+  int64_t last_idle_write_us;
+  double idle_write_interval_us;
+  /** how long the write about to begin is to be held back (0 if it is not) */
+  int64_t write_coalescing_delay_us;
+  /** is a write held back until write_coalescing_timer fires? How many
+      writes were requested meanwhile? */
+  bool write_coalescing_held;
+  int write_requests_while_held;
+  grpc_timer write_coalescing_timer;
+  /** moving average of how often holding back a write gathered more */
+  double write_coalescing_yield;
+
   /** is the transport destroying itself? */
   uint8_t destroying;
   /** has the upper layer closed the transport? */
@@ -401,6 +419,15 @@ struct grpc_chttp2_transport {
       grpc_core::chttp2::TransportFlowControl,
       grpc_core::chttp2::TransportFlowControlDisabled>
       flow_control;
+  /** decides how much data each writable stream sends per turn */
+  grpc_core::PolymorphicManualConstructor<
+      grpc_core::chttp2::WriteSchedulerBase,
+      grpc_core::chttp2::FifoWriteScheduler,
+      grpc_core::chttp2::DeficitRoundRobinWriteScheduler>
+      write_scheduler;
+  /** should the weights of the HTTP/2 priority of incoming HEADERS frames be
+      handed to the write scheduler? */
+  bool honor_stream_priority;
   /** initial window change. This is tracked as we parse settings frames from
    * the remote peer. If there is a positive delta, then we will make all
    * streams readable since they may have become unstalled */
@@ -581,6 +608,9 @@ struct grpc_chttp2_stream {
       grpc_core::chttp2::StreamFlowControlDisabled>
       flow_control;
 
+  /** weight and deficit of this stream in the transport's write scheduler */
+  grpc_core::chttp2::WriteSchedulerStreamState write_state;
+
   grpc_slice_buffer flow_controlled_buffer;
 
   grpc_closure_list run_after_write;
@@ -25,6 +25,75 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+/* marks an unused slot of the hash index */
+#define EMPTY_POS UINT32_MAX
+
+/* fibonacci hashing: the top bits of the product spread runs of consecutive
+   stream ids evenly over the index, and stream ids are picked by the peer, so
+   ids spaced by a power of two must not all land in the same run of slots */
+static size_t index_home(const grpc_chttp2_stream_map* map, uint32_t key) {
+  return (key * 0x9e3779b1u) >> map->index_shift;
+}
+
+static void alloc_index(grpc_chttp2_stream_map* map, int log2_capacity) {
+  size_t capacity = static_cast<size_t>(1) << log2_capacity;
+  map->index = static_cast<grpc_chttp2_stream_map_slot*>(
+      gpr_malloc(sizeof(grpc_chttp2_stream_map_slot) * capacity));
+  memset(map->index, 0xff, sizeof(grpc_chttp2_stream_map_slot) * capacity);
+  map->index_capacity = capacity;
+  map->index_shift = 32 - log2_capacity;
+}
+
+static grpc_chttp2_stream_map_slot* index_find(grpc_chttp2_stream_map* map,
+                                               uint32_t key) {
+  size_t mask = map->index_capacity - 1;
+  for (size_t i = index_home(map, key);; i = (i + 1) & mask) {
+    grpc_chttp2_stream_map_slot* slot = &map->index[i];
+    if (slot->pos == EMPTY_POS) return nullptr;
+    if (slot->key == key) return slot;
+  }
+}
+
+static void index_insert(grpc_chttp2_stream_map* map, uint32_t key,
+                         size_t pos) {
+  size_t mask = map->index_capacity - 1;
+  size_t i = index_home(map, key);
+  while (map->index[i].pos != EMPTY_POS) {
+    i = (i + 1) & mask;
+  }
+  map->index[i].key = key;
+  map->index[i].pos = static_cast<uint32_t>(pos);
+}
+
+/* remove slot from the index, moving the later entries of its probe run back
+   so that lookups never have to step over deleted slots */
+static void index_remove(grpc_chttp2_stream_map* map,
+                         grpc_chttp2_stream_map_slot* slot) {
+  size_t mask = map->index_capacity - 1;
+  size_t hole = static_cast<size_t>(slot - map->index);
+  for (size_t i = (hole + 1) & mask; map->index[i].pos != EMPTY_POS;
+       i = (i + 1) & mask) {
+    /* the entry at i may fill the hole unless its home slot lies
+       (cyclically) after the hole */
+    size_t home = index_home(map, map->index[i].key);
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      map->index[hole] = map->index[i];
+      hole = i;
+    }
+  }
+  map->index[hole].pos = EMPTY_POS;
+}
+
+static void grow_index(grpc_chttp2_stream_map* map) {
+  gpr_free(map->index);
+  alloc_index(map, 32 - map->index_shift + 1);
+  for (size_t i = 0; i < map->count; i++) {
+    if (map->values[i]) {
+      index_insert(map, map->keys[i], i);
+    }
+  }
+}
+
 void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
                                  size_t initial_capacity) {
   GPR_ASSERT(initial_capacity > 1);
@@ -35,25 +104,38 @@ void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
   map->count = 0;
   map->free = 0;
   map->capacity = initial_capacity;
+  int log2_index_capacity = 1;
+  while ((static_cast<size_t>(1) << log2_index_capacity) <
+         2 * initial_capacity) {
+    log2_index_capacity++;
+  }
+  alloc_index(map, log2_index_capacity);
 }
 
 void grpc_chttp2_stream_map_destroy(grpc_chttp2_stream_map* map) {
   gpr_free(map->keys);
   gpr_free(map->values);
+  gpr_free(map->index);
 }
 
-static size_t compact(uint32_t* keys, void** values, size_t count) {
+static void compact(grpc_chttp2_stream_map* map) {
+  uint32_t* keys = map->keys;
+  void** values = map->values;
   size_t i, out;
 
-  for (i = 0, out = 0; i < count; i++) {
+  for (i = 0, out = 0; i < map->count; i++) {
     if (values[i]) {
-      keys[out] = keys[i];
-      values[out] = values[i];
+      if (out != i) {
+        keys[out] = keys[i];
+        values[out] = values[i];
+        index_find(map, keys[out])->pos = static_cast<uint32_t>(out);
+      }
       out++;
     }
   }
 
-  return out;
+  map->count = out;
+  map->free = 0;
 }
 
 void grpc_chttp2_stream_map_add(grpc_chttp2_stream_map* map, uint32_t key,
@@ -69,72 +151,51 @@ void grpc_chttp2_stream_map_add(grpc_chttp2_stream_map* map, uint32_t key,
 
   if (count == capacity) {
     if (map->free > capacity / 4) {
-      count = compact(keys, values, count);
-      map->free = 0;
+      compact(map);
+      count = map->count;
     } else {
       /* resize when less than 25% of the table is free, because compaction
          won't help much */
       map->capacity = capacity = 3 * capacity / 2;
+      GPR_ASSERT(capacity < EMPTY_POS);
       map->keys = keys = static_cast<uint32_t*>(
           gpr_realloc(keys, capacity * sizeof(uint32_t)));
       map->values = values =
           static_cast<void**>(gpr_realloc(values, capacity * sizeof(void*)));
     }
   }
+  if (2 * (count - map->free + 1) > map->index_capacity) {
+    grow_index(map);
+  }
 
   keys[count] = key;
   values[count] = value;
+  index_insert(map, key, count);
   map->count = count + 1;
 }
 
-static void** find(grpc_chttp2_stream_map* map, uint32_t key) {
-  size_t min_idx = 0;
-  size_t max_idx = map->count;
-  size_t mid_idx;
-  uint32_t* keys = map->keys;
-  void** values = map->values;
-  uint32_t mid_key;
-
-  if (max_idx == 0) return nullptr;
-
-  while (min_idx < max_idx) {
-    /* find the midpoint, avoiding overflow */
-    mid_idx = min_idx + ((max_idx - min_idx) / 2);
-    mid_key = keys[mid_idx];
-
-    if (mid_key < key) {
-      min_idx = mid_idx + 1;
-    } else if (mid_key > key) {
-      max_idx = mid_idx;
-    } else /* mid_key == key */
-    {
-      return &values[mid_idx];
-    }
-  }
-
-  return nullptr;
-}
-
 void* grpc_chttp2_stream_map_delete(grpc_chttp2_stream_map* map, uint32_t key) {
-  void** pvalue = find(map, key);
-  void* out = nullptr;
-  if (pvalue != nullptr) {
-    out = *pvalue;
-    *pvalue = nullptr;
-    map->free += (out != nullptr);
-    /* recognize complete emptyness and ensure we can skip
-     * defragmentation later */
-    if (map->free == map->count) {
-      map->free = map->count = 0;
-    }
-    GPR_ASSERT(grpc_chttp2_stream_map_find(map, key) == nullptr);
+  grpc_chttp2_stream_map_slot* slot = index_find(map, key);
+  if (slot == nullptr) {
+    return nullptr;
+  }
+  void* out = map->values[slot->pos];
+  map->values[slot->pos] = nullptr;
+  map->free++;
+  index_remove(map, slot);
+  /* drop deleted entries from the end of the arrays right away: short lived
+     streams are usually the newest ones, so they never need compacting. This
+     also recognizes complete emptyness. */
+  while (map->count > 0 && map->values[map->count - 1] == nullptr) {
+    map->count--;
+    map->free--;
   }
   return out;
 }
 
 void* grpc_chttp2_stream_map_find(grpc_chttp2_stream_map* map, uint32_t key) {
-  void** pvalue = find(map, key);
-  return pvalue != nullptr ? *pvalue : nullptr;
+  grpc_chttp2_stream_map_slot* slot = index_find(map, key);
+  return slot != nullptr ? map->values[slot->pos] : nullptr;
 }
 
 size_t grpc_chttp2_stream_map_size(grpc_chttp2_stream_map* map) {
@@ -145,12 +206,18 @@ void* grpc_chttp2_stream_map_rand(grpc_chttp2_stream_map* map) {
   if (map->count == map->free) {
     return nullptr;
   }
-  if (map->free != 0) {
-    map->count = compact(map->keys, map->values, map->count);
-    map->free = 0;
+  /* with at least half of the positions populated, a random position finds
+     an entry after two tries on average */
+  if (map->free > map->count / 2) {
+    compact(map);
     GPR_ASSERT(map->count > 0);
   }
-  return map->values[(static_cast<size_t>(rand())) % map->count];
+  for (;;) {
+    void* value = map->values[(static_cast<size_t>(rand())) % map->count];
+    if (value != nullptr) {
+      return value;
+    }
+  }
 }
 
 void grpc_chttp2_stream_map_for_each(grpc_chttp2_stream_map* map,
@@ -22,19 +22,34 @@
 #include <grpc/support/port_platform.h>
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* Data structure to map a uint32_t to a data object (represented by a void*)
 
-   Represented as a sorted array of keys, and a corresponding array of values.
-   Lookups are performed with binary search.
-   Adds are restricted to strictly higher keys than previously seen (this is
-   guaranteed by http2). */
+   Represented as an array of keys, and a corresponding array of values, in
+   the order the keys were added. Adds are restricted to strictly higher keys
+   than previously seen (this is guaranteed by http2), so the arrays are also
+   sorted. Deleted entries leave a NULL value behind until the arrays are
+   compacted.
+   Lookups go through an open addressing hash index from key to array
+   position, so find, add and delete take constant expected time. */
+typedef struct {
+  uint32_t key;
+  /* position of key in the keys/values arrays, or UINT32_MAX if unused */
+  uint32_t pos;
+} grpc_chttp2_stream_map_slot;
+
 typedef struct {
   uint32_t* keys;
   void** values;
   size_t count;
   size_t free;
   size_t capacity;
+  /* hash index: a power of two number of slots, never more than half full */
+  grpc_chttp2_stream_map_slot* index;
+  size_t index_capacity;
+  /* 32 - log2(index_capacity) */
+  int index_shift;
 } grpc_chttp2_stream_map;
 
 void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
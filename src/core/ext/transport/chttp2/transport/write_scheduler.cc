@@ -0,0 +1,52 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/transport/chttp2/transport/write_scheduler.h"
+
+#include "src/core/lib/gpr/useful.h"
+
+namespace grpc_core {
+namespace chttp2 {
+
+uint32_t DeficitRoundRobinWriteScheduler::StreamQuantum(
+    const WriteSchedulerStreamState* s) const {
+  uint64_t quantum =
+      static_cast<uint64_t>(quantum_) * s->weight / kDefaultStreamWeight;
+  return static_cast<uint32_t>(GPR_CLAMP(quantum, 1, UINT32_MAX / 2));
+}
+
+uint32_t DeficitRoundRobinWriteScheduler::BeginTurn(
+    WriteSchedulerStreamState* s) {
+  s->deficit += StreamQuantum(s);
+  return s->deficit;
+}
+
+void DeficitRoundRobinWriteScheduler::EndTurn(WriteSchedulerStreamState* s,
+                                              uint32_t sent, bool has_more) {
+  if (!has_more) {
+    s->deficit = 0;
+    return;
+  }
+  s->deficit =
+      GPR_MIN(s->deficit - GPR_MIN(sent, s->deficit), StreamQuantum(s));
+}
+
+}  // namespace chttp2
+}  // namespace grpc_core
@@ -0,0 +1,103 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_WRITE_SCHEDULER_H
+#define GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_WRITE_SCHEDULER_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gprpp/abstract.h"
+
+namespace grpc_core {
+namespace chttp2 {
+
+// Weight of a stream that was given none; the HTTP/2 default (RFC 7540
+// section 5.3.5).
+static constexpr uint16_t kDefaultStreamWeight = 16;
+
+// What the write scheduler keeps for each stream; a member of
+// grpc_chttp2_stream.
+struct WriteSchedulerStreamState {
+  // Share of the transport's writes given to the stream: 1 to 256, like
+  // HTTP/2 priority weights.
+  uint16_t weight;
+  // Bytes the write scheduler still owes the stream.
+  uint32_t deficit;
+};
+
+// Decides how much DATA each stream may frame when grpc_chttp2_begin_write
+// pops it from the writable list. A stream that still has data to send after
+// its turn is appended back to the writable list, so bounding turns
+// interleaves the streams of a transport instead of draining them one after
+// the other.
+class WriteSchedulerBase {
+ public:
+  WriteSchedulerBase() {}
+  virtual ~WriteSchedulerBase() {}
+
+  // Called when a stream with data to send starts its turn. Returns how many
+  // bytes of DATA it may frame (before flow control is applied).
+  virtual uint32_t BeginTurn(WriteSchedulerStreamState* s) GRPC_ABSTRACT;
+
+  // Called at the end of the turn with the number of bytes framed, and whether
+  // the stream still has data queued.
+  virtual void EndTurn(WriteSchedulerStreamState* s, uint32_t sent,
+                       bool has_more) GRPC_ABSTRACT;
+
+  GRPC_ABSTRACT_BASE_CLASS
+};
+
+// Streams send as much as flow control allows in each turn: the writable list
+// is drained in FIFO order. This is the default.
+class FifoWriteScheduler final : public WriteSchedulerBase {
+ public:
+  uint32_t BeginTurn(WriteSchedulerStreamState* s) override {
+    return UINT32_MAX;
+  }
+  void EndTurn(WriteSchedulerStreamState* s, uint32_t sent,
+               bool has_more) override {}
+};
+
+// Deficit round robin: each turn credits a stream with a quantum of bytes
+// proportional to its weight (\a quantum for kDefaultStreamWeight), which is
+// what it may send. Credit left over because flow control cut the turn short
+// carries to the next turn, up to one quantum; a stream that runs out of data
+// loses it.
+class DeficitRoundRobinWriteScheduler final : public WriteSchedulerBase {
+ public:
+  explicit DeficitRoundRobinWriteScheduler(uint32_t quantum)
+      : quantum_(quantum) {}
+
+  uint32_t BeginTurn(WriteSchedulerStreamState* s) override;
+  void EndTurn(WriteSchedulerStreamState* s, uint32_t sent,
+               bool has_more) override;
+
+ private:
+  uint32_t StreamQuantum(const WriteSchedulerStreamState* s) const;
+
+  const uint32_t quantum_;
+};
+
+}  // namespace chttp2
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_WRITE_SCHEDULER_H */
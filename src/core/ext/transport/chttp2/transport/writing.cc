@@ -199,6 +199,7 @@ class WriteContext {
     GRPC_STATS_INC_HTTP2_SEND_TRAILING_METADATA_PER_WRITE(
         trailing_metadata_writes_);
     GRPC_STATS_INC_HTTP2_SEND_FLOWCTL_PER_WRITE(flow_control_writes_);
+    GRPC_STATS_INC_HTTP2_FRAMES_PER_WRITE(frames_);
   }
 
   void FlushSettings() {
@@ -212,6 +213,7 @@ class WriteContext {
       t_->dirtied_local_settings = false;
       t_->sent_local_settings = true;
       GRPC_STATS_INC_HTTP2_SETTINGS_WRITES();
+      IncFrames();
     }
   }
 
@@ -230,6 +232,7 @@ class WriteContext {
           &t_->outbuf, grpc_chttp2_window_update_create(0, transport_announce,
                                                         &throwaway_stats));
       ResetPingClock();
+      IncFrames();
     }
   }
 
@@ -237,6 +240,7 @@ class WriteContext {
     for (size_t i = 0; i < t_->ping_ack_count; i++) {
       grpc_slice_buffer_add(&t_->outbuf,
                             grpc_chttp2_ping_create(true, t_->ping_acks[i]));
+      IncFrames();
     }
     t_->ping_ack_count = 0;
   }
@@ -287,6 +291,7 @@ class WriteContext {
   void IncWindowUpdateWrites() { ++flow_control_writes_; }
   void IncMessageWrites() { ++message_writes_; }
   void IncTrailingMetadataWrites() { ++trailing_metadata_writes_; }
+  void IncFrames() { ++frames_; }
 
   void NoteScheduledResults() { result_.early_results_scheduled = true; }
 
@@ -306,6 +311,7 @@ class WriteContext {
   int initial_metadata_writes_ = 0;
   int trailing_metadata_writes_ = 0;
   int message_writes_ = 0;
+  int frames_ = 0;
   grpc_chttp2_begin_write_result result_ = {false, false, false};
 };
 
@@ -325,13 +331,27 @@ class DataSendContext {
                                     [GRPC_CHTTP2_SETTINGS_INITIAL_WINDOW_SIZE]);
   }
 
-  uint32_t max_outgoing() const {
+  uint32_t flow_control_outgoing() const {
     return static_cast<uint32_t> GPR_MIN(
         t_->settings[GRPC_PEER_SETTINGS][GRPC_CHTTP2_SETTINGS_MAX_FRAME_SIZE],
         GPR_MIN(stream_remote_window(), t_->flow_control->remote_window()));
   }
 
-  bool AnyOutgoing() const { return max_outgoing() > 0; }
+  uint32_t max_outgoing() const {
+    return GPR_MIN(flow_control_outgoing(), turn_budget_ - turn_bytes_);
+  }
+
+  bool AnyOutgoing() const { return flow_control_outgoing() > 0; }
+
+  /* Ask the write scheduler how much this stream may send before it has to
+     yield to the other writable streams */
+  void BeginTurn() {
+    turn_budget_ = t_->write_scheduler->BeginTurn(&s_->write_state);
+  }
+
+  void EndTurn(bool has_more) {
+    t_->write_scheduler->EndTurn(&s_->write_state, turn_bytes_, has_more);
+  }
 
   void FlushCompressedBytes() {
     uint32_t send_bytes = static_cast<uint32_t> GPR_MIN(
@@ -362,6 +382,8 @@ class DataSendContext {
     grpc_chttp2_encode_data(s_->id, &s_->compressed_data_buffer, send_bytes,
                             is_last_frame_, &s_->stats.outgoing, &t_->outbuf);
     s_->flow_control->SentData(send_bytes);
+    turn_bytes_ += send_bytes;
+    write_context_->IncFrames();
     if (s_->compressed_data_buffer.length == 0) {
       s_->sending_bytes += s_->uncompressed_data_size;
     }
@@ -398,6 +420,8 @@ class DataSendContext {
   grpc_chttp2_transport* t_;
   grpc_chttp2_stream* s_;
   const size_t sending_bytes_before_;
+  uint32_t turn_budget_ = UINT32_MAX;
+  uint32_t turn_bytes_ = 0;
   bool is_last_frame_ = false;
 };
 
@@ -444,6 +468,7 @@ class StreamWriteContext {
                                 s_->send_initial_metadata, &hopt, &t_->outbuf);
       write_context_->ResetPingClock();
       write_context_->IncInitialMetadataWrites();
+      write_context_->IncFrames();
     }
 
     s_->send_initial_metadata = nullptr;
@@ -464,6 +489,7 @@ class StreamWriteContext {
                                                       &s_->stats.outgoing));
     write_context_->ResetPingClock();
     write_context_->IncWindowUpdateWrites();
+    write_context_->IncFrames();
   }
 
   void FlushData() {
@@ -487,6 +513,7 @@ class StreamWriteContext {
       return;  // early out: nothing to do
     }
 
+    data_send_context.BeginTurn();
     while ((s_->flow_controlled_buffer.length > 0 ||
             s_->compressed_data_buffer.length > 0) &&
            data_send_context.max_outgoing() > 0) {
@@ -496,6 +523,8 @@ class StreamWriteContext {
         data_send_context.CompressMoreBytes();
       }
     }
+    data_send_context.EndTurn(s_->flow_controlled_buffer.length > 0 ||
+                              s_->compressed_data_buffer.length > 0);
     write_context_->ResetPingClock();
     if (data_send_context.is_last_frame()) {
       SentLastFrame();
@@ -504,6 +533,8 @@ class StreamWriteContext {
     stream_became_writable_ = true;
     if (s_->flow_controlled_buffer.length > 0 ||
         s_->compressed_data_buffer.length > 0) {
+      /* back to the tail of the writable list: whatever the flow control
+         windows or the write scheduler left over is sent in a later turn */
       GRPC_CHTTP2_STREAM_REF(s_, "chttp2_writing:fork");
       grpc_chttp2_list_add_writable_stream(t_, s_);
     }
@@ -537,6 +568,7 @@ class StreamWriteContext {
                                 s_->send_trailing_metadata, &hopt, &t_->outbuf);
     }
     write_context_->IncTrailingMetadataWrites();
+    write_context_->IncFrames();
     write_context_->ResetPingClock();
     SentLastFrame();
 
@@ -574,6 +606,7 @@ class StreamWriteContext {
       grpc_slice_buffer_add(
           &t_->outbuf, grpc_chttp2_rst_stream_create(
                            s_->id, GRPC_HTTP2_NO_ERROR, &s_->stats.outgoing));
+      write_context_->IncFrames();
     }
     grpc_chttp2_mark_stream_closed(t_, s_, !t_->is_client, true,
                                    GRPC_ERROR_NONE);
@@ -625,7 +658,11 @@ grpc_chttp2_begin_write_result grpc_chttp2_begin_write(
 
   maybe_initiate_ping(t);
 
-  return ctx.Result();
+  grpc_chttp2_begin_write_result result = ctx.Result();
+  if (result.writing) {
+    ctx.FlushStats();
+  }
+  return result;
 }
 
 void grpc_chttp2_end_write(grpc_chttp2_transport* t, grpc_error* error) {
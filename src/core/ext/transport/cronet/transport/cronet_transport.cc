@@ -704,16 +704,11 @@ static void create_grpc_frame(grpc_slice_buffer* write_slice_buffer,
  Convert metadata in a format that Cronet can consume
 */
 static void convert_metadata_to_cronet_headers(
-    grpc_linked_mdelem* head, const char* host, char** pp_url,
+    grpc_metadata_batch* metadata, const char* host, char** pp_url,
     bidirectional_stream_header** pp_headers, size_t* p_num_headers,
     const char** method) {
-  grpc_linked_mdelem* curr = head;
-  /* Walk the linked list and get number of header fields */
-  size_t num_headers_available = 0;
-  while (curr != nullptr) {
-    curr = curr->next;
-    num_headers_available++;
-  }
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(metadata);
+  size_t num_headers_available = metadata->list.count;
   /* Allocate enough memory. It is freed in the on_stream_ready callback
    */
   bidirectional_stream_header* headers =
@@ -721,16 +716,12 @@ static void convert_metadata_to_cronet_headers(
           sizeof(bidirectional_stream_header) * num_headers_available));
   *pp_headers = headers;
 
-  /* Walk the linked list again, this time copying the header fields.
-    s->num_headers can be less than num_headers_available, as some headers
-    are not used for cronet.
-    TODO (makdharma): Eliminate need to traverse the LL second time for perf.
+  /* Copy the header fields. s->num_headers can be less than
+    num_headers_available, as some headers are not used for cronet.
    */
-  curr = head;
   size_t num_headers = 0;
-  while (num_headers < num_headers_available) {
-    grpc_mdelem mdelem = curr->md;
-    curr = curr->next;
+  for (size_t i = 0; i < num_headers_available; i++) {
+    grpc_mdelem mdelem = elems[i]->md;
     char* key = grpc_slice_to_c_string(GRPC_MDKEY(mdelem));
     char* value;
     if (grpc_is_binary_header(GRPC_MDKEY(mdelem))) {
@@ -769,9 +760,6 @@ static void convert_metadata_to_cronet_headers(
     headers[num_headers].key = key;
     headers[num_headers].value = value;
     num_headers++;
-    if (curr == nullptr) {
-      break;
-    }
   }
   *p_num_headers = num_headers;
 }
@@ -788,12 +776,12 @@ static void parse_grpc_header(const uint8_t* data, int* length,
   *length |= (*p++);
 }
 
-static bool header_has_authority(grpc_linked_mdelem* head) {
-  while (head != nullptr) {
-    if (grpc_slice_eq(GRPC_MDKEY(head->md), GRPC_MDSTR_AUTHORITY)) {
+static bool header_has_authority(grpc_metadata_batch* metadata) {
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(metadata);
+  for (size_t i = 0; i < metadata->list.count; i++) {
+    if (grpc_slice_eq(GRPC_MDKEY(elems[i]->md), GRPC_MDSTR_AUTHORITY)) {
       return true;
     }
-    head = head->next;
   }
   return false;
 }
@@ -1013,7 +1001,7 @@ static enum e_op_result execute_stream_op(struct op_and_state* oas) {
     const char* method = "POST";
     s->header_array.headers = nullptr;
     convert_metadata_to_cronet_headers(stream_op->payload->send_initial_metadata
-                                           .send_initial_metadata->list.head,
+                                           .send_initial_metadata,
                                        t->host, &url, &s->header_array.headers,
                                        &s->header_array.count, &method);
     s->header_array.capacity = s->header_array.count;
@@ -1398,7 +1386,7 @@ static void perform_stream_op(grpc_transport* gt, grpc_stream* gs,
   CRONET_LOG(GPR_DEBUG, "perform_stream_op");
   if (op->send_initial_metadata &&
       header_has_authority(op->payload->send_initial_metadata
-                               .send_initial_metadata->list.head)) {
+                               .send_initial_metadata)) {
     /* Cronet does not support :authority header field. We cancel the call when
      this field is present in metadata */
     if (op->recv_initial_metadata) {
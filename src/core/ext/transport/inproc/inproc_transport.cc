@@ -30,6 +30,7 @@
 #include "src/core/lib/surface/api_trace.h"
 #include "src/core/lib/surface/channel.h"
 #include "src/core/lib/surface/channel_stack_type.h"
+#include "src/core/lib/surface/message_object.h"
 #include "src/core/lib/surface/server.h"
 #include "src/core/lib/transport/connectivity_state.h"
 #include "src/core/lib/transport/error_utils.h"
@@ -182,10 +183,10 @@ static void really_destroy_stream(inproc_stream* s) {
 
 static void log_metadata(const grpc_metadata_batch* md_batch, bool is_client,
                          bool is_initial) {
-  for (grpc_linked_mdelem* md = md_batch->list.head; md != nullptr;
-       md = md->next) {
-    char* key = grpc_slice_to_c_string(GRPC_MDKEY(md->md));
-    char* value = grpc_slice_to_c_string(GRPC_MDVALUE(md->md));
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(md_batch);
+  for (size_t i = 0; i < md_batch->list.count; i++) {
+    char* key = grpc_slice_to_c_string(GRPC_MDKEY(elems[i]->md));
+    char* value = grpc_slice_to_c_string(GRPC_MDVALUE(elems[i]->md));
     gpr_log(GPR_INFO, "INPROC:%s:%s: %s: %s", is_initial ? "HDR" : "TRL",
             is_client ? "CLI" : "SVR", key, value);
     gpr_free(key);
@@ -208,13 +209,14 @@ static grpc_error* fill_in_metadata(inproc_stream* s,
     *markfilled = true;
   }
   grpc_error* error = GRPC_ERROR_NONE;
-  for (grpc_linked_mdelem* elem = metadata->list.head;
-       (elem != nullptr) && (error == GRPC_ERROR_NONE); elem = elem->next) {
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(metadata);
+  for (size_t i = 0; i < metadata->list.count && error == GRPC_ERROR_NONE;
+       i++) {
+    grpc_mdelem md = elems[i]->md;
     grpc_linked_mdelem* nelem = static_cast<grpc_linked_mdelem*>(
         gpr_arena_alloc(s->arena, sizeof(*nelem)));
-    nelem->md =
-        grpc_mdelem_from_slices(grpc_slice_intern(GRPC_MDKEY(elem->md)),
-                                grpc_slice_intern(GRPC_MDVALUE(elem->md)));
+    nelem->md = grpc_mdelem_from_slices(grpc_slice_intern(GRPC_MDKEY(md)),
+                                        grpc_slice_intern(GRPC_MDVALUE(md)));
 
     error = grpc_metadata_batch_link_tail(out_md, nelem);
   }
@@ -1251,6 +1253,26 @@ grpc_channel* grpc_inproc_channel_create(grpc_server* server,
   grpc_channel_args* client_args =
       grpc_channel_args_copy_and_add(args, &default_authority_arg, 1);
 
+  // If either side asked for message objects to be handed over as they are,
+  // tell the channels on both
+  grpc_channel_args* server_channel_args = nullptr;
+  if (grpc_channel_arg_get_bool(
+          grpc_channel_args_find(args, GRPC_ARG_INPROC_MESSAGE_OBJECTS),
+          false) ||
+      grpc_channel_arg_get_bool(
+          grpc_channel_args_find(server_args, GRPC_ARG_INPROC_MESSAGE_OBJECTS),
+          false)) {
+    grpc_arg carries_arg = grpc_channel_arg_integer_create(
+        const_cast<char*>(GRPC_ARG_CARRIES_MESSAGE_OBJECTS), 1);
+    grpc_channel_args* old_client_args = client_args;
+    client_args =
+        grpc_channel_args_copy_and_add(old_client_args, &carries_arg, 1);
+    grpc_channel_args_destroy(old_client_args);
+    server_channel_args =
+        grpc_channel_args_copy_and_add(server_args, &carries_arg, 1);
+    server_args = server_channel_args;
+  }
+
   grpc_transport* server_transport;
   grpc_transport* client_transport;
   inproc_transports_create(&server_transport, server_args, &client_transport,
@@ -1262,6 +1284,9 @@ grpc_channel* grpc_inproc_channel_create(grpc_server* server,
 
   // Free up created channel args
   grpc_channel_args_destroy(client_args);
+  if (server_channel_args != nullptr) {
+    grpc_channel_args_destroy(server_channel_args);
+  }
 
   // Now finish scheduled operations
 
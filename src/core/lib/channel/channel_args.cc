@@ -28,6 +28,7 @@
 #include <grpc/support/string_util.h>
 
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/compression/compression_internal.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/useful.h"
 
@@ -227,7 +228,7 @@ grpc_compression_algorithm grpc_channel_args_get_compression_algorithm(
 
 grpc_channel_args* grpc_channel_args_set_compression_algorithm(
     grpc_channel_args* a, grpc_compression_algorithm algorithm) {
-  GPR_ASSERT(algorithm < GRPC_COMPRESS_ALGORITHMS_COUNT);
+  GPR_ASSERT(grpc_compression_algorithm_is_valid(algorithm));
   grpc_arg tmp;
   tmp.type = GRPC_ARG_INTEGER;
   tmp.key = (char*)GRPC_COMPRESSION_CHANNEL_DEFAULT_ALGORITHM;
@@ -282,7 +283,8 @@ grpc_channel_args* grpc_channel_args_compression_algorithm_set_state(
     tmp.type = GRPC_ARG_INTEGER;
     tmp.key = (char*)GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET;
     /* all enabled by default */
-    tmp.value.integer = (1u << GRPC_COMPRESS_ALGORITHMS_COUNT) - 1;
+    tmp.value.integer =
+        static_cast<int>(grpc_compression_all_algorithms_bitset());
     if (state != 0) {
       GPR_BITSET((unsigned*)&tmp.value.integer, algorithm);
     } else if (algorithm != GRPC_COMPRESS_NONE) {
@@ -301,7 +303,8 @@ uint32_t grpc_channel_args_compression_algorithm_get_states(
   if (find_compression_algorithm_states_bitset(a, &states_arg)) {
     return static_cast<uint32_t>(*states_arg);
   } else {
-    return (1u << GRPC_COMPRESS_ALGORITHMS_COUNT) - 1; /* All algs. enabled */
+    /* All algs. enabled */
+    return grpc_compression_all_algorithms_bitset();
   }
 }
 
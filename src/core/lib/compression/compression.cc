@@ -25,12 +25,16 @@
 
 #include "src/core/lib/compression/algorithm_metadata.h"
 #include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/surface/api_trace.h"
 #include "src/core/lib/transport/static_metadata.h"
 
 int grpc_compression_algorithm_is_message(
     grpc_compression_algorithm algorithm) {
+  if (algorithm >= GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE) {
+    return grpc_compression_algorithm_is_valid(algorithm);
+  }
   return (algorithm >= GRPC_COMPRESS_DEFLATE && algorithm <= GRPC_COMPRESS_GZIP)
              ? 1
              : 0;
@@ -55,6 +59,11 @@ int grpc_compression_algorithm_parse(grpc_slice name,
     *algorithm = GRPC_COMPRESS_STREAM_GZIP;
     return 1;
   } else {
+    grpc_message_compression_algorithm message_algorithm;
+    if (grpc_message_compressor_find_by_name(name, &message_algorithm)) {
+      *algorithm = static_cast<grpc_compression_algorithm>(message_algorithm);
+      return 1;
+    }
     return 0;
   }
   return 0;
@@ -80,6 +89,10 @@ int grpc_compression_algorithm_name(grpc_compression_algorithm algorithm,
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       return 0;
   }
+  if (grpc_compression_algorithm_is_message(algorithm)) {
+    return grpc_message_compression_algorithm_name(
+        static_cast<grpc_message_compression_algorithm>(algorithm), name);
+  }
   return 0;
 }
 
@@ -110,7 +123,7 @@ grpc_compression_algorithm grpc_compression_algorithm_for_level(
 void grpc_compression_options_init(grpc_compression_options* opts) {
   memset(opts, 0, sizeof(*opts));
   /* all enabled by default */
-  opts->enabled_algorithms_bitset = (1u << GRPC_COMPRESS_ALGORITHMS_COUNT) - 1;
+  opts->enabled_algorithms_bitset = grpc_compression_all_algorithms_bitset();
 }
 
 void grpc_compression_options_enable_algorithm(
@@ -143,6 +156,11 @@ grpc_slice grpc_compression_algorithm_slice(
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       return grpc_empty_slice();
   }
+  const char* name;
+  if (grpc_compression_algorithm_is_message(algorithm) &&
+      grpc_compression_algorithm_name(algorithm, &name)) {
+    return grpc_slice_from_static_string(name);
+  }
   return grpc_empty_slice();
 }
 
@@ -153,6 +171,10 @@ grpc_compression_algorithm grpc_compression_algorithm_from_slice(
   if (grpc_slice_eq(str, GRPC_MDSTR_GZIP)) return GRPC_COMPRESS_GZIP;
   if (grpc_slice_eq(str, GRPC_MDSTR_STREAM_SLASH_GZIP))
     return GRPC_COMPRESS_STREAM_GZIP;
+  grpc_message_compression_algorithm algorithm;
+  if (grpc_message_compressor_find_by_name(str, &algorithm)) {
+    return static_cast<grpc_compression_algorithm>(algorithm);
+  }
   return GRPC_COMPRESS_ALGORITHMS_COUNT;
 }
 
@@ -170,5 +192,9 @@ grpc_mdelem grpc_compression_encoding_mdelem(
     default:
       break;
   }
+  if (grpc_compression_algorithm_is_message(algorithm)) {
+    return grpc_message_compression_encoding_mdelem(
+        static_cast<grpc_message_compression_algorithm>(algorithm));
+  }
   return GRPC_MDNULL;
 }
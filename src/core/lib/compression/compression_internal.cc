@@ -25,6 +25,7 @@
 
 #include "src/core/lib/compression/algorithm_metadata.h"
 #include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/surface/api_trace.h"
 #include "src/core/lib/transport/static_metadata.h"
@@ -38,6 +39,8 @@ grpc_message_compression_algorithm_from_slice(grpc_slice str) {
   if (grpc_slice_eq(str, GRPC_MDSTR_DEFLATE))
     return GRPC_MESSAGE_COMPRESS_DEFLATE;
   if (grpc_slice_eq(str, GRPC_MDSTR_GZIP)) return GRPC_MESSAGE_COMPRESS_GZIP;
+  grpc_message_compression_algorithm algorithm;
+  if (grpc_message_compressor_find_by_name(str, &algorithm)) return algorithm;
   return GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT;
 }
 
@@ -60,6 +63,13 @@ grpc_mdelem grpc_message_compression_encoding_mdelem(
     default:
       break;
   }
+  const grpc_message_compressor_vtable* compressor =
+      grpc_message_compressor_find(algorithm);
+  if (compressor != nullptr) {
+    return grpc_mdelem_from_slices(
+        GRPC_MDSTR_GRPC_ENCODING,
+        grpc_slice_intern(grpc_slice_from_static_string(compressor->name)));
+  }
   return GRPC_MDNULL;
 }
 
@@ -76,6 +86,19 @@ grpc_mdelem grpc_stream_compression_encoding_mdelem(
   return GRPC_MDNULL;
 }
 
+int grpc_compression_algorithm_is_valid(grpc_compression_algorithm algorithm) {
+  if (algorithm < GRPC_COMPRESS_ALGORITHMS_COUNT) return 1;
+  return algorithm >= GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE &&
+         grpc_message_compressor_find(
+             static_cast<grpc_message_compression_algorithm>(algorithm)) !=
+             nullptr;
+}
+
+uint32_t grpc_compression_all_algorithms_bitset(void) {
+  return ((1u << GRPC_COMPRESS_ALGORITHMS_COUNT) - 1) |
+         grpc_message_compressor_registered_bitset();
+}
+
 /* Interfaces performing transformation between compression algorithms and
  * levels. */
 grpc_message_compression_algorithm
@@ -87,6 +110,10 @@ grpc_compression_algorithm_to_message_compression_algorithm(
     case GRPC_COMPRESS_GZIP:
       return GRPC_MESSAGE_COMPRESS_GZIP;
     default:
+      if (algo >= GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE &&
+          grpc_compression_algorithm_is_valid(algo)) {
+        return static_cast<grpc_message_compression_algorithm>(algo);
+      }
       return GRPC_MESSAGE_COMPRESS_NONE;
   }
 }
@@ -103,7 +130,8 @@ grpc_compression_algorithm_to_stream_compression_algorithm(
 }
 
 uint32_t grpc_compression_bitset_to_message_bitset(uint32_t bitset) {
-  return bitset & ((1u << GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT) - 1);
+  return bitset & (((1u << GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT) - 1) |
+                   grpc_message_compressor_registered_bitset());
 }
 
 uint32_t grpc_compression_bitset_to_stream_bitset(uint32_t bitset) {
@@ -155,6 +183,12 @@ int grpc_compression_algorithm_from_message_stream_compression_algorithm(
         *algorithm = GRPC_COMPRESS_GZIP;
         return 1;
       default:
+        if (message_algorithm >= GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE &&
+            grpc_message_compressor_find(message_algorithm) != nullptr) {
+          *algorithm =
+              static_cast<grpc_compression_algorithm>(message_algorithm);
+          return 1;
+        }
         *algorithm = GRPC_COMPRESS_NONE;
         return 0;
     }
@@ -169,20 +203,11 @@ int grpc_message_compression_algorithm_name(
   GRPC_API_TRACE(
       "grpc_message_compression_algorithm_parse(algorithm=%d, name=%p)", 2,
       ((int)algorithm, name));
-  switch (algorithm) {
-    case GRPC_MESSAGE_COMPRESS_NONE:
-      *name = "identity";
-      return 1;
-    case GRPC_MESSAGE_COMPRESS_DEFLATE:
-      *name = "deflate";
-      return 1;
-    case GRPC_MESSAGE_COMPRESS_GZIP:
-      *name = "gzip";
-      return 1;
-    case GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT:
-      return 0;
-  }
-  return 0;
+  const grpc_message_compressor_vtable* compressor =
+      grpc_message_compressor_find(algorithm);
+  if (compressor == nullptr) return 0;
+  *name = compressor->name;
+  return 1;
 }
 
 /* TODO(dgq): Add the ability to specify parameters to the individual
@@ -197,6 +222,8 @@ grpc_message_compression_algorithm grpc_message_compression_algorithm_for_level(
     abort();
   }
 
+  /* registered algorithms are only used when asked for by name */
+  accepted_encodings &= (1u << GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT) - 1;
   const size_t num_supported =
       GPR_BITCOUNT(accepted_encodings) - 1; /* discard NONE */
   if (level == GRPC_COMPRESS_LEVEL_NONE || num_supported == 0) {
@@ -254,7 +281,7 @@ int grpc_message_compression_algorithm_parse(
     *algorithm = GRPC_MESSAGE_COMPRESS_GZIP;
     return 1;
   } else {
-    return 0;
+    return grpc_message_compressor_find_by_name(value, algorithm);
   }
   return 0;
 }
@@ -42,6 +42,19 @@ typedef enum {
   GRPC_STREAM_COMPRESS_ALGORITHMS_COUNT
 } grpc_stream_compression_algorithm;
 
+/* Algorithms added with grpc_compression_algorithm_register take the same
+ * values, from GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE up, as a
+ * grpc_compression_algorithm and as a grpc_message_compression_algorithm, so
+ * that their bits are at the same place in either kind of bitset. */
+#define GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE 16
+#define GRPC_COMPRESS_MAX_REGISTERED_ALGORITHMS 16
+
+/* Returns 1 if \a algorithm is built in or has been registered, 0 otherwise */
+int grpc_compression_algorithm_is_valid(grpc_compression_algorithm algorithm);
+
+/* Bitset of every built in and registered algorithm */
+uint32_t grpc_compression_all_algorithms_bitset(void);
+
 /* Interfaces performing transformation between compression algorithms and
  * levels. */
 
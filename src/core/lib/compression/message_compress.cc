@@ -22,15 +22,53 @@
 
 #include <string.h>
 
+#include <grpc/compression.h>
 #include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
+#include <grpc/support/sync.h>
 
 #include <zlib.h>
 
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/surface/api_trace.h"
 
 #define OUTPUT_BLOCK_SIZE 1024
 
+/* Setting up a zlib stream allocates its whole state (about 256KiB for
+   deflate), which for small messages costs more than the compression itself.
+   Streams are therefore reset rather than ended after use, and kept on free
+   lists sharded by cpu, one list per kind of stream. Pooled streams hold at
+   most ZLIB_POOL_MAX_BYTES of zlib state in total; streams released beyond
+   that are ended. */
+#define ZLIB_POOL_MAX_BYTES (4 * 1024 * 1024)
+
+/* Kinds of stream: the direction, and whether the gzip wrapper is used. All
+   streams are created at the default compression level. */
+#define ZLIB_KIND(decompress, gzip) (((decompress) ? 2 : 0) | ((gzip) ? 1 : 0))
+#define ZLIB_NUM_KINDS 4
+
+typedef struct zlib_context {
+  z_stream zs;
+  /* bytes zlib allocated for zs: zlib only frees them when the stream ends */
+  size_t bytes;
+  struct zlib_context* next;
+} zlib_context;
+
+typedef struct {
+  gpr_mu mu;
+  zlib_context* free_list[ZLIB_NUM_KINDS];
+} zlib_pool_shard;
+
+static gpr_once g_pool_once = GPR_ONCE_INIT;
+static size_t g_pool_num_shards;
+static zlib_pool_shard* g_pool_shards;
+/* bytes of zlib state held by pooled (idle) streams */
+static gpr_atm g_pool_bytes;
+
 static int zlib_body(z_stream* zs, grpc_slice_buffer* input,
                      grpc_slice_buffer* output,
                      int (*flate)(z_stream* zs, int flush)) {
@@ -81,25 +119,119 @@ error:
 }
 
 static void* zalloc_gpr(void* opaque, unsigned int items, unsigned int size) {
+  static_cast<zlib_context*>(opaque)->bytes += items * size;
   return gpr_malloc(items * size);
 }
 
 static void zfree_gpr(void* opaque, void* address) { gpr_free(address); }
 
+static void pool_init(void) {
+  g_pool_num_shards = GPR_MAX(1, gpr_cpu_num_cores());
+  g_pool_shards = static_cast<zlib_pool_shard*>(
+      gpr_zalloc(g_pool_num_shards * sizeof(*g_pool_shards)));
+  for (size_t i = 0; i < g_pool_num_shards; i++) {
+    gpr_mu_init(&g_pool_shards[i].mu);
+  }
+}
+
+static zlib_pool_shard* pool_shard_for_current_cpu(void) {
+  gpr_once_init(&g_pool_once, pool_init);
+  return &g_pool_shards[gpr_cpu_current_cpu() % g_pool_num_shards];
+}
+
+static void zlib_context_destroy(zlib_context* ctx, int kind) {
+  if (kind & 2) {
+    inflateEnd(&ctx->zs);
+  } else {
+    deflateEnd(&ctx->zs);
+  }
+  gpr_free(ctx);
+}
+
+/* Returns a ready to use stream of the given kind, from the pool if one is
+   available */
+static zlib_context* zlib_context_get(int kind) {
+  zlib_pool_shard* shard = pool_shard_for_current_cpu();
+  gpr_mu_lock(&shard->mu);
+  zlib_context* ctx = shard->free_list[kind];
+  if (ctx != nullptr) shard->free_list[kind] = ctx->next;
+  gpr_mu_unlock(&shard->mu);
+  if (ctx != nullptr) {
+    gpr_atm_no_barrier_fetch_add(&g_pool_bytes,
+                                 -static_cast<gpr_atm>(ctx->bytes));
+    /* (de)compression works without grpc_init, which allocates the stats */
+    if (grpc_stats_per_cpu_storage != nullptr) {
+      GRPC_STATS_INC_ZLIB_CONTEXT_POOL_HITS();
+    }
+    return ctx;
+  }
+  if (grpc_stats_per_cpu_storage != nullptr) {
+    GRPC_STATS_INC_ZLIB_CONTEXT_POOL_MISSES();
+  }
+  ctx = static_cast<zlib_context*>(gpr_zalloc(sizeof(*ctx)));
+  ctx->zs.zalloc = zalloc_gpr;
+  ctx->zs.zfree = zfree_gpr;
+  ctx->zs.opaque = ctx;
+  int gzip = kind & 1;
+  int r;
+  if (kind & 2) {
+    r = inflateInit2(&ctx->zs, 15 | (gzip ? 16 : 0));
+  } else {
+    r = deflateInit2(&ctx->zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                     15 | (gzip ? 16 : 0), 8, Z_DEFAULT_STRATEGY);
+  }
+  GPR_ASSERT(r == Z_OK);
+  return ctx;
+}
+
+/* Resets \a ctx and returns it to the pool, or ends it if the pool is full */
+static void zlib_context_release(zlib_context* ctx, int kind) {
+  int r = (kind & 2) ? inflateReset(&ctx->zs) : deflateReset(&ctx->zs);
+  gpr_atm bytes = static_cast<gpr_atm>(ctx->bytes);
+  if (r != Z_OK ||
+      gpr_atm_no_barrier_fetch_add(&g_pool_bytes, bytes) + bytes >
+          ZLIB_POOL_MAX_BYTES) {
+    if (r == Z_OK) gpr_atm_no_barrier_fetch_add(&g_pool_bytes, -bytes);
+    zlib_context_destroy(ctx, kind);
+    return;
+  }
+  zlib_pool_shard* shard = pool_shard_for_current_cpu();
+  gpr_mu_lock(&shard->mu);
+  ctx->next = shard->free_list[kind];
+  shard->free_list[kind] = ctx;
+  gpr_mu_unlock(&shard->mu);
+}
+
+void grpc_msg_compress_pool_flush(void) {
+  gpr_once_init(&g_pool_once, pool_init);
+  for (size_t i = 0; i < g_pool_num_shards; i++) {
+    zlib_pool_shard* shard = &g_pool_shards[i];
+    gpr_mu_lock(&shard->mu);
+    for (int kind = 0; kind < ZLIB_NUM_KINDS; kind++) {
+      zlib_context* ctx = shard->free_list[kind];
+      while (ctx != nullptr) {
+        zlib_context* next = ctx->next;
+        gpr_atm_no_barrier_fetch_add(&g_pool_bytes,
+                                     -static_cast<gpr_atm>(ctx->bytes));
+        zlib_context_destroy(ctx, kind);
+        ctx = next;
+      }
+      shard->free_list[kind] = nullptr;
+    }
+    gpr_mu_unlock(&shard->mu);
+  }
+}
+
 static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
                          int gzip) {
-  z_stream zs;
   int r;
   size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (gzip ? 16 : 0),
-                   8, Z_DEFAULT_STRATEGY);
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, deflate) && output->length < input->length;
+  int kind = ZLIB_KIND(0, gzip);
+  zlib_context* ctx = zlib_context_get(kind);
+  r = zlib_body(&ctx->zs, input, output, deflate) &&
+      output->length < input->length;
   if (!r) {
     for (i = count_before; i < output->count; i++) {
       grpc_slice_unref_internal(output->slices[i]);
@@ -107,23 +239,19 @@ static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
     output->count = count_before;
     output->length = length_before;
   }
-  deflateEnd(&zs);
+  zlib_context_release(ctx, kind);
   return r;
 }
 
 static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
                            int gzip) {
-  z_stream zs;
   int r;
   size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = inflateInit2(&zs, 15 | (gzip ? 16 : 0));
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, inflate);
+  int kind = ZLIB_KIND(1, gzip);
+  zlib_context* ctx = zlib_context_get(kind);
+  r = zlib_body(&ctx->zs, input, output, inflate);
   if (!r) {
     for (i = count_before; i < output->count; i++) {
       grpc_slice_unref_internal(output->slices[i]);
@@ -131,7 +259,7 @@ static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
     output->count = count_before;
     output->length = length_before;
   }
-  inflateEnd(&zs);
+  zlib_context_release(ctx, kind);
   return r;
 }
 
@@ -143,27 +271,153 @@ static int copy(grpc_slice_buffer* input, grpc_slice_buffer* output) {
   return 1;
 }
 
-static int compress_inner(grpc_message_compression_algorithm algorithm,
-                          grpc_slice_buffer* input, grpc_slice_buffer* output) {
-  switch (algorithm) {
-    case GRPC_MESSAGE_COMPRESS_NONE:
-      /* the fallback path always needs to be send uncompressed: we simply
-         rely on that here */
-      return 0;
-    case GRPC_MESSAGE_COMPRESS_DEFLATE:
-      return zlib_compress(input, output, 0);
-    case GRPC_MESSAGE_COMPRESS_GZIP:
-      return zlib_compress(input, output, 1);
-    case GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT:
-      break;
-  }
-  gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
+static int identity_compress(void* user_data, grpc_slice_buffer* input,
+                             grpc_slice_buffer* output) {
+  /* the fallback path always needs to be send uncompressed: we simply
+     rely on that here */
+  return 0;
+}
+
+static int identity_decompress(void* user_data, grpc_slice_buffer* input,
+                               grpc_slice_buffer* output) {
+  return copy(input, output);
+}
+
+static int deflate_compress(void* user_data, grpc_slice_buffer* input,
+                            grpc_slice_buffer* output) {
+  return zlib_compress(input, output, 0);
+}
+
+static int deflate_decompress(void* user_data, grpc_slice_buffer* input,
+                              grpc_slice_buffer* output) {
+  return zlib_decompress(input, output, 0);
+}
+
+static int gzip_compress(void* user_data, grpc_slice_buffer* input,
+                         grpc_slice_buffer* output) {
+  return zlib_compress(input, output, 1);
+}
+
+static int gzip_decompress(void* user_data, grpc_slice_buffer* input,
+                           grpc_slice_buffer* output) {
+  return zlib_decompress(input, output, 1);
+}
+
+/* Indexed by grpc_message_compression_algorithm */
+static const grpc_message_compressor_vtable
+    g_builtin_compressors[GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT] = {
+        {"identity", identity_compress, identity_decompress, nullptr},
+        {"deflate", deflate_compress, deflate_decompress, nullptr},
+        {"gzip", gzip_compress, gzip_decompress, nullptr}};
+
+/* Algorithms added by grpc_compression_algorithm_register. Entries are
+   written under g_registry_mu before g_num_registered is (release) bumped
+   past them, and never change afterwards, so lookups need no lock. */
+static grpc_message_compressor_vtable
+    g_registered_compressors[GRPC_COMPRESS_MAX_REGISTERED_ALGORITHMS];
+static gpr_atm g_num_registered;
+static gpr_once g_registry_once = GPR_ONCE_INIT;
+static gpr_mu g_registry_mu;
+
+static void registry_init(void) { gpr_mu_init(&g_registry_mu); }
+
+/* Names go in grpc-encoding and in the comma separated grpc-accept-encoding,
+   so keep to a conservative subset of HTTP token characters */
+static bool is_valid_compressor_name(const char* name) {
+  if (name == nullptr || name[0] == '\0') return false;
+  for (const char* p = name; *p != '\0'; p++) {
+    if (!((*p >= 'a' && *p <= 'z') || (*p >= '0' && *p <= '9') || *p == '-' ||
+          *p == '.' || *p == '_')) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int grpc_compression_algorithm_register(
+    const grpc_message_compressor_vtable* compressor,
+    grpc_compression_algorithm* algorithm) {
+  GRPC_API_TRACE("grpc_compression_algorithm_register(compressor=%p)", 1,
+                 (compressor));
+  if (!is_valid_compressor_name(compressor->name) ||
+      compressor->compress == nullptr || compressor->decompress == nullptr) {
+    gpr_log(GPR_ERROR, "invalid message compressor '%s'",
+            compressor->name == nullptr ? "(null)" : compressor->name);
+    return 0;
+  }
+  gpr_once_init(&g_registry_once, registry_init);
+  gpr_mu_lock(&g_registry_mu);
+  size_t n = static_cast<size_t>(gpr_atm_no_barrier_load(&g_num_registered));
+  bool taken = false;
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(g_builtin_compressors); i++) {
+    taken |= strcmp(g_builtin_compressors[i].name, compressor->name) == 0;
+  }
+  for (size_t i = 0; i < n; i++) {
+    taken |= strcmp(g_registered_compressors[i].name, compressor->name) == 0;
+  }
+  if (taken) {
+    gpr_mu_unlock(&g_registry_mu);
+    gpr_log(GPR_ERROR, "message compressor '%s' is already registered",
+            compressor->name);
+    return 0;
+  }
+  if (n == GRPC_COMPRESS_MAX_REGISTERED_ALGORITHMS) {
+    gpr_mu_unlock(&g_registry_mu);
+    gpr_log(GPR_ERROR,
+            "can't register message compressor '%s': already have %d",
+            compressor->name, GRPC_COMPRESS_MAX_REGISTERED_ALGORITHMS);
+    return 0;
+  }
+  g_registered_compressors[n] = *compressor;
+  gpr_atm_rel_store(&g_num_registered, static_cast<gpr_atm>(n + 1));
+  gpr_mu_unlock(&g_registry_mu);
+  *algorithm = static_cast<grpc_compression_algorithm>(
+      GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE + n);
+  return 1;
+}
+
+const grpc_message_compressor_vtable* grpc_message_compressor_find(
+    grpc_message_compression_algorithm algorithm) {
+  size_t i = static_cast<size_t>(algorithm);
+  if (i < GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT) {
+    return &g_builtin_compressors[i];
+  }
+  if (i >= GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE) {
+    i -= GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE;
+    if (i < static_cast<size_t>(gpr_atm_acq_load(&g_num_registered))) {
+      return &g_registered_compressors[i];
+    }
+  }
+  return nullptr;
+}
+
+int grpc_message_compressor_find_by_name(
+    grpc_slice name, grpc_message_compression_algorithm* algorithm) {
+  size_t n = static_cast<size_t>(gpr_atm_acq_load(&g_num_registered));
+  for (size_t i = 0; i < n; i++) {
+    if (grpc_slice_str_cmp(name, g_registered_compressors[i].name) == 0) {
+      *algorithm = static_cast<grpc_message_compression_algorithm>(
+          GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE + i);
+      return 1;
+    }
+  }
   return 0;
 }
 
+uint32_t grpc_message_compressor_registered_bitset(void) {
+  size_t n = static_cast<size_t>(gpr_atm_acq_load(&g_num_registered));
+  return ((1u << n) - 1) << GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE;
+}
+
 int grpc_msg_compress(grpc_message_compression_algorithm algorithm,
                       grpc_slice_buffer* input, grpc_slice_buffer* output) {
-  if (!compress_inner(algorithm, input, output)) {
+  const grpc_message_compressor_vtable* compressor =
+      grpc_message_compressor_find(algorithm);
+  if (compressor == nullptr) {
+    gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
+  }
+  if (compressor == nullptr ||
+      !compressor->compress(compressor->user_data, input, output)) {
     copy(input, output);
     return 0;
   }
@@ -172,16 +426,11 @@ int grpc_msg_compress(grpc_message_compression_algorithm algorithm,
 
 int grpc_msg_decompress(grpc_message_compression_algorithm algorithm,
                         grpc_slice_buffer* input, grpc_slice_buffer* output) {
-  switch (algorithm) {
-    case GRPC_MESSAGE_COMPRESS_NONE:
-      return copy(input, output);
-    case GRPC_MESSAGE_COMPRESS_DEFLATE:
-      return zlib_decompress(input, output, 0);
-    case GRPC_MESSAGE_COMPRESS_GZIP:
-      return zlib_decompress(input, output, 1);
-    case GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT:
-      break;
-  }
-  gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
-  return 0;
+  const grpc_message_compressor_vtable* compressor =
+      grpc_message_compressor_find(algorithm);
+  if (compressor == nullptr) {
+    gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
+    return 0;
+  }
+  return compressor->decompress(compressor->user_data, input, output);
 }
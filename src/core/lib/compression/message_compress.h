@@ -21,10 +21,28 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <grpc/compression.h>
 #include <grpc/slice_buffer.h>
 
 #include "src/core/lib/compression/compression_internal.h"
 
+/* Message compression algorithms are implemented by a registry of
+   grpc_message_compressor_vtable: the built in identity, deflate and gzip at
+   their enum values, and those added with grpc_compression_algorithm_register
+   from GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE up. */
+
+/* Returns the compressor for 'algorithm', or NULL if there is none. */
+const grpc_message_compressor_vtable* grpc_message_compressor_find(
+    grpc_message_compression_algorithm algorithm);
+
+/* Looks up a registered (not built in) compressor by name. On success, sets
+   'algorithm' and returns 1; otherwise returns 0. */
+int grpc_message_compressor_find_by_name(
+    grpc_slice name, grpc_message_compression_algorithm* algorithm);
+
+/* Bitset of the algorithms added with grpc_compression_algorithm_register */
+uint32_t grpc_message_compressor_registered_bitset(void);
+
 /* compress 'input' to 'output' using 'algorithm'.
    On success, appends compressed slices to output and returns 1.
    On failure, appends uncompressed slices to output and returns 0. */
@@ -37,4 +55,8 @@ int grpc_msg_compress(grpc_message_compression_algorithm algorithm,
 int grpc_msg_decompress(grpc_message_compression_algorithm algorithm,
                         grpc_slice_buffer* input, grpc_slice_buffer* output);
 
+/* Release the zlib streams kept for reuse by grpc_msg_compress and
+   grpc_msg_decompress */
+void grpc_msg_compress_pool_flush(void);
+
 #endif /* GRPC_CORE_LIB_COMPRESSION_MESSAGE_COMPRESS_H */
@@ -28,6 +28,10 @@
 const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "client_calls_created",
     "server_calls_created",
+    "call_arena_pool_hits",
+    "call_arena_pool_misses",
+    "zlib_context_pool_hits",
+    "zlib_context_pool_misses",
     "cqs_created",
     "client_channels_created",
     "client_subchannels_created",
@@ -40,6 +44,7 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "pollset_kick_wakeup_fd",
     "pollset_kick_wakeup_cv",
     "pollset_kick_own_thread",
+    "pollset_batched_events",
     "syscall_epoll_ctl",
     "pollset_fd_cache_hits",
     "histogram_slow_lookups",
@@ -47,6 +52,8 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "syscall_read",
     "tcp_backup_pollers_created",
     "tcp_backup_poller_polls",
+    "tcp_zerocopy_writes",
+    "tcp_zerocopy_copied",
     "http2_op_batches",
     "http2_op_cancel",
     "http2_op_send_initial_metadata",
@@ -61,6 +68,7 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "http2_writes_offloaded",
     "http2_writes_continued",
     "http2_partial_writes",
+    "http2_writes_coalesced",
     "http2_initiate_write_due_to_initial_write",
     "http2_initiate_write_due_to_start_new_stream",
     "http2_initiate_write_due_to_send_message",
@@ -105,6 +113,7 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "hpack_send_huffman",
     "hpack_send_binary",
     "hpack_send_binary_base64",
+    "hpack_send_cached_block",
     "combiner_locks_initiated",
     "combiner_locks_scheduled_items",
     "combiner_locks_scheduled_final_items",
@@ -119,15 +128,27 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "executor_wakeup_initiated",
     "executor_queue_drained",
     "executor_push_retries",
+    "executor_stolen_items",
     "server_requested_calls",
     "server_slowpath_requests_queued",
     "cq_ev_queue_trylock_failures",
     "cq_ev_queue_trylock_successes",
     "cq_ev_queue_transient_pop_failures",
+    "sync_server_threads_created",
+    "sync_server_threads_reused",
+    "sync_server_work_queued",
+    "adaptive_compression_attempts",
+    "adaptive_compression_skipped",
+    "adaptive_compression_stopped",
+    "adaptive_compression_resumed",
 };
 const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of client side calls created by this process",
     "Number of server side calls created by this process",
+    "Number of call arenas whose first buffer was recycled from the arena pool",
+    "Number of call arenas whose first buffer had to be freshly allocated",
+    "Number of message (de)compressions that reused a pooled zlib stream",
+    "Number of message (de)compressions that had to set up a new zlib stream",
     "Number of completion queues created",
     "Number of client channels created",
     "Number of client subchannels created",
@@ -146,6 +167,9 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "polling wakeup (only valid for epoll1 right now)",
     "How many times could a polling wakeup be satisfied by keeping the waking "
     "thread awake? (only valid for epoll1 right now)",
+    "How many epoll events were handled in the same pass as an earlier event "
+    "from the same epoll_wait, saving a poller hand-off and an ExecCtx flush "
+    "each (only valid for epoll1 with GRPC_EPOLL1_BATCHED_EVENTS)",
     "Number of epoll_ctl calls made (only valid for epollex right now)",
     "Number of epoll_ctl calls skipped because the fd was cached as already "
     "being added.  (only valid for epollex right now)",
@@ -156,6 +180,8 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of read syscalls (or equivalent - eg recvmsg) made by this process",
     "Number of times a backup poller has been created (this can be expensive)",
     "Number of polls performed on the backup poller",
+    "Number of write syscalls issued with MSG_ZEROCOPY",
+    "Number of zerocopy completions for which the kernel fell back to copying",
     "Number of batches received by HTTP2 transport",
     "Number of cancelations received by HTTP2 transport",
     "Number of batches containing send initial metadata",
@@ -172,6 +198,8 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "written",
     "Number of HTTP2 writes that were made knowing there was still more data "
     "to be written (we cap maximum write size to syscall_write)",
+    "Number of HTTP2 writes whose start was held back to coalesce frames from "
+    "more streams",
     "Number of HTTP2 writes initiated due to 'initial_write'",
     "Number of HTTP2 writes initiated due to 'start_new_stream'",
     "Number of HTTP2 writes initiated due to 'send_message'",
@@ -223,6 +251,7 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of huffman encoded strings sent in metadata",
     "Number of binary strings received in metadata",
     "Number of binary strings received encoded in base64 in metadata",
+    "Number of header blocks replayed from the HPACK encoder's block cache",
     "Number of combiner lock entries by process (first items queued to a "
     "combiner)",
     "Number of items scheduled against combiner locks",
@@ -242,6 +271,8 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of times an executor queue was drained",
     "Number of times we raced and were forced to retry pushing a closure to "
     "the executor",
+    "Number of closures an idle executor thread took from the queues of "
+    "another thread",
     "How many calls were requested (not necessarily received) by the server",
     "How many times was the server slow path taken (indicates too few "
     "outstanding requests)",
@@ -251,6 +282,19 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "queue.",
     "Number of times NULL was popped out of completion queue's event queue "
     "even though the event queue was not empty",
+    "Number of threads created by synchronous server thread managers",
+    "Number of times a parked synchronous server thread was woken up "
+    "instead of creating a new thread",
+    "Number of work items a synchronous server queued because its thread "
+    "limit was reached",
+    "Number of messages adaptive message compression compressed to find out "
+    "whether compression pays off for their method",
+    "Number of messages adaptive message compression sent uncompressed "
+    "without trying, because compression was not paying off for their method",
+    "Number of times adaptive message compression stopped compressing the "
+    "messages of a method",
+    "Number of times a probe found compression paying off again and adaptive "
+    "message compression resumed compressing the messages of a method",
 };
 const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "call_initial_size",
@@ -265,7 +309,10 @@ const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "http2_send_message_per_write",
     "http2_send_trailing_metadata_per_write",
     "http2_send_flowctl_per_write",
+    "http2_frames_per_write",
     "server_cqs_checked",
+    "sync_server_queueing_delay",
+    "adaptive_compression_savings",
 };
 const char* grpc_stats_histogram_doc[GRPC_STATS_HISTOGRAM_COUNT] = {
     "Initial size of the grpc_call arena created at call start",
@@ -280,8 +327,13 @@ const char* grpc_stats_histogram_doc[GRPC_STATS_HISTOGRAM_COUNT] = {
     "Number of streams whose payload was written per TCP write",
     "Number of streams terminated per TCP write",
     "Number of flow control updates written per TCP write",
+    "Number of HTTP2 frames framed by the writer per TCP write (control "
+    "frames queued elsewhere are not counted)",
     "How many completion queues were checked looking for a CQ that had "
     "requested the incoming call",
+    "Microseconds work items spent queued for a synchronous server thread",
+    "Percentage of its size that compressing saved, for each message adaptive "
+    "message compression compressed",
 };
 const int grpc_stats_table_0[65] = {
     0,      1,      2,      3,      4,     5,     7,     9,     11,    14,
@@ -350,6 +402,11 @@ const uint8_t grpc_stats_table_7[102] = {
     42, 42, 43, 44, 44, 45, 46, 46, 47, 48, 48, 49, 49, 50, 50, 51, 51};
 const int grpc_stats_table_8[9] = {0, 1, 2, 4, 7, 13, 23, 39, 64};
 const uint8_t grpc_stats_table_9[9] = {0, 0, 1, 2, 2, 3, 4, 4, 5};
+const int grpc_stats_table_10[21] = {0,  1,  2,  3,  4,  5,  7,
+                                     9,  11, 14, 17, 21, 25, 30,
+                                     36, 43, 51, 61, 72, 85, 100};
+const uint8_t grpc_stats_table_11[16] = {0, 0, 1, 2,  3,  3,  4,  5,
+                                         6, 7, 8, 9, 10, 11, 12, 13};
 void grpc_stats_inc_call_initial_size(int value) {
   value = GPR_CLAMP(value, 0, 262144);
   if (value < 6) {
@@ -638,6 +695,31 @@ void grpc_stats_inc_http2_send_flowctl_per_write(int value) {
       GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE,
       grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_6, 64));
 }
+void grpc_stats_inc_http2_frames_per_write(int value) {
+  value = GPR_CLAMP(value, 0, 1024);
+  if (value < 13) {
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_HTTP2_FRAMES_PER_WRITE,
+                             value);
+    return;
+  }
+  union {
+    double dbl;
+    uint64_t uint;
+  } _val, _bkt;
+  _val.dbl = value;
+  if (_val.uint < 4637863191261478912ull) {
+    int bucket =
+        grpc_stats_table_7[((_val.uint - 4623507967449235456ull) >> 48)] + 13;
+    _bkt.dbl = grpc_stats_table_6[bucket];
+    bucket -= (_val.uint < _bkt.uint);
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_HTTP2_FRAMES_PER_WRITE,
+                             bucket);
+    return;
+  }
+  GRPC_STATS_INC_HISTOGRAM(
+      GRPC_STATS_HISTOGRAM_HTTP2_FRAMES_PER_WRITE,
+      grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_6, 64));
+}
 void grpc_stats_inc_server_cqs_checked(int value) {
   value = GPR_CLAMP(value, 0, 64);
   if (value < 3) {
@@ -661,17 +743,69 @@ void grpc_stats_inc_server_cqs_checked(int value) {
       GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED,
       grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_8, 8));
 }
-const int grpc_stats_histo_buckets[13] = {64, 128, 64, 64, 64, 64, 64,
-                                          64, 64,  64, 64, 64, 8};
-const int grpc_stats_histo_start[13] = {0,   64,  192, 256, 320, 384, 448,
-                                        512, 576, 640, 704, 768, 832};
-const int* const grpc_stats_histo_bucket_boundaries[13] = {
-    grpc_stats_table_0, grpc_stats_table_2, grpc_stats_table_4,
-    grpc_stats_table_6, grpc_stats_table_4, grpc_stats_table_4,
-    grpc_stats_table_6, grpc_stats_table_4, grpc_stats_table_6,
-    grpc_stats_table_6, grpc_stats_table_6, grpc_stats_table_6,
-    grpc_stats_table_8};
-void (*const grpc_stats_inc_histogram[13])(int x) = {
+void grpc_stats_inc_sync_server_queueing_delay(int value) {
+  value = GPR_CLAMP(value, 0, 16777216);
+  if (value < 5) {
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_SYNC_SERVER_QUEUEING_DELAY,
+                             value);
+    return;
+  }
+  union {
+    double dbl;
+    uint64_t uint;
+  } _val, _bkt;
+  _val.dbl = value;
+  if (_val.uint < 4683743612465315840ull) {
+    int bucket =
+        grpc_stats_table_5[((_val.uint - 4617315517961601024ull) >> 50)] + 5;
+    _bkt.dbl = grpc_stats_table_4[bucket];
+    bucket -= (_val.uint < _bkt.uint);
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_SYNC_SERVER_QUEUEING_DELAY,
+                             bucket);
+    return;
+  }
+  GRPC_STATS_INC_HISTOGRAM(
+      GRPC_STATS_HISTOGRAM_SYNC_SERVER_QUEUEING_DELAY,
+      grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_4, 64));
+}
+void grpc_stats_inc_adaptive_compression_savings(int value) {
+  value = GPR_CLAMP(value, 0, 100);
+  if (value < 6) {
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_ADAPTIVE_COMPRESSION_SAVINGS,
+                             value);
+    return;
+  }
+  union {
+    double dbl;
+    uint64_t uint;
+  } _val, _bkt;
+  _val.dbl = value;
+  if (_val.uint < 4633078116657397760ull) {
+    int bucket =
+        grpc_stats_table_11[((_val.uint - 4618441417868443648ull) >> 50)] + 6;
+    _bkt.dbl = grpc_stats_table_10[bucket];
+    bucket -= (_val.uint < _bkt.uint);
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_ADAPTIVE_COMPRESSION_SAVINGS,
+                             bucket);
+    return;
+  }
+  GRPC_STATS_INC_HISTOGRAM(
+      GRPC_STATS_HISTOGRAM_ADAPTIVE_COMPRESSION_SAVINGS,
+      grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_10, 20));
+}
+const int grpc_stats_histo_buckets[16] = {64, 128, 64, 64, 64, 64, 64, 64,
+                                          64, 64,  64, 64, 64, 8,  64, 20};
+const int grpc_stats_histo_start[16] = {0,   64,  192, 256, 320, 384,
+                                        448, 512, 576, 640, 704, 768,
+                                        832, 896, 904, 968};
+const int* const grpc_stats_histo_bucket_boundaries[16] = {
+    grpc_stats_table_0, grpc_stats_table_2,  grpc_stats_table_4,
+    grpc_stats_table_6, grpc_stats_table_4,  grpc_stats_table_4,
+    grpc_stats_table_6, grpc_stats_table_4,  grpc_stats_table_6,
+    grpc_stats_table_6, grpc_stats_table_6,  grpc_stats_table_6,
+    grpc_stats_table_6, grpc_stats_table_8,  grpc_stats_table_4,
+    grpc_stats_table_10};
+void (*const grpc_stats_inc_histogram[16])(int x) = {
     grpc_stats_inc_call_initial_size,
     grpc_stats_inc_poll_events_returned,
     grpc_stats_inc_tcp_write_size,
@@ -684,4 +818,7 @@ void (*const grpc_stats_inc_histogram[13])(int x) = {
     grpc_stats_inc_http2_send_message_per_write,
     grpc_stats_inc_http2_send_trailing_metadata_per_write,
     grpc_stats_inc_http2_send_flowctl_per_write,
-    grpc_stats_inc_server_cqs_checked};
+    grpc_stats_inc_http2_frames_per_write,
+    grpc_stats_inc_server_cqs_checked,
+    grpc_stats_inc_sync_server_queueing_delay,
+    grpc_stats_inc_adaptive_compression_savings};
@@ -29,6 +29,10 @@
 typedef enum {
   GRPC_STATS_COUNTER_CLIENT_CALLS_CREATED,
   GRPC_STATS_COUNTER_SERVER_CALLS_CREATED,
+  GRPC_STATS_COUNTER_CALL_ARENA_POOL_HITS,
+  GRPC_STATS_COUNTER_CALL_ARENA_POOL_MISSES,
+  GRPC_STATS_COUNTER_ZLIB_CONTEXT_POOL_HITS,
+  GRPC_STATS_COUNTER_ZLIB_CONTEXT_POOL_MISSES,
   GRPC_STATS_COUNTER_CQS_CREATED,
   GRPC_STATS_COUNTER_CLIENT_CHANNELS_CREATED,
   GRPC_STATS_COUNTER_CLIENT_SUBCHANNELS_CREATED,
@@ -41,6 +45,7 @@ typedef enum {
   GRPC_STATS_COUNTER_POLLSET_KICK_WAKEUP_FD,
   GRPC_STATS_COUNTER_POLLSET_KICK_WAKEUP_CV,
   GRPC_STATS_COUNTER_POLLSET_KICK_OWN_THREAD,
+  GRPC_STATS_COUNTER_POLLSET_BATCHED_EVENTS,
   GRPC_STATS_COUNTER_SYSCALL_EPOLL_CTL,
   GRPC_STATS_COUNTER_POLLSET_FD_CACHE_HITS,
   GRPC_STATS_COUNTER_HISTOGRAM_SLOW_LOOKUPS,
@@ -48,6 +53,8 @@ typedef enum {
   GRPC_STATS_COUNTER_SYSCALL_READ,
   GRPC_STATS_COUNTER_TCP_BACKUP_POLLERS_CREATED,
   GRPC_STATS_COUNTER_TCP_BACKUP_POLLER_POLLS,
+  GRPC_STATS_COUNTER_TCP_ZEROCOPY_WRITES,
+  GRPC_STATS_COUNTER_TCP_ZEROCOPY_COPIED,
   GRPC_STATS_COUNTER_HTTP2_OP_BATCHES,
   GRPC_STATS_COUNTER_HTTP2_OP_CANCEL,
   GRPC_STATS_COUNTER_HTTP2_OP_SEND_INITIAL_METADATA,
@@ -62,6 +69,7 @@ typedef enum {
   GRPC_STATS_COUNTER_HTTP2_WRITES_OFFLOADED,
   GRPC_STATS_COUNTER_HTTP2_WRITES_CONTINUED,
   GRPC_STATS_COUNTER_HTTP2_PARTIAL_WRITES,
+  GRPC_STATS_COUNTER_HTTP2_WRITES_COALESCED,
   GRPC_STATS_COUNTER_HTTP2_INITIATE_WRITE_DUE_TO_INITIAL_WRITE,
   GRPC_STATS_COUNTER_HTTP2_INITIATE_WRITE_DUE_TO_START_NEW_STREAM,
   GRPC_STATS_COUNTER_HTTP2_INITIATE_WRITE_DUE_TO_SEND_MESSAGE,
@@ -106,6 +114,7 @@ typedef enum {
   GRPC_STATS_COUNTER_HPACK_SEND_HUFFMAN,
   GRPC_STATS_COUNTER_HPACK_SEND_BINARY,
   GRPC_STATS_COUNTER_HPACK_SEND_BINARY_BASE64,
+  GRPC_STATS_COUNTER_HPACK_SEND_CACHED_BLOCK,
   GRPC_STATS_COUNTER_COMBINER_LOCKS_INITIATED,
   GRPC_STATS_COUNTER_COMBINER_LOCKS_SCHEDULED_ITEMS,
   GRPC_STATS_COUNTER_COMBINER_LOCKS_SCHEDULED_FINAL_ITEMS,
@@ -120,11 +129,19 @@ typedef enum {
   GRPC_STATS_COUNTER_EXECUTOR_WAKEUP_INITIATED,
   GRPC_STATS_COUNTER_EXECUTOR_QUEUE_DRAINED,
   GRPC_STATS_COUNTER_EXECUTOR_PUSH_RETRIES,
+  GRPC_STATS_COUNTER_EXECUTOR_STOLEN_ITEMS,
   GRPC_STATS_COUNTER_SERVER_REQUESTED_CALLS,
   GRPC_STATS_COUNTER_SERVER_SLOWPATH_REQUESTS_QUEUED,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_FAILURES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES,
+  GRPC_STATS_COUNTER_SYNC_SERVER_THREADS_CREATED,
+  GRPC_STATS_COUNTER_SYNC_SERVER_THREADS_REUSED,
+  GRPC_STATS_COUNTER_SYNC_SERVER_WORK_QUEUED,
+  GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_ATTEMPTS,
+  GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_SKIPPED,
+  GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_STOPPED,
+  GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_RESUMED,
   GRPC_STATS_COUNTER_COUNT
 } grpc_stats_counters;
 extern const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT];
@@ -142,7 +159,10 @@ typedef enum {
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_MESSAGE_PER_WRITE,
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_TRAILING_METADATA_PER_WRITE,
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE,
+  GRPC_STATS_HISTOGRAM_HTTP2_FRAMES_PER_WRITE,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED,
+  GRPC_STATS_HISTOGRAM_SYNC_SERVER_QUEUEING_DELAY,
+  GRPC_STATS_HISTOGRAM_ADAPTIVE_COMPRESSION_SAVINGS,
   GRPC_STATS_HISTOGRAM_COUNT
 } grpc_stats_histograms;
 extern const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT];
@@ -172,15 +192,29 @@ typedef enum {
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_TRAILING_METADATA_PER_WRITE_BUCKETS = 64,
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE_FIRST_SLOT = 768,
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE_BUCKETS = 64,
-  GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED_FIRST_SLOT = 832,
+  GRPC_STATS_HISTOGRAM_HTTP2_FRAMES_PER_WRITE_FIRST_SLOT = 832,
+  GRPC_STATS_HISTOGRAM_HTTP2_FRAMES_PER_WRITE_BUCKETS = 64,
+  GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED_FIRST_SLOT = 896,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED_BUCKETS = 8,
-  GRPC_STATS_HISTOGRAM_BUCKETS = 840
+  GRPC_STATS_HISTOGRAM_SYNC_SERVER_QUEUEING_DELAY_FIRST_SLOT = 904,
+  GRPC_STATS_HISTOGRAM_SYNC_SERVER_QUEUEING_DELAY_BUCKETS = 64,
+  GRPC_STATS_HISTOGRAM_ADAPTIVE_COMPRESSION_SAVINGS_FIRST_SLOT = 968,
+  GRPC_STATS_HISTOGRAM_ADAPTIVE_COMPRESSION_SAVINGS_BUCKETS = 20,
+  GRPC_STATS_HISTOGRAM_BUCKETS = 988
 } grpc_stats_histogram_constants;
 #if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
 #define GRPC_STATS_INC_CLIENT_CALLS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CLIENT_CALLS_CREATED)
 #define GRPC_STATS_INC_SERVER_CALLS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_CALLS_CREATED)
+#define GRPC_STATS_INC_CALL_ARENA_POOL_HITS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_ARENA_POOL_HITS)
+#define GRPC_STATS_INC_CALL_ARENA_POOL_MISSES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CALL_ARENA_POOL_MISSES)
+#define GRPC_STATS_INC_ZLIB_CONTEXT_POOL_HITS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_ZLIB_CONTEXT_POOL_HITS)
+#define GRPC_STATS_INC_ZLIB_CONTEXT_POOL_MISSES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_ZLIB_CONTEXT_POOL_MISSES)
 #define GRPC_STATS_INC_CQS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQS_CREATED)
 #define GRPC_STATS_INC_CLIENT_CHANNELS_CREATED() \
@@ -205,6 +239,8 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_POLLSET_KICK_WAKEUP_CV)
 #define GRPC_STATS_INC_POLLSET_KICK_OWN_THREAD() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_POLLSET_KICK_OWN_THREAD)
+#define GRPC_STATS_INC_POLLSET_BATCHED_EVENTS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_POLLSET_BATCHED_EVENTS)
 #define GRPC_STATS_INC_SYSCALL_EPOLL_CTL() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SYSCALL_EPOLL_CTL)
 #define GRPC_STATS_INC_POLLSET_FD_CACHE_HITS() \
@@ -219,6 +255,10 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_BACKUP_POLLERS_CREATED)
 #define GRPC_STATS_INC_TCP_BACKUP_POLLER_POLLS() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_BACKUP_POLLER_POLLS)
+#define GRPC_STATS_INC_TCP_ZEROCOPY_WRITES() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_ZEROCOPY_WRITES)
+#define GRPC_STATS_INC_TCP_ZEROCOPY_COPIED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_ZEROCOPY_COPIED)
 #define GRPC_STATS_INC_HTTP2_OP_BATCHES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_OP_BATCHES)
 #define GRPC_STATS_INC_HTTP2_OP_CANCEL() \
@@ -247,6 +287,8 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_WRITES_CONTINUED)
 #define GRPC_STATS_INC_HTTP2_PARTIAL_WRITES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_PARTIAL_WRITES)
+#define GRPC_STATS_INC_HTTP2_WRITES_COALESCED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_WRITES_COALESCED)
 #define GRPC_STATS_INC_HTTP2_INITIATE_WRITE_DUE_TO_INITIAL_WRITE() \
   GRPC_STATS_INC_COUNTER(                                          \
       GRPC_STATS_COUNTER_HTTP2_INITIATE_WRITE_DUE_TO_INITIAL_WRITE)
@@ -356,6 +398,8 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HPACK_SEND_BINARY)
 #define GRPC_STATS_INC_HPACK_SEND_BINARY_BASE64() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HPACK_SEND_BINARY_BASE64)
+#define GRPC_STATS_INC_HPACK_SEND_CACHED_BLOCK() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HPACK_SEND_CACHED_BLOCK)
 #define GRPC_STATS_INC_COMBINER_LOCKS_INITIATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_COMBINER_LOCKS_INITIATED)
 #define GRPC_STATS_INC_COMBINER_LOCKS_SCHEDULED_ITEMS() \
@@ -385,6 +429,8 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_EXECUTOR_QUEUE_DRAINED)
 #define GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_EXECUTOR_PUSH_RETRIES)
+#define GRPC_STATS_INC_EXECUTOR_STOLEN_ITEMS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_EXECUTOR_STOLEN_ITEMS)
 #define GRPC_STATS_INC_SERVER_REQUESTED_CALLS() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_REQUESTED_CALLS)
 #define GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED() \
@@ -395,6 +441,20 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_SUCCESSES)
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES)
+#define GRPC_STATS_INC_SYNC_SERVER_THREADS_CREATED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SYNC_SERVER_THREADS_CREATED)
+#define GRPC_STATS_INC_SYNC_SERVER_THREADS_REUSED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SYNC_SERVER_THREADS_REUSED)
+#define GRPC_STATS_INC_SYNC_SERVER_WORK_QUEUED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SYNC_SERVER_WORK_QUEUED)
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_ATTEMPTS() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_ATTEMPTS)
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_SKIPPED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_SKIPPED)
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_STOPPED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_STOPPED)
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_RESUMED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_ADAPTIVE_COMPRESSION_RESUMED)
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value) \
   grpc_stats_inc_call_initial_size((int)(value))
 void grpc_stats_inc_call_initial_size(int x);
@@ -431,12 +491,25 @@ void grpc_stats_inc_http2_send_trailing_metadata_per_write(int x);
 #define GRPC_STATS_INC_HTTP2_SEND_FLOWCTL_PER_WRITE(value) \
   grpc_stats_inc_http2_send_flowctl_per_write((int)(value))
 void grpc_stats_inc_http2_send_flowctl_per_write(int x);
+#define GRPC_STATS_INC_HTTP2_FRAMES_PER_WRITE(value) \
+  grpc_stats_inc_http2_frames_per_write((int)(value))
+void grpc_stats_inc_http2_frames_per_write(int x);
 #define GRPC_STATS_INC_SERVER_CQS_CHECKED(value) \
   grpc_stats_inc_server_cqs_checked((int)(value))
 void grpc_stats_inc_server_cqs_checked(int x);
+#define GRPC_STATS_INC_SYNC_SERVER_QUEUEING_DELAY(value) \
+  grpc_stats_inc_sync_server_queueing_delay((int)(value))
+void grpc_stats_inc_sync_server_queueing_delay(int x);
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_SAVINGS(value) \
+  grpc_stats_inc_adaptive_compression_savings((int)(value))
+void grpc_stats_inc_adaptive_compression_savings(int x);
 #else
 #define GRPC_STATS_INC_CLIENT_CALLS_CREATED()
 #define GRPC_STATS_INC_SERVER_CALLS_CREATED()
+#define GRPC_STATS_INC_CALL_ARENA_POOL_HITS()
+#define GRPC_STATS_INC_CALL_ARENA_POOL_MISSES()
+#define GRPC_STATS_INC_ZLIB_CONTEXT_POOL_HITS()
+#define GRPC_STATS_INC_ZLIB_CONTEXT_POOL_MISSES()
 #define GRPC_STATS_INC_CQS_CREATED()
 #define GRPC_STATS_INC_CLIENT_CHANNELS_CREATED()
 #define GRPC_STATS_INC_CLIENT_SUBCHANNELS_CREATED()
@@ -449,6 +522,7 @@ void grpc_stats_inc_server_cqs_checked(int x);
 #define GRPC_STATS_INC_POLLSET_KICK_WAKEUP_FD()
 #define GRPC_STATS_INC_POLLSET_KICK_WAKEUP_CV()
 #define GRPC_STATS_INC_POLLSET_KICK_OWN_THREAD()
+#define GRPC_STATS_INC_POLLSET_BATCHED_EVENTS()
 #define GRPC_STATS_INC_SYSCALL_EPOLL_CTL()
 #define GRPC_STATS_INC_POLLSET_FD_CACHE_HITS()
 #define GRPC_STATS_INC_HISTOGRAM_SLOW_LOOKUPS()
@@ -456,6 +530,8 @@ void grpc_stats_inc_server_cqs_checked(int x);
 #define GRPC_STATS_INC_SYSCALL_READ()
 #define GRPC_STATS_INC_TCP_BACKUP_POLLERS_CREATED()
 #define GRPC_STATS_INC_TCP_BACKUP_POLLER_POLLS()
+#define GRPC_STATS_INC_TCP_ZEROCOPY_WRITES()
+#define GRPC_STATS_INC_TCP_ZEROCOPY_COPIED()
 #define GRPC_STATS_INC_HTTP2_OP_BATCHES()
 #define GRPC_STATS_INC_HTTP2_OP_CANCEL()
 #define GRPC_STATS_INC_HTTP2_OP_SEND_INITIAL_METADATA()
@@ -470,6 +546,7 @@ void grpc_stats_inc_server_cqs_checked(int x);
 #define GRPC_STATS_INC_HTTP2_WRITES_OFFLOADED()
 #define GRPC_STATS_INC_HTTP2_WRITES_CONTINUED()
 #define GRPC_STATS_INC_HTTP2_PARTIAL_WRITES()
+#define GRPC_STATS_INC_HTTP2_WRITES_COALESCED()
 #define GRPC_STATS_INC_HTTP2_INITIATE_WRITE_DUE_TO_INITIAL_WRITE()
 #define GRPC_STATS_INC_HTTP2_INITIATE_WRITE_DUE_TO_START_NEW_STREAM()
 #define GRPC_STATS_INC_HTTP2_INITIATE_WRITE_DUE_TO_SEND_MESSAGE()
@@ -514,6 +591,7 @@ void grpc_stats_inc_server_cqs_checked(int x);
 #define GRPC_STATS_INC_HPACK_SEND_HUFFMAN()
 #define GRPC_STATS_INC_HPACK_SEND_BINARY()
 #define GRPC_STATS_INC_HPACK_SEND_BINARY_BASE64()
+#define GRPC_STATS_INC_HPACK_SEND_CACHED_BLOCK()
 #define GRPC_STATS_INC_COMBINER_LOCKS_INITIATED()
 #define GRPC_STATS_INC_COMBINER_LOCKS_SCHEDULED_ITEMS()
 #define GRPC_STATS_INC_COMBINER_LOCKS_SCHEDULED_FINAL_ITEMS()
@@ -528,11 +606,19 @@ void grpc_stats_inc_server_cqs_checked(int x);
 #define GRPC_STATS_INC_EXECUTOR_WAKEUP_INITIATED()
 #define GRPC_STATS_INC_EXECUTOR_QUEUE_DRAINED()
 #define GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES()
+#define GRPC_STATS_INC_EXECUTOR_STOLEN_ITEMS()
 #define GRPC_STATS_INC_SERVER_REQUESTED_CALLS()
 #define GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_FAILURES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_SUCCESSES()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRANSIENT_POP_FAILURES()
+#define GRPC_STATS_INC_SYNC_SERVER_THREADS_CREATED()
+#define GRPC_STATS_INC_SYNC_SERVER_THREADS_REUSED()
+#define GRPC_STATS_INC_SYNC_SERVER_WORK_QUEUED()
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_ATTEMPTS()
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_SKIPPED()
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_STOPPED()
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_RESUMED()
 #define GRPC_STATS_INC_CALL_INITIAL_SIZE(value)
 #define GRPC_STATS_INC_POLL_EVENTS_RETURNED(value)
 #define GRPC_STATS_INC_TCP_WRITE_SIZE(value)
@@ -545,11 +631,14 @@ void grpc_stats_inc_server_cqs_checked(int x);
 #define GRPC_STATS_INC_HTTP2_SEND_MESSAGE_PER_WRITE(value)
 #define GRPC_STATS_INC_HTTP2_SEND_TRAILING_METADATA_PER_WRITE(value)
 #define GRPC_STATS_INC_HTTP2_SEND_FLOWCTL_PER_WRITE(value)
+#define GRPC_STATS_INC_HTTP2_FRAMES_PER_WRITE(value)
 #define GRPC_STATS_INC_SERVER_CQS_CHECKED(value)
+#define GRPC_STATS_INC_SYNC_SERVER_QUEUEING_DELAY(value)
+#define GRPC_STATS_INC_ADAPTIVE_COMPRESSION_SAVINGS(value)
 #endif /* defined(GRPC_COLLECT_STATS) || !defined(NDEBUG) */
-extern const int grpc_stats_histo_buckets[13];
-extern const int grpc_stats_histo_start[13];
-extern const int* const grpc_stats_histo_bucket_boundaries[13];
-extern void (*const grpc_stats_inc_histogram[13])(int x);
+extern const int grpc_stats_histo_buckets[16];
+extern const int grpc_stats_histo_start[16];
+extern const int* const grpc_stats_histo_bucket_boundaries[16];
+extern void (*const grpc_stats_inc_histogram[16])(int x);
 
 #endif /* GRPC_CORE_LIB_DEBUG_STATS_DATA_H */
@@ -1,5 +1,9 @@
 client_calls_created_per_iteration:FLOAT,
 server_calls_created_per_iteration:FLOAT,
+call_arena_pool_hits_per_iteration:FLOAT,
+call_arena_pool_misses_per_iteration:FLOAT,
+zlib_context_pool_hits_per_iteration:FLOAT,
+zlib_context_pool_misses_per_iteration:FLOAT,
 cqs_created_per_iteration:FLOAT,
 client_channels_created_per_iteration:FLOAT,
 client_subchannels_created_per_iteration:FLOAT,
@@ -12,6 +16,7 @@ pollset_kicked_again_per_iteration:FLOAT,
 pollset_kick_wakeup_fd_per_iteration:FLOAT,
 pollset_kick_wakeup_cv_per_iteration:FLOAT,
 pollset_kick_own_thread_per_iteration:FLOAT,
+pollset_batched_events_per_iteration:FLOAT,
 syscall_epoll_ctl_per_iteration:FLOAT,
 pollset_fd_cache_hits_per_iteration:FLOAT,
 histogram_slow_lookups_per_iteration:FLOAT,
@@ -19,6 +24,8 @@ syscall_write_per_iteration:FLOAT,
 syscall_read_per_iteration:FLOAT,
 tcp_backup_pollers_created_per_iteration:FLOAT,
 tcp_backup_poller_polls_per_iteration:FLOAT,
+tcp_zerocopy_writes_per_iteration:FLOAT,
+tcp_zerocopy_copied_per_iteration:FLOAT,
 http2_op_batches_per_iteration:FLOAT,
 http2_op_cancel_per_iteration:FLOAT,
 http2_op_send_initial_metadata_per_iteration:FLOAT,
@@ -33,6 +40,7 @@ http2_writes_begun_per_iteration:FLOAT,
 http2_writes_offloaded_per_iteration:FLOAT,
 http2_writes_continued_per_iteration:FLOAT,
 http2_partial_writes_per_iteration:FLOAT,
+http2_writes_coalesced_per_iteration:FLOAT,
 http2_initiate_write_due_to_initial_write_per_iteration:FLOAT,
 http2_initiate_write_due_to_start_new_stream_per_iteration:FLOAT,
 http2_initiate_write_due_to_send_message_per_iteration:FLOAT,
@@ -77,6 +85,7 @@ hpack_send_uncompressed_per_iteration:FLOAT,
 hpack_send_huffman_per_iteration:FLOAT,
 hpack_send_binary_per_iteration:FLOAT,
 hpack_send_binary_base64_per_iteration:FLOAT,
+hpack_send_cached_block_per_iteration:FLOAT,
 combiner_locks_initiated_per_iteration:FLOAT,
 combiner_locks_scheduled_items_per_iteration:FLOAT,
 combiner_locks_scheduled_final_items_per_iteration:FLOAT,
@@ -91,8 +100,16 @@ executor_scheduled_to_self_per_iteration:FLOAT,
 executor_wakeup_initiated_per_iteration:FLOAT,
 executor_queue_drained_per_iteration:FLOAT,
 executor_push_retries_per_iteration:FLOAT,
+executor_stolen_items_per_iteration:FLOAT,
 server_requested_calls_per_iteration:FLOAT,
 server_slowpath_requests_queued_per_iteration:FLOAT,
 cq_ev_queue_trylock_failures_per_iteration:FLOAT,
 cq_ev_queue_trylock_successes_per_iteration:FLOAT,
-cq_ev_queue_transient_pop_failures_per_iteration:FLOAT
+cq_ev_queue_transient_pop_failures_per_iteration:FLOAT,
+sync_server_threads_created_per_iteration:FLOAT,
+sync_server_threads_reused_per_iteration:FLOAT,
+sync_server_work_queued_per_iteration:FLOAT,
+adaptive_compression_attempts_per_iteration:FLOAT,
+adaptive_compression_skipped_per_iteration:FLOAT,
+adaptive_compression_stopped_per_iteration:FLOAT,
+adaptive_compression_resumed_per_iteration:FLOAT
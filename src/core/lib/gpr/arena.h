@@ -16,11 +16,8 @@
  *
  */
 
-// \file Arena based allocator
-// Allows very fast allocation of memory, but that memory cannot be freed until
-// the arena as a whole is freed
-// Tracks the total memory allocated against it, so that future arenas can
-// pre-allocate the right amount of memory
+// \file C style wrappers around grpc_core::Arena (see
+// src/core/lib/gprpp/arena.h), which new code should use directly
 
 #ifndef GRPC_CORE_LIB_GPR_ARENA_H
 #define GRPC_CORE_LIB_GPR_ARENA_H
@@ -29,13 +26,27 @@
 
 #include <stddef.h>
 
-typedef struct gpr_arena gpr_arena;
+#include "src/core/lib/gprpp/arena.h"
+
+typedef grpc_core::Arena gpr_arena;
 
 // Create an arena, with \a initial_size bytes in the first allocated buffer
-gpr_arena* gpr_arena_create(size_t initial_size);
+inline gpr_arena* gpr_arena_create(size_t initial_size) {
+  return grpc_core::Arena::Create(initial_size);
+}
+// Create an arena like gpr_arena_create(), but recycle the first buffer from a
+// per-cpu pool of previously destroyed arenas when one of a suitable size is
+// available. Sets \a *pool_hit to whether the buffer came from the pool.
+inline gpr_arena* gpr_arena_create_pooled(size_t initial_size, bool* pool_hit) {
+  return grpc_core::Arena::CreatePooled(initial_size, pool_hit);
+}
 // Allocate \a size bytes from the arena
-void* gpr_arena_alloc(gpr_arena* arena, size_t size);
+inline void* gpr_arena_alloc(gpr_arena* arena, size_t size) {
+  return arena->Alloc(size);
+}
 // Destroy an arena, returning the total number of bytes allocated
-size_t gpr_arena_destroy(gpr_arena* arena);
+inline size_t gpr_arena_destroy(gpr_arena* arena) { return arena->Destroy(); }
+// Free all buffers cached by the arena pool
+inline void gpr_arena_pool_flush(void) { grpc_core::Arena::FlushPool(); }
 
 #endif /* GRPC_CORE_LIB_GPR_ARENA_H */
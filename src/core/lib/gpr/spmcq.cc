@@ -0,0 +1,103 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/gpr/spmcq.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#define INITIAL_CAPACITY 64
+
+static gpr_spmcq_buffer* buffer_create(size_t capacity) {
+  gpr_spmcq_buffer* b = static_cast<gpr_spmcq_buffer*>(gpr_malloc(
+      sizeof(gpr_spmcq_buffer) + (capacity - 1) * sizeof(gpr_atm)));
+  b->mask = capacity - 1;
+  b->retired_next = nullptr;
+  return b;
+}
+
+void gpr_spmcq_init(gpr_spmcq* q) {
+  gpr_atm_no_barrier_store(&q->top, 0);
+  gpr_atm_no_barrier_store(&q->bottom, 0);
+  gpr_atm_no_barrier_store(&q->buffer,
+                           (gpr_atm)buffer_create(INITIAL_CAPACITY));
+  q->retired = nullptr;
+}
+
+void gpr_spmcq_destroy(gpr_spmcq* q) {
+  gpr_free(reinterpret_cast<gpr_spmcq_buffer*>(
+      gpr_atm_no_barrier_load(&q->buffer)));
+  while (q->retired != nullptr) {
+    gpr_spmcq_buffer* next = q->retired->retired_next;
+    gpr_free(q->retired);
+    q->retired = next;
+  }
+}
+
+// Replace the (full) buffer of q with one twice as large, holding the items
+// from top to bottom
+static gpr_spmcq_buffer* grow(gpr_spmcq* q, gpr_spmcq_buffer* old,
+                              gpr_atm top, gpr_atm bottom) {
+  gpr_spmcq_buffer* b = buffer_create(2 * (old->mask + 1));
+  for (gpr_atm i = top; i < bottom; i++) {
+    gpr_atm_no_barrier_store(
+        &b->items[i & b->mask],
+        gpr_atm_no_barrier_load(&old->items[i & old->mask]));
+  }
+  gpr_atm_rel_store(&q->buffer, (gpr_atm)b);
+  old->retired_next = q->retired;
+  q->retired = old;
+  return b;
+}
+
+void gpr_spmcq_push(gpr_spmcq* q, void* item) {
+  GPR_ASSERT(item != nullptr);
+  gpr_atm bottom = gpr_atm_no_barrier_load(&q->bottom);
+  gpr_atm top = gpr_atm_acq_load(&q->top);
+  gpr_spmcq_buffer* b =
+      reinterpret_cast<gpr_spmcq_buffer*>(gpr_atm_no_barrier_load(&q->buffer));
+  if (static_cast<size_t>(bottom - top) > b->mask) {
+    b = grow(q, b, top, bottom);
+  }
+  gpr_atm_no_barrier_store(&b->items[bottom & b->mask], (gpr_atm)item);
+  // publish the item (and the buffer it is in) to consumers
+  gpr_atm_rel_store(&q->bottom, bottom + 1);
+}
+
+void* gpr_spmcq_pop(gpr_spmcq* q) {
+  for (;;) {
+    gpr_atm top = gpr_atm_acq_load(&q->top);
+    gpr_atm bottom = gpr_atm_acq_load(&q->bottom);
+    if (top >= bottom) return nullptr;
+    gpr_spmcq_buffer* b =
+        reinterpret_cast<gpr_spmcq_buffer*>(gpr_atm_acq_load(&q->buffer));
+    // The slot cannot have been reused yet: the producer only wraps around
+    // onto it once top has moved past it, in which case the cas fails
+    void* item = reinterpret_cast<void*>(
+        gpr_atm_no_barrier_load(&b->items[top & b->mask]));
+    if (gpr_atm_full_cas(&q->top, top, top + 1)) return item;
+  }
+}
+
+size_t gpr_spmcq_size(gpr_spmcq* q) {
+  gpr_atm top = gpr_atm_acq_load(&q->top);
+  gpr_atm bottom = gpr_atm_acq_load(&q->bottom);
+  return top < bottom ? static_cast<size_t>(bottom - top) : 0;
+}
@@ -0,0 +1,64 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_GPR_SPMCQ_H
+#define GRPC_CORE_LIB_GPR_SPMCQ_H
+
+#include <grpc/support/port_platform.h>
+
+#include <grpc/support/atm.h>
+#include <stddef.h>
+
+// Single-producer multiple-consumer lock free queue, for work stealing.
+// This is the work-stealing deque of Chase and Lev ("Dynamic Circular
+// Work-Stealing Deque", SPAA 2005) with the owner taking items from the
+// stealing end too, so that items are consumed in FIFO order: the owner pushes
+// at the bottom, and any thread (the owner included) pops from the top.
+// The buffer grows as needed; buffers outgrown are kept until the queue is
+// destroyed, since a consumer may still be reading from them.
+
+typedef struct gpr_spmcq_buffer {
+  size_t mask;  // capacity - 1; the capacity is a power of two
+  struct gpr_spmcq_buffer* retired_next;
+  gpr_atm items[1];
+} gpr_spmcq_buffer;
+
+typedef struct gpr_spmcq {
+  gpr_atm top;
+  // make sure the consumer and producer ends don't share a cacheline
+  char padding[GPR_CACHELINE_SIZE];
+  gpr_atm bottom;
+  gpr_atm buffer;
+  gpr_spmcq_buffer* retired;
+} gpr_spmcq;
+
+void gpr_spmcq_init(gpr_spmcq* q);
+// Frees the buffers of the queue, which must not be used concurrently anymore;
+// items still queued are dropped
+void gpr_spmcq_destroy(gpr_spmcq* q);
+// Push a (non-null) item
+// Thread compatible - can only be called from the owner of the queue
+void gpr_spmcq_push(gpr_spmcq* q, void* item);
+// Pop the oldest item, or return NULL if the queue is empty
+// Thread safe - can be called from multiple threads concurrently
+void* gpr_spmcq_pop(gpr_spmcq* q);
+// Return the number of items in the queue (a snapshot, which may already be
+// stale if other threads use the queue)
+size_t gpr_spmcq_size(gpr_spmcq* q);
+
+#endif /* GRPC_CORE_LIB_GPR_SPMCQ_H */
@@ -0,0 +1,277 @@
+/*
+ *
+ * Copyright 2017 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/gprpp/arena.h"
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/useful.h"
+
+// Uncomment this to give every allocation its own buffer instead of carving
+// it out of a shared zone.  This effectively eliminates the efficiency gain of
+// using an arena, but it may be useful for debugging purposes.
+//#define SIMPLE_ARENA_FOR_DEBUGGING
+
+namespace grpc_core {
+
+namespace {
+
+// Buffers are not zeroed when they are allocated: Alloc() zeroes just the
+// bytes it hands out, so that the unused tail of a large initial zone is never
+// touched.
+void* AllocAligned(size_t size) {
+  return gpr_malloc_aligned(size, GPR_MAX_ALIGNMENT);
+}
+
+size_t AlignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// The arena pool keeps the first buffer of destroyed pooled arenas on free
+// lists bucketed by power of two sizes. The largest bucket matches the upper
+// bound of the call_initial_size histogram; arenas larger than that are not
+// pooled. Free lists are sharded by cpu so that a call created and destroyed
+// on the same core reuses a buffer that is likely still in its cache.
+constexpr int kPoolMinBucketShift = 10;
+constexpr int kPoolMaxBucketShift = 18;
+constexpr int kPoolNumBuckets = kPoolMaxBucketShift - kPoolMinBucketShift + 1;
+// Maximum number of buffers cached per bucket in each shard
+constexpr size_t kPoolMaxCachedPerBucket = 16;
+
+struct PooledBuffer {
+  PooledBuffer* next;
+};
+
+struct PoolShard {
+  gpr_mu mu;
+  PooledBuffer* free_list[kPoolNumBuckets];
+  size_t num_cached[kPoolNumBuckets];
+};
+
+gpr_once g_pool_once = GPR_ONCE_INIT;
+size_t g_pool_num_shards;
+PoolShard* g_pool_shards;
+
+void PoolInit() {
+  g_pool_num_shards = GPR_MAX(1, gpr_cpu_num_cores());
+  g_pool_shards = static_cast<PoolShard*>(
+      gpr_zalloc(g_pool_num_shards * sizeof(PoolShard)));
+  for (size_t i = 0; i < g_pool_num_shards; i++) {
+    gpr_mu_init(&g_pool_shards[i].mu);
+  }
+}
+
+PoolShard* PoolShardForCurrentCpu() {
+  gpr_once_init(&g_pool_once, PoolInit);
+  return &g_pool_shards[gpr_cpu_current_cpu() % g_pool_num_shards];
+}
+
+// Returns the smallest bucket whose buffers hold \a size bytes, or -1 if
+// \a size is too large to be pooled
+int PoolBucketForSize(size_t size) {
+  int shift = kPoolMinBucketShift;
+  while ((static_cast<size_t>(1) << shift) < size) {
+    if (++shift > kPoolMaxBucketShift) return -1;
+  }
+  return shift - kPoolMinBucketShift;
+}
+
+size_t PoolBucketSize(int bucket) {
+  return static_cast<size_t>(1) << (bucket + kPoolMinBucketShift);
+}
+
+void PoolRelease(void* buffer, int bucket) {
+  PooledBuffer* pooled = static_cast<PooledBuffer*>(buffer);
+  PoolShard* shard = PoolShardForCurrentCpu();
+  gpr_mu_lock(&shard->mu);
+  if (shard->num_cached[bucket] < kPoolMaxCachedPerBucket) {
+    pooled->next = shard->free_list[bucket];
+    shard->free_list[bucket] = pooled;
+    shard->num_cached[bucket]++;
+    pooled = nullptr;
+  }
+  gpr_mu_unlock(&shard->mu);
+  if (pooled != nullptr) {
+    gpr_free_aligned(pooled);
+  }
+}
+
+}  // namespace
+
+Arena::Arena(size_t initial_zone_size, int pool_bucket)
+    : initial_zone_size_(initial_zone_size),
+      pool_bucket_(pool_bucket),
+      last_zone_(nullptr),
+      overflow_used_(0) {
+  gpr_atm_no_barrier_store(&initial_zone_used_, 0);
+  gpr_atm_no_barrier_store(&destructibles_, 0);
+  gpr_mu_init(&growth_mu_);
+}
+
+Arena::~Arena() { gpr_mu_destroy(&growth_mu_); }
+
+Arena* Arena::Create(size_t initial_size) {
+  initial_size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
+  void* mem = AllocAligned(GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena)) +
+                           initial_size);
+  return new (mem) Arena(initial_size, -1);
+}
+
+Arena* Arena::CreatePooled(size_t initial_size, bool* pool_hit) {
+  int bucket = PoolBucketForSize(initial_size);
+  if (bucket < 0) {
+    *pool_hit = false;
+    return Create(initial_size);
+  }
+  PoolShard* shard = PoolShardForCurrentCpu();
+  gpr_mu_lock(&shard->mu);
+  PooledBuffer* buffer = shard->free_list[bucket];
+  if (buffer != nullptr) {
+    shard->free_list[bucket] = buffer->next;
+    shard->num_cached[bucket]--;
+  }
+  gpr_mu_unlock(&shard->mu);
+  *pool_hit = buffer != nullptr;
+  size_t zone_size = PoolBucketSize(bucket);
+  void* mem =
+      buffer != nullptr
+          ? static_cast<void*>(buffer)
+          : AllocAligned(GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena)) +
+                         zone_size);
+  return new (mem) Arena(zone_size, bucket);
+}
+
+void Arena::FlushPool() {
+  gpr_once_init(&g_pool_once, PoolInit);
+  for (size_t i = 0; i < g_pool_num_shards; i++) {
+    PoolShard* shard = &g_pool_shards[i];
+    gpr_mu_lock(&shard->mu);
+    for (int bucket = 0; bucket < kPoolNumBuckets; bucket++) {
+      PooledBuffer* buffer = shard->free_list[bucket];
+      while (buffer != nullptr) {
+        PooledBuffer* next = buffer->next;
+        gpr_free_aligned(buffer);
+        buffer = next;
+      }
+      shard->free_list[bucket] = nullptr;
+      shard->num_cached[bucket] = 0;
+    }
+    gpr_mu_unlock(&shard->mu);
+  }
+}
+
+size_t Arena::Destroy() {
+  Destructible* obj =
+      reinterpret_cast<Destructible*>(gpr_atm_acq_load(&destructibles_));
+  while (obj != nullptr) {
+    Destructible* next = obj->next;
+    obj->destroy(obj);
+    obj = next;
+  }
+  size_t size = GPR_MIN(
+      static_cast<size_t>(gpr_atm_no_barrier_load(&initial_zone_used_)),
+      initial_zone_size_) + overflow_used_;
+  Zone* z = last_zone_;
+  int pool_bucket = pool_bucket_;
+  this->~Arena();
+  if (pool_bucket >= 0) {
+    PoolRelease(this, pool_bucket);
+  } else {
+    gpr_free_aligned(this);
+  }
+  while (z != nullptr) {
+    Zone* next_z = z->next;
+    gpr_free_aligned(z);
+    z = next_z;
+  }
+  return size;
+}
+
+void* Arena::Alloc(size_t size, size_t alignment) {
+  GPR_DEBUG_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  GPR_DEBUG_ASSERT(alignment <= GPR_MAX_ALIGNMENT);
+#ifndef SIMPLE_ARENA_FOR_DEBUGGING
+  // Bump allocate out of the initial zone. Unlike a plain fetch-add, the CAS
+  // only claims the space when the allocation fits, so an allocation that
+  // spills into an overflow zone does not burn the rest of the initial zone.
+  gpr_atm used = gpr_atm_no_barrier_load(&initial_zone_used_);
+  for (;;) {
+    size_t begin = AlignUp(static_cast<size_t>(used), alignment);
+    size_t end = begin + size;
+    if (end > initial_zone_size_) break;
+    if (gpr_atm_no_barrier_cas(&initial_zone_used_, used,
+                               static_cast<gpr_atm>(end))) {
+      void* result = initial_zone_start() + begin;
+      memset(result, 0, size);
+      return result;
+    }
+    used = gpr_atm_no_barrier_load(&initial_zone_used_);
+  }
+#endif  // SIMPLE_ARENA_FOR_DEBUGGING
+  return AllocFromOverflowZone(size, alignment);
+}
+
+void* Arena::AllocFromOverflowZone(size_t size, size_t alignment) {
+  // This is the uncommon path: thanks to the sizing hysteresis of call arenas
+  // most arenas never outgrow their initial zone.
+  const size_t header_size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Zone));
+  gpr_mu_lock(&growth_mu_);
+  Zone* z = last_zone_;
+  size_t begin = z == nullptr ? 0 : AlignUp(z->used, alignment);
+  if (z == nullptr || begin + size > z->size) {
+#ifdef SIMPLE_ARENA_FOR_DEBUGGING
+    size_t zone_size = size;
+#else
+    // The first overflow zone matches the initial zone, so that a call that
+    // barely spills doesn't triple its footprint. Later ones grow
+    // geometrically so that an arena that keeps outgrowing its zones needs
+    // only a logarithmic number of them.
+    size_t zone_size =
+        GPR_MAX(size, z == nullptr ? initial_zone_size_ : 2 * z->size);
+#endif
+    Zone* new_zone = static_cast<Zone*>(AllocAligned(header_size + zone_size));
+    new_zone->next = z;
+    new_zone->size = zone_size;
+    new_zone->used = 0;
+    last_zone_ = z = new_zone;
+    begin = 0;
+  }
+  overflow_used_ += begin + size - z->used;
+  z->used = begin + size;
+  gpr_mu_unlock(&growth_mu_);
+  void* result = reinterpret_cast<char*>(z) + header_size + begin;
+  memset(result, 0, size);
+  return result;
+}
+
+void Arena::RegisterDestructor(Destructible* obj) {
+  gpr_atm head;
+  do {
+    head = gpr_atm_no_barrier_load(&destructibles_);
+    obj->next = reinterpret_cast<Destructible*>(head);
+  } while (!gpr_atm_rel_cas(&destructibles_, head,
+                            reinterpret_cast<gpr_atm>(obj)));
+}
+
+}  // namespace grpc_core
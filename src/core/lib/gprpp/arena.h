@@ -0,0 +1,134 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// \file Arena based allocator
+// Allows very fast allocation of memory, but that memory cannot be freed until
+// the arena as a whole is freed
+// Tracks the total memory allocated against it, so that future arenas can
+// pre-allocate the right amount of memory
+
+#ifndef GRPC_CORE_LIB_GPRPP_ARENA_H
+#define GRPC_CORE_LIB_GPRPP_ARENA_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <grpc/support/atm.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gpr/alloc.h"
+
+namespace grpc_core {
+
+class Arena {
+ public:
+  /// Create an arena, with \a initial_size bytes in the first allocated buffer
+  static Arena* Create(size_t initial_size);
+  /// Create an arena like Create(), but recycle the first buffer from a
+  /// per-cpu pool of previously destroyed arenas when one of a suitable size
+  /// is available. Sets \a *pool_hit to whether the buffer came from the pool.
+  static Arena* CreatePooled(size_t initial_size, bool* pool_hit);
+  /// Free all buffers cached by the arena pool
+  static void FlushPool();
+
+  /// Run the destructors of all objects created with New() (in reverse order
+  /// of construction) and destroy the arena, returning the total number of
+  /// bytes allocated
+  size_t Destroy();
+
+  /// Allocate \a size zeroed bytes aligned to \a alignment, which must be a
+  /// power of two no larger than GPR_MAX_ALIGNMENT
+  void* Alloc(size_t size, size_t alignment = GPR_MAX_ALIGNMENT);
+
+  /// Allocate and construct a T using its real alignment. If T is not
+  /// trivially destructible, its destructor is run by Destroy().
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    if (std::is_trivially_destructible<T>::value) {
+      return new (Alloc(sizeof(T), alignof(T)))
+          T(std::forward<Args>(args)...);
+    }
+    typedef ManagedObject<T> Managed;
+    Managed* obj = new (Alloc(sizeof(Managed), alignof(Managed)))
+        Managed(std::forward<Args>(args)...);
+    RegisterDestructor(obj);
+    return &obj->value;
+  }
+
+ private:
+  // A node in the list of objects whose destructors Destroy() runs
+  struct Destructible {
+    void (*destroy)(Destructible* self);
+    Destructible* next;
+  };
+
+  template <typename T>
+  struct ManagedObject : public Destructible {
+    template <typename... Args>
+    explicit ManagedObject(Args&&... args)
+        : value(std::forward<Args>(args)...) {
+      destroy = DestroyValue;
+    }
+    static void DestroyValue(Destructible* self) {
+      static_cast<ManagedObject*>(self)->value.~T();
+    }
+    T value;
+  };
+
+  // Overflow zones are allocated once the initial zone is exhausted
+  struct Zone {
+    Zone* next;
+    size_t size;
+    size_t used;
+  };
+
+  Arena(size_t initial_zone_size, int pool_bucket);
+  ~Arena();
+
+  char* initial_zone_start() {
+    return reinterpret_cast<char*>(this) +
+           GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena));
+  }
+
+  void* AllocFromOverflowZone(size_t size, size_t alignment);
+  void RegisterDestructor(Destructible* obj);
+
+  // Bytes handed out of the initial zone, including alignment padding
+  gpr_atm initial_zone_used_;
+  const size_t initial_zone_size_;
+  // Index of the pool bucket the first buffer is returned to on destruction,
+  // or -1 if the arena is not pooled
+  const int pool_bucket_;
+  // Head of the Destructible list, most recently constructed first
+  gpr_atm destructibles_;
+  // Protects the overflow zones
+  gpr_mu growth_mu_;
+  // Most recently allocated overflow zone; its next pointer leads to the
+  // older ones
+  Zone* last_zone_;
+  // Bytes handed out of overflow zones, including alignment padding
+  size_t overflow_used_;
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_GPRPP_ARENA_H */
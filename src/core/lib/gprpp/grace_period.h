@@ -0,0 +1,75 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_GPRPP_GRACE_PERIOD_H
+#define GRPC_CORE_LIB_GPRPP_GRACE_PERIOD_H
+
+#include <grpc/support/port_platform.h>
+
+#include <grpc/support/atm.h>
+
+namespace grpc_core {
+
+// Lets lock-free readers of a structure that is only modified under a lock
+// walk it while writers unlink parts of it: a writer that unlinked something
+// calls Synchronize() before freeing it, which returns once every reader that
+// could still have seen it has left its read-side section.
+//
+// Readers are counted in one of two epochs; Synchronize() moves new readers
+// to the other epoch and waits for the old one to drain, so a steady stream of
+// readers cannot starve it. Read-side sections must be short and must not
+// block.
+//
+// Has no constructor so it can live in zero-initialized static storage.
+class GracePeriod {
+ public:
+  // Enters a read-side section. Returns the token to pass to ReadUnlock().
+  gpr_atm ReadLock() {
+    for (;;) {
+      gpr_atm epoch = gpr_atm_acq_load(&epoch_) & 1;
+      // A full barrier: the load below can't be satisfied before the count
+      // is visible to Synchronize().
+      gpr_atm_full_fetch_add(&readers_[epoch], 1);
+      // If Synchronize() flipped the epoch since we read it, it may not wait
+      // for us: count ourselves in the new epoch instead.
+      if ((gpr_atm_acq_load(&epoch_) & 1) == epoch) return epoch;
+      gpr_atm_full_fetch_add(&readers_[epoch], -1);
+    }
+  }
+
+  void ReadUnlock(gpr_atm epoch) {
+    gpr_atm_full_fetch_add(&readers_[epoch], -1);
+  }
+
+  // Waits until no reader can hold a reference to anything unlinked before
+  // the call. Calls must be serialized by the writers' lock.
+  void Synchronize() {
+    gpr_atm epoch = gpr_atm_full_fetch_add(&epoch_, 1) & 1;
+    gpr_atm_full_barrier();
+    while (gpr_atm_acq_load(&readers_[epoch]) != 0) {
+    }
+  }
+
+ private:
+  gpr_atm epoch_;
+  gpr_atm readers_[2];
+};
+
+}  // namespace grpc_core
+
+#endif /* GRPC_CORE_LIB_GPRPP_GRACE_PERIOD_H */
@@ -59,12 +59,14 @@ grpc_endpoint_pair grpc_iomgr_create_endpoint_pair(const char* name,
   grpc_core::ExecCtx exec_ctx;
 
   gpr_asprintf(&final_name, "%s:client", name);
-  p.client = grpc_tcp_create(grpc_fd_create(sv[1], final_name, false), args,
-                             "socketpair-server");
+  p.client = grpc_tcp_create(
+      grpc_fd_create(sv[1], final_name, grpc_tcp_needs_error_tracking(args)),
+      args, "socketpair-server");
   gpr_free(final_name);
   gpr_asprintf(&final_name, "%s:server", name);
-  p.server = grpc_tcp_create(grpc_fd_create(sv[0], final_name, false), args,
-                             "socketpair-client");
+  p.server = grpc_tcp_create(
+      grpc_fd_create(sv[0], final_name, grpc_tcp_needs_error_tracking(args)),
+      args, "socketpair-client");
   gpr_free(final_name);
 
   return p;
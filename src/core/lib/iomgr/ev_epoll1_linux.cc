@@ -43,6 +43,7 @@
 #include <grpc/support/string_util.h>
 
 #include "src/core/lib/debug/stats.h"
+#include "src/core/lib/gpr/env.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/tls.h"
 #include "src/core/lib/gpr/useful.h"
@@ -83,6 +84,10 @@ typedef struct epoll_set {
   /* Index of the first event in epoll_events that has to be processed. This
    * field is only valid if num_events > 0 */
   gpr_atm cursor;
+
+  /* Maximum number of events handled by one call to process_epoll_events().
+   * Set once in epoll_set_init() and read-only afterwards */
+  int max_events_per_iteration;
 } epoll_set;
 
 /* The global singleton epoll set */
@@ -116,6 +121,16 @@ static bool epoll_set_init() {
   gpr_log(GPR_INFO, "grpc epoll fd: %d", g_epoll_set.epfd);
   gpr_atm_no_barrier_store(&g_epoll_set.num_events, 0);
   gpr_atm_no_barrier_store(&g_epoll_set.cursor, 0);
+
+  /* In batched mode the designated poller drains every event returned by one
+     epoll_wait() before it runs any of the resulting closures, so all the
+     reads become runnable in one ExecCtx flush instead of one flush (and one
+     poller hand-off) per event */
+  char* env = gpr_getenv("GRPC_EPOLL1_BATCHED_EVENTS");
+  g_epoll_set.max_events_per_iteration =
+      gpr_is_true(env) ? MAX_EPOLL_EVENTS
+                       : MAX_EPOLL_EVENTS_HANDLED_PER_ITERATION;
+  gpr_free(env);
   return true;
 }
 
@@ -387,6 +402,12 @@ static void fd_notify_on_error(grpc_fd* fd, grpc_closure* closure) {
   fd->error_closure->NotifyOn(closure);
 }
 
+static void fd_set_readable(grpc_fd* fd) { fd->read_closure->SetReady(); }
+
+static void fd_set_writable(grpc_fd* fd) { fd->write_closure->SetReady(); }
+
+static void fd_set_error(grpc_fd* fd) { fd->error_closure->SetReady(); }
+
 static void fd_become_readable(grpc_fd* fd) { fd->read_closure->SetReady(); }
 
 static void fd_become_writable(grpc_fd* fd) { fd->write_closure->SetReady(); }
@@ -589,8 +610,8 @@ static int poll_deadline_to_millis_timeout(grpc_millis millis) {
 
 /* Process the epoll events found by do_epoll_wait() function.
    - g_epoll_set.cursor points to the index of the first event to be processed
-   - This function then processes up-to MAX_EPOLL_EVENTS_PER_ITERATION and
-     updates the g_epoll_set.cursor
+   - This function then processes up-to g_epoll_set.max_events_per_iteration
+     and updates the g_epoll_set.cursor
 
    NOTE ON SYNCRHONIZATION: Similar to do_epoll_wait(), this function is only
    called by g_active_poller thread. So there is no need for synchronization
@@ -603,8 +624,13 @@ static grpc_error* process_epoll_events(grpc_pollset* pollset) {
   long num_events = gpr_atm_acq_load(&g_epoll_set.num_events);
   long cursor = gpr_atm_acq_load(&g_epoll_set.cursor);
   for (int idx = 0;
-       (idx < MAX_EPOLL_EVENTS_HANDLED_PER_ITERATION) && cursor != num_events;
+       (idx < g_epoll_set.max_events_per_iteration) && cursor != num_events;
        idx++) {
+    if (idx > 0) {
+      /* Without batching this event would have needed its own pollset_work()
+         pass, poller hand-off and ExecCtx flush */
+      GRPC_STATS_INC_POLLSET_BATCHED_EVENTS();
+    }
     long c = cursor++;
     struct epoll_event* ev = &g_epoll_set.events[c];
     void* data_ptr = ev->data.ptr;
@@ -1203,6 +1229,9 @@ static const grpc_event_engine_vtable vtable = {
     fd_notify_on_read,
     fd_notify_on_write,
     fd_notify_on_error,
+    fd_set_readable,
+    fd_set_writable,
+    fd_set_error,
     fd_is_shutdown,
 
     pollset_init,
@@ -57,29 +57,18 @@ GrpcExecutor::GrpcExecutor(const char* name) : name_(name) {
 
 void GrpcExecutor::Init() { SetThreading(true); }
 
-size_t GrpcExecutor::RunClosures(const char* executor_name,
-                                 grpc_closure_list list) {
-  size_t n = 0;
-
-  grpc_closure* c = list.head;
-  while (c != nullptr) {
-    grpc_closure* next = c->next_data.next;
-    grpc_error* error = c->error_data.error;
+void GrpcExecutor::RunClosure(const char* executor_name, grpc_closure* c) {
+  grpc_error* error = c->error_data.error;
 #ifndef NDEBUG
-    EXECUTOR_TRACE("(%s) run %p [created by %s:%d]", executor_name, c,
-                   c->file_created, c->line_created);
-    c->scheduled = false;
+  EXECUTOR_TRACE("(%s) run %p [created by %s:%d]", executor_name, c,
+                 c->file_created, c->line_created);
+  c->scheduled = false;
 #else
-    EXECUTOR_TRACE("(%s) run %p", executor_name, c);
+  EXECUTOR_TRACE("(%s) run %p", executor_name, c);
 #endif
-    c->cb(c->cb_arg, error);
-    GRPC_ERROR_UNREF(error);
-    c = next;
-    n++;
-    grpc_core::ExecCtx::Get()->Flush();
-  }
-
-  return n;
+  c->cb(c->cb_arg, error);
+  GRPC_ERROR_UNREF(error);
+  grpc_core::ExecCtx::Get()->Flush();
 }
 
 bool GrpcExecutor::IsThreaded() const {
@@ -97,20 +86,28 @@ void GrpcExecutor::SetThreading(bool threading) {
     }
 
     GPR_ASSERT(num_threads_ == 0);
-    gpr_atm_rel_store(&num_threads_, 1);
     gpr_tls_init(&g_this_thread_state);
+    gpr_locked_mpscq_init(&long_jobs_);
+    gpr_atm_no_barrier_store(&pending_, 0);
+    gpr_atm_no_barrier_store(&num_long_jobs_, 0);
+    gpr_atm_no_barrier_store(&num_waiting_, 0);
+    gpr_atm_no_barrier_store(&shutdown_, 0);
+    gpr_mu_init(&mu_);
+    gpr_cv_init(&cv_);
     thd_state_ = static_cast<ThreadState*>(
         gpr_zalloc(sizeof(ThreadState) * max_threads_));
 
     for (size_t i = 0; i < max_threads_; i++) {
-      gpr_mu_init(&thd_state_[i].mu);
-      gpr_cv_init(&thd_state_[i].cv);
+      thd_state_[i].executor = this;
       thd_state_[i].id = i;
       thd_state_[i].name = name_;
+      gpr_spmcq_init(&thd_state_[i].local);
+      gpr_locked_mpscq_init(&thd_state_[i].inbox);
+      gpr_atm_no_barrier_store(&thd_state_[i].running_long_job, 0);
       thd_state_[i].thd = grpc_core::Thread();
-      thd_state_[i].elems = GRPC_CLOSURE_LIST_INIT;
     }
 
+    gpr_atm_rel_store(&num_threads_, 1);
     thd_state_[0].thd =
         grpc_core::Thread(name_, &GrpcExecutor::ThreadMain, &thd_state_[0]);
     thd_state_[0].thd.Start();
@@ -120,12 +117,10 @@ void GrpcExecutor::SetThreading(bool threading) {
       return;
     }
 
-    for (size_t i = 0; i < max_threads_; i++) {
-      gpr_mu_lock(&thd_state_[i].mu);
-      thd_state_[i].shutdown = true;
-      gpr_cv_signal(&thd_state_[i].cv);
-      gpr_mu_unlock(&thd_state_[i].mu);
-    }
+    gpr_mu_lock(&mu_);
+    gpr_atm_rel_store(&shutdown_, 1);
+    gpr_cv_broadcast(&cv_);
+    gpr_mu_unlock(&mu_);
 
     /* Ensure no thread is adding a new thread. Once this is past, then no
      * thread will try to add a new one either (since shutdown is true) */
@@ -140,11 +135,14 @@ void GrpcExecutor::SetThreading(bool threading) {
     }
 
     gpr_atm_rel_store(&num_threads_, 0);
+    Drain();
     for (size_t i = 0; i < max_threads_; i++) {
-      gpr_mu_destroy(&thd_state_[i].mu);
-      gpr_cv_destroy(&thd_state_[i].cv);
-      RunClosures(thd_state_[i].name, thd_state_[i].elems);
+      gpr_spmcq_destroy(&thd_state_[i].local);
+      gpr_locked_mpscq_destroy(&thd_state_[i].inbox);
     }
+    gpr_locked_mpscq_destroy(&long_jobs_);
+    gpr_mu_destroy(&mu_);
+    gpr_cv_destroy(&cv_);
 
     gpr_free(thd_state_);
     gpr_tls_destroy(&g_this_thread_state);
@@ -155,165 +153,217 @@ void GrpcExecutor::SetThreading(bool threading) {
 
 void GrpcExecutor::Shutdown() { SetThreading(false); }
 
+// Run the closures left behind by the threads, once they all exited
+void GrpcExecutor::Drain() {
+  for (size_t i = 0; i < max_threads_; i++) {
+    ThreadState* ts = &thd_state_[i];
+    grpc_closure* c;
+    while ((c = static_cast<grpc_closure*>(gpr_spmcq_pop(&ts->local))) !=
+           nullptr) {
+      RunClosure(ts->name, c);
+    }
+    while ((c = reinterpret_cast<grpc_closure*>(
+                gpr_locked_mpscq_pop(&ts->inbox))) != nullptr) {
+      RunClosure(ts->name, c);
+    }
+  }
+  grpc_closure* c;
+  while ((c = reinterpret_cast<grpc_closure*>(
+              gpr_locked_mpscq_pop(&long_jobs_))) != nullptr) {
+    RunClosure(name_, c);
+  }
+}
+
 void GrpcExecutor::ThreadMain(void* arg) {
   ThreadState* ts = static_cast<ThreadState*>(arg);
+  GrpcExecutor* executor = ts->executor;
   gpr_tls_set(&g_this_thread_state, reinterpret_cast<intptr_t>(ts));
 
   grpc_core::ExecCtx exec_ctx(GRPC_EXEC_CTX_FLAG_IS_INTERNAL_THREAD);
 
-  size_t subtract_depth = 0;
-  for (;;) {
-    EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: step (sub_depth=%" PRIdPTR ")",
-                   ts->name, ts->id, subtract_depth);
-
-    gpr_mu_lock(&ts->mu);
-    ts->depth -= subtract_depth;
-    // Wait for closures to be enqueued or for the executor to be shutdown
-    while (grpc_closure_list_empty(ts->elems) && !ts->shutdown) {
-      ts->queued_long_job = false;
-      gpr_cv_wait(&ts->cv, &ts->mu, gpr_inf_future(GPR_CLOCK_MONOTONIC));
+  while (!gpr_atm_acq_load(&executor->shutdown_)) {
+    bool is_long;
+    grpc_closure* closure = executor->Pop(ts, &is_long);
+    if (closure == nullptr) {
+      GRPC_STATS_INC_EXECUTOR_QUEUE_DRAINED();
+      executor->Wait();
+      continue;
     }
 
-    if (ts->shutdown) {
-      EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: shutdown", ts->name, ts->id);
-      gpr_mu_unlock(&ts->mu);
-      break;
+    EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: execute", ts->name, ts->id);
+
+    grpc_core::ExecCtx::Get()->InvalidateNow();
+    if (is_long) {
+      // Steer closures from outside of the executor away from this thread:
+      // whatever is already queued here is left to the other threads to steal
+      gpr_atm_rel_store(&ts->running_long_job, 1);
+      gpr_atm_full_fetch_add(&executor->num_long_jobs_, 1);
     }
+    RunClosure(ts->name, closure);
+    if (is_long) {
+      gpr_atm_full_fetch_add(&executor->num_long_jobs_, -1);
+      gpr_atm_rel_store(&ts->running_long_job, 0);
+    }
+  }
+  EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: shutdown", ts->name, ts->id);
+}
 
-    GRPC_STATS_INC_EXECUTOR_QUEUE_DRAINED();
-    grpc_closure_list closures = ts->elems;
-    ts->elems = GRPC_CLOSURE_LIST_INIT;
-    gpr_mu_unlock(&ts->mu);
+// Take the next closure for thread \a ts to run: its own closures first, then
+// long jobs, and then closures stolen from the other threads
+grpc_closure* GrpcExecutor::Pop(ThreadState* ts, bool* is_long) {
+  *is_long = false;
+  grpc_closure* c = static_cast<grpc_closure*>(gpr_spmcq_pop(&ts->local));
+  if (c == nullptr) {
+    c = reinterpret_cast<grpc_closure*>(gpr_locked_mpscq_try_pop(&ts->inbox));
+  }
+  if (c == nullptr) {
+    c = reinterpret_cast<grpc_closure*>(gpr_locked_mpscq_try_pop(&long_jobs_));
+    *is_long = c != nullptr;
+  }
+  if (c == nullptr) {
+    c = Steal(ts);
+  }
+  if (c != nullptr) {
+    gpr_atm_full_fetch_add(&pending_, -1);
+  }
+  return c;
+}
 
-    EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: execute", ts->name, ts->id);
+grpc_closure* GrpcExecutor::Steal(ThreadState* thief) {
+  size_t cur_thread_count =
+      static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
+  for (size_t i = 1; i < cur_thread_count; i++) {
+    ThreadState* victim = &thd_state_[(thief->id + i) % cur_thread_count];
+    grpc_closure* c = static_cast<grpc_closure*>(gpr_spmcq_pop(&victim->local));
+    if (c == nullptr) {
+      c = reinterpret_cast<grpc_closure*>(
+          gpr_locked_mpscq_try_pop(&victim->inbox));
+    }
+    if (c != nullptr) {
+      EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: stole %p from %" PRIdPTR,
+                     thief->name, thief->id, c, victim->id);
+      GRPC_STATS_INC_EXECUTOR_STOLEN_ITEMS();
+      return c;
+    }
+  }
+  return nullptr;
+}
 
-    grpc_core::ExecCtx::Get()->InvalidateNow();
-    subtract_depth = RunClosures(ts->name, closures);
+// Block until closures are queued or the executor is shut down. A closure may
+// have been queued after Pop() last looked, so pending_ is re-checked after
+// num_waiting_ is published, while Wakeup() checks num_waiting_ after
+// publishing the closure: either the waiter sees the closure, or the waker
+// sees the waiter.
+void GrpcExecutor::Wait() {
+  gpr_mu_lock(&mu_);
+  gpr_atm_full_fetch_add(&num_waiting_, 1);
+  while (gpr_atm_acq_load(&pending_) == 0 &&
+         !gpr_atm_no_barrier_load(&shutdown_)) {
+    gpr_cv_wait(&cv_, &mu_, gpr_inf_future(GPR_CLOCK_MONOTONIC));
+  }
+  gpr_atm_no_barrier_fetch_add(&num_waiting_, -1);
+  gpr_mu_unlock(&mu_);
+}
+
+void GrpcExecutor::Wakeup() {
+  if (gpr_atm_no_barrier_load(&num_waiting_) > 0) {
+    GRPC_STATS_INC_EXECUTOR_WAKEUP_INITIATED();
+    gpr_mu_lock(&mu_);
+    gpr_cv_signal(&cv_);
+    gpr_mu_unlock(&mu_);
+  }
+}
+
+// Start one more thread if no thread is idle and the busy ones fall behind,
+// using more than MAX_DEPTH queued closures per thread as a hint, or if the
+// closure is a long job (which must not wait for a thread to free up)
+void GrpcExecutor::MaybeAddThread(bool is_short) {
+  if (gpr_atm_no_barrier_load(&num_waiting_) > 0) return;
+  size_t cur_thread_count =
+      static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
+  if (cur_thread_count >= max_threads_) return;
+  size_t num_long_jobs =
+      static_cast<size_t>(gpr_atm_no_barrier_load(&num_long_jobs_));
+  size_t num_short_threads =
+      cur_thread_count - GPR_MIN(cur_thread_count, num_long_jobs);
+  size_t pending = static_cast<size_t>(gpr_atm_no_barrier_load(&pending_));
+  if (is_short && pending <= num_short_threads * MAX_DEPTH) return;
+
+  if (gpr_spinlock_trylock(&adding_thread_lock_)) {
+    cur_thread_count = static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
+    if (cur_thread_count < max_threads_ && !gpr_atm_acq_load(&shutdown_)) {
+      // Increment num_threads (safe to do a store instead of a cas because we
+      // always increment num_threads under the 'adding_thread_lock')
+      gpr_atm_rel_store(&num_threads_, cur_thread_count + 1);
+
+      thd_state_[cur_thread_count].thd = grpc_core::Thread(
+          name_, &GrpcExecutor::ThreadMain, &thd_state_[cur_thread_count]);
+      thd_state_[cur_thread_count].thd.Start();
+    }
+    gpr_spinlock_unlock(&adding_thread_lock_);
   }
 }
 
 void GrpcExecutor::Enqueue(grpc_closure* closure, grpc_error* error,
                            bool is_short) {
-  bool retry_push;
   if (is_short) {
     GRPC_STATS_INC_EXECUTOR_SCHEDULED_SHORT_ITEMS();
   } else {
     GRPC_STATS_INC_EXECUTOR_SCHEDULED_LONG_ITEMS();
   }
 
-  do {
-    retry_push = false;
-    size_t cur_thread_count =
-        static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
+  size_t cur_thread_count =
+      static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
 
-    // If the number of threads is zero(i.e either the executor is not threaded
-    // or already shutdown), then queue the closure on the exec context itself
-    if (cur_thread_count == 0) {
+  // If the number of threads is zero(i.e either the executor is not threaded
+  // or already shutdown), then queue the closure on the exec context itself
+  if (cur_thread_count == 0) {
 #ifndef NDEBUG
-      EXECUTOR_TRACE("(%s) schedule %p (created %s:%d) inline", name_, closure,
-                     closure->file_created, closure->line_created);
+    EXECUTOR_TRACE("(%s) schedule %p (created %s:%d) inline", name_, closure,
+                   closure->file_created, closure->line_created);
 #else
-      EXECUTOR_TRACE("(%s) schedule %p inline", name_, closure);
+    EXECUTOR_TRACE("(%s) schedule %p inline", name_, closure);
 #endif
-      grpc_closure_list_append(grpc_core::ExecCtx::Get()->closure_list(),
-                               closure, error);
-      return;
-    }
+    grpc_closure_list_append(grpc_core::ExecCtx::Get()->closure_list(),
+                             closure, error);
+    return;
+  }
 
-    ThreadState* ts = (ThreadState*)gpr_tls_get(&g_this_thread_state);
-    if (ts == nullptr) {
-      ts = &thd_state_[GPR_HASH_POINTER(grpc_core::ExecCtx::Get(),
-                                        cur_thread_count)];
-    } else {
-      GRPC_STATS_INC_EXECUTOR_SCHEDULED_TO_SELF();
+  closure->error_data.error = error;
+  // Counted before it is pushed, so that a thread popping it right away never
+  // takes pending_ below zero
+  gpr_atm_full_fetch_add(&pending_, 1);
+  ThreadState* ts = (ThreadState*)gpr_tls_get(&g_this_thread_state);
+  if (!is_short) {
+    // Long jobs are queued apart, for the first idle thread
+    gpr_locked_mpscq_push(&long_jobs_, &closure->next_data.atm_next);
+  } else if (ts != nullptr && ts->executor == this) {
+    // Closures scheduled from a thread of this executor stay on that thread,
+    // unless an idle thread steals them
+    GRPC_STATS_INC_EXECUTOR_SCHEDULED_TO_SELF();
+    gpr_spmcq_push(&ts->local, closure);
+  } else {
+    ts = &thd_state_[GPR_HASH_POINTER(grpc_core::ExecCtx::Get(),
+                                      cur_thread_count)];
+    // Avoid threads running long jobs, if some thread is not
+    for (size_t i = 0;
+         i < cur_thread_count && gpr_atm_acq_load(&ts->running_long_job); i++) {
+      GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES();
+      ts = &thd_state_[(ts->id + 1) % cur_thread_count];
     }
-
-    ThreadState* orig_ts = ts;
-    bool try_new_thread = false;
-
-    for (;;) {
+    gpr_locked_mpscq_push(&ts->inbox, &closure->next_data.atm_next);
+  }
 #ifndef NDEBUG
-      EXECUTOR_TRACE(
-          "(%s) try to schedule %p (%s) (created %s:%d) to thread "
-          "%" PRIdPTR,
-          name_, closure, is_short ? "short" : "long", closure->file_created,
-          closure->line_created, ts->id);
+  EXECUTOR_TRACE("(%s) scheduled %p (%s) (created %s:%d)", name_, closure,
+                 is_short ? "short" : "long", closure->file_created,
+                 closure->line_created);
 #else
-      EXECUTOR_TRACE("(%s) try to schedule %p (%s) to thread %" PRIdPTR, name_,
-                     closure, is_short ? "short" : "long", ts->id);
+  EXECUTOR_TRACE("(%s) scheduled %p (%s)", name_, closure,
+                 is_short ? "short" : "long");
 #endif
 
-      gpr_mu_lock(&ts->mu);
-      if (ts->queued_long_job) {
-        // if there's a long job queued, we never queue anything else to this
-        // queue (since long jobs can take 'infinite' time and we need to
-        // guarantee no starvation). Spin through queues and try again
-        gpr_mu_unlock(&ts->mu);
-        size_t idx = ts->id;
-        ts = &thd_state_[(idx + 1) % cur_thread_count];
-        if (ts == orig_ts) {
-          // We cycled through all the threads. Retry enqueue again by creating
-          // a new thread
-          //
-          // TODO (sreek): There is a potential issue here. We are
-          // unconditionally setting try_new_thread to true here. What if the
-          // executor is shutdown OR if cur_thread_count is already equal to
-          // max_threads ?
-          // (Fortunately, this is not an issue yet (as of july 2018) because
-          // there is only one instance of long job in gRPC and hence we will
-          // not hit this code path)
-          retry_push = true;
-          try_new_thread = true;
-          break;
-        }
-
-        continue;  // Try the next thread-state
-      }
-
-      // == Found the thread state (i.e thread) to enqueue this closure! ==
-
-      // Also, if this thread has been waiting for closures, wake it up.
-      // - If grpc_closure_list_empty() is true and the Executor is not
-      //   shutdown, it means that the thread must be waiting in ThreadMain()
-      // - Note that gpr_cv_signal() won't immediately wakeup the thread. That
-      //   happens after we release the mutex &ts->mu a few lines below
-      if (grpc_closure_list_empty(ts->elems) && !ts->shutdown) {
-        GRPC_STATS_INC_EXECUTOR_WAKEUP_INITIATED();
-        gpr_cv_signal(&ts->cv);
-      }
-
-      grpc_closure_list_append(&ts->elems, closure, error);
-
-      // If we already queued more than MAX_DEPTH number of closures on this
-      // thread, use this as a hint to create more threads
-      ts->depth++;
-      try_new_thread = ts->depth > MAX_DEPTH &&
-                       cur_thread_count < max_threads_ && !ts->shutdown;
-
-      ts->queued_long_job = !is_short;
-
-      gpr_mu_unlock(&ts->mu);
-      break;
-    }
-
-    if (try_new_thread && gpr_spinlock_trylock(&adding_thread_lock_)) {
-      cur_thread_count = static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
-      if (cur_thread_count < max_threads_) {
-        // Increment num_threads (safe to do a store instead of a cas because we
-        // always increment num_threads under the 'adding_thread_lock')
-        gpr_atm_rel_store(&num_threads_, cur_thread_count + 1);
-
-        thd_state_[cur_thread_count].thd = grpc_core::Thread(
-            name_, &GrpcExecutor::ThreadMain, &thd_state_[cur_thread_count]);
-        thd_state_[cur_thread_count].thd.Start();
-      }
-      gpr_spinlock_unlock(&adding_thread_lock_);
-    }
-
-    if (retry_push) {
-      GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES();
-    }
-  } while (retry_push);
+  Wakeup();
+  MaybeAddThread(is_short);
 }
 
 static GrpcExecutor* executors[GRPC_NUM_EXECUTORS];
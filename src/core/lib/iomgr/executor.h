@@ -21,19 +21,25 @@
 
 #include <grpc/support/port_platform.h>
 
+#include "src/core/lib/gpr/mpscq.h"
 #include "src/core/lib/gpr/spinlock.h"
+#include "src/core/lib/gpr/spmcq.h"
 #include "src/core/lib/gprpp/thd.h"
 #include "src/core/lib/iomgr/closure.h"
 
+class GrpcExecutor;
+
 typedef struct {
-  gpr_mu mu;
+  GrpcExecutor* executor;
   size_t id;         // For debugging purposes
   const char* name;  // Thread state name
-  gpr_cv cv;
-  grpc_closure_list elems;
-  size_t depth;  // Number of closures in the closure list
-  bool shutdown;
-  bool queued_long_job;
+  // Closures scheduled by this thread itself. Only this thread pushes; any
+  // thread of the executor may pop (steal)
+  gpr_spmcq local;
+  // Closures scheduled to this thread by threads outside of the executor
+  gpr_locked_mpscq inbox;
+  // Is this thread running a long job?
+  gpr_atm running_long_job;
   grpc_core::Thread thd;
 } ThreadState;
 
@@ -63,14 +69,34 @@ class GrpcExecutor {
   void Enqueue(grpc_closure* closure, grpc_error* error, bool is_short);
 
  private:
-  static size_t RunClosures(const char* executor_name, grpc_closure_list list);
+  static void RunClosure(const char* executor_name, grpc_closure* closure);
   static void ThreadMain(void* arg);
 
+  grpc_closure* Pop(ThreadState* ts, bool* is_long);
+  grpc_closure* Steal(ThreadState* thief);
+  void Wait();
+  void Wakeup();
+  void MaybeAddThread(bool is_short);
+  void Drain();
+
   const char* name_;
   ThreadState* thd_state_;
   size_t max_threads_;
   gpr_atm num_threads_;
   gpr_spinlock adding_thread_lock_;
+
+  // Long jobs are not queued on a particular thread, so that they never hold
+  // up other closures; the first idle thread picks them up
+  gpr_locked_mpscq long_jobs_;
+  // Number of closures queued and not yet popped, across all queues
+  gpr_atm pending_;
+  // Number of threads running long jobs
+  gpr_atm num_long_jobs_;
+  // Idle threads wait on cv_ (under mu_) for closures to be queued
+  gpr_mu mu_;
+  gpr_cv cv_;
+  gpr_atm num_waiting_;
+  gpr_atm shutdown_;
 };
 
 // == Global executor functions ==
@@ -135,6 +135,14 @@ struct grpc_resource_quota {
 
   gpr_atm last_size;
 
+  /* Protects max_threads and num_threads_allocated: threads are allocated
+     synchronously, outside of the combiner */
+  gpr_mu thread_count_mu;
+  /* Maximum number of threads that may be allocated from this quota */
+  int max_threads;
+  /* Number of threads currently allocated from this quota */
+  int num_threads_allocated;
+
   /* Has rq_step been scheduled to occur? */
   bool step_scheduled;
   /* Are we currently reclaiming memory */
@@ -594,6 +602,9 @@ grpc_resource_quota* grpc_resource_quota_create(const char* name) {
   resource_quota->free_pool = INT64_MAX;
   resource_quota->size = INT64_MAX;
   gpr_atm_no_barrier_store(&resource_quota->last_size, GPR_ATM_MAX);
+  gpr_mu_init(&resource_quota->thread_count_mu);
+  resource_quota->max_threads = INT_MAX;
+  resource_quota->num_threads_allocated = 0;
   resource_quota->step_scheduled = false;
   resource_quota->reclaiming = false;
   gpr_atm_no_barrier_store(&resource_quota->memory_usage_estimation, 0);
@@ -617,6 +628,7 @@ grpc_resource_quota* grpc_resource_quota_create(const char* name) {
 void grpc_resource_quota_unref_internal(grpc_resource_quota* resource_quota) {
   if (gpr_unref(&resource_quota->refs)) {
     GRPC_COMBINER_UNREF(resource_quota->combiner, "resource_quota");
+    gpr_mu_destroy(&resource_quota->thread_count_mu);
     gpr_free(resource_quota->name);
     gpr_free(resource_quota);
   }
@@ -664,6 +676,37 @@ size_t grpc_resource_quota_peek_size(grpc_resource_quota* resource_quota) {
       gpr_atm_no_barrier_load(&resource_quota->last_size));
 }
 
+/* Public API */
+void grpc_resource_quota_set_max_threads(grpc_resource_quota* resource_quota,
+                                         int new_max_threads) {
+  GPR_ASSERT(new_max_threads >= 0);
+  gpr_mu_lock(&resource_quota->thread_count_mu);
+  resource_quota->max_threads = new_max_threads;
+  gpr_mu_unlock(&resource_quota->thread_count_mu);
+}
+
+bool grpc_resource_quota_allocate_threads(grpc_resource_quota* resource_quota,
+                                          int thread_count) {
+  GPR_ASSERT(thread_count >= 0);
+  bool is_success = false;
+  gpr_mu_lock(&resource_quota->thread_count_mu);
+  if (resource_quota->num_threads_allocated <=
+      resource_quota->max_threads - thread_count) {
+    resource_quota->num_threads_allocated += thread_count;
+    is_success = true;
+  }
+  gpr_mu_unlock(&resource_quota->thread_count_mu);
+  return is_success;
+}
+
+void grpc_resource_quota_free_threads(grpc_resource_quota* resource_quota,
+                                      int thread_count) {
+  gpr_mu_lock(&resource_quota->thread_count_mu);
+  resource_quota->num_threads_allocated -= thread_count;
+  GPR_ASSERT(resource_quota->num_threads_allocated >= 0);
+  gpr_mu_unlock(&resource_quota->thread_count_mu);
+}
+
 /*******************************************************************************
  * grpc_resource_user channel args api
  */
@@ -79,6 +79,16 @@ double grpc_resource_quota_get_memory_pressure(
 
 size_t grpc_resource_quota_peek_size(grpc_resource_quota* resource_quota);
 
+/* Attempt to allocate \a thread_count threads from the quota. Returns true if
+   they were granted (the caller may then start that many threads, and must
+   return them with grpc_resource_quota_free_threads when they exit) and false
+   if that would exceed the quota's maximum number of threads */
+bool grpc_resource_quota_allocate_threads(grpc_resource_quota* resource_quota,
+                                          int thread_count);
+/* Return \a thread_count threads to the quota */
+void grpc_resource_quota_free_threads(grpc_resource_quota* resource_quota,
+                                      int thread_count);
+
 typedef struct grpc_resource_user grpc_resource_user;
 
 grpc_resource_user* grpc_resource_user_create(
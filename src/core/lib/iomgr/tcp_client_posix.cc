@@ -279,7 +279,8 @@ grpc_error* grpc_tcp_client_prepare_fd(const grpc_channel_args* channel_args,
   }
   addr_str = grpc_sockaddr_to_uri(mapped_addr);
   gpr_asprintf(&name, "tcp-client:%s", addr_str);
-  *fdobj = grpc_fd_create(fd, name, false);
+  *fdobj =
+      grpc_fd_create(fd, name, grpc_tcp_needs_error_tracking(channel_args));
   gpr_free(name);
   gpr_free(addr_str);
   return GRPC_ERROR_NONE;
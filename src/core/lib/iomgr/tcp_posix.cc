@@ -34,6 +34,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef GRPC_LINUX_ERRQUEUE
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#endif
+
 #include <grpc/slice.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
@@ -64,9 +69,35 @@ typedef GRPC_MSG_IOVLEN_TYPE msg_iovlen_type;
 typedef size_t msg_iovlen_type;
 #endif
 
+#ifdef GRPC_LINUX_ERRQUEUE
+/* Older libc headers may predate the zero-copy socket API even when the
+   kernel supports it. */
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+#endif /* GRPC_LINUX_ERRQUEUE */
+
 extern grpc_core::TraceFlag grpc_tcp_trace;
 
 namespace {
+/* Slices handed to the kernel by one MSG_ZEROCOPY sendmsg. They must stay alive
+   until the kernel reports (through the socket error queue) that it no longer
+   references them. */
+struct zerocopy_send_record {
+  uint32_t seq;
+  grpc_slice_buffer slices;
+  zerocopy_send_record* next;
+};
+
 struct grpc_tcp {
   grpc_endpoint base;
   grpc_fd* em_fd;
@@ -102,6 +133,25 @@ struct grpc_tcp {
 
   grpc_resource_user* resource_user;
   grpc_resource_user_slice_allocator slice_allocator;
+
+  /* true if the fd was created with track_err, i.e. error queue events are
+     delivered through grpc_fd_notify_on_error */
+  bool track_errors;
+  /* set when the endpoint is being destroyed to tell the error handler to
+     stop re-registering itself */
+  gpr_atm stop_error_notification;
+  grpc_closure error_closure;
+
+  /* sendmsg batches of at least this many bytes use MSG_ZEROCOPY; 0 if
+     zero-copy sends are disabled for this endpoint */
+  size_t zerocopy_send_threshold;
+  /* protects the fields below, which are touched by both the write path and
+     the error queue handler */
+  gpr_mu zerocopy_mu;
+  /* sequence number the kernel will assign to the next MSG_ZEROCOPY send */
+  uint32_t zerocopy_next_seq;
+  zerocopy_send_record* zerocopy_pending_head;
+  zerocopy_send_record* zerocopy_pending_tail;
 };
 
 struct backup_poller {
@@ -296,10 +346,23 @@ static void tcp_shutdown(grpc_endpoint* ep, grpc_error* why) {
   grpc_resource_user_shutdown(tcp->resource_user);
 }
 
+static void zerocopy_release_records(zerocopy_send_record* record) {
+  while (record != nullptr) {
+    zerocopy_send_record* next = record->next;
+    grpc_slice_buffer_destroy_internal(&record->slices);
+    gpr_free(record);
+    record = next;
+  }
+}
+
 static void tcp_free(grpc_tcp* tcp) {
   grpc_fd_orphan(tcp->em_fd, tcp->release_fd_cb, tcp->release_fd,
                  "tcp_unref_orphan");
   grpc_slice_buffer_destroy_internal(&tcp->last_read_buffer);
+  /* Any zero-copy send still unacknowledged at this point can no longer be
+     waited for: the socket is gone. */
+  zerocopy_release_records(tcp->zerocopy_pending_head);
+  gpr_mu_destroy(&tcp->zerocopy_mu);
   grpc_resource_user_unref(tcp->resource_user);
   gpr_free(tcp->peer_string);
   gpr_free(tcp);
@@ -343,10 +406,20 @@ static void tcp_unref(grpc_tcp* tcp) {
 static void tcp_ref(grpc_tcp* tcp) { gpr_ref(&tcp->refcount); }
 #endif
 
+/* Make the error handler drop its ref on the endpoint instead of
+   re-registering itself. */
+static void stop_error_notification(grpc_tcp* tcp) {
+  if (tcp->track_errors) {
+    gpr_atm_rel_store(&tcp->stop_error_notification, true);
+    grpc_fd_set_error(tcp->em_fd);
+  }
+}
+
 static void tcp_destroy(grpc_endpoint* ep) {
   grpc_network_status_unregister_endpoint(ep);
   grpc_tcp* tcp = reinterpret_cast<grpc_tcp*>(ep);
   grpc_slice_buffer_reset_and_unref_internal(&tcp->last_read_buffer);
+  stop_error_notification(tcp);
   TCP_UNREF(tcp, "destroy");
 }
 
@@ -513,6 +586,187 @@ static void tcp_read(grpc_endpoint* ep, grpc_slice_buffer* incoming_buffer,
   }
 }
 
+#ifdef GRPC_LINUX_ERRQUEUE
+/* Releases the slices of every pending zero-copy send whose sequence number
+   lies in [lo, hi]; the kernel coalesces consecutive completions into a single
+   notification. */
+static void zerocopy_complete(grpc_tcp* tcp, uint32_t lo, uint32_t hi) {
+  zerocopy_send_record* done = nullptr;
+  zerocopy_send_record* last = nullptr;
+  gpr_mu_lock(&tcp->zerocopy_mu);
+  zerocopy_send_record** prev = &tcp->zerocopy_pending_head;
+  while (*prev != nullptr) {
+    zerocopy_send_record* record = *prev;
+    if (static_cast<uint32_t>(record->seq - lo) <=
+        static_cast<uint32_t>(hi - lo)) {
+      *prev = record->next;
+      record->next = done;
+      done = record;
+    } else {
+      last = record;
+      prev = &record->next;
+    }
+  }
+  tcp->zerocopy_pending_tail = last;
+  gpr_mu_unlock(&tcp->zerocopy_mu);
+  zerocopy_release_records(done);
+}
+
+/* Drains the socket error queue. Returns true if at least one zero-copy
+   completion was consumed, false if the wakeup was caused by something else
+   (e.g. a socket error) that the read and write paths must observe. */
+static bool process_errors(grpc_tcp* tcp) {
+  bool processed = false;
+  for (;;) {
+    union {
+      char rbuf[1024];
+      struct cmsghdr align;
+    } aligned_buf;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_control = aligned_buf.rbuf;
+    msg.msg_controllen = sizeof(aligned_buf.rbuf);
+    ssize_t r;
+    do {
+      GRPC_STATS_INC_SYSCALL_READ();
+      r = recvmsg(tcp->fd, &msg, MSG_ERRQUEUE);
+    } while (r < 0 && errno == EINTR);
+    if (r < 0) {
+      /* EAGAIN: the error queue is empty */
+      return processed;
+    }
+    if ((msg.msg_flags & MSG_CTRUNC) != 0) {
+      gpr_log(GPR_ERROR, "TCP:%p error queue message was truncated", tcp);
+    }
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      const struct sock_extended_err* serr =
+          reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cmsg));
+      if (serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        GRPC_STATS_INC_TCP_ZEROCOPY_COPIED();
+      }
+      if (grpc_tcp_trace.enabled()) {
+        gpr_log(GPR_INFO, "TCP:%p zerocopy sends %u..%u complete", tcp,
+                serr->ee_info, serr->ee_data);
+      }
+      zerocopy_complete(tcp, serr->ee_info, serr->ee_data);
+      processed = true;
+    }
+  }
+}
+
+static void tcp_handle_error(void* arg /* grpc_tcp */, grpc_error* error);
+
+static void notify_on_error(grpc_tcp* tcp) {
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_INFO, "TCP:%p notify_on_error", tcp);
+  }
+  GRPC_CLOSURE_INIT(&tcp->error_closure, tcp_handle_error, tcp,
+                    grpc_schedule_on_exec_ctx);
+  grpc_fd_notify_on_error(tcp->em_fd, &tcp->error_closure);
+}
+
+static void tcp_handle_error(void* arg /* grpc_tcp */, grpc_error* error) {
+  grpc_tcp* tcp = static_cast<grpc_tcp*>(arg);
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_INFO, "TCP:%p got_error: %s", tcp, grpc_error_string(error));
+  }
+
+  if (error != GRPC_ERROR_NONE ||
+      static_cast<bool>(gpr_atm_acq_load(&tcp->stop_error_notification))) {
+    /* We aren't going to register to hear on error anymore, so it is safe to
+     * unref. */
+    TCP_UNREF(tcp, "error-tracking");
+    return;
+  }
+
+  if (!process_errors(tcp)) {
+    /* Not a zero-copy completion: let the read and write paths run so that
+     * they observe whatever happened to the socket. */
+    grpc_fd_set_readable(tcp->em_fd);
+    grpc_fd_set_writable(tcp->em_fd);
+  }
+  notify_on_error(tcp);
+}
+
+/* Takes a ref on every slice covered by iov (outgoing slices
+   [first_slice_idx, first_slice_idx + iov_size)) so that the memory stays
+   valid until the kernel completes the MSG_ZEROCOPY send. Inlined slices live
+   inside the caller's slice buffer, which may be reused as soon as the write
+   callback runs, so they are copied and iov is repointed at the copy. */
+static zerocopy_send_record* zerocopy_prepare_send(grpc_tcp* tcp,
+                                                   size_t first_slice_idx,
+                                                   struct iovec* iov,
+                                                   msg_iovlen_type iov_size) {
+  zerocopy_send_record* record =
+      static_cast<zerocopy_send_record*>(gpr_malloc(sizeof(*record)));
+  grpc_slice_buffer_init(&record->slices);
+  record->next = nullptr;
+  for (msg_iovlen_type i = 0; i < iov_size; i++) {
+    grpc_slice slice = tcp->outgoing_buffer->slices[first_slice_idx + i];
+    if (slice.refcount == nullptr) {
+      size_t offset = static_cast<size_t>(
+          static_cast<uint8_t*>(iov[i].iov_base) -
+          GRPC_SLICE_START_PTR(
+              tcp->outgoing_buffer->slices[first_slice_idx + i]));
+      grpc_slice copy = grpc_slice_malloc_large(GRPC_SLICE_LENGTH(slice));
+      memcpy(GRPC_SLICE_START_PTR(copy), GRPC_SLICE_START_PTR(slice),
+             GRPC_SLICE_LENGTH(slice));
+      iov[i].iov_base = GRPC_SLICE_START_PTR(copy) + offset;
+      grpc_slice_buffer_add_indexed(&record->slices, copy);
+    } else {
+      grpc_slice_buffer_add_indexed(&record->slices,
+                                    grpc_slice_ref_internal(slice));
+    }
+  }
+  return record;
+}
+
+/* Called once the sendmsg using record has returned. On success the kernel
+   assigned it the next zero-copy sequence number and it stays pending until
+   process_errors sees its completion; otherwise it is released immediately. */
+static void zerocopy_finish_send(grpc_tcp* tcp, zerocopy_send_record* record,
+                                 bool sent) {
+  if (!sent) {
+    zerocopy_release_records(record);
+    return;
+  }
+  GRPC_STATS_INC_TCP_ZEROCOPY_WRITES();
+  gpr_mu_lock(&tcp->zerocopy_mu);
+  record->seq = tcp->zerocopy_next_seq++;
+  if (tcp->zerocopy_pending_tail == nullptr) {
+    tcp->zerocopy_pending_head = record;
+  } else {
+    tcp->zerocopy_pending_tail->next = record;
+  }
+  tcp->zerocopy_pending_tail = record;
+  gpr_mu_unlock(&tcp->zerocopy_mu);
+}
+
+static int get_tx_zerocopy_threshold(const grpc_channel_args* channel_args) {
+  grpc_integer_options options = {0, 0, INT_MAX};
+  return grpc_channel_arg_get_integer(
+      grpc_channel_args_find(channel_args, GRPC_ARG_TCP_TX_ZEROCOPY_THRESHOLD),
+      options);
+}
+#endif /* GRPC_LINUX_ERRQUEUE */
+
+bool grpc_tcp_needs_error_tracking(const grpc_channel_args* channel_args) {
+#ifdef GRPC_LINUX_ERRQUEUE
+  return grpc_event_engine_can_track_errors() &&
+         get_tx_zerocopy_threshold(channel_args) > 0;
+#else
+  return false;
+#endif
+}
+
 /* returns true if done, false if pending; if returning true, *error is set */
 #if defined(IOV_MAX) && IOV_MAX < 1000
 #define MAX_WRITE_IOVEC IOV_MAX
@@ -564,13 +818,41 @@ static bool tcp_flush(grpc_tcp* tcp, grpc_error** error) {
     GRPC_STATS_INC_TCP_WRITE_SIZE(sending_length);
     GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(iov_size);
 
+    int flags = SENDMSG_FLAGS;
+#ifdef GRPC_LINUX_ERRQUEUE
+    zerocopy_send_record* zerocopy_record = nullptr;
+    if (tcp->zerocopy_send_threshold > 0 &&
+        sending_length >= tcp->zerocopy_send_threshold) {
+      zerocopy_record =
+          zerocopy_prepare_send(tcp, unwind_slice_idx, iov, iov_size);
+      flags |= MSG_ZEROCOPY;
+    }
+#endif
+
     GPR_TIMER_SCOPE("sendmsg", 1);
     do {
       /* TODO(klempner): Cork if this is a partial write */
       GRPC_STATS_INC_SYSCALL_WRITE();
-      sent_length = sendmsg(tcp->fd, &msg, SENDMSG_FLAGS);
+      sent_length = sendmsg(tcp->fd, &msg, flags);
     } while (sent_length < 0 && errno == EINTR);
 
+#ifdef GRPC_LINUX_ERRQUEUE
+    if (zerocopy_record != nullptr) {
+      if (sent_length < 0 && errno == ENOBUFS) {
+        /* Not enough option memory to pin the pages: copy this batch */
+        do {
+          GRPC_STATS_INC_SYSCALL_WRITE();
+          sent_length = sendmsg(tcp->fd, &msg, SENDMSG_FLAGS);
+        } while (sent_length < 0 && errno == EINTR);
+        flags = SENDMSG_FLAGS;
+      }
+      int saved_errno = errno;
+      zerocopy_finish_send(tcp, zerocopy_record,
+                           sent_length >= 0 && (flags & MSG_ZEROCOPY) != 0);
+      errno = saved_errno;
+    }
+#endif
+
     if (sent_length < 0) {
       if (errno == EAGAIN) {
         tcp->outgoing_byte_idx = unwind_byte_idx;
@@ -804,6 +1086,33 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
   grpc_network_status_register_endpoint(&tcp->base);
   grpc_resource_quota_unref_internal(resource_quota);
 
+  tcp->track_errors = false;
+  gpr_atm_no_barrier_store(&tcp->stop_error_notification, false);
+  tcp->zerocopy_send_threshold = 0;
+  gpr_mu_init(&tcp->zerocopy_mu);
+  tcp->zerocopy_next_seq = 0;
+  tcp->zerocopy_pending_head = nullptr;
+  tcp->zerocopy_pending_tail = nullptr;
+#ifdef GRPC_LINUX_ERRQUEUE
+  /* The fd was created with track_err iff this holds, see
+     grpc_tcp_needs_error_tracking() */
+  if (grpc_tcp_needs_error_tracking(channel_args)) {
+    tcp->track_errors = true;
+    const int enable = 1;
+    if (setsockopt(tcp->fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) ==
+        0) {
+      tcp->zerocopy_send_threshold =
+          static_cast<size_t>(get_tx_zerocopy_threshold(channel_args));
+    } else if (grpc_tcp_trace.enabled()) {
+      gpr_log(GPR_INFO, "TCP:%p SO_ZEROCOPY unavailable: %s", tcp,
+              strerror(errno));
+    }
+    /* paired with unref in tcp_handle_error */
+    TCP_REF(tcp, "error-tracking");
+    notify_on_error(tcp);
+  }
+#endif
+
   return &tcp->base;
 }
 
@@ -821,6 +1130,7 @@ void grpc_tcp_destroy_and_release_fd(grpc_endpoint* ep, int* fd,
   tcp->release_fd = fd;
   tcp->release_fd_cb = done;
   grpc_slice_buffer_reset_and_unref_internal(&tcp->last_read_buffer);
+  stop_error_notification(tcp);
   TCP_UNREF(tcp, "destroy");
 }
 
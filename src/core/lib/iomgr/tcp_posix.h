@@ -38,10 +38,16 @@
 extern grpc_core::TraceFlag grpc_tcp_trace;
 
 /* Create a tcp endpoint given a file desciptor and a read slice size.
-   Takes ownership of fd. */
+   Takes ownership of fd. fd must have been created with track_err set to
+   grpc_tcp_needs_error_tracking(args). */
 grpc_endpoint* grpc_tcp_create(grpc_fd* fd, const grpc_channel_args* args,
                                const char* peer_string);
 
+/* Returns true if endpoints created with \a args listen for socket error queue
+   events (used to learn when MSG_ZEROCOPY sends complete). The grpc_fd backing
+   such an endpoint must be created with track_err set. */
+bool grpc_tcp_needs_error_tracking(const grpc_channel_args* args);
+
 /* Return the tcp endpoint's fd, or -1 if this is not available. Does not
    release the fd.
    Requires: ep must be a tcp endpoint.
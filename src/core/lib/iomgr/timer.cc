@@ -19,14 +19,30 @@
 #include <grpc/support/port_platform.h>
 
 #include "src/core/lib/iomgr/timer.h"
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+
+#include "src/core/lib/gpr/env.h"
 #include "src/core/lib/iomgr/timer_manager.h"
 
+extern grpc_timer_vtable grpc_generic_timer_vtable;
+extern grpc_timer_vtable grpc_timer_wheel_vtable;
+
 grpc_timer_vtable* grpc_timer_impl;
 
 void grpc_set_timer_impl(grpc_timer_vtable* vtable) {
   grpc_timer_impl = vtable;
 }
 
+grpc_timer_vtable* grpc_generic_timer_impl_from_env(void) {
+  char* s = gpr_getenv("GRPC_TIMER_IMPL");
+  bool wheel = s != nullptr && strcmp(s, "wheel") == 0;
+  gpr_free(s);
+  return wheel ? &grpc_timer_wheel_vtable : &grpc_generic_timer_vtable;
+}
+
 void grpc_timer_init(grpc_timer* timer, grpc_millis deadline,
                      grpc_closure* closure) {
   grpc_timer_impl->init(timer, deadline, closure);
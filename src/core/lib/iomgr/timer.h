@@ -122,4 +122,9 @@ void grpc_kick_poller(void);
 /* Sets the timer implementation */
 void grpc_set_timer_impl(grpc_timer_vtable* vtable);
 
+/* Returns the timer implementation to use with the generic timer manager.
+   GRPC_TIMER_IMPL=wheel selects the hierarchical timing wheel; anything else
+   selects the sharded heaps */
+grpc_timer_vtable* grpc_generic_timer_impl_from_env(void);
+
 #endif /* GRPC_CORE_LIB_IOMGR_TIMER_H */
@@ -0,0 +1,534 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#include <inttypes.h>
+
+#include "src/core/lib/iomgr/timer.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/spinlock.h"
+#include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+
+/* A hierarchical timing wheel (Varghese & Lauck, "Hashed and Hierarchical
+ * Timing Wheels").
+ *
+ * Each shard has NUM_LEVELS wheels of WHEEL_SIZE slots. A slot on level L
+ * spans 2^(WHEEL_BITS * L) milliseconds. A timer is placed on the lowest
+ * level whose span still covers its deadline given the shard's current tick,
+ * so grpc_timer_init() and grpc_timer_cancel() are O(1): a bit of arithmetic
+ * and a doubly linked list operation. When the current tick reaches the start
+ * of an occupied slot on a higher level, that slot's timers are cascaded down
+ * to the lower levels; timers on level 0 fire exactly at their deadline.
+ * Timers further out than the top level are kept in an unordered overflow
+ * list that is re-examined once per top level revolution (~4.6 hours). */
+
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define NUM_LEVELS 4
+/* Pseudo-level that holds the overflow list */
+#define OVERFLOW_LEVEL NUM_LEVELS
+
+/* grpc_timer.heap_index is reused to remember where a timer lives: the shard
+ * index in the high bits and the level/slot in the low bits */
+#define LOCATION_BITS 16
+#define LOCATION_MASK ((1u << LOCATION_BITS) - 1)
+
+extern grpc_core::TraceFlag grpc_timer_trace;
+extern grpc_core::TraceFlag grpc_timer_check_trace;
+
+typedef struct {
+  gpr_mu mu;
+  /* Every tick before this one has been processed: all timers in the wheel
+     have deadline >= cur */
+  grpc_millis cur;
+  /* Lower bound on the deadline of the next timer due in this shard */
+  grpc_millis min_deadline;
+  /* Bit i of occupied[L] is set iff slots[L][i] is non-empty */
+  uint64_t occupied[NUM_LEVELS];
+  grpc_timer* slots[NUM_LEVELS][WHEEL_SIZE];
+  /* Timers beyond the reach of the top level, and a lower bound on the
+     earliest deadline among them */
+  grpc_timer* overflow;
+  grpc_millis overflow_min;
+} wheel_shard;
+
+static size_t g_num_shards;
+
+/* Array of shards. A timer goes to the shard of the cpu that armed it */
+static wheel_shard* g_shards;
+
+#if GPR_ARCH_64
+/* Thread local variable that stores the deadline of the next timer the thread
+ * has last-seen (see timer_generic.cc) */
+GPR_TLS_DECL(g_last_seen_min_timer);
+#endif
+
+struct shared_mutables {
+  /* Lower bound on the deadline of the next timer due across all shards */
+  grpc_millis min_timer;
+  /* Allow only one run_some_expired_timers at once */
+  gpr_spinlock checker_mu;
+  bool initialized;
+  /* Protects min_timer updates */
+  gpr_mu mu;
+} GPR_ALIGN_STRUCT(GPR_CACHELINE_SIZE);
+
+static struct shared_mutables g_shared_mutables;
+
+static grpc_millis load_min_timer() {
+#if GPR_ARCH_64
+  // See timer_generic.cc for why this uses a c-style cast
+  return static_cast<grpc_millis>(
+      gpr_atm_no_barrier_load((gpr_atm*)(&g_shared_mutables.min_timer)));
+#else
+  gpr_mu_lock(&g_shared_mutables.mu);
+  grpc_millis min_timer = g_shared_mutables.min_timer;
+  gpr_mu_unlock(&g_shared_mutables.mu);
+  return min_timer;
+#endif
+}
+
+/* REQUIRES: g_shared_mutables.mu locked */
+static void store_min_timer(grpc_millis min_timer) {
+#if GPR_ARCH_64
+  gpr_atm_no_barrier_store((gpr_atm*)(&g_shared_mutables.min_timer),
+                           min_timer);
+#else
+  g_shared_mutables.min_timer = min_timer;
+#endif
+}
+
+static int lowest_set_bit(uint64_t bits) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(bits);
+#else
+  int n = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+static uint32_t location(uint32_t level, uint32_t slot) {
+  return level * WHEEL_SIZE + slot;
+}
+
+static grpc_timer** location_head(wheel_shard* shard, uint32_t loc) {
+  uint32_t level = loc / WHEEL_SIZE;
+  return level == OVERFLOW_LEVEL ? &shard->overflow
+                                 : &shard->slots[level][loc % WHEEL_SIZE];
+}
+
+static void list_push(grpc_timer** head, grpc_timer* timer) {
+  timer->prev = nullptr;
+  timer->next = *head;
+  if (*head != nullptr) (*head)->prev = timer;
+  *head = timer;
+}
+
+static void list_remove(grpc_timer** head, grpc_timer* timer) {
+  if (timer->prev != nullptr) {
+    timer->prev->next = timer->next;
+  } else {
+    *head = timer->next;
+  }
+  if (timer->next != nullptr) timer->next->prev = timer->prev;
+}
+
+/* Places timer in the wheel relative to shard->cur.
+   REQUIRES: shard->mu locked, timer->deadline >= shard->cur */
+static void add_timer(wheel_shard* shard, grpc_timer* timer) {
+  uint64_t deadline = static_cast<uint64_t>(timer->deadline);
+  uint64_t cur = static_cast<uint64_t>(shard->cur);
+  uint32_t shard_bits = timer->heap_index & ~LOCATION_MASK;
+  for (uint32_t level = 0; level < NUM_LEVELS; level++) {
+    uint32_t shift = WHEEL_BITS * (level + 1);
+    if ((deadline >> shift) == (cur >> shift)) {
+      uint32_t slot = static_cast<uint32_t>(
+          (deadline >> (WHEEL_BITS * level)) & WHEEL_MASK);
+      list_push(&shard->slots[level][slot], timer);
+      shard->occupied[level] |= static_cast<uint64_t>(1) << slot;
+      timer->heap_index = shard_bits | location(level, slot);
+      return;
+    }
+  }
+  list_push(&shard->overflow, timer);
+  shard->overflow_min = GPR_MIN(shard->overflow_min, timer->deadline);
+  timer->heap_index = shard_bits | location(OVERFLOW_LEVEL, 0);
+}
+
+/* REQUIRES: shard->mu locked */
+static void remove_timer(wheel_shard* shard, grpc_timer* timer) {
+  uint32_t loc = timer->heap_index & LOCATION_MASK;
+  grpc_timer** head = location_head(shard, loc);
+  list_remove(head, timer);
+  if (*head != nullptr) return;
+  uint32_t level = loc / WHEEL_SIZE;
+  if (level == OVERFLOW_LEVEL) {
+    /* Don't let a stale lower bound outlive the list: the shard could move
+       past it before the next timer is added to the overflow list */
+    shard->overflow_min = GRPC_MILLIS_INF_FUTURE;
+  } else {
+    shard->occupied[level] &=
+        ~(static_cast<uint64_t>(1) << (loc % WHEEL_SIZE));
+  }
+}
+
+/* Returns the first tick at or after shard->cur at which a level 0 slot fires
+   or a higher level slot has to be cascaded. No timer in the shard is due
+   before it.
+   REQUIRES: shard->mu locked */
+static grpc_millis next_event(wheel_shard* shard) {
+  uint64_t cur = static_cast<uint64_t>(shard->cur);
+  uint64_t next = static_cast<uint64_t>(GRPC_MILLIS_INF_FUTURE);
+  for (uint32_t level = 0; level < NUM_LEVELS; level++) {
+    uint32_t shift = WHEEL_BITS * level;
+    /* Slots behind the current one are empty. The current slot of a higher
+       level is only occupied while cur sits exactly at its start, i.e. its
+       cascade is still pending */
+    uint32_t idx = static_cast<uint32_t>((cur >> shift) & WHEEL_MASK);
+    uint64_t bits = shard->occupied[level] & (~static_cast<uint64_t>(0) << idx);
+    if (bits != 0) {
+      uint64_t base = (cur >> (shift + WHEEL_BITS)) << (shift + WHEEL_BITS);
+      next = GPR_MIN(
+          next, base | (static_cast<uint64_t>(lowest_set_bit(bits)) << shift));
+    }
+  }
+  if (shard->overflow != nullptr) {
+    uint32_t shift = WHEEL_BITS * NUM_LEVELS;
+    next = GPR_MIN(
+        next, (static_cast<uint64_t>(shard->overflow_min) >> shift) << shift);
+  }
+  return static_cast<grpc_millis>(next);
+}
+
+/* Re-inserts every timer of the given list relative to shard->cur.
+   REQUIRES: shard->mu locked */
+static void cascade(wheel_shard* shard, grpc_timer* list) {
+  while (list != nullptr) {
+    grpc_timer* timer = list;
+    list = timer->next;
+    add_timer(shard, timer);
+  }
+}
+
+/* Fires every timer with deadline <= now, in deadline order.
+   REQUIRES: shard->mu locked */
+static size_t advance_shard(wheel_shard* shard, grpc_millis now,
+                            grpc_error* error) {
+  /* Timers at GRPC_MILLIS_INF_FUTURE never expire */
+  grpc_millis limit = GPR_MIN(now, GRPC_MILLIS_INF_FUTURE - 1);
+  size_t n = 0;
+  if (limit < shard->cur) return 0;
+  for (;;) {
+    grpc_millis tick = next_event(shard);
+    if (tick > limit) break;
+    shard->cur = tick;
+    uint64_t t = static_cast<uint64_t>(tick);
+    /* Cascade from the top down so that timers due at this very tick fall
+       all the way through to level 0 */
+    uint32_t overflow_shift = WHEEL_BITS * NUM_LEVELS;
+    if (shard->overflow != nullptr &&
+        (t & ((static_cast<uint64_t>(1) << overflow_shift) - 1)) == 0) {
+      grpc_timer* list = shard->overflow;
+      shard->overflow = nullptr;
+      shard->overflow_min = GRPC_MILLIS_INF_FUTURE;
+      cascade(shard, list);
+    }
+    for (uint32_t level = NUM_LEVELS - 1; level > 0; level--) {
+      uint32_t shift = WHEEL_BITS * level;
+      if ((t & ((static_cast<uint64_t>(1) << shift) - 1)) != 0) continue;
+      uint32_t slot = static_cast<uint32_t>((t >> shift) & WHEEL_MASK);
+      grpc_timer* list = shard->slots[level][slot];
+      if (list == nullptr) continue;
+      shard->slots[level][slot] = nullptr;
+      shard->occupied[level] &= ~(static_cast<uint64_t>(1) << slot);
+      cascade(shard, list);
+    }
+    uint32_t slot = static_cast<uint32_t>(t & WHEEL_MASK);
+    grpc_timer* timer = shard->slots[0][slot];
+    shard->slots[0][slot] = nullptr;
+    shard->occupied[0] &= ~(static_cast<uint64_t>(1) << slot);
+    while (timer != nullptr) {
+      grpc_timer* next = timer->next;
+      if (grpc_timer_trace.enabled()) {
+        gpr_log(GPR_INFO, "TIMER %p: FIRE %" PRId64 "ms late via %s scheduler",
+                timer, now - timer->deadline,
+                timer->closure->scheduler->vtable->name);
+      }
+      timer->pending = false;
+      GRPC_CLOSURE_SCHED(timer->closure, GRPC_ERROR_REF(error));
+      n++;
+      timer = next;
+    }
+    shard->cur = tick + 1;
+  }
+  shard->cur = limit + 1;
+  shard->min_deadline = next_event(shard);
+  return n;
+}
+
+static void timer_list_init() {
+  g_num_shards = GPR_MAX(1, gpr_cpu_num_cores());
+  g_shards =
+      static_cast<wheel_shard*>(gpr_zalloc(g_num_shards * sizeof(*g_shards)));
+
+  g_shared_mutables.initialized = true;
+  g_shared_mutables.checker_mu = GPR_SPINLOCK_INITIALIZER;
+  gpr_mu_init(&g_shared_mutables.mu);
+  grpc_millis now = grpc_core::ExecCtx::Get()->Now();
+  g_shared_mutables.min_timer = GRPC_MILLIS_INF_FUTURE;
+
+#if GPR_ARCH_64
+  gpr_tls_init(&g_last_seen_min_timer);
+  gpr_tls_set(&g_last_seen_min_timer, 0);
+#endif
+
+  for (size_t i = 0; i < g_num_shards; i++) {
+    wheel_shard* shard = &g_shards[i];
+    gpr_mu_init(&shard->mu);
+    shard->cur = now;
+    shard->min_deadline = GRPC_MILLIS_INF_FUTURE;
+    shard->overflow_min = GRPC_MILLIS_INF_FUTURE;
+  }
+}
+
+static void fire_list(grpc_timer* timer, grpc_error* error) {
+  while (timer != nullptr) {
+    grpc_timer* next = timer->next;
+    timer->pending = false;
+    GRPC_CLOSURE_SCHED(timer->closure, GRPC_ERROR_REF(error));
+    timer = next;
+  }
+}
+
+static void timer_list_shutdown() {
+  grpc_error* error =
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Timer list shutdown");
+  for (size_t i = 0; i < g_num_shards; i++) {
+    wheel_shard* shard = &g_shards[i];
+    gpr_mu_lock(&shard->mu);
+    for (uint32_t level = 0; level < NUM_LEVELS; level++) {
+      for (uint32_t slot = 0; slot < WHEEL_SIZE; slot++) {
+        fire_list(shard->slots[level][slot], error);
+      }
+    }
+    fire_list(shard->overflow, error);
+    gpr_mu_unlock(&shard->mu);
+    gpr_mu_destroy(&shard->mu);
+  }
+  GRPC_ERROR_UNREF(error);
+  gpr_mu_destroy(&g_shared_mutables.mu);
+
+#if GPR_ARCH_64
+  gpr_tls_destroy(&g_last_seen_min_timer);
+#endif
+
+  gpr_free(g_shards);
+  g_shared_mutables.initialized = false;
+}
+
+static void timer_init(grpc_timer* timer, grpc_millis deadline,
+                       grpc_closure* closure) {
+  timer->closure = closure;
+  timer->deadline = deadline;
+
+  if (grpc_timer_trace.enabled()) {
+    gpr_log(GPR_INFO, "TIMER %p: SET %" PRId64 " now %" PRId64 " call %p[%p]",
+            timer, deadline, grpc_core::ExecCtx::Get()->Now(), closure,
+            closure->cb);
+  }
+
+  if (!g_shared_mutables.initialized) {
+    timer->pending = false;
+    GRPC_CLOSURE_SCHED(timer->closure,
+                       GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                           "Attempt to create timer before initialization"));
+    return;
+  }
+
+  size_t shard_index =
+      static_cast<size_t>(gpr_cpu_current_cpu()) % g_num_shards;
+  wheel_shard* shard = &g_shards[shard_index];
+  timer->heap_index = static_cast<uint32_t>(shard_index) << LOCATION_BITS;
+
+  gpr_mu_lock(&shard->mu);
+  timer->pending = true;
+  grpc_millis now = grpc_core::ExecCtx::Get()->Now();
+  /* A checker running with a later clock may already have moved the shard
+     past the deadline, in which case the timer is due anyway */
+  if (deadline <= now || deadline < shard->cur) {
+    timer->pending = false;
+    GRPC_CLOSURE_SCHED(timer->closure, GRPC_ERROR_NONE);
+    gpr_mu_unlock(&shard->mu);
+    /* early out */
+    return;
+  }
+
+  add_timer(shard, timer);
+  bool is_first_timer = deadline < shard->min_deadline;
+  if (is_first_timer) shard->min_deadline = deadline;
+  if (grpc_timer_trace.enabled()) {
+    gpr_log(GPR_INFO,
+            "  .. add to shard %d at location %d => is_first_timer=%s",
+            static_cast<int>(shard_index),
+            static_cast<int>(timer->heap_index & LOCATION_MASK),
+            is_first_timer ? "true" : "false");
+  }
+  gpr_mu_unlock(&shard->mu);
+
+  /* Same reasoning as in timer_generic.cc: the shard's min_deadline has been
+     lowered under its lock, so a racing checker either sees it while
+     recomputing min_timer or finishes before we get here */
+  if (is_first_timer) {
+    gpr_mu_lock(&g_shared_mutables.mu);
+    if (deadline < g_shared_mutables.min_timer) {
+      store_min_timer(deadline);
+      grpc_kick_poller();
+    }
+    gpr_mu_unlock(&g_shared_mutables.mu);
+  }
+}
+
+static void timer_consume_kick(void) {
+#if GPR_ARCH_64
+  /* Force re-evaluation of last seen min */
+  gpr_tls_set(&g_last_seen_min_timer, 0);
+#endif
+}
+
+static void timer_cancel(grpc_timer* timer) {
+  if (!g_shared_mutables.initialized) {
+    /* must have already been cancelled, also the shard mutex is invalid */
+    return;
+  }
+
+  wheel_shard* shard = &g_shards[(timer->heap_index >> LOCATION_BITS) %
+                                 g_num_shards];
+  gpr_mu_lock(&shard->mu);
+  if (grpc_timer_trace.enabled()) {
+    gpr_log(GPR_INFO, "TIMER %p: CANCEL pending=%s", timer,
+            timer->pending ? "true" : "false");
+  }
+
+  if (timer->pending) {
+    GRPC_CLOSURE_SCHED(timer->closure, GRPC_ERROR_CANCELLED);
+    timer->pending = false;
+    remove_timer(shard, timer);
+  }
+  gpr_mu_unlock(&shard->mu);
+}
+
+static grpc_timer_check_result run_some_expired_timers(grpc_millis now,
+                                                       grpc_millis* next,
+                                                       grpc_error* error) {
+  grpc_timer_check_result result = GRPC_TIMERS_NOT_CHECKED;
+
+  grpc_millis min_timer = load_min_timer();
+#if GPR_ARCH_64
+  gpr_tls_set(&g_last_seen_min_timer, min_timer);
+#endif
+  if (now < min_timer) {
+    if (next != nullptr) *next = GPR_MIN(*next, min_timer);
+    GRPC_ERROR_UNREF(error);
+    return GRPC_TIMERS_CHECKED_AND_EMPTY;
+  }
+
+  if (gpr_spinlock_trylock(&g_shared_mutables.checker_mu)) {
+    gpr_mu_lock(&g_shared_mutables.mu);
+    result = GRPC_TIMERS_CHECKED_AND_EMPTY;
+    grpc_millis new_min_timer = GRPC_MILLIS_INF_FUTURE;
+    for (size_t i = 0; i < g_num_shards; i++) {
+      wheel_shard* shard = &g_shards[i];
+      gpr_mu_lock(&shard->mu);
+      if (shard->min_deadline <= now) {
+        size_t n = advance_shard(shard, now, error);
+        if (n > 0) result = GRPC_TIMERS_FIRED;
+        if (grpc_timer_check_trace.enabled()) {
+          gpr_log(GPR_INFO,
+                  "  .. shard[%d] popped %" PRIdPTR
+                  " min_deadline --> %" PRId64,
+                  static_cast<int>(i), n, shard->min_deadline);
+        }
+      }
+      new_min_timer = GPR_MIN(new_min_timer, shard->min_deadline);
+      gpr_mu_unlock(&shard->mu);
+    }
+    store_min_timer(new_min_timer);
+    if (next != nullptr) *next = GPR_MIN(*next, new_min_timer);
+    gpr_mu_unlock(&g_shared_mutables.mu);
+    gpr_spinlock_unlock(&g_shared_mutables.checker_mu);
+  }
+
+  GRPC_ERROR_UNREF(error);
+
+  return result;
+}
+
+static grpc_timer_check_result timer_check(grpc_millis* next) {
+  grpc_millis now = grpc_core::ExecCtx::Get()->Now();
+
+#if GPR_ARCH_64
+  /* fetch from a thread-local first: this avoids contention on a globally
+     mutable cacheline in the common case */
+  grpc_millis min_timer = gpr_tls_get(&g_last_seen_min_timer);
+#else
+  grpc_millis min_timer = load_min_timer();
+#endif
+
+  if (now < min_timer) {
+    if (next != nullptr) {
+      *next = GPR_MIN(*next, min_timer);
+    }
+    if (grpc_timer_check_trace.enabled()) {
+      gpr_log(GPR_INFO, "TIMER CHECK SKIP: now=%" PRId64 " min_timer=%" PRId64,
+              now, min_timer);
+    }
+    return GRPC_TIMERS_CHECKED_AND_EMPTY;
+  }
+
+  grpc_error* shutdown_error =
+      now != GRPC_MILLIS_INF_FUTURE
+          ? GRPC_ERROR_NONE
+          : GRPC_ERROR_CREATE_FROM_STATIC_STRING("Shutting down timer system");
+
+  grpc_timer_check_result r =
+      run_some_expired_timers(now, next, shutdown_error);
+  if (grpc_timer_check_trace.enabled()) {
+    gpr_log(GPR_INFO, "TIMER CHECK END: now=%" PRId64 " r=%d", now, r);
+  }
+  return r;
+}
+
+grpc_timer_vtable grpc_timer_wheel_vtable = {
+    timer_init,      timer_cancel,        timer_check,
+    timer_list_init, timer_list_shutdown, timer_consume_kick};
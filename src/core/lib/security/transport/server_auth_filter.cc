@@ -56,12 +56,12 @@ struct channel_data {
 
 static grpc_metadata_array metadata_batch_to_md_array(
     const grpc_metadata_batch* batch) {
-  grpc_linked_mdelem* l;
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(batch);
   grpc_metadata_array result;
   grpc_metadata_array_init(&result);
-  for (l = batch->list.head; l != nullptr; l = l->next) {
+  for (size_t i = 0; i < batch->list.count; i++) {
     grpc_metadata* usr_md = nullptr;
-    grpc_mdelem md = l->md;
+    grpc_mdelem md = elems[i]->md;
     grpc_slice key = GRPC_MDKEY(md);
     grpc_slice value = GRPC_MDVALUE(md);
     if (result.count == result.capacity) {
@@ -27,6 +27,7 @@
 #include <grpc/support/log.h>
 
 #include "src/core/lib/gpr/murmur_hash.h"
+#include "src/core/lib/gprpp/grace_period.h"
 #include "src/core/lib/iomgr/iomgr_internal.h" /* for iomgr_abort_on_leaks() */
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
@@ -35,6 +36,7 @@
 #define LOG2_SHARD_COUNT 5
 #define SHARD_COUNT (1 << LOG2_SHARD_COUNT)
 #define INITIAL_SHARD_CAPACITY 8
+#define MAX_RETIRED_PER_SHARD 32
 
 #define TABLE_IDX(hash, capacity) (((hash) >> LOG2_SHARD_COUNT) % (capacity))
 #define SHARD_IDX(hash) ((hash) & ((1 << LOG2_SHARD_COUNT) - 1))
@@ -45,14 +47,21 @@ typedef struct interned_slice_refcount {
   size_t length;
   gpr_atm refcnt;
   uint32_t hash;
-  struct interned_slice_refcount* bucket_next;
+  gpr_atm bucket_next; /* interned_slice_refcount* */
 } interned_slice_refcount;
 
+/* Lookups walk a shard without taking its lock (see find_and_ref): only
+   inserting, unlinking and resizing take mu. Slices whose last ref is gone are
+   unlinked at once, but only freed in batches once a grace period has passed,
+   as a lookup may still be reading them. */
 typedef struct slice_shard {
   gpr_mu mu;
-  interned_slice_refcount** strs;
+  grpc_core::GracePeriod grace;
+  gpr_atm strs;     /* gpr_atm[capacity] of interned_slice_refcount* */
+  gpr_atm capacity; /* only ever grows */
   size_t count;
-  size_t capacity;
+  interned_slice_refcount* retired[MAX_RETIRED_PER_SHARD];
+  size_t retired_count;
 } slice_shard;
 
 /* hash seed: decided at initialization time */
@@ -76,19 +85,50 @@ static void interned_slice_ref(void* p) {
   GPR_ASSERT(gpr_atm_no_barrier_fetch_add(&s->refcnt, 1) > 0);
 }
 
+/* Takes a ref to \a s, unless its last ref is already gone: it is then about
+   to be unlinked and must not be handed out again */
+static bool ref_if_alive(interned_slice_refcount* s) {
+  for (;;) {
+    gpr_atm count = gpr_atm_no_barrier_load(&s->refcnt);
+    if (count == 0) return false;
+    if (gpr_atm_no_barrier_cas(&s->refcnt, count, count + 1)) return true;
+  }
+}
+
+static gpr_atm* shard_strs(slice_shard* shard) {
+  return reinterpret_cast<gpr_atm*>(gpr_atm_acq_load(&shard->strs));
+}
+
+static interned_slice_refcount* next_in_bucket(gpr_atm* link) {
+  return reinterpret_cast<interned_slice_refcount*>(gpr_atm_acq_load(link));
+}
+
+static void free_retired_locked(slice_shard* shard) {
+  if (shard->retired_count == 0) return;
+  shard->grace.Synchronize();
+  for (size_t i = 0; i < shard->retired_count; i++) {
+    gpr_free(shard->retired[i]);
+  }
+  shard->retired_count = 0;
+}
+
 static void interned_slice_destroy(interned_slice_refcount* s) {
   slice_shard* shard = &g_shards[SHARD_IDX(s->hash)];
   gpr_mu_lock(&shard->mu);
   GPR_ASSERT(0 == gpr_atm_no_barrier_load(&s->refcnt));
-  interned_slice_refcount** prev_next;
+  size_t capacity = static_cast<size_t>(gpr_atm_acq_load(&shard->capacity));
+  gpr_atm* prev_next = &shard_strs(shard)[TABLE_IDX(s->hash, capacity)];
   interned_slice_refcount* cur;
-  for (prev_next = &shard->strs[TABLE_IDX(s->hash, shard->capacity)],
-      cur = *prev_next;
-       cur != s; prev_next = &cur->bucket_next, cur = cur->bucket_next)
+  for (cur = next_in_bucket(prev_next); cur != s;
+       prev_next = &cur->bucket_next, cur = next_in_bucket(prev_next))
     ;
-  *prev_next = cur->bucket_next;
+  /* cur->bucket_next is left alone: lookups may still be walking through it */
+  gpr_atm_rel_store(prev_next, gpr_atm_no_barrier_load(&cur->bucket_next));
   shard->count--;
-  gpr_free(s);
+  if (shard->retired_count == MAX_RETIRED_PER_SHARD) {
+    free_retired_locked(shard);
+  }
+  shard->retired[shard->retired_count++] = s;
   gpr_mu_unlock(&shard->mu);
 }
 
@@ -129,25 +169,32 @@ static const grpc_slice_refcount_vtable interned_slice_sub_vtable = {
 static void grow_shard(slice_shard* shard) {
   GPR_TIMER_SCOPE("grow_strtab", 0);
 
-  size_t capacity = shard->capacity * 2;
+  size_t old_capacity =
+      static_cast<size_t>(gpr_atm_no_barrier_load(&shard->capacity));
+  size_t capacity = old_capacity * 2;
   size_t i;
-  interned_slice_refcount** strtab;
+  gpr_atm* old_strtab = shard_strs(shard);
+  gpr_atm* strtab;
   interned_slice_refcount *s, *next;
 
-  strtab = static_cast<interned_slice_refcount**>(
-      gpr_zalloc(sizeof(interned_slice_refcount*) * capacity));
+  strtab = static_cast<gpr_atm*>(gpr_zalloc(sizeof(gpr_atm) * capacity));
 
-  for (i = 0; i < shard->capacity; i++) {
-    for (s = shard->strs[i]; s; s = next) {
+  /* Relinking in place can make a concurrent lookup miss, but never loop:
+     the lookup then retries under the lock */
+  for (i = 0; i < old_capacity; i++) {
+    for (s = next_in_bucket(&old_strtab[i]); s; s = next) {
       size_t idx = TABLE_IDX(s->hash, capacity);
-      next = s->bucket_next;
-      s->bucket_next = strtab[idx];
-      strtab[idx] = s;
+      next = next_in_bucket(&s->bucket_next);
+      gpr_atm_rel_store(&s->bucket_next, strtab[idx]);
+      strtab[idx] = (gpr_atm)s;
     }
   }
-  gpr_free(shard->strs);
-  shard->strs = strtab;
-  shard->capacity = capacity;
+  /* publish the table before its capacity: a lookup pairing the old capacity
+     with the new table stays in bounds */
+  gpr_atm_rel_store(&shard->strs, (gpr_atm)strtab);
+  gpr_atm_rel_store(&shard->capacity, (gpr_atm)capacity);
+  shard->grace.Synchronize();
+  gpr_free(old_strtab);
 }
 
 static grpc_slice materialize(interned_slice_refcount* s) {
@@ -158,6 +205,24 @@ static grpc_slice materialize(interned_slice_refcount* s) {
   return slice;
 }
 
+/* Returns a new ref to the live interned copy of \a slice, or nullptr.
+   Without the shard lock, this must be called in a read-side section of
+   shard->grace, and can miss a string that a concurrent grow_shard is
+   moving. */
+static interned_slice_refcount* find_and_ref(slice_shard* shard,
+                                             grpc_slice slice, uint32_t hash) {
+  size_t capacity = static_cast<size_t>(gpr_atm_acq_load(&shard->capacity));
+  interned_slice_refcount* s;
+  for (s = next_in_bucket(&shard_strs(shard)[TABLE_IDX(hash, capacity)]); s;
+       s = next_in_bucket(&s->bucket_next)) {
+    if (s->hash == hash && grpc_slice_eq(slice, materialize(s)) &&
+        ref_if_alive(s)) {
+      break;
+    }
+  }
+  return s;
+}
+
 uint32_t grpc_slice_default_hash_impl(grpc_slice s) {
   return gpr_murmur_hash3(GRPC_SLICE_START_PTR(s), GRPC_SLICE_LENGTH(s),
                           g_hash_seed);
@@ -217,27 +282,22 @@ grpc_slice grpc_slice_intern(grpc_slice slice) {
     }
   }
 
-  interned_slice_refcount* s;
   slice_shard* shard = &g_shards[SHARD_IDX(hash)];
 
+  /* search for an existing string, first without the lock */
+  gpr_atm epoch = shard->grace.ReadLock();
+  interned_slice_refcount* s = find_and_ref(shard, slice, hash);
+  shard->grace.ReadUnlock(epoch);
+  if (s != nullptr) {
+    return materialize(s);
+  }
+
   gpr_mu_lock(&shard->mu);
 
-  /* search for an existing string */
-  size_t idx = TABLE_IDX(hash, shard->capacity);
-  for (s = shard->strs[idx]; s; s = s->bucket_next) {
-    if (s->hash == hash && grpc_slice_eq(slice, materialize(s))) {
-      if (gpr_atm_no_barrier_fetch_add(&s->refcnt, 1) == 0) {
-        /* If we get here, we've added a ref to something that was about to
-         * die - drop it immediately.
-         * The *only* possible path here (given the shard mutex) should be to
-         * drop from one ref back to zero - assert that with a CAS */
-        GPR_ASSERT(gpr_atm_rel_cas(&s->refcnt, 1, 0));
-        /* and treat this as if we were never here... sshhh */
-      } else {
-        gpr_mu_unlock(&shard->mu);
-        return materialize(s);
-      }
-    }
+  s = find_and_ref(shard, slice, hash);
+  if (s != nullptr) {
+    gpr_mu_unlock(&shard->mu);
+    return materialize(s);
   }
 
   /* not found: create a new string */
@@ -251,13 +311,15 @@ grpc_slice grpc_slice_intern(grpc_slice slice) {
   s->base.sub_refcount = &s->sub;
   s->sub.vtable = &interned_slice_sub_vtable;
   s->sub.sub_refcount = &s->sub;
-  s->bucket_next = shard->strs[idx];
-  shard->strs[idx] = s;
   memcpy(s + 1, GRPC_SLICE_START_PTR(slice), GRPC_SLICE_LENGTH(slice));
+  size_t capacity = static_cast<size_t>(gpr_atm_acq_load(&shard->capacity));
+  gpr_atm* bucket = &shard_strs(shard)[TABLE_IDX(hash, capacity)];
+  gpr_atm_no_barrier_store(&s->bucket_next, gpr_atm_no_barrier_load(bucket));
+  gpr_atm_rel_store(bucket, (gpr_atm)s);
 
   shard->count++;
 
-  if (shard->count > shard->capacity * 2) {
+  if (shard->count > capacity * 2) {
     grow_shard(shard);
   }
 
@@ -279,9 +341,11 @@ void grpc_slice_intern_init(void) {
     slice_shard* shard = &g_shards[i];
     gpr_mu_init(&shard->mu);
     shard->count = 0;
-    shard->capacity = INITIAL_SHARD_CAPACITY;
-    shard->strs = static_cast<interned_slice_refcount**>(
-        gpr_zalloc(sizeof(*shard->strs) * shard->capacity));
+    shard->retired_count = 0;
+    gpr_atm_no_barrier_store(&shard->capacity, INITIAL_SHARD_CAPACITY);
+    gpr_atm_no_barrier_store(
+        &shard->strs,
+        (gpr_atm)gpr_zalloc(sizeof(gpr_atm) * INITIAL_SHARD_CAPACITY));
   }
   for (size_t i = 0; i < GPR_ARRAY_SIZE(static_metadata_hash); i++) {
     static_metadata_hash[i].hash = 0;
@@ -309,14 +373,17 @@ void grpc_slice_intern_init(void) {
 void grpc_slice_intern_shutdown(void) {
   for (size_t i = 0; i < SHARD_COUNT; i++) {
     slice_shard* shard = &g_shards[i];
+    free_retired_locked(shard);
     gpr_mu_destroy(&shard->mu);
     /* TODO(ctiller): GPR_ASSERT(shard->count == 0); */
     if (shard->count != 0) {
       gpr_log(GPR_DEBUG, "WARNING: %" PRIuPTR " metadata strings were leaked",
               shard->count);
-      for (size_t j = 0; j < shard->capacity; j++) {
-        for (interned_slice_refcount* s = shard->strs[j]; s;
-             s = s->bucket_next) {
+      size_t capacity =
+          static_cast<size_t>(gpr_atm_no_barrier_load(&shard->capacity));
+      for (size_t j = 0; j < capacity; j++) {
+        for (interned_slice_refcount* s = next_in_bucket(&shard_strs(shard)[j]);
+             s; s = next_in_bucket(&s->bucket_next)) {
           char* text =
               grpc_dump_slice(materialize(s), GPR_DUMP_HEX | GPR_DUMP_ASCII);
           gpr_log(GPR_DEBUG, "LEAKED: %s", text);
@@ -327,6 +394,6 @@ void grpc_slice_intern_shutdown(void) {
         abort();
       }
     }
-    gpr_free(shard->strs);
+    gpr_free(shard_strs(shard));
   }
 }
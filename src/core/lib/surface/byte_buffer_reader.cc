@@ -31,6 +31,7 @@
 #include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/surface/message_object.h"
 
 static int is_compressed(grpc_byte_buffer* buffer) {
   switch (buffer->type) {
@@ -70,6 +71,15 @@ int grpc_byte_buffer_reader_init(grpc_byte_buffer_reader* reader,
                                           decompressed_slices_buffer.count);
         }
         grpc_slice_buffer_destroy_internal(&decompressed_slices_buffer);
+      } else if (grpc_byte_buffer_is_message_object(reader->buffer_in)) {
+        /* read the object's serialized bytes */
+        reader->buffer_out = grpc_byte_buffer_copy(reader->buffer_in);
+        if (!grpc_byte_buffer_serialize_message_object(reader->buffer_out)) {
+          gpr_log(GPR_ERROR, "Unexpected error serializing message object.");
+          grpc_byte_buffer_destroy(reader->buffer_out);
+          memset(reader, 0, sizeof(*reader));
+          return 0;
+        }
       } else { /* not compressed, use the input buffer as output */
         reader->buffer_out = reader->buffer_in;
       }
@@ -83,8 +93,8 @@ int grpc_byte_buffer_reader_init(grpc_byte_buffer_reader* reader,
 void grpc_byte_buffer_reader_destroy(grpc_byte_buffer_reader* reader) {
   switch (reader->buffer_in->type) {
     case GRPC_BB_RAW:
-      /* keeping the same if-else structure as in the init function */
-      if (is_compressed(reader->buffer_in)) {
+      /* decompressed or serialized into a buffer of its own by init */
+      if (reader->buffer_out != reader->buffer_in) {
         grpc_byte_buffer_destroy(reader->buffer_out);
       }
       break;
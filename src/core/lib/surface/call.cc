@@ -33,11 +33,12 @@
 
 #include "src/core/lib/channel/channel_stack.h"
 #include "src/core/lib/compression/algorithm_metadata.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/alloc.h"
-#include "src/core/lib/gpr/arena.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/arena.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
@@ -48,6 +49,7 @@
 #include "src/core/lib/surface/call_test_only.h"
 #include "src/core/lib/surface/channel.h"
 #include "src/core/lib/surface/completion_queue.h"
+#include "src/core/lib/surface/message_object.h"
 #include "src/core/lib/surface/validate_metadata.h"
 #include "src/core/lib/transport/error_utils.h"
 #include "src/core/lib/transport/metadata.h"
@@ -161,7 +163,7 @@ typedef struct {
 
 struct grpc_call {
   gpr_refcount ext_ref;
-  gpr_arena* arena;
+  grpc_core::Arena* arena;
   grpc_call_combiner call_combiner;
   grpc_completion_queue* cq;
   grpc_polling_entity pollent;
@@ -312,13 +314,13 @@ static void add_init_error(grpc_error** composite, grpc_error* new_err) {
 }
 
 void* grpc_call_arena_alloc(grpc_call* call, size_t size) {
-  return gpr_arena_alloc(call->arena, size);
+  return call->arena->Alloc(size);
 }
 
 static parent_call* get_or_create_parent_call(grpc_call* call) {
   parent_call* p = (parent_call*)gpr_atm_acq_load(&call->parent_call_atm);
   if (p == nullptr) {
-    p = static_cast<parent_call*>(gpr_arena_alloc(call->arena, sizeof(*p)));
+    p = call->arena->New<parent_call>();
     gpr_mu_init(&p->child_list_mu);
     if (!gpr_atm_rel_cas(&call->parent_call_atm, (gpr_atm) nullptr,
                          (gpr_atm)p)) {
@@ -348,10 +350,17 @@ grpc_error* grpc_call_create(const grpc_call_create_args* args,
   grpc_call* call;
   size_t initial_size = grpc_channel_get_call_size_estimate(args->channel);
   GRPC_STATS_INC_CALL_INITIAL_SIZE(initial_size);
-  gpr_arena* arena = gpr_arena_create(initial_size);
+  bool arena_pool_hit;
+  grpc_core::Arena* arena =
+      grpc_core::Arena::CreatePooled(initial_size, &arena_pool_hit);
+  if (arena_pool_hit) {
+    GRPC_STATS_INC_CALL_ARENA_POOL_HITS();
+  } else {
+    GRPC_STATS_INC_CALL_ARENA_POOL_MISSES();
+  }
   call = static_cast<grpc_call*>(
-      gpr_arena_alloc(arena, GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(grpc_call)) +
-                                 channel_stack->call_stack_size));
+      arena->Alloc(GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(grpc_call)) +
+                   channel_stack->call_stack_size));
   gpr_ref_init(&call->ext_ref, 1);
   call->arena = arena;
   grpc_call_combiner_init(&call->call_combiner);
@@ -396,8 +405,7 @@ grpc_error* grpc_call_create(const grpc_call_create_args* args,
   bool immediately_cancel = false;
 
   if (args->parent != nullptr) {
-    call->child =
-        static_cast<child_call*>(gpr_arena_alloc(arena, sizeof(child_call)));
+    call->child = arena->New<child_call>();
     call->child->parent = args->parent;
 
     GRPC_CALL_INTERNAL_REF(args->parent, "child");
@@ -531,7 +539,7 @@ static void release_call(void* call, grpc_error* error) {
   grpc_channel* channel = c->channel;
   gpr_free(static_cast<void*>(const_cast<char*>(c->final_info.error_string)));
   grpc_call_combiner_destroy(&c->call_combiner);
-  grpc_channel_update_call_size_estimate(channel, gpr_arena_destroy(c->arena));
+  grpc_channel_update_call_size_estimate(channel, c->arena->Destroy());
   GRPC_CHANNEL_INTERNAL_UNREF(channel, "call");
 }
 
@@ -660,6 +668,10 @@ char* grpc_call_get_peer(grpc_call* call) {
   return gpr_strdup("unknown");
 }
 
+int grpc_call_carries_message_objects(grpc_call* call) {
+  return grpc_channel_carries_message_objects(call->channel);
+}
+
 grpc_call* grpc_call_from_top_element(grpc_call_element* elem) {
   return CALL_FROM_TOP_ELEM(elem);
 }
@@ -824,7 +836,7 @@ static void set_status_from_error(grpc_call* call, status_source source,
 
 static void set_incoming_message_compression_algorithm(
     grpc_call* call, grpc_message_compression_algorithm algo) {
-  GPR_ASSERT(algo < GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT);
+  GPR_ASSERT(grpc_message_compressor_find(algo) != nullptr);
   call->incoming_message_compression_algorithm = algo;
 }
 
@@ -951,7 +963,7 @@ static int prepare_application_metadata(grpc_call* call, int count,
     const grpc_metadata* md =
         get_md_elem(metadata, additional_metadata, i, count);
     grpc_linked_mdelem* l = linked_from_md(md);
-    GPR_ASSERT(sizeof(grpc_linked_mdelem) == sizeof(md->internal_data));
+    GPR_ASSERT(sizeof(grpc_linked_mdelem) <= sizeof(md->internal_data));
     if (!GRPC_LOG_IF_ERROR("validate_metadata",
                            grpc_validate_header_key_is_legal(md->key))) {
       break;
@@ -1043,11 +1055,12 @@ static void publish_app_metadata(grpc_call* call, grpc_metadata_batch* b,
     dest->metadata = static_cast<grpc_metadata*>(
         gpr_realloc(dest->metadata, sizeof(grpc_metadata) * dest->capacity));
   }
-  for (grpc_linked_mdelem* l = b->list.head; l != nullptr; l = l->next) {
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(b);
+  for (size_t i = 0; i < b->list.count; i++) {
     mdusr = &dest->metadata[dest->count++];
     /* we pass back borrowed slices that are valid whilst the call is valid */
-    mdusr->key = GRPC_MDKEY(l->md);
-    mdusr->value = GRPC_MDVALUE(l->md);
+    mdusr->key = GRPC_MDKEY(elems[i]->md);
+    mdusr->value = GRPC_MDVALUE(elems[i]->md);
   }
 }
 
@@ -1179,8 +1192,7 @@ static batch_control* reuse_or_allocate_batch_control(grpc_call* call,
     }
     memset(bctl, 0, sizeof(*bctl));
   } else {
-    bctl = static_cast<batch_control*>(
-        gpr_arena_alloc(call->arena, sizeof(batch_control)));
+    bctl = call->arena->New<batch_control>();
     *pslot = bctl;
   }
   bctl->call = call;
@@ -1459,7 +1471,7 @@ static void validate_filtered_metadata(batch_control* bctl) {
     char* error_msg = nullptr;
     const grpc_compression_options compression_options =
         grpc_channel_compression_options(call->channel);
-    if (compression_algorithm >= GRPC_COMPRESS_ALGORITHMS_COUNT) {
+    if (!grpc_compression_algorithm_is_valid(compression_algorithm)) {
       gpr_asprintf(&error_msg, "Invalid compression algorithm value '%d'.",
                    compression_algorithm);
       gpr_log(GPR_ERROR, "%s", error_msg);
@@ -1709,6 +1721,17 @@ static grpc_call_error call_start_batch(grpc_call* call, const grpc_op* ops,
           goto done_with_error;
         }
         uint32_t flags = op->flags;
+        if (grpc_byte_buffer_is_message_object(
+                op->data.send_message.send_message)) {
+          if (grpc_channel_carries_message_objects(call->channel)) {
+            /* there are no bytes to compress */
+            flags |= GRPC_WRITE_NO_COMPRESS;
+          } else if (!grpc_byte_buffer_serialize_message_object(
+                         op->data.send_message.send_message)) {
+            error = GRPC_CALL_ERROR_INVALID_MESSAGE;
+            goto done_with_error;
+          }
+        }
         /* If the outgoing buffer is already compressed, mark it as so in the
            flags. These will be picked up by the compression filter and further
            (wasteful) attempts at compression skipped. */
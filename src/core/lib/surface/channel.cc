@@ -33,6 +33,7 @@
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/channel_trace.h"
 #include "src/core/lib/channel/channelz.h"
+#include "src/core/lib/compression/compression_internal.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
@@ -43,6 +44,7 @@
 #include "src/core/lib/surface/api_trace.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/surface/channel_init.h"
+#include "src/core/lib/surface/message_object.h"
 #include "src/core/lib/transport/static_metadata.h"
 
 /** Cache grpc-status: X mdelems for X = 0..NUM_CACHED_STATUS_ELEMS.
@@ -70,6 +72,8 @@ struct grpc_channel {
   grpc_core::RefCountedPtr<grpc_core::channelz::ChannelNode> channelz_channel;
 
   char* target;
+
+  bool carries_message_objects;
 };
 
 #define CHANNEL_STACK_FROM_CHANNEL(c) ((grpc_channel_stack*)((c) + 1))
@@ -130,11 +134,19 @@ grpc_channel* grpc_channel_create_with_builder(
                GRPC_COMPRESS_LEVEL_COUNT - 1}));
     } else if (0 == strcmp(args->args[i].key,
                            GRPC_COMPRESSION_CHANNEL_DEFAULT_ALGORITHM)) {
-      channel->compression_options.default_algorithm.is_set = true;
-      channel->compression_options.default_algorithm.algorithm =
+      grpc_compression_algorithm algorithm =
           static_cast<grpc_compression_algorithm>(grpc_channel_arg_get_integer(
               &args->args[i], {GRPC_COMPRESS_NONE, GRPC_COMPRESS_NONE,
-                               GRPC_COMPRESS_ALGORITHMS_COUNT - 1}));
+                               GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE +
+                                   GRPC_COMPRESS_MAX_REGISTERED_ALGORITHMS -
+                                   1}));
+      if (!grpc_compression_algorithm_is_valid(algorithm)) {
+        gpr_log(GPR_ERROR, "%s ignored: no compression algorithm %d",
+                args->args[i].key, algorithm);
+        algorithm = GRPC_COMPRESS_NONE;
+      }
+      channel->compression_options.default_algorithm.is_set = true;
+      channel->compression_options.default_algorithm.algorithm = algorithm;
     } else if (0 ==
                strcmp(args->args[i].key,
                       GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET)) {
@@ -162,6 +174,10 @@ grpc_channel* grpc_channel_create_with_builder(
     } else if (0 == strcmp(args->args[i].key,
                            GRPC_ARG_CHANNELZ_CHANNEL_IS_INTERNAL_CHANNEL)) {
       internal_channel = grpc_channel_arg_get_bool(&args->args[i], false);
+    } else if (0 == strcmp(args->args[i].key,
+                           GRPC_ARG_CARRIES_MESSAGE_OBJECTS)) {
+      channel->carries_message_objects =
+          grpc_channel_arg_get_bool(&args->args[i], false);
     }
   }
 
@@ -233,6 +249,10 @@ grpc_channel* grpc_channel_create(const char* target,
   return grpc_channel_create_with_builder(builder, channel_stack_type);
 }
 
+bool grpc_channel_carries_message_objects(grpc_channel* channel) {
+  return channel->carries_message_objects;
+}
+
 size_t grpc_channel_get_call_size_estimate(grpc_channel* channel) {
 #define ROUND_UP_SIZE 256
   /* We round up our current estimate to the NEXT value of ROUND_UP_SIZE.
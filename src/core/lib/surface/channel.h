@@ -61,6 +61,10 @@ grpc_core::channelz::ChannelNode* grpc_channel_get_channelz_node(
 grpc_mdelem grpc_channel_get_reffed_status_elem(grpc_channel* channel,
                                                 int status_code);
 
+/** Does \a channel hand message objects to the other side as they are? (see
+    GRPC_ARG_CARRIES_MESSAGE_OBJECTS) */
+bool grpc_channel_carries_message_objects(grpc_channel* channel);
+
 size_t grpc_channel_get_call_size_estimate(grpc_channel* channel);
 void grpc_channel_update_call_size_estimate(grpc_channel* channel, size_t size);
 
@@ -33,6 +33,7 @@
 #include "src/core/lib/gpr/spinlock.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/pollset.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/profiling/timers.h"
@@ -184,7 +185,7 @@ static const cq_poller_vtable g_poller_vtable_by_poller_type[] = {
 typedef struct cq_vtable {
   grpc_cq_completion_type cq_completion_type;
   size_t data_size;
-  void (*init)(void* data);
+  void (*init)(void* data, grpc_completion_queue_functor* callback);
   void (*shutdown)(grpc_completion_queue* cq);
   void (*destroy)(void* data);
   bool (*begin_op)(grpc_completion_queue* cq, void* tag);
@@ -253,6 +254,29 @@ typedef struct cq_pluck_data {
   plucker pluckers[GRPC_MAX_COMPLETION_QUEUE_PLUCKERS];
 } cq_pluck_data;
 
+typedef struct cq_callback_data {
+  /** The functor every event is passed to */
+  grpc_completion_queue_functor* callback;
+
+  /** Number of events whose callback has not returned yet (+1 if we're not
+      shutdown) */
+  gpr_atm pending_events;
+
+  /** 0 initially. 1 once we completed shutting (pollers return then) */
+  gpr_atm shutdown;
+
+  /** 0 initially. 1 once we initiated shutdown */
+  bool shutdown_called;
+} cq_callback_data;
+
+/** An event on its way to the callback of a GRPC_CQ_CALLBACK completion
+    queue */
+typedef struct cq_callback_event {
+  grpc_closure closure;
+  grpc_completion_queue* cq;
+  grpc_event event;
+} cq_callback_event;
+
 /* Completion queue structure */
 struct grpc_completion_queue {
   /** Once owning_refs drops to zero, we will destroy the cq */
@@ -276,11 +300,14 @@ struct grpc_completion_queue {
 /* Forward declarations */
 static void cq_finish_shutdown_next(grpc_completion_queue* cq);
 static void cq_finish_shutdown_pluck(grpc_completion_queue* cq);
+static void cq_finish_shutdown_callback(grpc_completion_queue* cq);
 static void cq_shutdown_next(grpc_completion_queue* cq);
 static void cq_shutdown_pluck(grpc_completion_queue* cq);
+static void cq_shutdown_callback(grpc_completion_queue* cq);
 
 static bool cq_begin_op_for_next(grpc_completion_queue* cq, void* tag);
 static bool cq_begin_op_for_pluck(grpc_completion_queue* cq, void* tag);
+static bool cq_begin_op_for_callback(grpc_completion_queue* cq, void* tag);
 
 static void cq_end_op_for_next(grpc_completion_queue* cq, void* tag,
                                grpc_error* error,
@@ -294,16 +321,29 @@ static void cq_end_op_for_pluck(grpc_completion_queue* cq, void* tag,
                                              grpc_cq_completion* storage),
                                 void* done_arg, grpc_cq_completion* storage);
 
+static void cq_end_op_for_callback(grpc_completion_queue* cq, void* tag,
+                                   grpc_error* error,
+                                   void (*done)(void* done_arg,
+                                                grpc_cq_completion* storage),
+                                   void* done_arg,
+                                   grpc_cq_completion* storage);
+
 static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
                           void* reserved);
 
+static grpc_event cq_poll_callback(grpc_completion_queue* cq,
+                                   gpr_timespec deadline, void* reserved);
+
 static grpc_event cq_pluck(grpc_completion_queue* cq, void* tag,
                            gpr_timespec deadline, void* reserved);
 
-static void cq_init_next(void* data);
-static void cq_init_pluck(void* data);
+static void cq_init_next(void* data, grpc_completion_queue_functor* callback);
+static void cq_init_pluck(void* data, grpc_completion_queue_functor* callback);
+static void cq_init_callback(void* data,
+                             grpc_completion_queue_functor* callback);
 static void cq_destroy_next(void* data);
 static void cq_destroy_pluck(void* data);
+static void cq_destroy_callback(void* data);
 
 /* Completion queue vtables based on the completion-type */
 static const cq_vtable g_cq_vtable[] = {
@@ -315,6 +355,10 @@ static const cq_vtable g_cq_vtable[] = {
     {GRPC_CQ_PLUCK, sizeof(cq_pluck_data), cq_init_pluck, cq_shutdown_pluck,
      cq_destroy_pluck, cq_begin_op_for_pluck, cq_end_op_for_pluck, nullptr,
      cq_pluck},
+    /* GRPC_CQ_CALLBACK */
+    {GRPC_CQ_CALLBACK, sizeof(cq_callback_data), cq_init_callback,
+     cq_shutdown_callback, cq_destroy_callback, cq_begin_op_for_callback,
+     cq_end_op_for_callback, cq_poll_callback, nullptr},
 };
 
 #define DATA_FROM_CQ(cq) ((void*)(cq + 1))
@@ -419,8 +463,8 @@ static long cq_event_queue_num_items(grpc_cq_event_queue* q) {
 }
 
 grpc_completion_queue* grpc_completion_queue_create_internal(
-    grpc_cq_completion_type completion_type,
-    grpc_cq_polling_type polling_type) {
+    grpc_cq_completion_type completion_type, grpc_cq_polling_type polling_type,
+    grpc_completion_queue_functor* callback) {
   GPR_TIMER_SCOPE("grpc_completion_queue_create_internal", 0);
 
   grpc_completion_queue* cq;
@@ -448,14 +492,14 @@ grpc_completion_queue* grpc_completion_queue_create_internal(
   gpr_ref_init(&cq->owning_refs, 2);
 
   poller_vtable->init(POLLSET_FROM_CQ(cq), &cq->mu);
-  vtable->init(DATA_FROM_CQ(cq));
+  vtable->init(DATA_FROM_CQ(cq), callback);
 
   GRPC_CLOSURE_INIT(&cq->pollset_shutdown_done, on_pollset_shutdown_done, cq,
                     grpc_schedule_on_exec_ctx);
   return cq;
 }
 
-static void cq_init_next(void* ptr) {
+static void cq_init_next(void* ptr, grpc_completion_queue_functor* callback) {
   cq_next_data* cqd = static_cast<cq_next_data*>(ptr);
   /* Initial count is dropped by grpc_completion_queue_shutdown */
   gpr_atm_no_barrier_store(&cqd->pending_events, 1);
@@ -470,7 +514,8 @@ static void cq_destroy_next(void* ptr) {
   cq_event_queue_destroy(&cqd->queue);
 }
 
-static void cq_init_pluck(void* ptr) {
+static void cq_init_pluck(void* ptr,
+                          grpc_completion_queue_functor* callback) {
   cq_pluck_data* cqd = static_cast<cq_pluck_data*>(ptr);
   /* Initial count is dropped by grpc_completion_queue_shutdown */
   gpr_atm_no_barrier_store(&cqd->pending_events, 1);
@@ -487,6 +532,22 @@ static void cq_destroy_pluck(void* ptr) {
   GPR_ASSERT(cqd->completed_head.next == (uintptr_t)&cqd->completed_head);
 }
 
+static void cq_init_callback(void* ptr,
+                             grpc_completion_queue_functor* callback) {
+  cq_callback_data* cqd = static_cast<cq_callback_data*>(ptr);
+  GPR_ASSERT(callback != nullptr);
+  cqd->callback = callback;
+  /* Initial count is dropped by grpc_completion_queue_shutdown */
+  gpr_atm_no_barrier_store(&cqd->pending_events, 1);
+  gpr_atm_no_barrier_store(&cqd->shutdown, 0);
+  cqd->shutdown_called = false;
+}
+
+static void cq_destroy_callback(void* ptr) {
+  cq_callback_data* cqd = static_cast<cq_callback_data*>(ptr);
+  GPR_ASSERT(gpr_atm_no_barrier_load(&cqd->pending_events) == 0);
+}
+
 grpc_cq_completion_type grpc_get_cq_completion_type(grpc_completion_queue* cq) {
   return cq->vtable->cq_completion_type;
 }
@@ -596,6 +657,11 @@ static bool cq_begin_op_for_pluck(grpc_completion_queue* cq, void* tag) {
   return atm_inc_if_nonzero(&cqd->pending_events);
 }
 
+static bool cq_begin_op_for_callback(grpc_completion_queue* cq, void* tag) {
+  cq_callback_data* cqd = static_cast<cq_callback_data*> DATA_FROM_CQ(cq);
+  return atm_inc_if_nonzero(&cqd->pending_events);
+}
+
 bool grpc_cq_begin_op(grpc_completion_queue* cq, void* tag) {
 #ifndef NDEBUG
   gpr_mu_lock(cq->mu);
@@ -759,6 +825,78 @@ static void cq_end_op_for_pluck(grpc_completion_queue* cq, void* tag,
   GRPC_ERROR_UNREF(error);
 }
 
+/* Inlineable callbacks run from the ExecCtx that completed the operation:
+   no queue, no poller wakeup and no thread switch */
+static grpc_closure_scheduler* cq_callback_scheduler(cq_callback_data* cqd) {
+  return cqd->callback->inlineable
+             ? grpc_schedule_on_exec_ctx
+             : grpc_executor_scheduler(GRPC_EXECUTOR_SHORT);
+}
+
+static void cq_run_callback(void* arg, grpc_error* error) {
+  cq_callback_event* ev = static_cast<cq_callback_event*>(arg);
+  grpc_completion_queue* cq = ev->cq;
+  cq_callback_data* cqd = static_cast<cq_callback_data*> DATA_FROM_CQ(cq);
+  grpc_completion_type type = ev->event.type;
+  cqd->callback->run(cqd->callback, ev->event);
+  gpr_free(ev);
+  /* Count an operation out only once its callback returned, so that the
+     shutdown event is always the last one the callback sees */
+  if (type == GRPC_OP_COMPLETE &&
+      gpr_atm_full_fetch_add(&cqd->pending_events, -1) == 1) {
+    gpr_mu_lock(cq->mu);
+    cq_finish_shutdown_callback(cq);
+    gpr_mu_unlock(cq->mu);
+  }
+  GRPC_CQ_INTERNAL_UNREF(cq, "callback");
+}
+
+static void cq_schedule_callback(grpc_completion_queue* cq, grpc_event event) {
+  cq_callback_data* cqd = static_cast<cq_callback_data*> DATA_FROM_CQ(cq);
+  cq_callback_event* ev =
+      static_cast<cq_callback_event*>(gpr_malloc(sizeof(*ev)));
+  ev->cq = cq;
+  ev->event = event;
+  GRPC_CQ_INTERNAL_REF(cq, "callback");
+  GRPC_CLOSURE_SCHED(GRPC_CLOSURE_INIT(&ev->closure, cq_run_callback, ev,
+                                       cq_callback_scheduler(cqd)),
+                     GRPC_ERROR_NONE);
+}
+
+/* Pass a GRPC_OP_COMPLETED operation to the callback of a completion queue
+ * (with a completion type of GRPC_CQ_CALLBACK) */
+static void cq_end_op_for_callback(
+    grpc_completion_queue* cq, void* tag, grpc_error* error,
+    void (*done)(void* done_arg, grpc_cq_completion* storage), void* done_arg,
+    grpc_cq_completion* storage) {
+  GPR_TIMER_SCOPE("cq_end_op_for_callback", 0);
+
+  if (grpc_api_trace.enabled() ||
+      (grpc_trace_operation_failures.enabled() && error != GRPC_ERROR_NONE)) {
+    const char* errmsg = grpc_error_string(error);
+    GRPC_API_TRACE(
+        "cq_end_op_for_callback(cq=%p, tag=%p, error=%s, "
+        "done=%p, done_arg=%p, storage=%p)",
+        6, (cq, tag, errmsg, done, done_arg, storage));
+    if (grpc_trace_operation_failures.enabled() && error != GRPC_ERROR_NONE) {
+      gpr_log(GPR_ERROR, "Operation failed: tag=%p, error=%s", tag, errmsg);
+    }
+  }
+
+  cq_check_tag(cq, tag, true); /* Used in debug builds only */
+
+  grpc_event event;
+  memset(&event, 0, sizeof(event));
+  event.type = GRPC_OP_COMPLETE;
+  event.success = error == GRPC_ERROR_NONE;
+  event.tag = tag;
+  /* The event is copied out, so the storage can be released right away */
+  done(done_arg, storage);
+  cq_schedule_callback(cq, event);
+
+  GRPC_ERROR_UNREF(error);
+}
+
 void grpc_cq_end_op(grpc_completion_queue* cq, void* tag, grpc_error* error,
                     void (*done)(void* done_arg, grpc_cq_completion* storage),
                     void* done_arg, grpc_cq_completion* storage) {
@@ -1233,6 +1371,88 @@ static void cq_shutdown_pluck(grpc_completion_queue* cq) {
   GRPC_CQ_INTERNAL_UNREF(cq, "shutting_down (pluck cq)");
 }
 
+static void cq_finish_shutdown_callback(grpc_completion_queue* cq) {
+  cq_callback_data* cqd = static_cast<cq_callback_data*> DATA_FROM_CQ(cq);
+
+  GPR_ASSERT(cqd->shutdown_called);
+  GPR_ASSERT(!gpr_atm_no_barrier_load(&cqd->shutdown));
+  gpr_atm_no_barrier_store(&cqd->shutdown, 1);
+
+  grpc_event event;
+  memset(&event, 0, sizeof(event));
+  event.type = GRPC_QUEUE_SHUTDOWN;
+  cq_schedule_callback(cq, event);
+  cq->poller_vtable->shutdown(POLLSET_FROM_CQ(cq), &cq->pollset_shutdown_done);
+}
+
+/* NOTE: This function is almost exactly identical to cq_shutdown_next() but
+ * merging them is a bit tricky and probably not worth it */
+static void cq_shutdown_callback(grpc_completion_queue* cq) {
+  cq_callback_data* cqd = static_cast<cq_callback_data*> DATA_FROM_CQ(cq);
+
+  /* Need an extra ref for cq here because:
+   * We call cq_finish_shutdown_callback() below, that would call pollset
+   * shutdown. Pollset shutdown decrements the cq ref count which can
+   * potentially destroy the cq (if that happens to be the last ref).
+   * Creating an extra ref here prevents the cq from getting destroyed while
+   * this function is still active */
+  GRPC_CQ_INTERNAL_REF(cq, "shutting_down (callback cq)");
+  gpr_mu_lock(cq->mu);
+  if (cqd->shutdown_called) {
+    gpr_mu_unlock(cq->mu);
+    GRPC_CQ_INTERNAL_UNREF(cq, "shutting_down (callback cq)");
+    return;
+  }
+  cqd->shutdown_called = true;
+  if (gpr_atm_full_fetch_add(&cqd->pending_events, -1) == 1) {
+    cq_finish_shutdown_callback(cq);
+  }
+  gpr_mu_unlock(cq->mu);
+  GRPC_CQ_INTERNAL_UNREF(cq, "shutting_down (callback cq)");
+}
+
+/* Callback completion queues hand their events to their callback, but they
+   may still need polling: this polls until the deadline or shutdown. Callbacks
+   of operations completed while polling run from this thread. */
+static grpc_event cq_poll_callback(grpc_completion_queue* cq,
+                                   gpr_timespec deadline, void* reserved) {
+  GPR_TIMER_SCOPE("cq_poll_callback", 0);
+  GPR_ASSERT(!reserved);
+
+  grpc_event ret;
+  memset(&ret, 0, sizeof(ret));
+  cq_callback_data* cqd = static_cast<cq_callback_data*> DATA_FROM_CQ(cq);
+  grpc_core::ExecCtx exec_ctx;
+  grpc_millis deadline_millis = grpc_timespec_to_millis_round_up(deadline);
+
+  GRPC_CQ_INTERNAL_REF(cq, "poll");
+  gpr_mu_lock(cq->mu);
+  for (;;) {
+    if (gpr_atm_no_barrier_load(&cqd->shutdown)) {
+      ret.type = GRPC_QUEUE_SHUTDOWN;
+      break;
+    }
+    if (grpc_core::ExecCtx::Get()->Now() >= deadline_millis) {
+      ret.type = GRPC_QUEUE_TIMEOUT;
+      break;
+    }
+    cq->num_polls++;
+    grpc_error* err =
+        cq->poller_vtable->work(POLLSET_FROM_CQ(cq), nullptr, deadline_millis);
+    if (err != GRPC_ERROR_NONE) {
+      const char* msg = grpc_error_string(err);
+      gpr_log(GPR_ERROR, "Completion queue poll failed: %s", msg);
+      GRPC_ERROR_UNREF(err);
+      ret.type = GRPC_QUEUE_TIMEOUT;
+      break;
+    }
+  }
+  gpr_mu_unlock(cq->mu);
+  GRPC_SURFACE_TRACE_RETURNED_EVENT(cq, &ret);
+  GRPC_CQ_INTERNAL_UNREF(cq, "poll");
+  return ret;
+}
+
 /* Shutdown simply drops a ref that we reserved at creation time; if we drop
    to zero here, then enter shutdown mode and wake up any waiters */
 void grpc_completion_queue_shutdown(grpc_completion_queue* cq) {
@@ -30,8 +30,10 @@
 #include "src/core/lib/channel/channelz_registry.h"
 #include "src/core/lib/channel/connected_channel.h"
 #include "src/core/lib/channel/handshaker_registry.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/arena.h"
 #include "src/core/lib/gprpp/fork.h"
 #include "src/core/lib/http/parser.h"
 #include "src/core/lib/iomgr/call_combiner.h"
@@ -178,6 +180,8 @@ void grpc_shutdown(void) {
       grpc_slice_intern_shutdown();
       grpc_core::channelz::ChannelzRegistry::Shutdown();
       grpc_stats_shutdown();
+      gpr_arena_pool_flush();
+      grpc_msg_compress_pool_flush();
       grpc_core::Fork::GlobalShutdown();
     }
     grpc_core::ExecCtx::GlobalShutdown();
@@ -67,11 +67,8 @@ static void fill_metadata(grpc_call_element* elem, grpc_metadata_batch* mdb) {
   calld->details.md = grpc_mdelem_from_slices(
       GRPC_MDSTR_GRPC_MESSAGE,
       grpc_slice_from_copied_string(chand->error_message));
-  calld->status.prev = calld->details.next = nullptr;
-  calld->status.next = &calld->details;
-  calld->details.prev = &calld->status;
-  mdb->list.head = &calld->status;
-  mdb->list.tail = &calld->details;
+  mdb->list.inline_elems[0] = &calld->status;
+  mdb->list.inline_elems[1] = &calld->details;
   mdb->list.count = 2;
   mdb->deadline = GRPC_MILLIS_INF_FUTURE;
 }
@@ -0,0 +1,114 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/surface/message_object.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/slice/slice_internal.h"
+
+/* A message object travels as the only slice of its byte buffer, whose
+   refcount holds the object. The slice's bytes are a marker, seen only by code
+   that reads them without serializing the object first. */
+static const char message_object_marker[] = "grpc.message_object";
+
+typedef struct {
+  grpc_slice_refcount base;
+  gpr_refcount refs;
+  void* object;
+  const void* type;
+  const grpc_message_object_vtable* vtable;
+} message_object_refcount;
+
+static void message_object_ref(void* p) {
+  message_object_refcount* r = static_cast<message_object_refcount*>(p);
+  gpr_ref(&r->refs);
+}
+
+static void message_object_unref(void* p) {
+  message_object_refcount* r = static_cast<message_object_refcount*>(p);
+  if (gpr_unref(&r->refs)) {
+    r->vtable->destroy(r->object);
+    gpr_free(r);
+  }
+}
+
+static const grpc_slice_refcount_vtable message_object_refcount_vtable = {
+    message_object_ref, message_object_unref, grpc_slice_default_eq_impl,
+    grpc_slice_default_hash_impl};
+
+static message_object_refcount* get_message_object(grpc_byte_buffer* bb) {
+  if (bb->type != GRPC_BB_RAW || bb->data.raw.slice_buffer.count != 1) {
+    return nullptr;
+  }
+  grpc_slice_refcount* refcount = bb->data.raw.slice_buffer.slices[0].refcount;
+  if (refcount == nullptr ||
+      refcount->vtable != &message_object_refcount_vtable) {
+    return nullptr;
+  }
+  return reinterpret_cast<message_object_refcount*>(refcount);
+}
+
+grpc_byte_buffer* grpc_message_object_byte_buffer_create(
+    void* object, const void* type, const grpc_message_object_vtable* vtable) {
+  message_object_refcount* r = static_cast<message_object_refcount*>(
+      gpr_malloc(sizeof(message_object_refcount)));
+  r->base.vtable = &message_object_refcount_vtable;
+  r->base.sub_refcount = &r->base;
+  gpr_ref_init(&r->refs, 1);
+  r->object = object;
+  r->type = type;
+  r->vtable = vtable;
+  grpc_slice slice;
+  slice.refcount = &r->base;
+  slice.data.refcounted.bytes =
+      reinterpret_cast<uint8_t*>(const_cast<char*>(message_object_marker));
+  slice.data.refcounted.length = sizeof(message_object_marker) - 1;
+  grpc_byte_buffer* bb = grpc_raw_byte_buffer_create(nullptr, 0);
+  grpc_slice_buffer_add(&bb->data.raw.slice_buffer, slice);
+  return bb;
+}
+
+void* grpc_byte_buffer_get_message_object(grpc_byte_buffer* bb,
+                                          const void* type, int* exclusive) {
+  message_object_refcount* r = get_message_object(bb);
+  if (r == nullptr || r->type != type) return nullptr;
+  *exclusive = gpr_ref_is_unique(&r->refs);
+  return r->object;
+}
+
+bool grpc_byte_buffer_is_message_object(grpc_byte_buffer* bb) {
+  return get_message_object(bb) != nullptr;
+}
+
+bool grpc_byte_buffer_serialize_message_object(grpc_byte_buffer* bb) {
+  message_object_refcount* r = get_message_object(bb);
+  GPR_ASSERT(r != nullptr);
+  grpc_slice_buffer serialized;
+  grpc_slice_buffer_init(&serialized);
+  bool ok = r->vtable->serialize(r->object, &serialized) != 0;
+  if (ok) {
+    grpc_slice_buffer_swap(&serialized, &bb->data.raw.slice_buffer);
+  }
+  grpc_slice_buffer_destroy_internal(&serialized);
+  return ok;
+}
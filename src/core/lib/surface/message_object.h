@@ -0,0 +1,40 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_SURFACE_MESSAGE_OBJECT_H
+#define GRPC_CORE_LIB_SURFACE_MESSAGE_OBJECT_H
+
+#include <grpc/support/port_platform.h>
+
+#include <grpc/byte_buffer.h>
+
+/** Set on the channels whose calls hand message objects to the other side
+    as they are: the two sides of an in-process channel created with
+    GRPC_ARG_INPROC_MESSAGE_OBJECTS. */
+#define GRPC_ARG_CARRIES_MESSAGE_OBJECTS "grpc.carries_message_objects"
+
+/* Returns whether \a bb carries a message object (see
+   grpc_message_object_byte_buffer_create) */
+bool grpc_byte_buffer_is_message_object(grpc_byte_buffer* bb);
+
+/* Replace the message object carried by \a bb with its serialized bytes.
+   Returns false, leaving \a bb as it was, if the object failed to
+   serialize. */
+bool grpc_byte_buffer_serialize_message_object(grpc_byte_buffer* bb);
+
+#endif /* GRPC_CORE_LIB_SURFACE_MESSAGE_OBJECT_H */
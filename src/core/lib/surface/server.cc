@@ -27,6 +27,7 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
+#include <grpc/support/time.h>
 
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/connected_channel.h"
@@ -34,6 +35,7 @@
 #include "src/core/lib/gpr/mpscq.h"
 #include "src/core/lib/gpr/spinlock.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/iomgr.h"
 #include "src/core/lib/slice/slice_internal.h"
@@ -45,6 +47,11 @@
 #include "src/core/lib/transport/metadata.h"
 #include "src/core/lib/transport/static_metadata.h"
 
+/* retries of an owed pop that spin before it starts to sleep, and the longest
+   sleep between retries */
+#define OWED_POP_SPINS 100
+#define OWED_POP_MAX_SLEEP_US 1000
+
 grpc_core::TraceFlag grpc_server_channel_trace(false, "server_channel");
 
 namespace {
@@ -89,6 +96,29 @@ struct channel_registered_method {
   bool has_host;
   grpc_slice method;
   grpc_slice host;
+  uint32_t method_hash;
+};
+
+/* The registrations of one method path: a run of channel_registered_methods,
+   host specific ones first so that they take precedence over the wildcard */
+struct channel_registered_path {
+  uint32_t hash;
+  grpc_slice method;
+  channel_registered_method* begin;
+  channel_registered_method* end;
+};
+
+/* Minimal perfect hash from the distinct hashes of the registered paths to
+   the first channel_registered_path with that hash (paths are sorted by hash,
+   so paths sharing a hash are adjacent). Built by hash and displace: hashes
+   are grouped in buckets, and each bucket is given the first seed that sends
+   all of its hashes to free slots. */
+struct registered_path_table {
+  uint32_t num_buckets;
+  uint32_t* seeds;
+  uint32_t num_slots;
+  /* index into registered_paths, or UINT32_MAX for a free slot */
+  uint32_t* slots;
 };
 
 struct channel_data {
@@ -100,8 +130,10 @@ struct channel_data {
   channel_data* next;
   channel_data* prev;
   channel_registered_method* registered_methods;
-  uint32_t registered_method_slots;
-  uint32_t registered_method_max_probes;
+  uint32_t num_registered_methods;
+  channel_registered_path* registered_paths;
+  uint32_t num_registered_paths;
+  registered_path_table registered_path_index;
   grpc_closure finish_destroy_channel_closure;
   grpc_closure channel_connectivity_changed;
 };
@@ -126,6 +158,7 @@ typedef enum {
 typedef struct request_matcher request_matcher;
 
 struct call_data {
+  gpr_mpscq_node pending_link; /* must be first */
   grpc_call* call;
 
   gpr_atm state;
@@ -151,14 +184,20 @@ struct call_data {
   grpc_closure* on_done_recv_initial_metadata;
 
   grpc_closure publish;
-
-  call_data* pending_next;
 };
 
+/* Matches incoming calls with requested calls without taking a server wide
+   lock. Requests are pushed on per-cq queues and calls that find no request
+   on the pending queue; balance tracks the number of queued requests minus
+   the number of pending calls. Whoever moves balance across zero is owed an
+   item from the other side, which has already been queued (requests are
+   pushed before they are counted) or is about to be (calls are counted
+   before they are pushed), so it retries the pop until it succeeds or the
+   server shuts down. */
 struct request_matcher {
   grpc_server* server;
-  call_data* pending_head;
-  call_data* pending_tail;
+  gpr_atm balance;
+  gpr_locked_mpscq pending;
   gpr_locked_mpscq* requests_per_cq;
 };
 
@@ -189,7 +228,7 @@ struct grpc_server {
 
   /* The two following mutexes control access to server-state
      mu_global controls access to non-call-related state (e.g., channel state)
-     mu_call controls access to call-related state (e.g., the call lists)
+     mu_call serializes the draining of the request matchers at shutdown
 
      If they are ever required to be nested, you must lock mu_global
      before mu_call. This is currently used in shutdown processing
@@ -307,6 +346,8 @@ static void channel_broadcaster_shutdown(channel_broadcaster* cb,
 static void request_matcher_init(request_matcher* rm, grpc_server* server) {
   memset(rm, 0, sizeof(*rm));
   rm->server = server;
+  gpr_atm_no_barrier_store(&rm->balance, 0);
+  gpr_locked_mpscq_init(&rm->pending);
   rm->requests_per_cq = static_cast<gpr_locked_mpscq*>(
       gpr_malloc(sizeof(*rm->requests_per_cq) * server->cq_count));
   for (size_t i = 0; i < server->cq_count; i++) {
@@ -320,6 +361,8 @@ static void request_matcher_destroy(request_matcher* rm) {
     gpr_locked_mpscq_destroy(&rm->requests_per_cq[i]);
   }
   gpr_free(rm->requests_per_cq);
+  GPR_ASSERT(gpr_locked_mpscq_pop(&rm->pending) == nullptr);
+  gpr_locked_mpscq_destroy(&rm->pending);
 }
 
 static void kill_zombie(void* elem, grpc_error* error) {
@@ -327,16 +370,20 @@ static void kill_zombie(void* elem, grpc_error* error) {
       grpc_call_from_top_element(static_cast<grpc_call_element*>(elem)));
 }
 
+static void zombify_call(call_data* calld) {
+  gpr_atm_no_barrier_store(&calld->state, ZOMBIED);
+  GRPC_CLOSURE_INIT(
+      &calld->kill_zombie_closure, kill_zombie,
+      grpc_call_stack_element(grpc_call_get_call_stack(calld->call), 0),
+      grpc_schedule_on_exec_ctx);
+  GRPC_CLOSURE_SCHED(&calld->kill_zombie_closure, GRPC_ERROR_NONE);
+}
+
 static void request_matcher_zombify_all_pending_calls(request_matcher* rm) {
-  while (rm->pending_head) {
-    call_data* calld = rm->pending_head;
-    rm->pending_head = calld->pending_next;
-    gpr_atm_no_barrier_store(&calld->state, ZOMBIED);
-    GRPC_CLOSURE_INIT(
-        &calld->kill_zombie_closure, kill_zombie,
-        grpc_call_stack_element(grpc_call_get_call_stack(calld->call), 0),
-        grpc_schedule_on_exec_ctx);
-    GRPC_CLOSURE_SCHED(&calld->kill_zombie_closure, GRPC_ERROR_NONE);
+  call_data* calld;
+  while ((calld = reinterpret_cast<call_data*>(
+              gpr_locked_mpscq_pop(&rm->pending))) != nullptr) {
+    zombify_call(calld);
   }
 }
 
@@ -353,6 +400,63 @@ static void request_matcher_kill_requests(grpc_server* server,
   GRPC_ERROR_UNREF(error);
 }
 
+/* Fails or zombifies everything still queued on \a rm. Called at shutdown,
+   and by matching operations that notice the shutdown only after queueing
+   something, so that nothing is left behind once the server has drained the
+   matcher */
+static void request_matcher_drain(request_matcher* rm) {
+  request_matcher_kill_requests(
+      rm->server, rm, GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server Shutdown"));
+  request_matcher_zombify_all_pending_calls(rm);
+}
+
+/* Waits before retry \a attempt (from 0) to pop an item owed to the caller.
+   The item's producer has counted it and pushes it right after, so spin for a
+   while; if it is still missing, the producer was most likely descheduled in
+   between, so sleep for growing intervals to let it run instead of burning
+   the CPU it may need */
+static void request_matcher_owed_pop_backoff(size_t attempt) {
+  if (attempt < OWED_POP_SPINS) return;
+  const size_t doublings = GPR_MIN(attempt - OWED_POP_SPINS, size_t(10));
+  const int64_t sleep_us =
+      GPR_MIN(int64_t(1) << doublings, OWED_POP_MAX_SLEEP_US);
+  gpr_sleep_until(gpr_time_add(gpr_now(GPR_CLOCK_MONOTONIC),
+                               gpr_time_from_micros(sleep_us, GPR_TIMESPAN)));
+}
+
+/* Pops a requested call owed to the caller, scanning the cqs from
+   \a start_cq_idx. Returns nullptr if the server shuts down first. */
+static requested_call* request_matcher_pop_request(request_matcher* rm,
+                                                   size_t start_cq_idx,
+                                                   size_t* cq_idx) {
+  grpc_server* server = rm->server;
+  for (size_t i = 0;; i++) {
+    *cq_idx = (start_cq_idx + i) % server->cq_count;
+    requested_call* rc = reinterpret_cast<requested_call*>(
+        gpr_locked_mpscq_try_pop(&rm->requests_per_cq[*cq_idx]));
+    if (rc != nullptr) {
+      GRPC_STATS_INC_SERVER_CQS_CHECKED(i);
+      return rc;
+    }
+    if ((i + 1) % server->cq_count == 0) {
+      if (gpr_atm_acq_load(&server->shutdown_flag)) return nullptr;
+      request_matcher_owed_pop_backoff(i / server->cq_count);
+    }
+  }
+}
+
+/* Pops a pending call owed to the caller. Returns nullptr if the server shuts
+   down first. */
+static call_data* request_matcher_pop_pending_call(request_matcher* rm) {
+  for (size_t attempt = 0;; attempt++) {
+    call_data* calld = reinterpret_cast<call_data*>(
+        gpr_locked_mpscq_try_pop(&rm->pending));
+    if (calld != nullptr) return calld;
+    if (gpr_atm_acq_load(&rm->server->shutdown_flag)) return nullptr;
+    request_matcher_owed_pop_backoff(attempt);
+  }
+}
+
 /*
  * server proper
  */
@@ -489,52 +593,29 @@ static void publish_new_rpc(void* arg, grpc_error* error) {
     return;
   }
 
-  for (size_t i = 0; i < server->cq_count; i++) {
-    size_t cq_idx = (chand->cq_idx + i) % server->cq_count;
-    requested_call* rc = reinterpret_cast<requested_call*>(
-        gpr_locked_mpscq_try_pop(&rm->requests_per_cq[cq_idx]));
+  if (gpr_atm_full_fetch_add(&rm->balance, -1) > 0) {
+    /* a request is queued for us: take one, preferring our own cq */
+    size_t cq_idx;
+    requested_call* rc =
+        request_matcher_pop_request(rm, chand->cq_idx, &cq_idx);
     if (rc == nullptr) {
-      continue;
-    } else {
-      GRPC_STATS_INC_SERVER_CQS_CHECKED(i);
-      gpr_atm_no_barrier_store(&calld->state, ACTIVATED);
-      publish_call(server, calld, cq_idx, rc);
-      return; /* early out */
+      zombify_call(calld);
+      request_matcher_drain(rm);
+      return;
     }
+    gpr_atm_no_barrier_store(&calld->state, ACTIVATED);
+    publish_call(server, calld, cq_idx, rc);
+    return;
   }
 
-  /* no cq to take the request found: queue it on the slow list */
+  /* no request to take: queue the call on the slow list, where the next
+     request will find it */
   GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED();
-  gpr_mu_lock(&server->mu_call);
-
-  // We need to ensure that all the queues are empty.  We do this under
-  // the server mu_call lock to ensure that if something is added to
-  // an empty request queue, it will block until the call is actually
-  // added to the pending list.
-  for (size_t i = 0; i < server->cq_count; i++) {
-    size_t cq_idx = (chand->cq_idx + i) % server->cq_count;
-    requested_call* rc = reinterpret_cast<requested_call*>(
-        gpr_locked_mpscq_pop(&rm->requests_per_cq[cq_idx]));
-    if (rc == nullptr) {
-      continue;
-    } else {
-      gpr_mu_unlock(&server->mu_call);
-      GRPC_STATS_INC_SERVER_CQS_CHECKED(i + server->cq_count);
-      gpr_atm_no_barrier_store(&calld->state, ACTIVATED);
-      publish_call(server, calld, cq_idx, rc);
-      return; /* early out */
-    }
-  }
-
   gpr_atm_no_barrier_store(&calld->state, PENDING);
-  if (rm->pending_head == nullptr) {
-    rm->pending_tail = rm->pending_head = calld;
-  } else {
-    rm->pending_tail->pending_next = calld;
-    rm->pending_tail = calld;
+  gpr_locked_mpscq_push(&rm->pending, &calld->pending_link);
+  if (gpr_atm_acq_load(&server->shutdown_flag)) {
+    request_matcher_drain(rm);
   }
-  calld->pending_next = nullptr;
-  gpr_mu_unlock(&server->mu_call);
 }
 
 static void finish_start_new_rpc(
@@ -569,48 +650,66 @@ static void finish_start_new_rpc(
   }
 }
 
-static void start_new_rpc(grpc_call_element* elem) {
-  channel_data* chand = static_cast<channel_data*>(elem->channel_data);
-  call_data* calld = static_cast<call_data*>(elem->call_data);
-  grpc_server* server = chand->server;
-  uint32_t i;
-  uint32_t hash;
-  channel_registered_method* rm;
+/* Registered method paths and hosts are interned: when the incoming slice is
+   interned too, it is equal only if it is the very same slice */
+static bool registered_slice_eq(grpc_slice registered, grpc_slice incoming,
+                                bool incoming_interned) {
+  if (incoming_interned) return registered.refcount == incoming.refcount;
+  return grpc_slice_eq(registered, incoming);
+}
 
-  if (chand->registered_methods && calld->path_set && calld->host_set) {
-    /* TODO(ctiller): unify these two searches */
-    /* check for an exact match with host */
-    hash = GRPC_MDSTR_KV_HASH(grpc_slice_hash(calld->host),
-                              grpc_slice_hash(calld->path));
-    for (i = 0; i <= chand->registered_method_max_probes; i++) {
-      rm = &chand->registered_methods[(hash + i) %
-                                      chand->registered_method_slots];
-      if (!rm) break;
-      if (!rm->has_host) continue;
-      if (!grpc_slice_eq(rm->host, calld->host)) continue;
-      if (!grpc_slice_eq(rm->method, calld->path)) continue;
-      if ((rm->flags & GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST) &&
-          0 == (calld->recv_initial_metadata_flags &
-                GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST)) {
+static uint32_t registered_path_slot(const registered_path_table* index,
+                                     uint32_t hash, uint32_t seed) {
+  /* murmur3 finalizer: every seed gives a different spread of the hashes */
+  uint32_t h = hash ^ seed;
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h % index->num_slots;
+}
+
+static channel_registered_method* find_registered_method(
+    channel_data* chand, call_data* calld) {
+  uint32_t hash = grpc_slice_hash(calld->path);
+  const registered_path_table* index = &chand->registered_path_index;
+  uint32_t slot = registered_path_slot(
+      index, hash, index->seeds[hash % index->num_buckets]);
+  uint32_t path_idx = index->slots[slot];
+  if (path_idx == UINT32_MAX) return nullptr;
+  bool path_interned = grpc_slice_is_interned(calld->path);
+  bool host_interned = grpc_slice_is_interned(calld->host);
+  for (channel_registered_path* p = &chand->registered_paths[path_idx];
+       p != chand->registered_paths + chand->num_registered_paths &&
+       p->hash == hash;
+       p++) {
+    if (!registered_slice_eq(p->method, calld->path, path_interned)) continue;
+    for (channel_registered_method* rm = p->begin; rm != p->end; rm++) {
+      if (rm->has_host &&
+          !registered_slice_eq(rm->host, calld->host, host_interned)) {
         continue;
       }
-      finish_start_new_rpc(server, elem, &rm->server_registered_method->matcher,
-                           rm->server_registered_method->payload_handling);
-      return;
-    }
-    /* check for a wildcard method definition (no host set) */
-    hash = GRPC_MDSTR_KV_HASH(0, grpc_slice_hash(calld->path));
-    for (i = 0; i <= chand->registered_method_max_probes; i++) {
-      rm = &chand->registered_methods[(hash + i) %
-                                      chand->registered_method_slots];
-      if (!rm) break;
-      if (rm->has_host) continue;
-      if (!grpc_slice_eq(rm->method, calld->path)) continue;
       if ((rm->flags & GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST) &&
           0 == (calld->recv_initial_metadata_flags &
                 GRPC_INITIAL_METADATA_IDEMPOTENT_REQUEST)) {
         continue;
       }
+      return rm;
+    }
+    return nullptr;
+  }
+  return nullptr;
+}
+
+static void start_new_rpc(grpc_call_element* elem) {
+  channel_data* chand = static_cast<channel_data*>(elem->channel_data);
+  call_data* calld = static_cast<call_data*>(elem->call_data);
+  grpc_server* server = chand->server;
+
+  if (chand->registered_methods && calld->path_set && calld->host_set) {
+    channel_registered_method* rm = find_registered_method(chand, calld);
+    if (rm != nullptr) {
       finish_start_new_rpc(server, elem, &rm->server_registered_method->matcher,
                            rm->server_registered_method->payload_handling);
       return;
@@ -862,6 +961,11 @@ static grpc_error* init_channel_elem(grpc_channel_element* elem,
   chand->channel = nullptr;
   chand->next = chand->prev = chand;
   chand->registered_methods = nullptr;
+  chand->num_registered_methods = 0;
+  chand->registered_paths = nullptr;
+  chand->num_registered_paths = 0;
+  memset(&chand->registered_path_index, 0,
+         sizeof(chand->registered_path_index));
   chand->connectivity_state = GRPC_CHANNEL_IDLE;
   GRPC_CLOSURE_INIT(&chand->channel_connectivity_changed,
                     channel_connectivity_changed, chand,
@@ -873,13 +977,16 @@ static void destroy_channel_elem(grpc_channel_element* elem) {
   size_t i;
   channel_data* chand = static_cast<channel_data*>(elem->channel_data);
   if (chand->registered_methods) {
-    for (i = 0; i < chand->registered_method_slots; i++) {
+    for (i = 0; i < chand->num_registered_methods; i++) {
       grpc_slice_unref_internal(chand->registered_methods[i].method);
       if (chand->registered_methods[i].has_host) {
         grpc_slice_unref_internal(chand->registered_methods[i].host);
       }
     }
     gpr_free(chand->registered_methods);
+    gpr_free(chand->registered_paths);
+    gpr_free(chand->registered_path_index.seeds);
+    gpr_free(chand->registered_path_index.slots);
   }
   if (chand->server) {
     gpr_mu_lock(&chand->server->mu_global);
@@ -1052,19 +1159,161 @@ void grpc_server_get_pollsets(grpc_server* server, grpc_pollset*** pollsets,
   *pollsets = server->pollsets;
 }
 
+static int compare_channel_registered_methods(const void* a, const void* b) {
+  const channel_registered_method* x =
+      static_cast<const channel_registered_method*>(a);
+  const channel_registered_method* y =
+      static_cast<const channel_registered_method*>(b);
+  if (x->method_hash != y->method_hash) {
+    return x->method_hash < y->method_hash ? -1 : 1;
+  }
+  /* interned: equal paths share a refcount */
+  uintptr_t xm = reinterpret_cast<uintptr_t>(x->method.refcount);
+  uintptr_t ym = reinterpret_cast<uintptr_t>(y->method.refcount);
+  if (xm != ym) return xm < ym ? -1 : 1;
+  return static_cast<int>(y->has_host) - static_cast<int>(x->has_host);
+}
+
+/* Tries to place every distinct path hash with \a num_slots slots. Returns
+   false if some bucket found no seed, in which case the caller retries with
+   more slots. */
+static bool build_registered_path_index(channel_data* chand,
+                                        uint32_t num_hashes,
+                                        uint32_t num_slots) {
+  static const uint32_t kMaxSeed = 1 << 16;
+  registered_path_table* index = &chand->registered_path_index;
+  index->num_buckets = GPR_MAX(1, num_hashes / 2);
+  index->num_slots = num_slots;
+  gpr_free(index->seeds);
+  gpr_free(index->slots);
+  index->seeds =
+      static_cast<uint32_t*>(gpr_zalloc(sizeof(uint32_t) * index->num_buckets));
+  index->slots =
+      static_cast<uint32_t*>(gpr_malloc(sizeof(uint32_t) * num_slots));
+  memset(index->slots, 0xff, sizeof(uint32_t) * num_slots);
+  /* bucket the first path of each distinct hash */
+  uint32_t* bucket_size = static_cast<uint32_t*>(
+      gpr_zalloc(sizeof(uint32_t) * (index->num_buckets + 1)));
+  for (uint32_t i = 0; i < chand->num_registered_paths; i++) {
+    uint32_t hash = chand->registered_paths[i].hash;
+    if (i > 0 && chand->registered_paths[i - 1].hash == hash) continue;
+    bucket_size[hash % index->num_buckets + 1]++;
+  }
+  uint32_t* bucket_start = static_cast<uint32_t*>(
+      gpr_malloc(sizeof(uint32_t) * (index->num_buckets + 1)));
+  bucket_start[0] = 0;
+  for (uint32_t b = 0; b < index->num_buckets; b++) {
+    bucket_start[b + 1] = bucket_start[b] + bucket_size[b + 1];
+  }
+  uint32_t* bucket_paths =
+      static_cast<uint32_t*>(gpr_malloc(sizeof(uint32_t) * num_hashes));
+  memset(bucket_size, 0, sizeof(uint32_t) * (index->num_buckets + 1));
+  for (uint32_t i = 0; i < chand->num_registered_paths; i++) {
+    uint32_t hash = chand->registered_paths[i].hash;
+    if (i > 0 && chand->registered_paths[i - 1].hash == hash) continue;
+    uint32_t b = hash % index->num_buckets;
+    bucket_paths[bucket_start[b] + bucket_size[b]++] = i;
+  }
+  /* place the largest buckets first, while most slots are still free */
+  uint32_t* order = static_cast<uint32_t*>(
+      gpr_malloc(sizeof(uint32_t) * index->num_buckets));
+  uint32_t num_ordered = 0;
+  uint32_t max_size = 0;
+  for (uint32_t b = 0; b < index->num_buckets; b++) {
+    max_size = GPR_MAX(max_size, bucket_size[b]);
+  }
+  for (uint32_t size = max_size; size > 0; size--) {
+    for (uint32_t b = 0; b < index->num_buckets; b++) {
+      if (bucket_size[b] == size) order[num_ordered++] = b;
+    }
+  }
+  bool ok = true;
+  for (uint32_t o = 0; ok && o < num_ordered; o++) {
+    uint32_t b = order[o];
+    uint32_t* paths = bucket_paths + bucket_start[b];
+    uint32_t seed;
+    for (seed = 0; seed < kMaxSeed; seed++) {
+      uint32_t placed;
+      for (placed = 0; placed < bucket_size[b]; placed++) {
+        uint32_t slot = registered_path_slot(
+            index, chand->registered_paths[paths[placed]].hash, seed);
+        if (index->slots[slot] != UINT32_MAX) break;
+        index->slots[slot] = paths[placed];
+      }
+      if (placed == bucket_size[b]) break;
+      /* undo the partial placement */
+      while (placed-- > 0) {
+        index->slots[registered_path_slot(
+            index, chand->registered_paths[paths[placed]].hash, seed)] =
+            UINT32_MAX;
+      }
+    }
+    index->seeds[b] = seed;
+    ok = seed < kMaxSeed;
+  }
+  gpr_free(order);
+  gpr_free(bucket_paths);
+  gpr_free(bucket_start);
+  gpr_free(bucket_size);
+  return ok;
+}
+
+/* build a lookup table phrased in terms of mdstr's in this channels context
+   to quickly find registered methods */
+static void build_registered_method_table(channel_data* chand, grpc_server* s) {
+  uint32_t num_methods = 0;
+  for (registered_method* rm = s->registered_methods; rm; rm = rm->next) {
+    num_methods++;
+  }
+  if (num_methods == 0) return;
+  chand->registered_methods = static_cast<channel_registered_method*>(
+      gpr_zalloc(sizeof(channel_registered_method) * num_methods));
+  chand->num_registered_methods = num_methods;
+  channel_registered_method* crm = chand->registered_methods;
+  for (registered_method* rm = s->registered_methods; rm; rm = rm->next) {
+    crm->server_registered_method = rm;
+    crm->flags = rm->flags;
+    crm->has_host = rm->host != nullptr;
+    if (crm->has_host) {
+      crm->host = grpc_slice_intern(grpc_slice_from_static_string(rm->host));
+    }
+    crm->method = grpc_slice_intern(grpc_slice_from_static_string(rm->method));
+    crm->method_hash = grpc_slice_hash(crm->method);
+    crm++;
+  }
+  qsort(chand->registered_methods, num_methods,
+        sizeof(channel_registered_method), compare_channel_registered_methods);
+
+  /* one entry per distinct path */
+  chand->registered_paths = static_cast<channel_registered_path*>(
+      gpr_malloc(sizeof(channel_registered_path) * num_methods));
+  uint32_t num_hashes = 0;
+  channel_registered_path* path = nullptr;
+  for (crm = chand->registered_methods;
+       crm != chand->registered_methods + num_methods; crm++) {
+    if (path == nullptr || path->method.refcount != crm->method.refcount) {
+      if (path == nullptr || path->hash != crm->method_hash) num_hashes++;
+      path = &chand->registered_paths[chand->num_registered_paths++];
+      path->hash = crm->method_hash;
+      path->method = crm->method;
+      path->begin = crm;
+    }
+    path->end = crm + 1;
+  }
+
+  /* hash and displace nearly always succeeds with one slot per hash; if it
+     does not, a few spare slots make it easy */
+  uint32_t num_slots = num_hashes;
+  while (!build_registered_path_index(chand, num_hashes, num_slots)) {
+    num_slots += num_slots / 8 + 1;
+  }
+}
+
 void grpc_server_setup_transport(grpc_server* s, grpc_transport* transport,
                                  grpc_pollset* accepting_pollset,
                                  const grpc_channel_args* args) {
-  size_t num_registered_methods;
-  size_t alloc;
-  registered_method* rm;
-  channel_registered_method* crm;
   grpc_channel* channel;
   channel_data* chand;
-  uint32_t hash;
-  size_t slots;
-  uint32_t probes;
-  uint32_t max_probes = 0;
   grpc_transport_op* op = nullptr;
 
   channel = grpc_channel_create(nullptr, args, GRPC_SERVER_CHANNEL, transport);
@@ -1085,48 +1334,7 @@ void grpc_server_setup_transport(grpc_server* s, grpc_transport* transport,
   }
   chand->cq_idx = cq_idx;
 
-  num_registered_methods = 0;
-  for (rm = s->registered_methods; rm; rm = rm->next) {
-    num_registered_methods++;
-  }
-  /* build a lookup table phrased in terms of mdstr's in this channels context
-     to quickly find registered methods */
-  if (num_registered_methods > 0) {
-    slots = 2 * num_registered_methods;
-    alloc = sizeof(channel_registered_method) * slots;
-    chand->registered_methods =
-        static_cast<channel_registered_method*>(gpr_zalloc(alloc));
-    for (rm = s->registered_methods; rm; rm = rm->next) {
-      grpc_slice host;
-      bool has_host;
-      grpc_slice method;
-      if (rm->host != nullptr) {
-        host = grpc_slice_intern(grpc_slice_from_static_string(rm->host));
-        has_host = true;
-      } else {
-        has_host = false;
-      }
-      method = grpc_slice_intern(grpc_slice_from_static_string(rm->method));
-      hash = GRPC_MDSTR_KV_HASH(has_host ? grpc_slice_hash(host) : 0,
-                                grpc_slice_hash(method));
-      for (probes = 0; chand->registered_methods[(hash + probes) % slots]
-                           .server_registered_method != nullptr;
-           probes++)
-        ;
-      if (probes > max_probes) max_probes = probes;
-      crm = &chand->registered_methods[(hash + probes) % slots];
-      crm->server_registered_method = rm;
-      crm->flags = rm->flags;
-      crm->has_host = has_host;
-      if (has_host) {
-        crm->host = host;
-      }
-      crm->method = method;
-    }
-    GPR_ASSERT(slots <= UINT32_MAX);
-    chand->registered_method_slots = static_cast<uint32_t>(slots);
-    chand->registered_method_max_probes = max_probes;
-  }
+  build_registered_method_table(chand, s);
 
   gpr_mu_lock(&s->mu_global);
   chand->next = &s->root_channel_data;
@@ -1218,7 +1426,9 @@ void grpc_server_shutdown_and_notify(grpc_server* server,
 
   channel_broadcaster_init(server, &broadcaster);
 
-  gpr_atm_rel_store(&server->shutdown_flag, 1);
+  /* full barrier: matching operations queue before they check the flag, and
+     the pending work is collected after setting it */
+  gpr_atm_full_xchg(&server->shutdown_flag, 1);
 
   /* collect all unregistered then registered calls */
   gpr_mu_lock(&server->mu_call);
@@ -1292,7 +1502,6 @@ void grpc_server_add_listener(grpc_server* server, void* arg,
 
 static grpc_call_error queue_call_request(grpc_server* server, size_t cq_idx,
                                           requested_call* rc) {
-  call_data* calld = nullptr;
   request_matcher* rm = nullptr;
   if (gpr_atm_acq_load(&server->shutdown_flag)) {
     fail_call(server, cq_idx, rc,
@@ -1307,29 +1516,37 @@ static grpc_call_error queue_call_request(grpc_server* server, size_t cq_idx,
       rm = &rc->data.registered.method->matcher;
       break;
   }
-  if (gpr_locked_mpscq_push(&rm->requests_per_cq[cq_idx], &rc->request_link)) {
-    /* this was the first queued request: we need to lock and start
-       matching calls */
-    gpr_mu_lock(&server->mu_call);
-    while ((calld = rm->pending_head) != nullptr) {
-      rc = reinterpret_cast<requested_call*>(
-          gpr_locked_mpscq_pop(&rm->requests_per_cq[cq_idx]));
-      if (rc == nullptr) break;
-      rm->pending_head = calld->pending_next;
-      gpr_mu_unlock(&server->mu_call);
-      if (!gpr_atm_full_cas(&calld->state, PENDING, ACTIVATED)) {
-        // Zombied Call
-        GRPC_CLOSURE_INIT(
-            &calld->kill_zombie_closure, kill_zombie,
-            grpc_call_stack_element(grpc_call_get_call_stack(calld->call), 0),
-            grpc_schedule_on_exec_ctx);
-        GRPC_CLOSURE_SCHED(&calld->kill_zombie_closure, GRPC_ERROR_NONE);
-      } else {
-        publish_call(server, calld, cq_idx, rc);
-      }
-      gpr_mu_lock(&server->mu_call);
+  gpr_locked_mpscq_push(&rm->requests_per_cq[cq_idx], &rc->request_link);
+  if (gpr_atm_acq_load(&server->shutdown_flag)) {
+    request_matcher_drain(rm);
+    return GRPC_CALL_OK;
+  }
+  /* a negative balance means a call is pending: match it with a request */
+  while (gpr_atm_full_fetch_add(&rm->balance, 1) < 0) {
+    call_data* calld = request_matcher_pop_pending_call(rm);
+    if (calld == nullptr) {
+      request_matcher_drain(rm);
+      break;
+    }
+    if (!gpr_atm_full_cas(&calld->state, PENDING, ACTIVATED)) {
+      // Zombied Call: our request is still queued, so count it again and
+      // look for another call
+      GRPC_CLOSURE_INIT(
+          &calld->kill_zombie_closure, kill_zombie,
+          grpc_call_stack_element(grpc_call_get_call_stack(calld->call), 0),
+          grpc_schedule_on_exec_ctx);
+      GRPC_CLOSURE_SCHED(&calld->kill_zombie_closure, GRPC_ERROR_NONE);
+      continue;
+    }
+    size_t rc_cq_idx;
+    requested_call* match = request_matcher_pop_request(rm, cq_idx, &rc_cq_idx);
+    if (match == nullptr) {
+      zombify_call(calld);
+      request_matcher_drain(rm);
+      break;
     }
-    gpr_mu_unlock(&server->mu_call);
+    publish_call(server, calld, rc_cq_idx, match);
+    break;
   }
   return GRPC_CALL_OK;
 }
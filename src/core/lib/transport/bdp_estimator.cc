@@ -37,6 +37,7 @@ BdpEstimator::BdpEstimator(const char* name)
       inter_ping_delay_(100.0),  // start at 100ms
       stable_estimate_count_(0),
       bw_est_(0),
+      rtt_est_(0),
       name_(name) {}
 
 grpc_millis BdpEstimator::CompletePing() {
@@ -54,6 +55,8 @@ grpc_millis BdpEstimator::CompletePing() {
             bw_est_ / 125000.0);
   }
   GPR_ASSERT(ping_state_ == PingState::STARTED);
+  // same smoothing as TCP's SRTT (RFC 6298)
+  rtt_est_ = rtt_est_ == 0 ? dt : 0.875 * rtt_est_ + 0.125 * dt;
   if (accumulator_ > 2 * estimate_ / 3 && bw > bw_est_) {
     estimate_ = GPR_MAX(accumulator_, estimate_ * 2);
     bw_est_ = bw;
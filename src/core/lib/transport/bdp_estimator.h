@@ -42,6 +42,9 @@ class BdpEstimator {
 
   int64_t EstimateBdp() const { return estimate_; }
   double EstimateBandwidth() const { return bw_est_; }
+  // Smoothed round trip time of the pings, in seconds; zero until the first
+  // ping completes
+  double EstimateRtt() const { return rtt_est_; }
 
   void AddIncomingBytes(int64_t num_bytes) { accumulator_ += num_bytes; }
 
@@ -86,6 +89,7 @@ class BdpEstimator {
   int inter_ping_delay_;
   int stable_estimate_count_;
   double bw_est_;
+  double rtt_est_;
   const char* name_;
 };
 
@@ -35,6 +35,8 @@
 
 #include "src/core/lib/gpr/murmur_hash.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gprpp/grace_period.h"
+#include "src/core/lib/gprpp/inlined_vector.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/slice/slice_internal.h"
@@ -55,11 +57,11 @@ grpc_core::DebugOnlyTraceFlag grpc_trace_metadata(false, "metadata");
 #ifndef NDEBUG
 #define DEBUG_ARGS , const char *file, int line
 #define FWD_DEBUG_ARGS , file, line
-#define REF_MD_LOCKED(shard, s) ref_md_locked((shard), (s), __FILE__, __LINE__)
+#define REF_MD(shard, s) ref_md((shard), (s), __FILE__, __LINE__)
 #else
 #define DEBUG_ARGS
 #define FWD_DEBUG_ARGS
-#define REF_MD_LOCKED(shard, s) ref_md_locked((shard), (s))
+#define REF_MD(shard, s) ref_md((shard), (s))
 #endif
 
 #define INITIAL_SHARD_CAPACITY 8
@@ -84,7 +86,7 @@ typedef struct interned_metadata {
   gpr_atm destroy_user_data;
   gpr_atm user_data;
 
-  struct interned_metadata* bucket_next;
+  gpr_atm bucket_next; /* interned_metadata* */
 } interned_metadata;
 
 /* Shadow structure for grpc_mdelem_data for allocated elements */
@@ -97,11 +99,15 @@ typedef struct allocated_metadata {
   gpr_atm refcnt;
 } allocated_metadata;
 
+/* Lookups of existing elements walk a shard without taking its lock (see
+   find_and_ref): only inserting, collecting and resizing take mu, and memory
+   they unlink is freed only once a grace period has passed. */
 typedef struct mdtab_shard {
   gpr_mu mu;
-  interned_metadata** elems;
+  grpc_core::GracePeriod grace;
+  gpr_atm elems;    /* gpr_atm[capacity] of interned_metadata* */
+  gpr_atm capacity; /* only ever grows */
   size_t count;
-  size_t capacity;
   /** Estimate of the number of unreferenced mdelems in the hash table.
       This will eventually converge to the exact number, but it's instantaneous
       accuracy is not guaranteed */
@@ -112,6 +118,14 @@ static mdtab_shard g_shards[SHARD_COUNT];
 
 static void gc_mdtab(mdtab_shard* shard);
 
+static gpr_atm* shard_elems(mdtab_shard* shard) {
+  return reinterpret_cast<gpr_atm*>(gpr_atm_acq_load(&shard->elems));
+}
+
+static interned_metadata* next_in_bucket(gpr_atm* link) {
+  return reinterpret_cast<interned_metadata*>(gpr_atm_acq_load(link));
+}
+
 void grpc_mdctx_global_init(void) {
   /* initialize shards */
   for (size_t i = 0; i < SHARD_COUNT; i++) {
@@ -119,9 +133,10 @@ void grpc_mdctx_global_init(void) {
     gpr_mu_init(&shard->mu);
     shard->count = 0;
     gpr_atm_no_barrier_store(&shard->free_estimate, 0);
-    shard->capacity = INITIAL_SHARD_CAPACITY;
-    shard->elems = static_cast<interned_metadata**>(
-        gpr_zalloc(sizeof(*shard->elems) * shard->capacity));
+    gpr_atm_no_barrier_store(&shard->capacity, INITIAL_SHARD_CAPACITY);
+    gpr_atm_no_barrier_store(
+        &shard->elems,
+        (gpr_atm)gpr_zalloc(sizeof(gpr_atm) * INITIAL_SHARD_CAPACITY));
   }
 }
 
@@ -138,7 +153,7 @@ void grpc_mdctx_global_shutdown() {
         abort();
       }
     }
-    gpr_free(shard->elems);
+    gpr_free(shard_elems(shard));
   }
 }
 
@@ -148,94 +163,139 @@ static int is_mdelem_static(grpc_mdelem e) {
              &grpc_static_mdelem_table[GRPC_STATIC_MDELEM_COUNT];
 }
 
-static void ref_md_locked(mdtab_shard* shard,
-                          interned_metadata* md DEBUG_ARGS) {
+/* Refcount of an element gc_mdtab has claimed: it can't be revived anymore */
+#define MDELEM_COLLECTED (static_cast<gpr_atm>(-1))
+
+/* Takes a ref to \a md, reviving it if it had none left, unless gc_mdtab has
+   already claimed it. Needs no lock: gc_mdtab claims an element by swapping
+   its refcount from zero to MDELEM_COLLECTED, and this races with it by CAS */
+static bool ref_md(mdtab_shard* shard, interned_metadata* md DEBUG_ARGS) {
+  gpr_atm count;
+  do {
+    count = gpr_atm_no_barrier_load(&md->refcnt);
+    if (count == MDELEM_COLLECTED) return false;
+  } while (!gpr_atm_no_barrier_cas(&md->refcnt, count, count + 1));
 #ifndef NDEBUG
   if (grpc_trace_metadata.enabled()) {
     char* key_str = grpc_slice_to_c_string(md->key);
     char* value_str = grpc_slice_to_c_string(md->value);
     gpr_log(file, line, GPR_LOG_SEVERITY_DEBUG,
             "ELM   REF:%p:%" PRIdPTR "->%" PRIdPTR ": '%s' = '%s'", (void*)md,
-            gpr_atm_no_barrier_load(&md->refcnt),
-            gpr_atm_no_barrier_load(&md->refcnt) + 1, key_str, value_str);
+            count, count + 1, key_str, value_str);
     gpr_free(key_str);
     gpr_free(value_str);
   }
 #endif
-  if (0 == gpr_atm_no_barrier_fetch_add(&md->refcnt, 1)) {
+  if (count == 0) {
     gpr_atm_no_barrier_fetch_add(&shard->free_estimate, -1);
   }
+  return true;
 }
 
 static void gc_mdtab(mdtab_shard* shard) {
   GPR_TIMER_SCOPE("gc_mdtab", 0);
 
   size_t i;
-  interned_metadata** prev_next;
+  size_t capacity =
+      static_cast<size_t>(gpr_atm_no_barrier_load(&shard->capacity));
+  gpr_atm* elems = shard_elems(shard);
+  gpr_atm* prev_next;
   interned_metadata *md, *next;
-  gpr_atm num_freed = 0;
-
-  for (i = 0; i < shard->capacity; i++) {
-    prev_next = &shard->elems[i];
-    for (md = shard->elems[i]; md; md = next) {
-      void* user_data = (void*)gpr_atm_no_barrier_load(&md->user_data);
-      next = md->bucket_next;
-      if (gpr_atm_acq_load(&md->refcnt) == 0) {
-        grpc_slice_unref_internal(md->key);
-        grpc_slice_unref_internal(md->value);
-        if (md->user_data) {
-          ((destroy_user_data_func)gpr_atm_no_barrier_load(
-              &md->destroy_user_data))(user_data);
-        }
-        gpr_free(md);
-        *prev_next = next;
-        num_freed++;
+  grpc_core::InlinedVector<interned_metadata*, 16> unlinked;
+
+  for (i = 0; i < capacity; i++) {
+    prev_next = &elems[i];
+    for (md = next_in_bucket(prev_next); md; md = next) {
+      next = next_in_bucket(&md->bucket_next);
+      if (gpr_atm_acq_cas(&md->refcnt, 0, MDELEM_COLLECTED)) {
+        /* md->bucket_next is left alone: lookups may be walking through it */
+        gpr_atm_rel_store(prev_next, (gpr_atm)next);
+        unlinked.push_back(md);
         shard->count--;
       } else {
         prev_next = &md->bucket_next;
       }
     }
   }
-  gpr_atm_no_barrier_fetch_add(&shard->free_estimate, -num_freed);
+  if (unlinked.size() == 0) return;
+  shard->grace.Synchronize();
+  for (i = 0; i < unlinked.size(); i++) {
+    md = unlinked[i];
+    void* user_data = (void*)gpr_atm_no_barrier_load(&md->user_data);
+    grpc_slice_unref_internal(md->key);
+    grpc_slice_unref_internal(md->value);
+    if (user_data) {
+      ((destroy_user_data_func)gpr_atm_no_barrier_load(
+          &md->destroy_user_data))(user_data);
+    }
+    gpr_free(md);
+  }
+  gpr_atm_no_barrier_fetch_add(&shard->free_estimate,
+                               -static_cast<gpr_atm>(unlinked.size()));
 }
 
 static void grow_mdtab(mdtab_shard* shard) {
   GPR_TIMER_SCOPE("grow_mdtab", 0);
 
-  size_t capacity = shard->capacity * 2;
+  size_t old_capacity =
+      static_cast<size_t>(gpr_atm_no_barrier_load(&shard->capacity));
+  size_t capacity = old_capacity * 2;
   size_t i;
-  interned_metadata** mdtab;
+  gpr_atm* old_mdtab = shard_elems(shard);
+  gpr_atm* mdtab;
   interned_metadata *md, *next;
   uint32_t hash;
 
-  mdtab = static_cast<interned_metadata**>(
-      gpr_zalloc(sizeof(interned_metadata*) * capacity));
+  mdtab = static_cast<gpr_atm*>(gpr_zalloc(sizeof(gpr_atm) * capacity));
 
-  for (i = 0; i < shard->capacity; i++) {
-    for (md = shard->elems[i]; md; md = next) {
+  /* Relinking in place can make a concurrent lookup miss, but never loop:
+     the lookup then retries under the lock */
+  for (i = 0; i < old_capacity; i++) {
+    for (md = next_in_bucket(&old_mdtab[i]); md; md = next) {
       size_t idx;
       hash = GRPC_MDSTR_KV_HASH(grpc_slice_hash(md->key),
                                 grpc_slice_hash(md->value));
-      next = md->bucket_next;
+      next = next_in_bucket(&md->bucket_next);
       idx = TABLE_IDX(hash, capacity);
-      md->bucket_next = mdtab[idx];
-      mdtab[idx] = md;
+      gpr_atm_rel_store(&md->bucket_next, mdtab[idx]);
+      mdtab[idx] = (gpr_atm)md;
     }
   }
-  gpr_free(shard->elems);
-  shard->elems = mdtab;
-  shard->capacity = capacity;
+  /* publish the table before its capacity: a lookup pairing the old capacity
+     with the new table stays in bounds */
+  gpr_atm_rel_store(&shard->elems, (gpr_atm)mdtab);
+  gpr_atm_rel_store(&shard->capacity, (gpr_atm)capacity);
+  shard->grace.Synchronize();
+  gpr_free(old_mdtab);
 }
 
 static void rehash_mdtab(mdtab_shard* shard) {
   if (gpr_atm_no_barrier_load(&shard->free_estimate) >
-      static_cast<gpr_atm>(shard->capacity / 4)) {
+      gpr_atm_no_barrier_load(&shard->capacity) / 4) {
     gc_mdtab(shard);
   } else {
     grow_mdtab(shard);
   }
 }
 
+/* Returns a new ref to the element for \a key and \a value, or nullptr.
+   Without the shard lock, this must be called in a read-side section of
+   shard->grace, and can miss an element that a concurrent grow_mdtab is
+   moving. */
+static interned_metadata* find_and_ref(mdtab_shard* shard, grpc_slice key,
+                                       grpc_slice value, uint32_t hash) {
+  size_t capacity = static_cast<size_t>(gpr_atm_acq_load(&shard->capacity));
+  interned_metadata* md;
+  for (md = next_in_bucket(&shard_elems(shard)[TABLE_IDX(hash, capacity)]);
+       md; md = next_in_bucket(&md->bucket_next)) {
+    if (grpc_slice_eq(key, md->key) && grpc_slice_eq(value, md->value) &&
+        REF_MD(shard, md)) {
+      break;
+    }
+  }
+  return md;
+}
+
 grpc_mdelem grpc_mdelem_create(
     grpc_slice key, grpc_slice value,
     grpc_mdelem_data* compatible_external_backing_store) {
@@ -277,20 +337,24 @@ grpc_mdelem grpc_mdelem_create(
       GRPC_MDSTR_KV_HASH(grpc_slice_hash(key), grpc_slice_hash(value));
   interned_metadata* md;
   mdtab_shard* shard = &g_shards[SHARD_IDX(hash)];
-  size_t idx;
+  size_t capacity;
 
   GPR_TIMER_SCOPE("grpc_mdelem_from_metadata_strings", 0);
 
+  /* search for an existing pair, first without the lock */
+  gpr_atm epoch = shard->grace.ReadLock();
+  md = find_and_ref(shard, key, value, hash);
+  shard->grace.ReadUnlock(epoch);
+  if (md != nullptr) {
+    return GRPC_MAKE_MDELEM(md, GRPC_MDELEM_STORAGE_INTERNED);
+  }
+
   gpr_mu_lock(&shard->mu);
 
-  idx = TABLE_IDX(hash, shard->capacity);
-  /* search for an existing pair */
-  for (md = shard->elems[idx]; md; md = md->bucket_next) {
-    if (grpc_slice_eq(key, md->key) && grpc_slice_eq(value, md->value)) {
-      REF_MD_LOCKED(shard, md);
-      gpr_mu_unlock(&shard->mu);
-      return GRPC_MAKE_MDELEM(md, GRPC_MDELEM_STORAGE_INTERNED);
-    }
+  md = find_and_ref(shard, key, value, hash);
+  if (md != nullptr) {
+    gpr_mu_unlock(&shard->mu);
+    return GRPC_MAKE_MDELEM(md, GRPC_MDELEM_STORAGE_INTERNED);
   }
 
   /* not found: create a new pair */
@@ -300,9 +364,11 @@ grpc_mdelem grpc_mdelem_create(
   md->value = grpc_slice_ref_internal(value);
   md->user_data = 0;
   md->destroy_user_data = 0;
-  md->bucket_next = shard->elems[idx];
-  shard->elems[idx] = md;
   gpr_mu_init(&md->mu_user_data);
+  capacity = static_cast<size_t>(gpr_atm_no_barrier_load(&shard->capacity));
+  gpr_atm* bucket = &shard_elems(shard)[TABLE_IDX(hash, capacity)];
+  gpr_atm_no_barrier_store(&md->bucket_next, gpr_atm_no_barrier_load(bucket));
+  gpr_atm_rel_store(bucket, (gpr_atm)md);
 #ifndef NDEBUG
   if (grpc_trace_metadata.enabled()) {
     char* key_str = grpc_slice_to_c_string(md->key);
@@ -315,7 +381,7 @@ grpc_mdelem grpc_mdelem_create(
 #endif
   shard->count++;
 
-  if (shard->count > shard->capacity * 2) {
+  if (shard->count > capacity * 2) {
     rehash_mdtab(shard);
   }
 
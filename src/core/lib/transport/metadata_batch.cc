@@ -21,6 +21,7 @@
 #include "src/core/lib/transport/metadata_batch.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #include <grpc/support/alloc.h>
@@ -30,32 +31,27 @@
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 
+static grpc_linked_mdelem** list_elems(grpc_mdelem_list* list) {
+  return list->overflow != nullptr ? list->overflow : list->inline_elems;
+}
+
 static void assert_valid_list(grpc_mdelem_list* list) {
 #ifndef NDEBUG
-  grpc_linked_mdelem* l;
-
-  GPR_ASSERT((list->head == nullptr) == (list->tail == nullptr));
-  if (!list->head) return;
-  GPR_ASSERT(list->head->prev == nullptr);
-  GPR_ASSERT(list->tail->next == nullptr);
-  GPR_ASSERT((list->head == list->tail) == (list->head->next == nullptr));
-
-  size_t verified_count = 0;
-  for (l = list->head; l; l = l->next) {
-    GPR_ASSERT(!GRPC_MDISNULL(l->md));
-    GPR_ASSERT((l->prev == nullptr) == (l == list->head));
-    GPR_ASSERT((l->next == nullptr) == (l == list->tail));
-    if (l->next) GPR_ASSERT(l->next->prev == l);
-    if (l->prev) GPR_ASSERT(l->prev->next == l);
-    verified_count++;
+  GPR_ASSERT(list->overflow == nullptr
+                 ? list->count <= GRPC_MDELEM_LIST_INLINE_CAPACITY
+                 : list->count <= list->capacity);
+  grpc_linked_mdelem** elems = list_elems(list);
+  for (size_t i = 0; i < list->count; i++) {
+    GPR_ASSERT(!GRPC_MDISNULL(elems[i]->md));
   }
-  GPR_ASSERT(list->count == verified_count);
 #endif /* NDEBUG */
 }
 
 static void assert_valid_callouts(grpc_metadata_batch* batch) {
 #ifndef NDEBUG
-  for (grpc_linked_mdelem* l = batch->list.head; l != nullptr; l = l->next) {
+  grpc_linked_mdelem** elems = list_elems(&batch->list);
+  for (size_t i = 0; i < batch->list.count; i++) {
+    grpc_linked_mdelem* l = elems[i];
     grpc_slice key_interned = grpc_slice_intern(GRPC_MDKEY(l->md));
     grpc_metadata_batch_callouts_index callout_idx =
         GRPC_BATCH_INDEX_OF(key_interned);
@@ -74,15 +70,18 @@ void grpc_metadata_batch_assert_ok(grpc_metadata_batch* batch) {
 #endif /* NDEBUG */
 
 void grpc_metadata_batch_init(grpc_metadata_batch* batch) {
-  memset(batch, 0, sizeof(*batch));
+  /* inline_elems beyond count are never read: leave them be */
+  memset(&batch->list, 0, offsetof(grpc_mdelem_list, inline_elems));
+  memset(&batch->idx, 0, sizeof(batch->idx));
   batch->deadline = GRPC_MILLIS_INF_FUTURE;
 }
 
 void grpc_metadata_batch_destroy(grpc_metadata_batch* batch) {
-  grpc_linked_mdelem* l;
-  for (l = batch->list.head; l; l = l->next) {
-    GRPC_MDELEM_UNREF(l->md);
+  grpc_linked_mdelem** elems = list_elems(&batch->list);
+  for (size_t i = 0; i < batch->list.count; i++) {
+    GRPC_MDELEM_UNREF(elems[i]->md);
   }
+  if (batch->list.overflow != nullptr) gpr_free(batch->list.overflow);
 }
 
 grpc_error* grpc_attach_md_to_error(grpc_error* src, grpc_mdelem md) {
@@ -134,17 +133,30 @@ grpc_error* grpc_metadata_batch_add_head(grpc_metadata_batch* batch,
   return grpc_metadata_batch_link_head(batch, storage);
 }
 
+/* Make room for one more element: moves the elements to the heap once they
+   outgrow the inline array, and grows the heap array geometrically */
+static void reserve_one(grpc_mdelem_list* list) {
+  if (list->overflow == nullptr) {
+    if (list->count < GRPC_MDELEM_LIST_INLINE_CAPACITY) return;
+    list->capacity = 4 * GRPC_MDELEM_LIST_INLINE_CAPACITY;
+    list->overflow = static_cast<grpc_linked_mdelem**>(
+        gpr_malloc(sizeof(*list->overflow) * list->capacity));
+    memcpy(list->overflow, list->inline_elems,
+           sizeof(*list->overflow) * list->count);
+  } else if (list->count == list->capacity) {
+    list->capacity *= 2;
+    list->overflow = static_cast<grpc_linked_mdelem**>(gpr_realloc(
+        list->overflow, sizeof(*list->overflow) * list->capacity));
+  }
+}
+
 static void link_head(grpc_mdelem_list* list, grpc_linked_mdelem* storage) {
   assert_valid_list(list);
   GPR_ASSERT(!GRPC_MDISNULL(storage->md));
-  storage->prev = nullptr;
-  storage->next = list->head;
-  if (list->head != nullptr) {
-    list->head->prev = storage;
-  } else {
-    list->tail = storage;
-  }
-  list->head = storage;
+  reserve_one(list);
+  grpc_linked_mdelem** elems = list_elems(list);
+  memmove(elems + 1, elems, sizeof(*elems) * list->count);
+  elems[0] = storage;
   list->count++;
   assert_valid_list(list);
 }
@@ -173,16 +185,9 @@ grpc_error* grpc_metadata_batch_add_tail(grpc_metadata_batch* batch,
 static void link_tail(grpc_mdelem_list* list, grpc_linked_mdelem* storage) {
   assert_valid_list(list);
   GPR_ASSERT(!GRPC_MDISNULL(storage->md));
-  storage->prev = list->tail;
-  storage->next = nullptr;
   storage->reserved = nullptr;
-  if (list->tail != nullptr) {
-    list->tail->next = storage;
-  } else {
-    list->head = storage;
-  }
-  list->tail = storage;
-  list->count++;
+  reserve_one(list);
+  list_elems(list)[list->count++] = storage;
   assert_valid_list(list);
 }
 
@@ -202,17 +207,14 @@ grpc_error* grpc_metadata_batch_link_tail(grpc_metadata_batch* batch,
 static void unlink_storage(grpc_mdelem_list* list,
                            grpc_linked_mdelem* storage) {
   assert_valid_list(list);
-  if (storage->prev != nullptr) {
-    storage->prev->next = storage->next;
-  } else {
-    list->head = storage->next;
-  }
-  if (storage->next != nullptr) {
-    storage->next->prev = storage->prev;
-  } else {
-    list->tail = storage->prev;
+  grpc_linked_mdelem** elems = list_elems(list);
+  size_t i = 0;
+  while (elems[i] != storage) {
+    i++;
+    GPR_ASSERT(i < list->count);
   }
   list->count--;
+  memmove(elems + i, elems + i + 1, sizeof(*elems) * (list->count - i));
   assert_valid_list(list);
 }
 
@@ -262,15 +264,14 @@ void grpc_metadata_batch_clear(grpc_metadata_batch* batch) {
 }
 
 bool grpc_metadata_batch_is_empty(grpc_metadata_batch* batch) {
-  return batch->list.head == nullptr &&
-         batch->deadline == GRPC_MILLIS_INF_FUTURE;
+  return batch->list.count == 0 && batch->deadline == GRPC_MILLIS_INF_FUTURE;
 }
 
 size_t grpc_metadata_batch_size(grpc_metadata_batch* batch) {
   size_t size = 0;
-  for (grpc_linked_mdelem* elem = batch->list.head; elem != nullptr;
-       elem = elem->next) {
-    size += GRPC_MDELEM_LENGTH(elem->md);
+  grpc_linked_mdelem** elems = list_elems(&batch->list);
+  for (size_t i = 0; i < batch->list.count; i++) {
+    size += GRPC_MDELEM_LENGTH(elems[i]->md);
   }
   return size;
 }
@@ -288,10 +289,11 @@ grpc_error* grpc_metadata_batch_filter(grpc_metadata_batch* batch,
                                        grpc_metadata_batch_filter_func func,
                                        void* user_data,
                                        const char* composite_error_string) {
-  grpc_linked_mdelem* l = batch->list.head;
   grpc_error* error = GRPC_ERROR_NONE;
-  while (l) {
-    grpc_linked_mdelem* next = l->next;
+  size_t i = 0;
+  while (i < batch->list.count) {
+    grpc_linked_mdelem* l = list_elems(&batch->list)[i];
+    size_t count = batch->list.count;
     grpc_filtered_mdelem new_mdelem = func(user_data, l->md);
     add_error(&error, new_mdelem.error, composite_error_string);
     if (GRPC_MDISNULL(new_mdelem.md)) {
@@ -299,7 +301,8 @@ grpc_error* grpc_metadata_batch_filter(grpc_metadata_batch* batch,
     } else if (new_mdelem.md.payload != l->md.payload) {
       grpc_metadata_batch_substitute(batch, l, new_mdelem.md);
     }
-    l = next;
+    /* if l was removed, the next element has taken its place */
+    if (batch->list.count == count) i++;
   }
   return error;
 }
@@ -309,11 +312,10 @@ void grpc_metadata_batch_copy(grpc_metadata_batch* src,
                               grpc_linked_mdelem* storage) {
   grpc_metadata_batch_init(dst);
   dst->deadline = src->deadline;
-  size_t i = 0;
-  for (grpc_linked_mdelem* elem = src->list.head; elem != nullptr;
-       elem = elem->next) {
-    grpc_error* error = grpc_metadata_batch_add_tail(dst, &storage[i++],
-                                                     GRPC_MDELEM_REF(elem->md));
+  grpc_linked_mdelem** elems = list_elems(&src->list);
+  for (size_t i = 0; i < src->list.count; i++) {
+    grpc_error* error = grpc_metadata_batch_add_tail(
+        dst, &storage[i], GRPC_MDELEM_REF(elems[i]->md));
     // The only way that grpc_metadata_batch_add_tail() can fail is if
     // there's a duplicate entry for a callout.  However, that can't be
     // the case here, because we would not have been allowed to create
@@ -324,6 +326,7 @@ void grpc_metadata_batch_copy(grpc_metadata_batch* src,
 
 void grpc_metadata_batch_move(grpc_metadata_batch* src,
                               grpc_metadata_batch* dst) {
+  /* the heap array, if any, changes hands */
   *dst = *src;
   grpc_metadata_batch_init(src);
 }
@@ -32,16 +32,24 @@
 
 typedef struct grpc_linked_mdelem {
   grpc_mdelem md;
-  struct grpc_linked_mdelem* next;
-  struct grpc_linked_mdelem* prev;
   void* reserved;
 } grpc_linked_mdelem;
 
+/** Number of elements a batch holds before spilling to the heap */
+#define GRPC_MDELEM_LIST_INLINE_CAPACITY 16
+
+/** The elements of a batch, in order, as a flat array of pointers to their
+    (caller owned) storage. Iterating reads consecutive pointers rather than
+    chasing links, and the callouts still point straight at the storage.
+    A zeroed list is a valid empty one. */
 typedef struct grpc_mdelem_list {
   size_t count;
   size_t default_count;  // Number of default keys.
-  grpc_linked_mdelem* head;
-  grpc_linked_mdelem* tail;
+  /** Heap array of \a capacity elements, or nullptr while the elements fit
+      in \a inline_elems */
+  grpc_linked_mdelem** overflow;
+  size_t capacity;
+  grpc_linked_mdelem* inline_elems[GRPC_MDELEM_LIST_INLINE_CAPACITY];
 } grpc_mdelem_list;
 
 typedef struct grpc_metadata_batch {
@@ -54,6 +62,13 @@ typedef struct grpc_metadata_batch {
   grpc_millis deadline;
 } grpc_metadata_batch;
 
+/** The elements of \a batch, in order: valid until the batch is modified */
+inline grpc_linked_mdelem* const* grpc_metadata_batch_elems(
+    const grpc_metadata_batch* batch) {
+  return batch->list.overflow != nullptr ? batch->list.overflow
+                                         : batch->list.inline_elems;
+}
+
 void grpc_metadata_batch_init(grpc_metadata_batch* batch);
 void grpc_metadata_batch_destroy(grpc_metadata_batch* batch);
 void grpc_metadata_batch_clear(grpc_metadata_batch* batch);
@@ -62,7 +77,8 @@ bool grpc_metadata_batch_is_empty(grpc_metadata_batch* batch);
 /* Returns the transport size of the batch. */
 size_t grpc_metadata_batch_size(grpc_metadata_batch* batch);
 
-/** Remove \a storage from the batch, unreffing the mdelem contained */
+/** Remove \a storage from the batch, unreffing the mdelem contained. Linear
+    in the number of elements. */
 void grpc_metadata_batch_remove(grpc_metadata_batch* batch,
                                 grpc_linked_mdelem* storage);
 
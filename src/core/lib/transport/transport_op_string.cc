@@ -45,10 +45,10 @@ static void put_metadata(gpr_strvec* b, grpc_mdelem md) {
 }
 
 static void put_metadata_list(gpr_strvec* b, grpc_metadata_batch md) {
-  grpc_linked_mdelem* m;
-  for (m = md.list.head; m != nullptr; m = m->next) {
-    if (m != md.list.head) gpr_strvec_add(b, gpr_strdup(", "));
-    put_metadata(b, m->md);
+  grpc_linked_mdelem* const* elems = grpc_metadata_batch_elems(&md);
+  for (size_t i = 0; i < md.list.count; i++) {
+    if (i != 0) gpr_strvec_add(b, gpr_strdup(", "));
+    put_metadata(b, elems[i]->md);
   }
   if (md.deadline != GRPC_MILLIS_INF_FUTURE) {
     char* tmp;
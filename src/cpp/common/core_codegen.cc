@@ -102,6 +102,17 @@ size_t CoreCodegen::grpc_byte_buffer_length(grpc_byte_buffer* bb) {
   return ::grpc_byte_buffer_length(bb);
 }
 
+grpc_byte_buffer* CoreCodegen::grpc_message_object_byte_buffer_create(
+    void* object, const void* type, const grpc_message_object_vtable* vtable) {
+  return ::grpc_message_object_byte_buffer_create(object, type, vtable);
+}
+
+void* CoreCodegen::grpc_byte_buffer_get_message_object(grpc_byte_buffer* bb,
+                                                       const void* type,
+                                                       int* exclusive) {
+  return ::grpc_byte_buffer_get_message_object(bb, type, exclusive);
+}
+
 grpc_call_error CoreCodegen::grpc_call_cancel_with_status(
     grpc_call* call, grpc_status_code status, const char* description,
     void* reserved) {
@@ -112,6 +123,9 @@ void CoreCodegen::grpc_call_unref(grpc_call* call) { ::grpc_call_unref(call); }
 void* CoreCodegen::grpc_call_arena_alloc(grpc_call* call, size_t length) {
   return ::grpc_call_arena_alloc(call, length);
 }
+int CoreCodegen::grpc_call_carries_message_objects(grpc_call* call) {
+  return ::grpc_call_carries_message_objects(call);
+}
 
 int CoreCodegen::grpc_byte_buffer_reader_init(grpc_byte_buffer_reader* reader,
                                               grpc_byte_buffer* buffer) {
@@ -33,4 +33,9 @@ ResourceQuota& ResourceQuota::Resize(size_t new_size) {
   return *this;
 }
 
+ResourceQuota& ResourceQuota::SetMaxThreads(int new_max_threads) {
+  grpc_resource_quota_set_max_threads(impl_, new_max_threads);
+  return *this;
+}
+
 }  // namespace grpc
@@ -18,6 +18,7 @@
 
 #include <grpcpp/server_builder.h>
 
+#include <grpc/compression.h>
 #include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpcpp/impl/service_type.h>
@@ -54,8 +55,10 @@ ServerBuilder::ServerBuilder()
   }
 
   // all compression algorithms enabled by default.
+  grpc_compression_options compression_options;
+  grpc_compression_options_init(&compression_options);
   enabled_compression_algorithms_bitset_ =
-      (1u << GRPC_COMPRESS_ALGORITHMS_COUNT) - 1;
+      compression_options.enabled_algorithms_bitset;
   memset(&maybe_default_compression_level_, 0,
          sizeof(maybe_default_compression_level_));
   memset(&maybe_default_compression_algorithm_, 0,
@@ -38,6 +38,7 @@
 #include <grpcpp/support/time.h>
 
 #include "src/core/ext/transport/inproc/inproc_transport.h"
+#include "src/core/lib/iomgr/resource_quota.h"
 #include "src/core/lib/profiling/timers.h"
 #include "src/core/lib/surface/call.h"
 #include "src/cpp/client/create_channel_internal.h"
@@ -266,9 +267,10 @@ class Server::SyncRequestThreadManager : public ThreadManager {
  public:
   SyncRequestThreadManager(Server* server, CompletionQueue* server_cq,
                            std::shared_ptr<GlobalCallbacks> global_callbacks,
+                           grpc_resource_quota* resource_quota,
                            int min_pollers, int max_pollers,
                            int cq_timeout_msec)
-      : ThreadManager(min_pollers, max_pollers),
+      : ThreadManager(resource_quota, min_pollers, max_pollers),
         server_(server),
         server_cq_(server_cq),
         cq_timeout_msec_(cq_timeout_msec),
@@ -321,6 +323,31 @@ class Server::SyncRequestThreadManager : public ThreadManager {
     // object
   }
 
+  // Take the call out of the SyncRequest and request the next one right away,
+  // so that calls to the same method keep being matched while this one waits
+  // for a thread
+  void* PrepareQueuedWork(void* tag, bool ok) override {
+    SyncRequest* sync_req = static_cast<SyncRequest*>(tag);
+    if (!sync_req || !ok) {
+      return nullptr;
+    }
+    SyncRequest::CallData* cd = new SyncRequest::CallData(server_, sync_req);
+    if (!IsShutdown()) {
+      sync_req->SetupRequest();
+      sync_req->Request(server_->c_server(), server_cq_->cq());
+    }
+    return cd;
+  }
+
+  void DoQueuedWork(void* tag, bool ok) override {
+    std::unique_ptr<SyncRequest::CallData> cd(
+        static_cast<SyncRequest::CallData*>(tag));
+    if (cd != nullptr) {
+      GPR_TIMER_SCOPE("cd.Run()", 0);
+      cd->Run(global_callbacks_);
+    }
+  }
+
   void AddSyncMethod(internal::RpcServiceMethod* method, void* tag) {
     sync_requests_.emplace_back(new SyncRequest(method, tag));
   }
@@ -391,17 +418,22 @@ Server::Server(
   global_callbacks_ = g_callbacks;
   global_callbacks_->UpdateArguments(args);
 
+  grpc_channel_args channel_args;
+  args->SetChannelArgs(&channel_args);
+
   if (sync_server_cqs_ != nullptr) {
+    // The threads of all the thread managers come from the resource quota of
+    // the server (a private, unlimited one if none was set)
+    grpc_resource_quota* resource_quota =
+        grpc_resource_quota_from_channel_args(&channel_args);
     for (const auto& it : *sync_server_cqs_) {
       sync_req_mgrs_.emplace_back(new SyncRequestThreadManager(
-          this, it.get(), global_callbacks_, min_pollers, max_pollers,
-          sync_cq_timeout_msec));
+          this, it.get(), global_callbacks_, resource_quota, min_pollers,
+          max_pollers, sync_cq_timeout_msec));
     }
+    grpc_resource_quota_unref(resource_quota);
   }
 
-  grpc_channel_args channel_args;
-  args->SetChannelArgs(&channel_args);
-
   for (size_t i = 0; i < channel_args.num_args; i++) {
     if (0 ==
         strcmp(channel_args.args[i].key, kHealthCheckServiceInterfaceArg)) {
@@ -23,12 +23,25 @@
 
 #include <grpc/support/log.h>
 
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gprpp/thd.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/resource_quota.h"
 
 namespace grpc {
 
+namespace {
+// A parked thread that is not needed again within this time exits, and gives
+// its thread back to the resource quota
+constexpr int kMaxParkTimeMs = 10000;
+}  // namespace
+
 ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr)
     : thd_mgr_(thd_mgr) {
+  {
+    grpc_core::ExecCtx exec_ctx;
+    GRPC_STATS_INC_SYNC_SERVER_THREADS_CREATED();
+  }
   // Make thread creation exclusive with respect to its join happening in
   // ~WorkerThread().
   thd_ = grpc_core::Thread(
@@ -48,20 +61,29 @@ ThreadManager::WorkerThread::~WorkerThread() {
   thd_.Join();
 }
 
-ThreadManager::ThreadManager(int min_pollers, int max_pollers)
+ThreadManager::ThreadManager(grpc_resource_quota* resource_quota,
+                             int min_pollers, int max_pollers)
     : shutdown_(false),
+      resource_quota_(resource_quota),
       num_pollers_(0),
       min_pollers_(min_pollers),
       max_pollers_(max_pollers == -1 ? INT_MAX : max_pollers),
-      num_threads_(0) {}
+      num_threads_(0),
+      num_working_(0),
+      num_parked_(0),
+      num_resumes_pending_(0) {
+  grpc_resource_quota_ref(resource_quota_);
+}
 
 ThreadManager::~ThreadManager() {
   {
     std::lock_guard<std::mutex> lock(mu_);
     GPR_ASSERT(num_threads_ == 0);
+    GPR_ASSERT(queued_work_.empty());
   }
 
   CleanupCompletedThreads();
+  grpc_resource_quota_unref(resource_quota_);
 }
 
 void ThreadManager::Wait() {
@@ -74,6 +96,7 @@ void ThreadManager::Wait() {
 void ThreadManager::Shutdown() {
   std::lock_guard<std::mutex> lock(mu_);
   shutdown_ = true;
+  park_cv_.notify_all();
 }
 
 bool ThreadManager::IsShutdown() {
@@ -87,6 +110,8 @@ void ThreadManager::MarkAsCompleted(WorkerThread* thd) {
     completed_threads_.push_back(thd);
   }
 
+  grpc_resource_quota_free_threads(resource_quota_, 1);
+
   std::lock_guard<std::mutex> lock(mu_);
   num_threads_--;
   if (num_threads_ == 0) {
@@ -106,6 +131,14 @@ void ThreadManager::CleanupCompletedThreads() {
 }
 
 void ThreadManager::Initialize() {
+  if (!grpc_resource_quota_allocate_threads(resource_quota_, min_pollers_)) {
+    gpr_log(GPR_ERROR,
+            "No thread quota available to even create the minimum required "
+            "polling threads (i.e %d). Unable to start the thread manager",
+            min_pollers_);
+    abort();
+  }
+
   {
     std::unique_lock<std::mutex> lock(mu_);
     num_pollers_ = min_pollers_;
@@ -118,6 +151,65 @@ void ThreadManager::Initialize() {
   }
 }
 
+bool ThreadManager::AddPoller(std::unique_lock<std::mutex>* lock) {
+  if (num_parked_ > num_resumes_pending_) {
+    num_resumes_pending_++;
+    num_pollers_++;
+    park_cv_.notify_one();
+    grpc_core::ExecCtx exec_ctx;
+    GRPC_STATS_INC_SYNC_SERVER_THREADS_REUSED();
+    return true;
+  }
+  if (!grpc_resource_quota_allocate_threads(resource_quota_, 1)) {
+    return false;
+  }
+  num_pollers_++;
+  num_threads_++;
+  // Drop lock before spawning thread to avoid contention
+  lock->unlock();
+  new WorkerThread(this);
+  lock->lock();
+  return true;
+}
+
+void ThreadManager::DrainQueuedWork(std::unique_lock<std::mutex>* lock) {
+  while (!queued_work_.empty()) {
+    QueuedWork work = queued_work_.front();
+    queued_work_.pop_front();
+    num_working_++;
+    lock->unlock();
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+    {
+      gpr_timespec delay =
+          gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), work.enqueue_time);
+      grpc_core::ExecCtx exec_ctx;
+      GRPC_STATS_INC_SYNC_SERVER_QUEUEING_DELAY(
+          delay.tv_sec * GPR_US_PER_SEC + delay.tv_nsec / GPR_NS_PER_US);
+    }
+#endif
+    DoQueuedWork(work.tag, work.ok);
+    lock->lock();
+    num_working_--;
+  }
+}
+
+bool ThreadManager::Park(std::unique_lock<std::mutex>* lock) {
+  num_parked_++;
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(kMaxParkTimeMs);
+  while (num_resumes_pending_ == 0 && !shutdown_) {
+    if (park_cv_.wait_until(*lock, deadline) == std::cv_status::timeout) {
+      break;
+    }
+  }
+  num_parked_--;
+  if (num_resumes_pending_ > 0) {
+    num_resumes_pending_--;
+    return true;
+  }
+  return false;
+}
+
 void ThreadManager::MainWorkLoop() {
   while (true) {
     void* tag;
@@ -130,76 +222,83 @@ void ThreadManager::MainWorkLoop() {
     bool done = false;
     switch (work_status) {
       case TIMEOUT:
-        // If we timed out and we have more pollers than we need (or we are
-        // shutdown), finish this thread
-        if (shutdown_ || num_pollers_ > max_pollers_) done = true;
+        // If we timed out and we are shutdown, finish this thread. Otherwise
+        // the max_pollers_ check below decides whether to poll again
+        if (shutdown_) done = true;
         break;
       case SHUTDOWN:
         // If the thread manager is shutdown, finish this thread
         done = true;
         break;
       case WORK_FOUND:
-        // If we got work and there are now insufficient pollers, start a new
-        // one
-        if (!shutdown_ && num_pollers_ < min_pollers_) {
-          num_pollers_++;
-          num_threads_++;
-          // Drop lock before spawning thread to avoid contention
-          lock.unlock();
-          new WorkerThread(this);
-        } else {
-          // Drop lock for consistency with above branch
+        // If we got work and there are now insufficient pollers, get another
+        // one. If the resource quota has no thread left and nobody else is
+        // polling, rather than leaving the completion queue unattended while
+        // we run the work, queue it for one of the threads that are running
+        // work: they check the queue before polling again.
+        if (!shutdown_ && num_pollers_ < min_pollers_ && !AddPoller(&lock) &&
+            num_pollers_ == 0 && num_working_ > 0) {
+          gpr_timespec enqueue_time = gpr_now(GPR_CLOCK_MONOTONIC);
           lock.unlock();
+          void* queued_tag = PrepareQueuedWork(tag, ok);
+          lock.lock();
+          queued_work_.push_back({queued_tag, ok, enqueue_time});
+          if (num_working_ > 0) {
+            num_pollers_++;
+            grpc_core::ExecCtx exec_ctx;
+            GRPC_STATS_INC_SYNC_SERVER_WORK_QUEUED();
+            continue;
+          }
+          // The busy threads finished meanwhile and went back to polling
+          // without seeing the work: run it right away (below)
+          break;
         }
+        num_working_++;
+        lock.unlock();
         // Lock is always released at this point - do the application work
         DoWork(tag, ok);
         // Take the lock again to check post conditions
         lock.lock();
+        num_working_--;
         // If we're shutdown, we should finish at this point.
         if (shutdown_) done = true;
         break;
     }
+
+    // Work that was queued while we were busy has been waiting the longest:
+    // run it before polling for more (or exiting, since nobody else might
+    // be left to run it)
+    DrainQueuedWork(&lock);
+
     // If we decided to finish the thread, break out of the while loop
     if (done) break;
 
     // Otherwise go back to polling as long as it doesn't exceed max_pollers_
     //
-    // **WARNING**:
-    // There is a possibility of threads thrashing here (i.e excessive thread
-    // shutdowns and creations than the ideal case). This happens if max_poller_
-    // count is small and the rate of incoming requests is also small. In such
-    // scenarios we can possibly configure max_pollers_ to a higher value and/or
-    // increase the cq timeout.
-    //
-    // However, not doing this check here and unconditionally incrementing
-    // num_pollers (and hoping that the system will eventually settle down) has
-    // far worse consequences i.e huge number of threads getting created to the
-    // point of thread-exhaustion. For example: if the incoming request rate is
-    // very high, all the polling threads will return very quickly from
-    // PollForWork() with WORK_FOUND. They all briefly decrement num_pollers_
-    // counter thereby possibly - and briefly - making it go below min_pollers;
-    // This will most likely result in the creation of a new poller since
-    // num_pollers_ dipped below min_pollers_.
+    // Without the max_pollers_ check, a high rate of incoming requests can
+    // cause a thread avalanche: all the polling threads return very quickly
+    // from PollForWork() with WORK_FOUND and briefly decrement num_pollers_,
+    // possibly making it dip below min_pollers_, which adds pollers. If they
+    // all went back to polling, a new thread would be added in each cycle
+    // until there is heavy contention on mutexes (the mu_ here or the mutexes
+    // in gRPC core like the pollset mutex), which makes DoWork() take longer
+    // and pollers get added even faster.
     //
-    // Now, If we didn't do the max_poller_ check here, all these threads will
-    // go back to doing PollForWork() and the whole cycle repeats (with a new
-    // thread being added in each cycle). Once the total number of threads in
-    // the system crosses a certain threshold (around ~1500), there is heavy
-    // contention on mutexes (the mu_ here or the mutexes in gRPC core like the
-    // pollset mutex) that makes DoWork() take longer to finish thereby causing
-    // new poller threads to be created even faster. This results in a thread
-    // avalanche.
+    // Threads that are not needed for polling are parked rather than finished,
+    // so that when pollers are needed again (which with a small max_pollers_
+    // and a low rate of incoming requests happens all the time) they are
+    // resumed instead of thrashing through thread creations and exits.
     if (num_pollers_ < max_pollers_) {
       num_pollers_++;
-    } else {
+    } else if (!Park(&lock)) {
       break;
     }
-  };
+  }
 
   CleanupCompletedThreads();
 
-  // If we are here, either ThreadManager is shutting down or it already has
-  // enough threads.
+  // If we are here, either ThreadManager is shutting down or this thread was
+  // not needed for a while.
 }
 
 }  // namespace grpc
@@ -20,10 +20,13 @@
 #define GRPC_INTERNAL_CPP_THREAD_MANAGER_H
 
 #include <condition_variable>
+#include <deque>
 #include <list>
 #include <memory>
 #include <mutex>
 
+#include <grpc/grpc.h>
+#include <grpc/support/time.h>
 #include <grpcpp/support/config.h>
 
 #include "src/core/lib/gprpp/thd.h"
@@ -32,7 +35,11 @@ namespace grpc {
 
 class ThreadManager {
  public:
-  explicit ThreadManager(int min_pollers, int max_pollers);
+  // Every thread of the ThreadManager is allocated from \a resource_quota, so
+  // that the maximum number of threads set on the quota caps the threads of
+  // all the ThreadManagers sharing it
+  ThreadManager(grpc_resource_quota* resource_quota, int min_pollers,
+                int max_pollers);
   virtual ~ThreadManager();
 
   // Initializes and Starts the Rpc Manager threads
@@ -43,6 +50,10 @@ class ThreadManager {
 
   // "Polls" for new work.
   // If the return value is WORK_FOUND:
+  //  - If the thread limit of the resource quota has been reached and this
+  //    was the only polling thread, ThreadManager instead calls
+  //    PrepareQueuedWork() and queues the work for the next thread that
+  //    becomes free, while this one keeps polling
   //  - The implementaion of PollForWork() MAY set some opaque identifier to
   //    (identify the work item found) via the '*tag' parameter
   //  - The implementaion MUST set the value of 'ok' to 'true' or 'false'. A
@@ -57,7 +68,7 @@ class ThreadManager {
   //
   // If the return value is TIMEOUT:,
   //  - ThreadManager WILL NOT call DoWork()
-  //  - ThreadManager MAY terminate the thread depending on the current number
+  //  - ThreadManager MAY park the thread depending on the current number
   //    of active poller threads and mix_pollers/max_pollers settings
   //  - Also, the value of timeout is specific to the derived class
   //    implementation
@@ -72,6 +83,16 @@ class ThreadManager {
   // actually finds some work
   virtual void DoWork(void* tag, bool ok) = 0;
 
+  // Called instead of DoWork() when the work found by PollForWork() is queued
+  // (see above), by the polling thread before it polls again. It should do
+  // the setup needed for the next call to PollForWork() to find some work, so
+  // that work keeps flowing in while it is queued. Returns the tag passed to
+  // DoQueuedWork(), which performs the rest of the work on the thread that
+  // takes it out of the queue. By default returns 'tag', to be passed to
+  // DoWork()
+  virtual void* PrepareQueuedWork(void* tag, bool ok) { return tag; }
+  virtual void DoQueuedWork(void* tag, bool ok) { DoWork(tag, ok); }
+
   // Mark the ThreadManager as shutdown and begin draining the work. This is a
   // non-blocking call and the caller should call Wait(), a blocking call which
   // returns only once the shutdown is complete
@@ -108,16 +129,43 @@ class ThreadManager {
   // The main funtion in ThreadManager
   void MainWorkLoop();
 
+  // Called with mu_ held when a poller found work and too few pollers are
+  // left: asks a parked thread to resume polling or, if there is none, starts
+  // a new thread if the resource quota allows it. Returns false if neither
+  // was possible. May release the lock.
+  bool AddPoller(std::unique_lock<std::mutex>* lock);
+
+  // Called with mu_ held: runs the queued work, releasing the lock meanwhile
+  void DrainQueuedWork(std::unique_lock<std::mutex>* lock);
+
+  // Called with mu_ held: waits until a poller is needed again. Returns true
+  // if the thread should resume polling (num_pollers_ already accounts for
+  // it), or false if it should exit because it stayed parked for too long or
+  // the ThreadManager is shutting down
+  bool Park(std::unique_lock<std::mutex>* lock);
+
   void MarkAsCompleted(WorkerThread* thd);
   void CleanupCompletedThreads();
 
-  // Protects shutdown_, num_pollers_ and num_threads_
+  // Work found while the thread limit was reached and no other thread was
+  // polling
+  struct QueuedWork {
+    void* tag;
+    bool ok;
+    gpr_timespec enqueue_time;
+  };
+
+  // Protects shutdown_, num_pollers_, num_threads_, num_working_,
+  // num_parked_, num_resumes_pending_ and queued_work_
   // TODO: sreek - Change num_pollers and num_threads_ to atomics
   std::mutex mu_;
 
   bool shutdown_;
   std::condition_variable shutdown_cv_;
 
+  // Source of the threads of this ThreadManager
+  grpc_resource_quota* resource_quota_;
+
   // Number of threads doing polling
   int num_pollers_;
 
@@ -126,9 +174,20 @@ class ThreadManager {
   int max_pollers_;
 
   // The total number of threads (includes threads includes the threads that are
-  // currently polling i.e num_pollers_)
+  // currently polling i.e num_pollers_, and the parked ones)
   int num_threads_;
 
+  // Number of threads running DoWork()
+  int num_working_;
+
+  // Threads waiting on park_cv_ to be needed again, and how many of them have
+  // been asked to resume polling but have not woken up yet
+  int num_parked_;
+  int num_resumes_pending_;
+  std::condition_variable park_cv_;
+
+  std::deque<QueuedWork> queued_work_;
+
   std::mutex list_mu_;
   std::list<WorkerThread*> completed_threads_;
 };
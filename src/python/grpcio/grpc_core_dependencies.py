@@ -19,7 +19,6 @@ CORE_SOURCE_FILES = [
     'third_party/address_sorting/address_sorting_posix.c',
     'third_party/address_sorting/address_sorting_windows.c',
     'src/core/lib/gpr/alloc.cc',
-    'src/core/lib/gpr/arena.cc',
     'src/core/lib/gpr/atm.cc',
     'src/core/lib/gpr/cpu_iphone.cc',
     'src/core/lib/gpr/cpu_linux.cc',
@@ -36,6 +35,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/gpr/log_windows.cc',
     'src/core/lib/gpr/mpscq.cc',
     'src/core/lib/gpr/murmur_hash.cc',
+    'src/core/lib/gpr/spmcq.cc',
     'src/core/lib/gpr/string.cc',
     'src/core/lib/gpr/string_posix.cc',
     'src/core/lib/gpr/string_util_windows.cc',
@@ -52,6 +52,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/gpr/tmpfile_posix.cc',
     'src/core/lib/gpr/tmpfile_windows.cc',
     'src/core/lib/gpr/wrap_memcpy.cc',
+    'src/core/lib/gprpp/arena.cc',
     'src/core/lib/gprpp/fork.cc',
     'src/core/lib/gprpp/thd_posix.cc',
     'src/core/lib/gprpp/thd_windows.cc',
@@ -157,6 +158,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/iomgr/timer_heap.cc',
     'src/core/lib/iomgr/timer_manager.cc',
     'src/core/lib/iomgr/timer_uv.cc',
+    'src/core/lib/iomgr/timer_wheel.cc',
     'src/core/lib/iomgr/udp_server.cc',
     'src/core/lib/iomgr/unix_sockets_posix.cc',
     'src/core/lib/iomgr/unix_sockets_posix_noop.cc',
@@ -189,6 +191,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/surface/completion_queue_factory.cc',
     'src/core/lib/surface/event_string.cc',
     'src/core/lib/surface/lame_client.cc',
+    'src/core/lib/surface/message_object.cc',
     'src/core/lib/surface/metadata_array.cc',
     'src/core/lib/surface/server.cc',
     'src/core/lib/surface/validate_metadata.cc',
@@ -209,6 +212,7 @@ CORE_SOURCE_FILES = [
     'src/core/lib/transport/transport_op_string.cc',
     'src/core/lib/debug/trace.cc',
     'src/core/ext/transport/chttp2/server/secure/server_secure_chttp2.cc',
+    'src/core/ext/transport/chttp2/transport/base64_simd.cc',
     'src/core/ext/transport/chttp2/transport/bin_decoder.cc',
     'src/core/ext/transport/chttp2/transport/bin_encoder.cc',
     'src/core/ext/transport/chttp2/transport/chttp2_plugin.cc',
@@ -224,12 +228,14 @@ CORE_SOURCE_FILES = [
     'src/core/ext/transport/chttp2/transport/hpack_parser.cc',
     'src/core/ext/transport/chttp2/transport/hpack_table.cc',
     'src/core/ext/transport/chttp2/transport/http2_settings.cc',
+    'src/core/ext/transport/chttp2/transport/huffman_decoder.cc',
     'src/core/ext/transport/chttp2/transport/huffsyms.cc',
     'src/core/ext/transport/chttp2/transport/incoming_metadata.cc',
     'src/core/ext/transport/chttp2/transport/parsing.cc',
     'src/core/ext/transport/chttp2/transport/stream_lists.cc',
     'src/core/ext/transport/chttp2/transport/stream_map.cc',
     'src/core/ext/transport/chttp2/transport/varint.cc',
+    'src/core/ext/transport/chttp2/transport/write_scheduler.cc',
     'src/core/ext/transport/chttp2/transport/writing.cc',
     'src/core/ext/transport/chttp2/alpn/alpn.cc',
     'src/core/ext/filters/http/client/http_client_filter.cc',
@@ -68,6 +68,9 @@ extern grpc_compression_options_disable_algorithm_type grpc_compression_options_
 typedef int(*grpc_compression_options_is_algorithm_enabled_type)(const grpc_compression_options* opts, grpc_compression_algorithm algorithm);
 extern grpc_compression_options_is_algorithm_enabled_type grpc_compression_options_is_algorithm_enabled_import;
 #define grpc_compression_options_is_algorithm_enabled grpc_compression_options_is_algorithm_enabled_import
+typedef int(*grpc_compression_algorithm_register_type)(const grpc_message_compressor_vtable* compressor, grpc_compression_algorithm* algorithm);
+extern grpc_compression_algorithm_register_type grpc_compression_algorithm_register_import;
+#define grpc_compression_algorithm_register grpc_compression_algorithm_register_import
 typedef void(*grpc_metadata_array_init_type)(grpc_metadata_array* array);
 extern grpc_metadata_array_init_type grpc_metadata_array_init_import;
 #define grpc_metadata_array_init grpc_metadata_array_init_import
@@ -104,6 +107,9 @@ extern grpc_completion_queue_create_for_next_type grpc_completion_queue_create_f
 typedef grpc_completion_queue*(*grpc_completion_queue_create_for_pluck_type)(void* reserved);
 extern grpc_completion_queue_create_for_pluck_type grpc_completion_queue_create_for_pluck_import;
 #define grpc_completion_queue_create_for_pluck grpc_completion_queue_create_for_pluck_import
+typedef grpc_completion_queue*(*grpc_completion_queue_create_for_callback_type)(grpc_completion_queue_functor* callback, void* reserved);
+extern grpc_completion_queue_create_for_callback_type grpc_completion_queue_create_for_callback_import;
+#define grpc_completion_queue_create_for_callback grpc_completion_queue_create_for_callback_import
 typedef grpc_completion_queue*(*grpc_completion_queue_create_type)(const grpc_completion_queue_factory* factory, const grpc_completion_queue_attributes* attributes, void* reserved);
 extern grpc_completion_queue_create_type grpc_completion_queue_create_import;
 #define grpc_completion_queue_create grpc_completion_queue_create_import
@@ -158,6 +164,9 @@ extern grpc_call_start_batch_type grpc_call_start_batch_import;
 typedef char*(*grpc_call_get_peer_type)(grpc_call* call);
 extern grpc_call_get_peer_type grpc_call_get_peer_import;
 #define grpc_call_get_peer grpc_call_get_peer_import
+typedef int(*grpc_call_carries_message_objects_type)(grpc_call* call);
+extern grpc_call_carries_message_objects_type grpc_call_carries_message_objects_import;
+#define grpc_call_carries_message_objects grpc_call_carries_message_objects_import
 typedef void(*grpc_census_call_set_context_type)(grpc_call* call, struct census_context* context);
 extern grpc_census_call_set_context_type grpc_census_call_set_context_import;
 #define grpc_census_call_set_context grpc_census_call_set_context_import
@@ -248,6 +257,9 @@ extern grpc_resource_quota_unref_type grpc_resource_quota_unref_import;
 typedef void(*grpc_resource_quota_resize_type)(grpc_resource_quota* resource_quota, size_t new_size);
 extern grpc_resource_quota_resize_type grpc_resource_quota_resize_import;
 #define grpc_resource_quota_resize grpc_resource_quota_resize_import
+typedef void(*grpc_resource_quota_set_max_threads_type)(grpc_resource_quota* resource_quota, int new_max_threads);
+extern grpc_resource_quota_set_max_threads_type grpc_resource_quota_set_max_threads_import;
+#define grpc_resource_quota_set_max_threads grpc_resource_quota_set_max_threads_import
 typedef const grpc_arg_pointer_vtable*(*grpc_resource_quota_arg_vtable_type)(void);
 extern grpc_resource_quota_arg_vtable_type grpc_resource_quota_arg_vtable_import;
 #define grpc_resource_quota_arg_vtable grpc_resource_quota_arg_vtable_import
@@ -419,6 +431,12 @@ extern grpc_raw_byte_buffer_create_type grpc_raw_byte_buffer_create_import;
 typedef grpc_byte_buffer*(*grpc_raw_compressed_byte_buffer_create_type)(grpc_slice* slices, size_t nslices, grpc_compression_algorithm compression);
 extern grpc_raw_compressed_byte_buffer_create_type grpc_raw_compressed_byte_buffer_create_import;
 #define grpc_raw_compressed_byte_buffer_create grpc_raw_compressed_byte_buffer_create_import
+typedef grpc_byte_buffer*(*grpc_message_object_byte_buffer_create_type)(void* object, const void* type, const grpc_message_object_vtable* vtable);
+extern grpc_message_object_byte_buffer_create_type grpc_message_object_byte_buffer_create_import;
+#define grpc_message_object_byte_buffer_create grpc_message_object_byte_buffer_create_import
+typedef void*(*grpc_byte_buffer_get_message_object_type)(grpc_byte_buffer* bb, const void* type, int* exclusive);
+extern grpc_byte_buffer_get_message_object_type grpc_byte_buffer_get_message_object_import;
+#define grpc_byte_buffer_get_message_object grpc_byte_buffer_get_message_object_import
 typedef grpc_byte_buffer*(*grpc_byte_buffer_copy_type)(grpc_byte_buffer* bb);
 extern grpc_byte_buffer_copy_type grpc_byte_buffer_copy_import;
 #define grpc_byte_buffer_copy grpc_byte_buffer_copy_import
@@ -234,6 +234,44 @@ static void test_bad_decompression_data_stream(void) {
   grpc_slice_buffer_destroy(&output);
 }
 
+/* zlib streams are reused across messages: a stream left in an error state
+   by one message must not affect the next */
+static void test_decompression_after_failure(void) {
+  grpc_slice_buffer bad;
+  grpc_slice_buffer input;
+  grpc_slice_buffer compressed;
+  grpc_slice_buffer output;
+
+  grpc_core::ExecCtx exec_ctx;
+  for (int i = 0; i < 10; i++) {
+    grpc_slice_buffer_init(&bad);
+    grpc_slice_buffer_init(&input);
+    grpc_slice_buffer_init(&compressed);
+    grpc_slice_buffer_init(&output);
+    grpc_slice_buffer_add(&bad,
+                          grpc_slice_from_copied_buffer("\x78\xda\xff\xff", 4));
+    GPR_ASSERT(
+        0 == grpc_msg_decompress(GRPC_MESSAGE_COMPRESS_DEFLATE, &bad, &output));
+    GPR_ASSERT(output.length == 0);
+
+    grpc_slice_buffer_add(&input, create_test_value(ONE_KB_A));
+    GPR_ASSERT(
+        grpc_msg_compress(GRPC_MESSAGE_COMPRESS_DEFLATE, &input, &compressed));
+    GPR_ASSERT(grpc_msg_decompress(GRPC_MESSAGE_COMPRESS_DEFLATE, &compressed,
+                                   &output));
+    grpc_slice merged = grpc_slice_merge(output.slices, output.count);
+    grpc_slice expected = create_test_value(ONE_KB_A);
+    GPR_ASSERT(grpc_slice_eq(merged, expected));
+    grpc_slice_unref(merged);
+    grpc_slice_unref(expected);
+
+    grpc_slice_buffer_destroy(&bad);
+    grpc_slice_buffer_destroy(&input);
+    grpc_slice_buffer_destroy(&compressed);
+    grpc_slice_buffer_destroy(&output);
+  }
+}
+
 static void test_bad_compression_algorithm(void) {
   grpc_slice_buffer input;
   grpc_slice_buffer output;
@@ -284,6 +322,112 @@ static void test_bad_decompression_algorithm(void) {
   grpc_slice_buffer_destroy(&output);
 }
 
+/* A run length code for the registered algorithm tests: each run of up to 255
+   equal bytes becomes a count byte followed by the repeated byte */
+static void rle_flush(grpc_slice_buffer* output, uint8_t* run) {
+  grpc_slice pair = GRPC_SLICE_MALLOC(2);
+  memcpy(GRPC_SLICE_START_PTR(pair), run, 2);
+  grpc_slice_buffer_add(output, pair);
+}
+
+static int rle_compress(void* user_data, grpc_slice_buffer* input,
+                        grpc_slice_buffer* output) {
+  grpc_slice_buffer tmp;
+  grpc_slice_buffer_init(&tmp);
+  uint8_t run[2] = {0, 0};
+  for (size_t i = 0; i < input->count; i++) {
+    const uint8_t* p = GRPC_SLICE_START_PTR(input->slices[i]);
+    for (size_t j = 0; j < GRPC_SLICE_LENGTH(input->slices[i]); j++) {
+      if (run[0] > 0 && (run[1] != p[j] || run[0] == 255)) {
+        rle_flush(&tmp, run);
+        run[0] = 0;
+      }
+      run[0]++;
+      run[1] = p[j];
+    }
+  }
+  if (run[0] > 0) rle_flush(&tmp, run);
+  int compressed = tmp.length < input->length;
+  if (compressed) grpc_slice_buffer_move_into(&tmp, output);
+  grpc_slice_buffer_destroy(&tmp);
+  ++*static_cast<int*>(user_data);
+  return compressed;
+}
+
+static int rle_decompress(void* user_data, grpc_slice_buffer* input,
+                          grpc_slice_buffer* output) {
+  if (input->length % 2 != 0) return 0;
+  grpc_slice flat = grpc_slice_merge(input->slices, input->count);
+  const uint8_t* p = GRPC_SLICE_START_PTR(flat);
+  for (size_t i = 0; i < GRPC_SLICE_LENGTH(flat); i += 2) {
+    grpc_slice run = GRPC_SLICE_MALLOC(p[i]);
+    memset(GRPC_SLICE_START_PTR(run), p[i + 1], p[i]);
+    grpc_slice_buffer_add(output, run);
+  }
+  grpc_slice_unref(flat);
+  return 1;
+}
+
+static int g_rle_compress_calls;
+
+static grpc_message_compression_algorithm test_register_algorithm(void) {
+  const grpc_message_compressor_vtable rle = {
+      "test.rle", rle_compress, rle_decompress, &g_rle_compress_calls};
+  grpc_compression_algorithm algorithm;
+  GPR_ASSERT(grpc_compression_algorithm_register(&rle, &algorithm));
+  GPR_ASSERT(algorithm >= GRPC_COMPRESS_REGISTERED_ALGORITHMS_BASE);
+  GPR_ASSERT(grpc_compression_algorithm_is_message(algorithm));
+  GPR_ASSERT(!grpc_compression_algorithm_is_stream(algorithm));
+  GPR_ASSERT(GPR_BITGET(grpc_compression_all_algorithms_bitset(), algorithm));
+
+  /* names must be unique, and usable as an accept-encoding entry */
+  grpc_compression_algorithm ignored;
+  GPR_ASSERT(!grpc_compression_algorithm_register(&rle, &ignored));
+  grpc_message_compressor_vtable bad = rle;
+  bad.name = "gzip";
+  GPR_ASSERT(!grpc_compression_algorithm_register(&bad, &ignored));
+  bad.name = "rle,gzip";
+  GPR_ASSERT(!grpc_compression_algorithm_register(&bad, &ignored));
+  bad.name = "";
+  GPR_ASSERT(!grpc_compression_algorithm_register(&bad, &ignored));
+
+  const char* name;
+  GPR_ASSERT(grpc_compression_algorithm_name(algorithm, &name));
+  GPR_ASSERT(strcmp(name, "test.rle") == 0);
+  grpc_compression_algorithm parsed;
+  GPR_ASSERT(grpc_compression_algorithm_parse(
+      grpc_slice_from_static_string("test.rle"), &parsed));
+  GPR_ASSERT(parsed == algorithm);
+
+  grpc_message_compression_algorithm message_algorithm =
+      grpc_compression_algorithm_to_message_compression_algorithm(algorithm);
+  GPR_ASSERT(static_cast<int>(message_algorithm) ==
+             static_cast<int>(algorithm));
+  grpc_message_compression_algorithm message_parsed;
+  GPR_ASSERT(grpc_message_compression_algorithm_parse(
+      grpc_slice_from_static_string("test.rle"), &message_parsed));
+  GPR_ASSERT(message_parsed == message_algorithm);
+  GPR_ASSERT(
+      grpc_compression_algorithm_from_message_stream_compression_algorithm(
+          &parsed, message_algorithm, GRPC_STREAM_COMPRESS_NONE));
+  GPR_ASSERT(parsed == algorithm);
+  uint32_t bitset = (1u << GRPC_COMPRESS_GZIP) |
+                    (1u << GRPC_COMPRESS_STREAM_GZIP) | (1u << algorithm);
+  GPR_ASSERT(grpc_compression_bitset_to_message_bitset(bitset) ==
+             ((1u << GRPC_MESSAGE_COMPRESS_GZIP) | (1u << message_algorithm)));
+  GPR_ASSERT(grpc_compression_bitset_to_stream_bitset(bitset) ==
+             (1u << GRPC_STREAM_COMPRESS_GZIP));
+  GPR_ASSERT(grpc_compression_bitset_from_message_stream_compression_bitset(
+                 grpc_compression_bitset_to_message_bitset(bitset),
+                 grpc_compression_bitset_to_stream_bitset(bitset)) == bitset);
+  /* registered algorithms are never picked by level */
+  GPR_ASSERT(grpc_message_compression_algorithm_for_level(
+                 GRPC_COMPRESS_LEVEL_HIGH,
+                 1u | (1u << message_algorithm)) == GRPC_MESSAGE_COMPRESS_NONE);
+
+  return message_algorithm;
+}
+
 int main(int argc, char** argv) {
   unsigned i, j, k, m;
   grpc_slice_split_mode uncompressed_split_modes[] = {
@@ -295,18 +439,18 @@ int main(int argc, char** argv) {
   grpc_test_init(argc, argv);
   grpc_init();
 
-  for (i = 0; i < GRPC_MESSAGE_COMPRESS_ALGORITHMS_COUNT; i++) {
+  grpc_message_compression_algorithm algorithms[] = {
+      GRPC_MESSAGE_COMPRESS_NONE, GRPC_MESSAGE_COMPRESS_DEFLATE,
+      GRPC_MESSAGE_COMPRESS_GZIP, test_register_algorithm()};
+  for (i = 0; i < GPR_ARRAY_SIZE(algorithms); i++) {
     for (j = 0; j < GPR_ARRAY_SIZE(uncompressed_split_modes); j++) {
       for (k = 0; k < GPR_ARRAY_SIZE(compressed_split_modes); k++) {
         for (m = 0; m < TEST_VALUE_COUNT; m++) {
           grpc_slice slice = create_test_value(static_cast<test_value>(m));
           assert_passthrough(
-              slice, static_cast<grpc_message_compression_algorithm>(i),
-              static_cast<grpc_slice_split_mode>(j),
+              slice, algorithms[i], static_cast<grpc_slice_split_mode>(j),
               static_cast<grpc_slice_split_mode>(k),
-              get_compressability(
-                  static_cast<test_value>(m),
-                  static_cast<grpc_message_compression_algorithm>(i)));
+              get_compressability(static_cast<test_value>(m), algorithms[i]));
           grpc_slice_unref(slice);
         }
       }
@@ -317,8 +461,10 @@ int main(int argc, char** argv) {
   test_bad_decompression_data_crc();
   test_bad_decompression_data_stream();
   test_bad_decompression_data_trailing_garbage();
+  test_decompression_after_failure();
   test_bad_compression_algorithm();
   test_bad_decompression_algorithm();
+  GPR_ASSERT(g_rle_compress_calls > 0);
   grpc_shutdown();
 
   return 0;
@@ -30,6 +30,7 @@
 #include <grpc/support/time.h>
 
 #include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/compression/message_compress.h"
 #include "src/core/lib/surface/call.h"
 #include "src/core/lib/surface/call_test_only.h"
 #include "src/core/lib/transport/static_metadata.h"
@@ -377,7 +378,8 @@ static void request_with_payload_template(
   cq_verify(cqv);
 
   GPR_ASSERT(GPR_BITCOUNT(grpc_call_test_only_get_encodings_accepted_by_peer(
-                 s)) == GRPC_COMPRESS_ALGORITHMS_COUNT);
+                 s)) ==
+             GPR_BITCOUNT(grpc_compression_all_algorithms_bitset()));
   GPR_ASSERT(GPR_BITGET(grpc_call_test_only_get_encodings_accepted_by_peer(s),
                         GRPC_COMPRESS_NONE) != 0);
   GPR_ASSERT(GPR_BITGET(grpc_call_test_only_get_encodings_accepted_by_peer(s),
@@ -636,6 +638,278 @@ static void test_invoke_request_with_disabled_algorithm(
                                  GRPC_STATUS_UNIMPLEMENTED, nullptr);
 }
 
+/* An application supplied algorithm: deflate under another name */
+static int registered_compress(void* calls, grpc_slice_buffer* input,
+                               grpc_slice_buffer* output) {
+  gpr_atm_no_barrier_fetch_add(static_cast<gpr_atm*>(calls), 1);
+  grpc_slice_buffer tmp;
+  grpc_slice_buffer_init(&tmp);
+  int r = grpc_msg_compress(GRPC_MESSAGE_COMPRESS_DEFLATE, input, &tmp);
+  if (r) grpc_slice_buffer_move_into(&tmp, output);
+  grpc_slice_buffer_destroy(&tmp);
+  return r;
+}
+
+static int registered_decompress(void* calls, grpc_slice_buffer* input,
+                                 grpc_slice_buffer* output) {
+  return grpc_msg_decompress(GRPC_MESSAGE_COMPRESS_DEFLATE, input, output);
+}
+
+static gpr_atm g_registered_compress_calls;
+static grpc_compression_algorithm g_registered_algorithm;
+
+static void register_algorithm(void) {
+  const grpc_message_compressor_vtable compressor = {
+      "test-deflate", registered_compress, registered_decompress,
+      &g_registered_compress_calls};
+  GPR_ASSERT(grpc_compression_algorithm_register(&compressor,
+                                                 &g_registered_algorithm));
+}
+
+static void register_algorithm_once(void) {
+  static gpr_once once = GPR_ONCE_INIT;
+  gpr_once_init(&once, register_algorithm);
+}
+
+static void test_invoke_request_with_registered_algorithm(
+    grpc_end2end_test_config config) {
+  register_algorithm_once();
+  gpr_atm calls_before = gpr_atm_no_barrier_load(&g_registered_compress_calls);
+  request_with_payload_template(
+      config, "test_invoke_request_with_registered_algorithm", 0,
+      g_registered_algorithm, g_registered_algorithm, g_registered_algorithm,
+      g_registered_algorithm, nullptr, false,
+      /* ignored */ GRPC_COMPRESS_LEVEL_NONE, false);
+  /* two requests and two responses */
+  GPR_ASSERT(gpr_atm_no_barrier_load(&g_registered_compress_calls) ==
+             calls_before + 4);
+}
+
+/* Returns a 1KiB message that deflate can't shrink, or one it can */
+static grpc_slice adaptive_compression_payload(bool compressible,
+                                               uint32_t* seed) {
+  grpc_slice slice = grpc_slice_malloc(1024);
+  uint8_t* p = GRPC_SLICE_START_PTR(slice);
+  for (size_t i = 0; i < GRPC_SLICE_LENGTH(slice); i++) {
+    *seed = *seed * 1103515245 + 12345;
+    p[i] = compressible ? 'x' : static_cast<uint8_t>(*seed >> 16);
+  }
+  return slice;
+}
+
+/* Streams incompressible and then compressible messages both ways between
+   channels that compress adaptively with the counting application supplied
+   algorithm */
+static void test_adaptive_compression(grpc_end2end_test_config config) {
+  /* The first message is compressed and found not to pay off, the next
+     16 are skipped, the probe after them fails too, and so do the next 32.
+     The probe after those finds the payloads compressible again, and
+     compression resumes for every message after it. */
+  const int kIncompressibleMessages = 50;
+  const int kMessages = kIncompressibleMessages + 3;
+  register_algorithm_once();
+  gpr_atm calls_before = gpr_atm_no_barrier_load(&g_registered_compress_calls);
+  grpc_call* c;
+  grpc_call* s;
+  grpc_end2end_test_fixture f;
+  grpc_op ops[6];
+  grpc_op* op;
+  grpc_metadata_array initial_metadata_recv;
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_metadata_array request_metadata_recv;
+  grpc_byte_buffer* request_payload_recv = nullptr;
+  grpc_byte_buffer* response_payload_recv = nullptr;
+  grpc_call_details call_details;
+  grpc_status_code status;
+  grpc_call_error error;
+  grpc_slice details;
+  int was_cancelled = 2;
+  cq_verifier* cqv;
+  uint32_t seed = 42;
+
+  grpc_arg adaptive_arg = grpc_channel_arg_integer_create(
+      const_cast<char*>(GRPC_COMPRESSION_CHANNEL_ADAPTIVE), 1);
+  grpc_channel_args* compression_args =
+      grpc_channel_args_set_compression_algorithm(nullptr,
+                                                  g_registered_algorithm);
+  grpc_channel_args* args =
+      grpc_channel_args_copy_and_add(compression_args, &adaptive_arg, 1);
+
+  f = begin_test(config, "test_adaptive_compression", args, args);
+  cqv = cq_verifier_create(f.cq);
+
+  gpr_timespec deadline = five_seconds_from_now();
+  c = grpc_channel_create_call(f.client, nullptr, GRPC_PROPAGATE_DEFAULTS, f.cq,
+                               grpc_slice_from_static_string("/foo"), nullptr,
+                               deadline, nullptr);
+  GPR_ASSERT(c);
+
+  grpc_metadata_array_init(&initial_metadata_recv);
+  grpc_metadata_array_init(&trailing_metadata_recv);
+  grpc_metadata_array_init(&request_metadata_recv);
+  grpc_call_details_init(&call_details);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_RECV_INITIAL_METADATA;
+  op->data.recv_initial_metadata.recv_initial_metadata = &initial_metadata_recv;
+  op++;
+  op->op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  op->data.recv_status_on_client.trailing_metadata = &trailing_metadata_recv;
+  op->data.recv_status_on_client.status = &status;
+  op->data.recv_status_on_client.status_details = &details;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(1),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  error =
+      grpc_server_request_call(f.server, &s, &call_details,
+                               &request_metadata_recv, f.cq, f.cq, tag(100));
+  GPR_ASSERT(GRPC_CALL_OK == error);
+  CQ_EXPECT_COMPLETION(cqv, tag(100), true);
+  cq_verify(cqv);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  op->data.recv_close_on_server.cancelled = &was_cancelled;
+  op++;
+  error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops), tag(101),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  for (int i = 0; i < kMessages; i++) {
+    bool compressible = i >= kIncompressibleMessages;
+    grpc_compression_algorithm expected_algorithm =
+        compressible ? g_registered_algorithm : GRPC_COMPRESS_NONE;
+    grpc_slice payload_slice =
+        adaptive_compression_payload(compressible, &seed);
+    grpc_byte_buffer* request_payload =
+        grpc_raw_byte_buffer_create(&payload_slice, 1);
+    grpc_byte_buffer* response_payload =
+        grpc_raw_byte_buffer_create(&payload_slice, 1);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_MESSAGE;
+    op->data.send_message.send_message = request_payload;
+    op++;
+    error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops),
+                                  tag(2), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_RECV_MESSAGE;
+    op->data.recv_message.recv_message = &request_payload_recv;
+    op++;
+    error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops),
+                                  tag(102), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+    CQ_EXPECT_COMPLETION(cqv, tag(2), 1);
+    CQ_EXPECT_COMPLETION(cqv, tag(102), 1);
+    cq_verify(cqv);
+
+    GPR_ASSERT(byte_buffer_eq_slice(request_payload_recv,
+                                    grpc_slice_ref(payload_slice)));
+    GPR_ASSERT(request_payload_recv->data.raw.compression ==
+               expected_algorithm);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_SEND_MESSAGE;
+    op->data.send_message.send_message = response_payload;
+    op++;
+    error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops),
+                                  tag(103), nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+
+    memset(ops, 0, sizeof(ops));
+    op = ops;
+    op->op = GRPC_OP_RECV_MESSAGE;
+    op->data.recv_message.recv_message = &response_payload_recv;
+    op++;
+    error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(3),
+                                  nullptr);
+    GPR_ASSERT(GRPC_CALL_OK == error);
+    CQ_EXPECT_COMPLETION(cqv, tag(103), 1);
+    CQ_EXPECT_COMPLETION(cqv, tag(3), 1);
+    cq_verify(cqv);
+
+    GPR_ASSERT(byte_buffer_eq_slice(response_payload_recv,
+                                    grpc_slice_ref(payload_slice)));
+    GPR_ASSERT(response_payload_recv->data.raw.compression ==
+               expected_algorithm);
+
+    grpc_slice_unref(payload_slice);
+    grpc_byte_buffer_destroy(request_payload);
+    grpc_byte_buffer_destroy(response_payload);
+    grpc_byte_buffer_destroy(request_payload_recv);
+    grpc_byte_buffer_destroy(response_payload_recv);
+  }
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  op++;
+  error = grpc_call_start_batch(c, ops, static_cast<size_t>(op - ops), tag(4),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  memset(ops, 0, sizeof(ops));
+  op = ops;
+  op->op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  op->data.send_status_from_server.trailing_metadata_count = 0;
+  op->data.send_status_from_server.status = GRPC_STATUS_OK;
+  grpc_slice status_details = grpc_slice_from_static_string("xyz");
+  op->data.send_status_from_server.status_details = &status_details;
+  op++;
+  error = grpc_call_start_batch(s, ops, static_cast<size_t>(op - ops), tag(104),
+                                nullptr);
+  GPR_ASSERT(GRPC_CALL_OK == error);
+
+  CQ_EXPECT_COMPLETION(cqv, tag(1), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(4), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(101), 1);
+  CQ_EXPECT_COMPLETION(cqv, tag(104), 1);
+  cq_verify(cqv);
+
+  GPR_ASSERT(status == GRPC_STATUS_OK);
+  GPR_ASSERT(was_cancelled == 0);
+
+  /* the first message, two probes and the two messages after the last probe,
+     each way */
+  GPR_ASSERT(gpr_atm_no_barrier_load(&g_registered_compress_calls) ==
+             calls_before + 2 * 5);
+
+  grpc_slice_unref(details);
+  grpc_metadata_array_destroy(&initial_metadata_recv);
+  grpc_metadata_array_destroy(&trailing_metadata_recv);
+  grpc_metadata_array_destroy(&request_metadata_recv);
+  grpc_call_details_destroy(&call_details);
+
+  grpc_call_unref(c);
+  grpc_call_unref(s);
+
+  cq_verifier_destroy(cqv);
+
+  {
+    grpc_core::ExecCtx exec_ctx;
+    grpc_channel_args_destroy(compression_args);
+    grpc_channel_args_destroy(args);
+  }
+
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
 void compressed_payload(grpc_end2end_test_config config) {
   test_invoke_request_with_exceptionally_uncompressed_payload(config);
   test_invoke_request_with_uncompressed_payload(config);
@@ -644,6 +918,8 @@ void compressed_payload(grpc_end2end_test_config config) {
   test_invoke_request_with_server_level(config);
   test_invoke_request_with_compressed_payload_md_override(config);
   test_invoke_request_with_disabled_algorithm(config);
+  test_invoke_request_with_registered_algorithm(config);
+  test_adaptive_compression(config);
 }
 
 void compressed_payload_pre_init(void) {}
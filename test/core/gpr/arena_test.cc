@@ -115,6 +115,117 @@ static void concurrent_test(void) {
   gpr_arena_destroy(args.arena);
 }
 
+static void pooled_test(void) {
+  gpr_log(GPR_DEBUG, "pooled_test");
+
+  const size_t kInitSize = 3000;
+  const size_t kAllocSize = 2048;
+  // The pool is sharded per cpu, so a recycled buffer is only guaranteed to
+  // be seen if we are not migrated between destroy and create: retry a few
+  // times.
+  bool saw_hit = false;
+  for (int i = 0; i < 100 && !saw_hit; i++) {
+    bool pool_hit;
+    gpr_arena* a = gpr_arena_create_pooled(kInitSize, &pool_hit);
+    saw_hit = pool_hit;
+    char* p = static_cast<char*>(gpr_arena_alloc(a, kAllocSize));
+    // recycled buffers must still be handed out zeroed
+    for (size_t j = 0; j < kAllocSize; j++) {
+      GPR_ASSERT(p[j] == 0);
+    }
+    memset(p, 0xff, kAllocSize);
+    // grow beyond the initial zone
+    memset(gpr_arena_alloc(a, 4 * kInitSize), 0xff, 4 * kInitSize);
+    GPR_ASSERT(gpr_arena_destroy(a) >= kAllocSize + 4 * kInitSize);
+  }
+  GPR_ASSERT(saw_hit);
+
+  // too large to be pooled
+  bool pool_hit;
+  gpr_arena* a = gpr_arena_create_pooled(1024 * 1024, &pool_hit);
+  gpr_arena_destroy(a);
+  a = gpr_arena_create_pooled(1024 * 1024, &pool_hit);
+  GPR_ASSERT(!pool_hit);
+  gpr_arena_destroy(a);
+
+  gpr_arena_pool_flush();
+}
+
+static void spill_test(void) {
+  gpr_log(GPR_DEBUG, "spill_test");
+
+  grpc_core::Arena* a = grpc_core::Arena::Create(64);
+  char* first = static_cast<char*>(a->Alloc(48));
+  // does not fit in the initial zone: must not waste its remaining space
+  a->Alloc(32);
+  char* third = static_cast<char*>(a->Alloc(16));
+  GPR_ASSERT(third == first + 48);
+  GPR_ASSERT(a->Destroy() == 96);
+}
+
+static void overflow_zone_size_test(void) {
+  gpr_log(GPR_DEBUG, "overflow_zone_size_test");
+
+  grpc_core::Arena* a = grpc_core::Arena::Create(64);
+  a->Alloc(64);
+  // the first overflow zone is as large as the initial zone
+  char* first = static_cast<char*>(a->Alloc(16));
+  for (size_t i = 1; i < 4; i++) {
+    GPR_ASSERT(static_cast<char*>(a->Alloc(16)) == first + 16 * i);
+  }
+  char* next_zone = static_cast<char*>(a->Alloc(16));
+  GPR_ASSERT(next_zone < first || next_zone >= first + 64);
+  // and the next one twice as large
+  for (size_t i = 1; i < 8; i++) {
+    GPR_ASSERT(static_cast<char*>(a->Alloc(16)) == next_zone + 16 * i);
+  }
+  GPR_ASSERT(a->Destroy() == 64 + 12 * 16);
+}
+
+namespace {
+
+class DestructionRecorder {
+ public:
+  DestructionRecorder(int id, int* order, int* count)
+      : id_(id), order_(order), count_(count) {}
+  ~DestructionRecorder() { order_[(*count_)++] = id_; }
+
+ private:
+  int id_;
+  int* order_;
+  int* count_;
+};
+
+}  // namespace
+
+static void new_test(void) {
+  gpr_log(GPR_DEBUG, "new_test");
+
+  grpc_core::Arena* a = grpc_core::Arena::Create(64);
+  // small types are only padded to their own alignment
+  char* c1 = a->New<char>('a');
+  char* c2 = a->New<char>('b');
+  GPR_ASSERT(c2 == c1 + 1);
+  GPR_ASSERT(*c1 == 'a' && *c2 == 'b');
+  double* d = a->New<double>(1.5);
+  GPR_ASSERT(reinterpret_cast<intptr_t>(d) % alignof(double) == 0);
+  GPR_ASSERT(*d == 1.5);
+  // destructors run at destruction, in reverse order of construction, also
+  // for objects in overflow zones
+  int order[4];
+  int count = 0;
+  for (int i = 0; i < 4; i++) {
+    a->New<DestructionRecorder>(i, order, &count);
+    a->Alloc(100);
+  }
+  GPR_ASSERT(count == 0);
+  a->Destroy();
+  GPR_ASSERT(count == 4);
+  for (int i = 0; i < 4; i++) {
+    GPR_ASSERT(order[i] == 3 - i);
+  }
+}
+
 int main(int argc, char* argv[]) {
   grpc_test_init(argc, argv);
 
@@ -126,6 +237,10 @@ int main(int argc, char* argv[]) {
   TEST(1_inc, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11);
   TEST(6_123, 6, 1, 2, 3);
   concurrent_test();
+  pooled_test();
+  spill_test();
+  overflow_zone_size_test();
+  new_test();
 
   return 0;
 }
@@ -0,0 +1,148 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/lib/gpr/spmcq.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "test/core/util/test_config.h"
+
+// Items are the integers 1..N, disguised as pointers
+static void* item(size_t i) { return reinterpret_cast<void*>(i); }
+static size_t item_value(void* p) { return reinterpret_cast<size_t>(p); }
+
+static void test_serial(void) {
+  gpr_log(GPR_DEBUG, "test_serial");
+  gpr_spmcq q;
+  gpr_spmcq_init(&q);
+  GPR_ASSERT(gpr_spmcq_pop(&q) == nullptr);
+  // interleave pushes and pops so that the buffer both wraps around and grows
+  size_t next_push = 1;
+  size_t next_pop = 1;
+  for (size_t round = 1; round <= 12; round++) {
+    for (size_t i = 0; i < (static_cast<size_t>(1) << round); i++) {
+      gpr_spmcq_push(&q, item(next_push++));
+    }
+    GPR_ASSERT(gpr_spmcq_size(&q) == next_push - next_pop);
+    for (size_t i = 0; i < (static_cast<size_t>(1) << (round - 1)); i++) {
+      GPR_ASSERT(item_value(gpr_spmcq_pop(&q)) == next_pop++);
+    }
+  }
+  void* p;
+  while ((p = gpr_spmcq_pop(&q)) != nullptr) {
+    GPR_ASSERT(item_value(p) == next_pop++);
+  }
+  GPR_ASSERT(next_pop == next_push);
+  GPR_ASSERT(gpr_spmcq_size(&q) == 0);
+  gpr_spmcq_destroy(&q);
+}
+
+#define NUM_ITEMS 1000000
+
+typedef struct {
+  gpr_spmcq* q;
+  gpr_event* start;
+  gpr_atm* done;
+  gpr_atm* seen;
+  size_t popped;
+} thief_args;
+
+static void thief_thread(void* arg) {
+  thief_args* a = static_cast<thief_args*>(arg);
+  gpr_event_wait(a->start, gpr_inf_future(GPR_CLOCK_REALTIME));
+  size_t last = 0;
+  for (;;) {
+    bool done = gpr_atm_acq_load(a->done) != 0;
+    void* p = gpr_spmcq_pop(a->q);
+    if (p == nullptr) {
+      if (done) return;
+      continue;
+    }
+    size_t i = item_value(p);
+    // a single consumer sees items in the order they were pushed
+    GPR_ASSERT(i > last);
+    last = i;
+    GPR_ASSERT(gpr_atm_no_barrier_fetch_add(&a->seen[i], 1) == 0);
+    a->popped++;
+  }
+}
+
+// The owner pushes while thieves pop; every item is popped exactly once
+static void test_mt(void) {
+  gpr_log(GPR_DEBUG, "test_mt");
+  gpr_event start;
+  gpr_event_init(&start);
+  gpr_atm done;
+  gpr_atm_no_barrier_store(&done, 0);
+  gpr_atm* seen =
+      static_cast<gpr_atm*>(gpr_zalloc((NUM_ITEMS + 1) * sizeof(gpr_atm)));
+  gpr_spmcq q;
+  gpr_spmcq_init(&q);
+  grpc_core::Thread thds[8];
+  thief_args ta[GPR_ARRAY_SIZE(thds)];
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(thds); i++) {
+    ta[i].q = &q;
+    ta[i].start = &start;
+    ta[i].done = &done;
+    ta[i].seen = seen;
+    ta[i].popped = 0;
+    thds[i] = grpc_core::Thread("grpc_spmcq_thief", thief_thread, &ta[i]);
+    thds[i].Start();
+  }
+  gpr_event_set(&start, (void*)1);
+  size_t owner_popped = 0;
+  for (size_t i = 1; i <= NUM_ITEMS; i++) {
+    gpr_spmcq_push(&q, item(i));
+    // the owner takes its share too
+    if (i % 4 == 0) {
+      void* p = gpr_spmcq_pop(&q);
+      if (p != nullptr) {
+        GPR_ASSERT(gpr_atm_no_barrier_fetch_add(&seen[item_value(p)], 1) == 0);
+        owner_popped++;
+      }
+    }
+  }
+  gpr_atm_rel_store(&done, 1);
+  size_t total = owner_popped;
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(thds); i++) {
+    thds[i].Join();
+    total += ta[i].popped;
+  }
+  gpr_log(GPR_DEBUG, "owner popped %" PRIuPTR " of %d", owner_popped,
+          NUM_ITEMS);
+  GPR_ASSERT(total == NUM_ITEMS);
+  for (size_t i = 1; i <= NUM_ITEMS; i++) {
+    GPR_ASSERT(gpr_atm_no_barrier_load(&seen[i]) == 1);
+  }
+  gpr_spmcq_destroy(&q);
+  gpr_free(seen);
+}
+
+int main(int argc, char** argv) {
+  grpc_test_init(argc, argv);
+  test_serial();
+  test_mt();
+  return 0;
+}
@@ -77,6 +77,19 @@ TEST(InlinedVectorTest, EmplaceBack) {
   EXPECT_EQ(3, *v[0]);
 }
 
+TEST(InlinedVectorTest, PopBack) {
+  InlinedVector<UniquePtr<int>, 1> v;
+  v.emplace_back(New<int>(3));
+  v.emplace_back(New<int>(5));
+  v.pop_back();
+  EXPECT_EQ(1UL, v.size());
+  EXPECT_EQ(3, *v[0]);
+  v.pop_back();
+  EXPECT_TRUE(v.empty());
+  v.emplace_back(New<int>(7));
+  EXPECT_EQ(7, *v[0]);
+}
+
 TEST(InlinedVectorTest, ClearAndRepopulate) {
   const int kNumElements = 10;
   InlinedVector<int, 5> v;
@@ -29,6 +29,7 @@
 #include <grpc/grpc.h>
 #include <grpc/support/log.h>
 #include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/useful.h"
 #include "test/core/util/test_config.h"
 #include "test/core/util/tracer_util.h"
 
@@ -37,6 +38,9 @@
 extern grpc_core::TraceFlag grpc_timer_trace;
 extern grpc_core::TraceFlag grpc_timer_check_trace;
 
+extern grpc_timer_vtable grpc_generic_timer_vtable;
+extern grpc_timer_vtable grpc_timer_wheel_vtable;
+
 static int cb_called[MAX_CB][2];
 
 static void cb(void* arg, grpc_error* error) {
@@ -151,6 +155,53 @@ void destruction_test(void) {
   GPR_ASSERT(1 == cb_called[2][0]);
 }
 
+/* Timers spread across every level of a timing wheel (and beyond) must fire
+   once the clock reaches their deadline, and not a tick earlier. */
+void long_deadline_test(void) {
+  const grpc_millis deltas[] = {
+      1,      63,     64,      65,       4095,          4096,
+      5000,   262143, 262144,  300000,   1 << 24,       (1 << 24) + 5,
+      1 << 30};
+  const size_t n = GPR_ARRAY_SIZE(deltas);
+  grpc_timer timers[MAX_CB];
+  grpc_core::ExecCtx exec_ctx;
+
+  gpr_log(GPR_INFO, "long_deadline_test");
+
+  GPR_ASSERT(2 * n <= MAX_CB);
+  grpc_core::ExecCtx::Get()->TestOnlySetNow(1000);
+  grpc_timer_list_init();
+  memset(cb_called, 0, sizeof(cb_called));
+
+  grpc_millis start = grpc_core::ExecCtx::Get()->Now();
+  for (size_t i = 0; i < 2 * n; i++) {
+    grpc_timer_init(&timers[i], start + deltas[i % n],
+                    GRPC_CLOSURE_CREATE(cb, (void*)(intptr_t)i,
+                                        grpc_schedule_on_exec_ctx));
+  }
+  /* The second copy of every timer gets cancelled */
+  for (size_t i = n; i < 2 * n; i++) {
+    grpc_timer_cancel(&timers[i]);
+  }
+  grpc_core::ExecCtx::Get()->Flush();
+
+  for (size_t i = 0; i < n; i++) {
+    grpc_core::ExecCtx::Get()->TestOnlySetNow(start + deltas[i] - 1);
+    grpc_timer_check(nullptr);
+    grpc_core::ExecCtx::Get()->Flush();
+    GPR_ASSERT(cb_called[i][1] == 0);
+    grpc_core::ExecCtx::Get()->TestOnlySetNow(start + deltas[i]);
+    grpc_timer_check(nullptr);
+    grpc_core::ExecCtx::Get()->Flush();
+    for (size_t j = 0; j < 2 * n; j++) {
+      GPR_ASSERT(cb_called[j][1] == (j <= i));
+      GPR_ASSERT(cb_called[j][0] == (j >= n));
+    }
+  }
+
+  grpc_timer_list_shutdown();
+}
+
 int main(int argc, char** argv) {
   grpc_test_init(argc, argv);
   grpc_core::ExecCtx::GlobalInit();
@@ -158,8 +209,14 @@ int main(int argc, char** argv) {
   grpc_determine_iomgr_platform();
   grpc_iomgr_platform_init();
   gpr_set_log_verbosity(GPR_LOG_SEVERITY_DEBUG);
-  add_test();
-  destruction_test();
+  grpc_timer_vtable* impls[] = {&grpc_generic_timer_vtable,
+                                &grpc_timer_wheel_vtable};
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(impls); i++) {
+    grpc_set_timer_impl(impls[i]);
+    add_test();
+    destruction_test();
+    long_deadline_test();
+  }
   grpc_iomgr_platform_shutdown();
   grpc_core::ExecCtx::GlobalShutdown();
   return 0;
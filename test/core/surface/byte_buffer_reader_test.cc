@@ -266,6 +266,67 @@ static void test_byte_buffer_copy(void) {
   grpc_byte_buffer_destroy(copied_buffer);
 }
 
+/* A message object that serializes to its string, or fails to if it is
+   NULL */
+static int message_object_destroyed;
+
+static int serialize_message_object(void* object, grpc_slice_buffer* out) {
+  if (object == nullptr) return 0;
+  grpc_slice_buffer_add(
+      out, grpc_slice_from_copied_string(static_cast<const char*>(object)));
+  return 1;
+}
+
+static void destroy_message_object(void* object) {
+  message_object_destroyed++;
+}
+
+static const grpc_message_object_vtable message_object_vtable = {
+    serialize_message_object, destroy_message_object};
+
+static void test_message_object(void) {
+  static const char type = 0;
+  static const char other_type = 0;
+  char object[] = "test";
+  grpc_byte_buffer* buffer;
+  grpc_byte_buffer* copy;
+  grpc_byte_buffer_reader reader;
+  grpc_slice slice;
+  int exclusive = 0;
+
+  LOG_TEST("test_message_object");
+  message_object_destroyed = 0;
+  buffer = grpc_message_object_byte_buffer_create(object, &type,
+                                                  &message_object_vtable);
+  GPR_ASSERT(grpc_byte_buffer_get_message_object(buffer, &type, &exclusive) ==
+             object);
+  GPR_ASSERT(exclusive);
+  GPR_ASSERT(grpc_byte_buffer_get_message_object(buffer, &other_type,
+                                                 &exclusive) == nullptr);
+  copy = grpc_byte_buffer_copy(buffer);
+  GPR_ASSERT(grpc_byte_buffer_get_message_object(copy, &type, &exclusive) ==
+             object);
+  GPR_ASSERT(!exclusive);
+  /* readers see the serialized object */
+  GPR_ASSERT(grpc_byte_buffer_reader_init(&reader, copy) &&
+             "Couldn't init byte buffer reader");
+  slice = grpc_byte_buffer_reader_readall(&reader);
+  GPR_ASSERT(grpc_slice_str_cmp(slice, "test") == 0);
+  grpc_slice_unref(slice);
+  grpc_byte_buffer_reader_destroy(&reader);
+  grpc_byte_buffer_destroy(copy);
+  GPR_ASSERT(message_object_destroyed == 0);
+  grpc_byte_buffer_destroy(buffer);
+  GPR_ASSERT(message_object_destroyed == 1);
+
+  /* a reader fails on an object that doesn't serialize */
+  buffer = grpc_message_object_byte_buffer_create(nullptr, &type,
+                                                  &message_object_vtable);
+  GPR_ASSERT(!grpc_byte_buffer_reader_init(&reader, buffer));
+  grpc_byte_buffer_destroy(buffer);
+  GPR_ASSERT(message_object_destroyed == 2);
+}
+
 int main(int argc, char** argv) {
   grpc_test_init(argc, argv);
   test_read_one_slice();
@@ -277,5 +338,6 @@ int main(int argc, char** argv) {
   test_byte_buffer_from_reader();
   test_byte_buffer_copy();
   test_readall();
+  test_message_object();
   return 0;
 }
@@ -18,6 +18,8 @@
 
 #include "src/core/lib/surface/completion_queue.h"
 
+#include <string.h>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
@@ -350,6 +352,88 @@ static void test_pluck_after_shutdown(void) {
   }
 }
 
+#define NUM_CALLBACK_TAGS 128
+
+typedef struct test_callback_functor {
+  grpc_completion_queue_functor functor;
+  gpr_mu mu;
+  gpr_cv cv;
+  int seen[NUM_CALLBACK_TAGS];
+  size_t events;
+  bool shutdown;
+} test_callback_functor;
+
+static void test_callback_run(grpc_completion_queue_functor* functor,
+                              grpc_event ev) {
+  test_callback_functor* f = (test_callback_functor*)functor;
+  gpr_mu_lock(&f->mu);
+  GPR_ASSERT(!f->shutdown);
+  if (ev.type == GRPC_QUEUE_SHUTDOWN) {
+    GPR_ASSERT(f->events == NUM_CALLBACK_TAGS);
+    f->shutdown = true;
+    gpr_cv_signal(&f->cv);
+  } else {
+    GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+    GPR_ASSERT(ev.success);
+    intptr_t i = (intptr_t)ev.tag;
+    GPR_ASSERT(i >= 0 && i < NUM_CALLBACK_TAGS);
+    GPR_ASSERT(!f->seen[i]);
+    f->seen[i] = 1;
+    f->events++;
+  }
+  gpr_mu_unlock(&f->mu);
+}
+
+/* every operation ended on a callback cq reaches the functor exactly once,
+   followed by a single shutdown event, whether the functor is run inline or
+   on the executor */
+static void test_callback(void) {
+  grpc_cq_completion completions[NUM_CALLBACK_TAGS];
+  int inlineable[] = {1, 0};
+
+  LOG_TEST("test_callback");
+
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(inlineable); i++) {
+    test_callback_functor f;
+    memset(&f, 0, sizeof(f));
+    f.functor.run = test_callback_run;
+    f.functor.inlineable = inlineable[i];
+    gpr_mu_init(&f.mu);
+    gpr_cv_init(&f.cv);
+    grpc_completion_queue* cc =
+        grpc_completion_queue_create_for_callback(&f.functor, nullptr);
+    GPR_ASSERT(grpc_get_cq_completion_type(cc) == GRPC_CQ_CALLBACK);
+
+    for (intptr_t j = 0; j < NUM_CALLBACK_TAGS; j++) {
+      GPR_ASSERT(grpc_cq_begin_op(cc, (void*)j));
+    }
+    {
+      grpc_core::ExecCtx exec_ctx;
+      for (intptr_t j = 0; j < NUM_CALLBACK_TAGS; j++) {
+        grpc_cq_end_op(cc, (void*)j, GRPC_ERROR_NONE,
+                       do_nothing_end_completion, nullptr, &completions[j]);
+      }
+    }
+    /* polling a callback cq never returns an event */
+    grpc_event ev = grpc_completion_queue_next(
+        cc, gpr_inf_past(GPR_CLOCK_REALTIME), nullptr);
+    GPR_ASSERT(ev.type == GRPC_QUEUE_TIMEOUT);
+
+    grpc_completion_queue_shutdown(cc);
+    gpr_mu_lock(&f.mu);
+    while (!f.shutdown) {
+      gpr_cv_wait(&f.cv, &f.mu, gpr_inf_future(GPR_CLOCK_REALTIME));
+    }
+    gpr_mu_unlock(&f.mu);
+    ev = grpc_completion_queue_next(cc, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                    nullptr);
+    GPR_ASSERT(ev.type == GRPC_QUEUE_SHUTDOWN);
+    grpc_completion_queue_destroy(cc);
+    gpr_cv_destroy(&f.cv);
+    gpr_mu_destroy(&f.mu);
+  }
+}
+
 struct thread_state {
   grpc_completion_queue* cc;
   void* tag;
@@ -368,6 +452,7 @@ int main(int argc, char** argv) {
   test_pluck_after_shutdown();
   test_cq_tls_cache_full();
   test_cq_tls_cache_empty();
+  test_callback();
   grpc_shutdown();
   return 0;
 }
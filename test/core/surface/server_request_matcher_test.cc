@@ -0,0 +1,279 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Stress test for the server's matching of incoming calls with requested
+   calls: server threads, each polling its own cq, keep a few requests
+   outstanding while client threads issue many more calls at once, for a
+   registered and an unregistered method, so that calls and requests race to
+   be queued on both sides of the matchers. Every call must be served exactly
+   once. */
+
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/ext/transport/inproc/inproc_transport.h"
+#include "src/core/lib/gprpp/thd.h"
+
+#include "test/core/util/test_config.h"
+
+#define NUM_SERVER_CQS 4
+/* requests kept outstanding by each server thread, per method */
+#define REQUESTS_PER_CQ 2
+#define NUM_CLIENT_THREADS 4
+#define CALLS_PER_CLIENT 1000
+/* calls each client thread keeps in flight */
+#define CLIENT_WINDOW 16
+
+#define REGISTERED_METHOD "/test/Registered"
+#define UNREGISTERED_METHOD "/test/Unregistered"
+
+typedef struct server_slot {
+  bool registered;
+  /* is the slot waiting for a requested call, or for the reply to finish? */
+  bool replying;
+  grpc_call* call;
+  gpr_timespec deadline;
+  grpc_call_details details;
+  grpc_metadata_array request_metadata;
+  int cancelled;
+} server_slot;
+
+typedef struct server_thread_state {
+  grpc_completion_queue* cq;
+  server_slot slots[2 * REQUESTS_PER_CQ];
+  grpc_core::Thread thd;
+} server_thread_state;
+
+static grpc_server* g_server;
+static void* g_registered_method;
+static server_thread_state g_server_threads[NUM_SERVER_CQS];
+static gpr_atm g_calls_served;
+
+static void request_call(server_thread_state* st, server_slot* slot) {
+  slot->replying = false;
+  grpc_metadata_array_init(&slot->request_metadata);
+  grpc_call_error error;
+  if (slot->registered) {
+    error = grpc_server_request_registered_call(
+        g_server, g_registered_method, &slot->call, &slot->deadline,
+        &slot->request_metadata, nullptr, st->cq, st->cq, slot);
+  } else {
+    grpc_call_details_init(&slot->details);
+    error = grpc_server_request_call(g_server, &slot->call, &slot->details,
+                                     &slot->request_metadata, st->cq, st->cq,
+                                     slot);
+  }
+  GPR_ASSERT(error == GRPC_CALL_OK);
+}
+
+static void release_request(server_slot* slot) {
+  grpc_metadata_array_destroy(&slot->request_metadata);
+  if (!slot->registered) grpc_call_details_destroy(&slot->details);
+}
+
+static void reply(server_thread_state* st, server_slot* slot) {
+  slot->replying = true;
+  if (!slot->registered) {
+    GPR_ASSERT(0 == grpc_slice_str_cmp(slot->details.method,
+                                       UNREGISTERED_METHOD));
+  }
+  grpc_op ops[3];
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+  ops[1].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  ops[1].data.send_status_from_server.status = GRPC_STATUS_OK;
+  ops[2].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  ops[2].data.recv_close_on_server.cancelled = &slot->cancelled;
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_call_start_batch(slot->call, ops, 3, slot, nullptr));
+}
+
+/* Serves calls until the cq shuts down. Requests failed by the server
+   shutdown are not renewed. */
+static void server_thread(void* arg) {
+  server_thread_state* st = static_cast<server_thread_state*>(arg);
+  for (;;) {
+    grpc_event ev = grpc_completion_queue_next(
+        st->cq, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr);
+    if (ev.type == GRPC_QUEUE_SHUTDOWN) return;
+    GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+    server_slot* slot = static_cast<server_slot*>(ev.tag);
+    if (!slot->replying) {
+      if (ev.success) {
+        reply(st, slot);
+      } else {
+        release_request(slot);
+      }
+      continue;
+    }
+    GPR_ASSERT(ev.success);
+    GPR_ASSERT(!slot->cancelled);
+    grpc_call_unref(slot->call);
+    release_request(slot);
+    gpr_atm_full_fetch_add(&g_calls_served, 1);
+    request_call(st, slot);
+  }
+}
+
+typedef struct client_call {
+  grpc_call* call;
+  grpc_metadata_array initial_metadata;
+  grpc_metadata_array trailing_metadata;
+  grpc_status_code status;
+  grpc_slice details;
+} client_call;
+
+typedef struct client_thread_state {
+  grpc_channel* channel;
+  grpc_completion_queue* cq;
+  client_call calls[CLIENT_WINDOW];
+  grpc_core::Thread thd;
+} client_thread_state;
+
+static void start_call(client_thread_state* ct, client_call* cc, int n) {
+  grpc_slice method = grpc_slice_from_static_string(
+      n % 2 == 0 ? REGISTERED_METHOD : UNREGISTERED_METHOD);
+  cc->call = grpc_channel_create_call(
+      ct->channel, nullptr, GRPC_PROPAGATE_DEFAULTS, ct->cq, method, nullptr,
+      grpc_timeout_seconds_to_deadline(30), nullptr);
+  grpc_metadata_array_init(&cc->initial_metadata);
+  grpc_metadata_array_init(&cc->trailing_metadata);
+  grpc_op ops[4];
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+  ops[1].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  ops[2].op = GRPC_OP_RECV_INITIAL_METADATA;
+  ops[2].data.recv_initial_metadata.recv_initial_metadata =
+      &cc->initial_metadata;
+  ops[3].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  ops[3].data.recv_status_on_client.trailing_metadata = &cc->trailing_metadata;
+  ops[3].data.recv_status_on_client.status = &cc->status;
+  ops[3].data.recv_status_on_client.status_details = &cc->details;
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_call_start_batch(cc->call, ops, 4, cc, nullptr));
+}
+
+static void client_thread(void* arg) {
+  client_thread_state* ct = static_cast<client_thread_state*>(arg);
+  int started = 0;
+  for (; started < CLIENT_WINDOW; started++) {
+    start_call(ct, &ct->calls[started], started);
+  }
+  for (int finished = 0; finished < CALLS_PER_CLIENT; finished++) {
+    grpc_event ev = grpc_completion_queue_next(
+        ct->cq, grpc_timeout_seconds_to_deadline(30), nullptr);
+    GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+    GPR_ASSERT(ev.success);
+    client_call* cc = static_cast<client_call*>(ev.tag);
+    GPR_ASSERT(cc->status == GRPC_STATUS_OK);
+    grpc_slice_unref(cc->details);
+    grpc_metadata_array_destroy(&cc->initial_metadata);
+    grpc_metadata_array_destroy(&cc->trailing_metadata);
+    grpc_call_unref(cc->call);
+    if (started < CALLS_PER_CLIENT) {
+      start_call(ct, cc, started++);
+    }
+  }
+}
+
+static void drain_and_destroy_cq(grpc_completion_queue* cq) {
+  grpc_completion_queue_shutdown(cq);
+  while (grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                    nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(cq);
+}
+
+static void test_concurrent_matching(void) {
+  gpr_log(GPR_INFO, "test_concurrent_matching");
+  g_server = grpc_server_create(nullptr, nullptr);
+  g_registered_method = grpc_server_register_method(
+      g_server, REGISTERED_METHOD, nullptr, GRPC_SRM_PAYLOAD_NONE, 0);
+  GPR_ASSERT(g_registered_method != nullptr);
+  for (int i = 0; i < NUM_SERVER_CQS; i++) {
+    g_server_threads[i].cq = grpc_completion_queue_create_for_next(nullptr);
+    grpc_server_register_completion_queue(g_server, g_server_threads[i].cq,
+                                          nullptr);
+  }
+  grpc_server_start(g_server);
+  gpr_atm_no_barrier_store(&g_calls_served, 0);
+
+  for (int i = 0; i < NUM_SERVER_CQS; i++) {
+    server_thread_state* st = &g_server_threads[i];
+    for (int j = 0; j < 2 * REQUESTS_PER_CQ; j++) {
+      st->slots[j].registered = j % 2 == 0;
+      request_call(st, &st->slots[j]);
+    }
+    st->thd = grpc_core::Thread("grpc_server_matcher_test", server_thread, st);
+    st->thd.Start();
+  }
+
+  client_thread_state clients[NUM_CLIENT_THREADS];
+  for (int i = 0; i < NUM_CLIENT_THREADS; i++) {
+    clients[i].channel = grpc_inproc_channel_create(g_server, nullptr, nullptr);
+    clients[i].cq = grpc_completion_queue_create_for_next(nullptr);
+    clients[i].thd =
+        grpc_core::Thread("grpc_client_matcher_test", client_thread,
+                          &clients[i]);
+    clients[i].thd.Start();
+  }
+  for (int i = 0; i < NUM_CLIENT_THREADS; i++) {
+    clients[i].thd.Join();
+    grpc_channel_destroy(clients[i].channel);
+    drain_and_destroy_cq(clients[i].cq);
+  }
+  /* the server side of the last calls may complete a little after the
+     client side: wait for it, so that only requests are left when the server
+     shuts down */
+  gpr_timespec deadline = grpc_timeout_seconds_to_deadline(10);
+  while (gpr_atm_acq_load(&g_calls_served) <
+         NUM_CLIENT_THREADS * CALLS_PER_CLIENT) {
+    GPR_ASSERT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline) < 0);
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(1));
+  }
+  GPR_ASSERT(gpr_atm_acq_load(&g_calls_served) ==
+             NUM_CLIENT_THREADS * CALLS_PER_CLIENT);
+
+  grpc_completion_queue* shutdown_cq =
+      grpc_completion_queue_create_for_pluck(nullptr);
+  grpc_server_shutdown_and_notify(g_server, shutdown_cq, nullptr);
+  GPR_ASSERT(grpc_completion_queue_pluck(shutdown_cq, nullptr,
+                                         grpc_timeout_seconds_to_deadline(5),
+                                         nullptr)
+                 .type == GRPC_OP_COMPLETE);
+  grpc_completion_queue_destroy(shutdown_cq);
+  grpc_server_destroy(g_server);
+  for (int i = 0; i < NUM_SERVER_CQS; i++) {
+    grpc_completion_queue_shutdown(g_server_threads[i].cq);
+    g_server_threads[i].thd.Join();
+    grpc_completion_queue_destroy(g_server_threads[i].cq);
+  }
+}
+
+int main(int argc, char** argv) {
+  grpc_test_init(argc, argv);
+  grpc_init();
+  test_concurrent_matching();
+  grpc_shutdown();
+  return 0;
+}
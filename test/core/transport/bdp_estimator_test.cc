@@ -98,6 +98,26 @@ TEST(BdpEstimatorTest, GetEstimate3Samples) {
   est.EstimateBdp();
 }
 
+TEST(BdpEstimatorTest, EstimateRtt) {
+  BdpEstimator est("test");
+  EXPECT_EQ(est.EstimateRtt(), 0);
+  grpc_core::ExecCtx exec_ctx;
+  for (int i = 0; i < 3; i++) {
+    est.SchedulePing();
+    est.StartPing();
+    inc_time();
+    est.CompletePing();
+    EXPECT_EQ(est.EstimateRtt(), 30);
+  }
+  est.SchedulePing();
+  est.StartPing();
+  inc_time();
+  inc_time();
+  est.CompletePing();
+  EXPECT_GT(est.EstimateRtt(), 30);
+  EXPECT_LT(est.EstimateRtt(), 60);
+}
+
 namespace {
 int64_t NextPow2(int64_t v) {
   v--;
@@ -18,6 +18,7 @@
 
 #include "src/core/ext/transport/chttp2/transport/bin_encoder.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 /* This is here for grpc_is_binary_header
@@ -26,6 +27,8 @@
 #include <grpc/grpc.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include "src/core/ext/transport/chttp2/transport/base64_simd.h"
+#include "src/core/ext/transport/chttp2/transport/bin_decoder.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 
@@ -98,6 +101,61 @@ static void expect_binary_header(const char* hdr, int binary) {
   }
 }
 
+static grpc_slice decode(grpc_slice base64, size_t length) {
+  return grpc_chttp2_base64_decode_with_length(base64, length);
+}
+
+static grpc_slice random_slice(size_t length) {
+  grpc_slice slice = GRPC_SLICE_MALLOC(length);
+  for (size_t i = 0; i < length; i++) {
+    GRPC_SLICE_START_PTR(slice)[i] = static_cast<uint8_t>(rand());
+  }
+  return slice;
+}
+
+/* every base64 implementation this machine supports encodes and decodes like
+   the portable one, over lengths that cover the bulk kernels' block sizes and
+   the encoder's chunking, and with invalid characters anywhere */
+static void expect_base64_impls_agree(void) {
+  static const grpc_chttp2_base64_impl impls[] = {GRPC_CHTTP2_BASE64_SSE4,
+                                                  GRPC_CHTTP2_BASE64_AVX2};
+  for (int i = 0; i < 300; i++) {
+    grpc_slice input = random_slice(static_cast<size_t>(rand()) % 4096);
+    grpc_chttp2_base64_set_impl(GRPC_CHTTP2_BASE64_SCALAR);
+    grpc_slice base64 = grpc_chttp2_base64_encode(input);
+    grpc_slice combined = grpc_chttp2_base64_encode_and_huffman_compress(input);
+    grpc_slice corrupt = grpc_slice_dup(base64);
+    if (GRPC_SLICE_LENGTH(corrupt) > 0) {
+      GRPC_SLICE_START_PTR(
+          corrupt)[static_cast<size_t>(rand()) % GRPC_SLICE_LENGTH(corrupt)] =
+          "!*.~\x80"[rand() % 5];
+    }
+    size_t length = GRPC_SLICE_LENGTH(input);
+    grpc_slice corrupt_decoded = decode(corrupt, length);
+    expect_slice_eq(grpc_slice_ref(input), decode(base64, length),
+                    "scalar round trip", __LINE__);
+    for (grpc_chttp2_base64_impl impl : impls) {
+      if (!grpc_chttp2_base64_impl_supported(impl)) continue;
+      grpc_chttp2_base64_set_impl(impl);
+      expect_slice_eq(grpc_slice_ref(base64), grpc_chttp2_base64_encode(input),
+                      "encode", __LINE__);
+      expect_slice_eq(grpc_slice_ref(combined),
+                      grpc_chttp2_base64_encode_and_huffman_compress(input),
+                      "encode and huffman compress", __LINE__);
+      expect_slice_eq(grpc_slice_ref(input), decode(base64, length), "decode",
+                      __LINE__);
+      expect_slice_eq(grpc_slice_ref(corrupt_decoded), decode(corrupt, length),
+                      "decode invalid", __LINE__);
+    }
+    grpc_slice_unref(input);
+    grpc_slice_unref(base64);
+    grpc_slice_unref(combined);
+    grpc_slice_unref(corrupt);
+    grpc_slice_unref(corrupt_decoded);
+  }
+  grpc_chttp2_base64_set_impl(GRPC_CHTTP2_BASE64_SCALAR);
+}
+
 int main(int argc, char** argv) {
   grpc_init();
 
@@ -171,6 +229,8 @@ int main(int argc, char** argv) {
   expect_binary_header("foo-bar", 0);
   expect_binary_header("-bin", 0);
 
+  expect_base64_impls_agree();
+
   grpc_shutdown();
   return all_ok ? 0 : 1;
 }
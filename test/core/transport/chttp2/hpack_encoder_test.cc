@@ -26,6 +26,7 @@
 #include <grpc/support/string_util.h>
 
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
@@ -68,25 +69,20 @@ static void verify(const verify_params params, const char* expected,
   for (i = 0; i < nheaders; i++) {
     char* key = va_arg(l, char*);
     char* value = va_arg(l, char*);
-    if (i) {
-      e[i - 1].next = &e[i];
-      e[i].prev = &e[i - 1];
-    }
     grpc_slice value_slice = grpc_slice_from_static_string(value);
     if (!params.only_intern_key) {
       value_slice = grpc_slice_intern(value_slice);
     }
-    e[i].md = grpc_mdelem_from_slices(
-        grpc_slice_intern(grpc_slice_from_static_string(key)), value_slice);
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "add_tail",
+        grpc_metadata_batch_add_tail(
+            &b, &e[i],
+            grpc_mdelem_from_slices(
+                grpc_slice_intern(grpc_slice_from_static_string(key)),
+                value_slice))));
   }
-  e[0].prev = nullptr;
-  e[nheaders - 1].next = nullptr;
   va_end(l);
 
-  b.list.head = &e[0];
-  b.list.tail = &e[nheaders - 1];
-  b.list.count = nheaders;
-
   if (cap_to_delete == num_to_delete) {
     cap_to_delete = GPR_MAX(2 * cap_to_delete, 1000);
     to_delete = static_cast<void**>(
@@ -208,12 +204,8 @@ static void verify_table_size_change_match_elem_size(const char* key,
       static_cast<grpc_linked_mdelem*>(gpr_malloc(sizeof(*e)));
   grpc_metadata_batch b;
   grpc_metadata_batch_init(&b);
-  e[0].md = elem;
-  e[0].prev = nullptr;
-  e[0].next = nullptr;
-  b.list.head = &e[0];
-  b.list.tail = &e[0];
-  b.list.count = 1;
+  GPR_ASSERT(GRPC_LOG_IF_ERROR("add_tail",
+                               grpc_metadata_batch_add_tail(&b, e, elem)));
   grpc_slice_buffer_init(&output);
 
   grpc_transport_one_way_stats stats;
@@ -250,6 +242,37 @@ static void test_interned_key_indexed() {
   }
 }
 
+static int64_t cached_blocks_sent() {
+  grpc_stats_data stats;
+  grpc_stats_collect(&stats);
+  return stats.counters[GRPC_STATS_COUNTER_HPACK_SEND_CACHED_BLOCK];
+}
+
+static void test_cached_block() {
+  verify_params params = {false, false, false};
+  int64_t before = cached_blocks_sent();
+  verify(params, "000005 0104 deadbeef 40 0161 0161", 1, "a", "a");
+  /* fully indexed: recorded, then replayed */
+  verify(params, "000001 0104 deadbeef be", 1, "a", "a");
+  verify(params, "000001 0104 deadbeef be", 1, "a", "a");
+  verify(params, "000001 0104 deadbeef be", 1, "a", "a");
+  /* adding to the table moves a:a, so the cached block must not be used */
+  verify(params, "000005 0104 deadbeef 40 0162 0163", 1, "b", "c");
+  verify(params, "000001 0104 deadbeef bf", 1, "a", "a");
+  verify(params, "000001 0104 deadbeef bf", 1, "a", "a");
+  /* a different block of the same elements */
+  verify(params, "000002 0104 deadbeef be bf", 2, "b", "c", "a", "a");
+  verify(params, "000002 0104 deadbeef be bf", 2, "b", "c", "a", "a");
+  /* a literal keeps the block out of the cache */
+  verify(params, "000006 0104 deadbeef bf 40 0164 0165", 2, "a", "a", "d",
+         "e");
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  GPR_ASSERT(cached_blocks_sent() - before == 4);
+#else
+  (void)before;
+#endif
+}
+
 static void run_test(void (*test)(), const char* name) {
   gpr_log(GPR_INFO, "RUN TEST: %s", name);
   grpc_core::ExecCtx exec_ctx;
@@ -267,6 +290,7 @@ int main(int argc, char** argv) {
   TEST(test_decode_table_overflow);
   TEST(test_encode_header_size);
   TEST(test_interned_key_indexed);
+  TEST(test_cached_block);
   grpc_shutdown();
   for (i = 0; i < num_to_delete; i++) {
     gpr_free(to_delete[i]);
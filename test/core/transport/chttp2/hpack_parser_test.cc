@@ -205,6 +205,14 @@ static void test_vectors(grpc_slice_split_mode mode) {
               "set-cookie",
               "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1", NULL);
   grpc_chttp2_hpack_parser_destroy(&parser);
+
+  grpc_chttp2_hpack_parser_init(&parser);
+  /* HEADERS with priority: exclusive dependency on stream 3, weight 32 */
+  GPR_ASSERT(parser.stream_weight == 0);
+  grpc_chttp2_hpack_parser_set_has_priority(&parser);
+  test_vector(&parser, mode, "8000 0003 1f82", ":method", "GET", NULL);
+  GPR_ASSERT(parser.stream_weight == 32);
+  grpc_chttp2_hpack_parser_destroy(&parser);
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,155 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/ext/transport/chttp2/transport/huffman_decoder.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <grpc/support/log.h>
+#include "src/core/ext/transport/chttp2/transport/huffsyms.h"
+#include "test/core/util/test_config.h"
+
+#define MAX_ENCODED_LENGTH 512
+
+/* huffman encode [in, in + length) into out, padding with the prefix of EOS;
+   returns the encoded length */
+static size_t huffman_encode(const uint8_t* in, size_t length, uint8_t* out) {
+  uint64_t bits = 0;
+  int nbits = 0;
+  size_t out_length = 0;
+  for (size_t i = 0; i < length; i++) {
+    const grpc_chttp2_huffsym* sym = &grpc_chttp2_huffsyms[in[i]];
+    bits = (bits << sym->length) | sym->bits;
+    nbits += static_cast<int>(sym->length);
+    while (nbits >= 8) {
+      nbits -= 8;
+      out[out_length++] = static_cast<uint8_t>(bits >> nbits);
+    }
+  }
+  if (nbits > 0) {
+    out[out_length++] =
+        static_cast<uint8_t>((bits << (8 - nbits)) | (0xff >> nbits));
+  }
+  return out_length;
+}
+
+/* decode in with both decoders, split at split, and check that they agree;
+   returns the decoded length */
+static size_t decode_and_compare(const uint8_t* in, size_t length,
+                                 size_t split, uint8_t* out) {
+  uint8_t ref_out[GRPC_CHTTP2_HUFFMAN_MAX_DECODED_LENGTH(MAX_ENCODED_LENGTH)];
+  uint8_t ref_state = 0;
+  size_t ref_length =
+      grpc_chttp2_huffman_decode_by_nibble(&ref_state, in, in + length,
+                                           ref_out);
+  uint8_t state = 0;
+  size_t out_length =
+      grpc_chttp2_huffman_decode(&state, in, in + split, out);
+  out_length += grpc_chttp2_huffman_decode(&state, in + split, in + length,
+                                           out + out_length);
+  GPR_ASSERT(state == ref_state);
+  GPR_ASSERT(out_length == ref_length);
+  GPR_ASSERT(0 == memcmp(out, ref_out, out_length));
+  return out_length;
+}
+
+/* every byte from every state decodes the same way with both decoders */
+static void test_all_states_and_bytes(void) {
+  gpr_log(GPR_INFO, "test_all_states_and_bytes");
+  for (int state = 0; state < 256; state++) {
+    for (int byte = 0; byte < 256; byte++) {
+      uint8_t in = static_cast<uint8_t>(byte);
+      uint8_t ref_state = static_cast<uint8_t>(state);
+      uint8_t ref_out[2];
+      size_t ref_length =
+          grpc_chttp2_huffman_decode_by_nibble(&ref_state, &in, &in + 1,
+                                               ref_out);
+      uint8_t new_state = static_cast<uint8_t>(state);
+      uint8_t out[2];
+      size_t length =
+          grpc_chttp2_huffman_decode(&new_state, &in, &in + 1, out);
+      GPR_ASSERT(new_state == ref_state);
+      GPR_ASSERT(length == ref_length);
+      GPR_ASSERT(0 == memcmp(out, ref_out, length));
+    }
+  }
+}
+
+static void test_round_trip(const char* s) {
+  gpr_log(GPR_INFO, "test_round_trip: %s", s);
+  size_t length = strlen(s);
+  uint8_t encoded[MAX_ENCODED_LENGTH];
+  size_t encoded_length =
+      huffman_encode(reinterpret_cast<const uint8_t*>(s), length, encoded);
+  uint8_t out[GRPC_CHTTP2_HUFFMAN_MAX_DECODED_LENGTH(MAX_ENCODED_LENGTH)];
+  for (size_t split = 0; split <= encoded_length; split++) {
+    GPR_ASSERT(length ==
+               decode_and_compare(encoded, encoded_length, split, out));
+    GPR_ASSERT(0 == memcmp(out, s, length));
+  }
+}
+
+/* random symbols, encoded correctly */
+static void test_random_strings(void) {
+  gpr_log(GPR_INFO, "test_random_strings");
+  uint8_t in[MAX_ENCODED_LENGTH / 4];
+  uint8_t encoded[MAX_ENCODED_LENGTH];
+  uint8_t out[GRPC_CHTTP2_HUFFMAN_MAX_DECODED_LENGTH(MAX_ENCODED_LENGTH)];
+  for (int i = 0; i < 10000; i++) {
+    size_t length = static_cast<size_t>(rand()) % sizeof(in);
+    for (size_t j = 0; j < length; j++) {
+      in[j] = static_cast<uint8_t>(rand());
+    }
+    size_t encoded_length = huffman_encode(in, length, encoded);
+    size_t split = static_cast<size_t>(rand()) % (encoded_length + 1);
+    GPR_ASSERT(length ==
+               decode_and_compare(encoded, encoded_length, split, out));
+    GPR_ASSERT(0 == memcmp(out, in, length));
+  }
+}
+
+/* random bytes, which need not be valid huffman codes at all */
+static void test_random_bytes(void) {
+  gpr_log(GPR_INFO, "test_random_bytes");
+  uint8_t in[MAX_ENCODED_LENGTH];
+  uint8_t out[GRPC_CHTTP2_HUFFMAN_MAX_DECODED_LENGTH(MAX_ENCODED_LENGTH)];
+  for (int i = 0; i < 10000; i++) {
+    size_t length = static_cast<size_t>(rand()) % (sizeof(in) + 1);
+    for (size_t j = 0; j < length; j++) {
+      in[j] = static_cast<uint8_t>(rand());
+    }
+    decode_and_compare(in, length, static_cast<size_t>(rand()) % (length + 1),
+                       out);
+  }
+}
+
+int main(int argc, char** argv) {
+  grpc_test_init(argc, argv);
+  grpc_chttp2_huffman_decoder_init();
+  test_all_states_and_bytes();
+  test_round_trip("");
+  test_round_trip("a");
+  test_round_trip("/grpc.testing.EchoTestService/Echo");
+  test_round_trip("grpc-c++/1.15.0-dev grpc-c/6.0.0-dev (linux; chttp2)");
+  test_round_trip("application/grpc");
+  test_round_trip("\x01\xff\x80 binary \x7f\xfe");
+  test_random_strings();
+  test_random_bytes();
+  return 0;
+}
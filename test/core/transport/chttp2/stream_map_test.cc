@@ -17,6 +17,11 @@
  */
 
 #include "src/core/ext/transport/chttp2/transport/stream_map.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include "test/core/util/test_config.h"
 
@@ -188,6 +193,94 @@ static void test_periodic_compaction(uint32_t n) {
   grpc_chttp2_stream_map_destroy(&map);
 }
 
+/* verify that for_each visits keys in ascending order, and count them */
+static void count_for_each(void* user_data, uint32_t stream_id, void* ptr) {
+  uint32_t* last = static_cast<uint32_t*>(user_data);
+  GPR_ASSERT(ptr);
+  GPR_ASSERT(last[0] < stream_id);
+  last[0] = stream_id;
+  last[1]++;
+}
+
+/* add keys with random strides and delete random ones, checking every
+   operation against a plain array of the live keys */
+static void test_random_operations(uint32_t n) {
+  grpc_chttp2_stream_map map;
+  uint32_t* live = static_cast<uint32_t*>(gpr_malloc(sizeof(uint32_t) * n));
+  uint32_t num_live = 0;
+  uint32_t next_key = 1;
+  uint32_t i;
+
+  LOG_TEST("test_random_operations");
+  gpr_log(GPR_INFO, "n = %d", n);
+
+  grpc_chttp2_stream_map_init(&map, 8);
+  for (i = 0; i < 4 * n; i++) {
+    if (num_live < n && (num_live == 0 || rand() % 3 != 0)) {
+      /* strides that are multiples of a large power of two would all land
+         in the same index slot without mixing */
+      next_key += (rand() % 2 == 0) ? 2 : 4096;
+      grpc_chttp2_stream_map_add(&map, next_key,
+                                 (void*)static_cast<uintptr_t>(next_key));
+      live[num_live++] = next_key;
+    } else {
+      uint32_t victim = static_cast<uint32_t>(rand()) % num_live;
+      uint32_t key = live[victim];
+      GPR_ASSERT((void*)(uintptr_t)key ==
+                 grpc_chttp2_stream_map_delete(&map, key));
+      GPR_ASSERT(nullptr == grpc_chttp2_stream_map_find(&map, key));
+      memmove(&live[victim], &live[victim + 1],
+              (num_live - victim - 1) * sizeof(uint32_t));
+      num_live--;
+    }
+    GPR_ASSERT(num_live == grpc_chttp2_stream_map_size(&map));
+    if (num_live > 0) {
+      uintptr_t value = (uintptr_t)grpc_chttp2_stream_map_rand(&map);
+      GPR_ASSERT(value == (uintptr_t)grpc_chttp2_stream_map_find(
+                              &map, static_cast<uint32_t>(value)));
+    } else {
+      GPR_ASSERT(nullptr == grpc_chttp2_stream_map_rand(&map));
+    }
+  }
+  for (i = 0; i < num_live; i++) {
+    GPR_ASSERT((void*)(uintptr_t)live[i] ==
+               grpc_chttp2_stream_map_find(&map, live[i]));
+    GPR_ASSERT(nullptr == grpc_chttp2_stream_map_find(&map, live[i] + 1));
+  }
+  uint32_t for_each_check[2] = {0, 0};
+  grpc_chttp2_stream_map_for_each(&map, count_for_each, for_each_check);
+  GPR_ASSERT(for_each_check[1] == num_live);
+  grpc_chttp2_stream_map_destroy(&map);
+  gpr_free(live);
+}
+
+/* deleting the visited stream from a for_each callback must not skip any
+   other stream */
+static void delete_for_each(void* user_data, uint32_t stream_id, void* ptr) {
+  grpc_chttp2_stream_map* map = static_cast<grpc_chttp2_stream_map*>(user_data);
+  GPR_ASSERT(ptr == grpc_chttp2_stream_map_delete(map, stream_id));
+}
+
+static void test_delete_in_for_each(uint32_t n) {
+  grpc_chttp2_stream_map map;
+  uint32_t i;
+
+  LOG_TEST("test_delete_in_for_each");
+  gpr_log(GPR_INFO, "n = %d", n);
+
+  grpc_chttp2_stream_map_init(&map, 8);
+  for (i = 1; i <= n; i++) {
+    grpc_chttp2_stream_map_add(&map, 2 * i + 1,
+                               (void*)static_cast<uintptr_t>(i));
+  }
+  grpc_chttp2_stream_map_for_each(&map, delete_for_each, &map);
+  GPR_ASSERT(0 == grpc_chttp2_stream_map_size(&map));
+  for (i = 1; i <= n; i++) {
+    GPR_ASSERT(nullptr == grpc_chttp2_stream_map_find(&map, 2 * i + 1));
+  }
+  grpc_chttp2_stream_map_destroy(&map);
+}
+
 int main(int argc, char** argv) {
   uint32_t n = 1;
   uint32_t prev = 1;
@@ -204,6 +297,8 @@ int main(int argc, char** argv) {
     test_delete_evens_sweep(n);
     test_delete_evens_incremental(n);
     test_periodic_compaction(n);
+    test_random_operations(n);
+    test_delete_in_for_each(n);
 
     tmp = n;
     n += prev;
@@ -0,0 +1,276 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/byte_buffer.h>
+#include <grpc/byte_buffer_reader.h>
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include <string.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/gpr/host_port.h"
+#include "src/core/lib/slice/slice_internal.h"
+
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace test {
+namespace {
+
+// Concurrent unary calls per round, and rounds per test: enough open streams
+// and closely spaced writes for coalescing to kick in once the transports
+// have measured their round trip time.
+constexpr int kCallsPerRound = 16;
+constexpr int kRounds = 50;
+
+enum TagKind { kServerRequest, kServerBatch, kClientBatch };
+
+void* Tag(TagKind kind, int index) {
+  return reinterpret_cast<void*>(static_cast<intptr_t>(kind) << 16 | index);
+}
+
+struct ClientCall {
+  grpc_call* call;
+  grpc_metadata_array initial_metadata;
+  grpc_metadata_array trailing_metadata;
+  grpc_byte_buffer* response;
+  grpc_status_code status;
+  grpc_slice details;
+};
+
+struct ServerCall {
+  grpc_call* call;
+  grpc_call_details details;
+  grpc_metadata_array request_metadata;
+  grpc_byte_buffer* request;
+  int cancelled;
+};
+
+grpc_channel_args* CoalescingArgs(int max_delay_us) {
+  grpc_arg arg;
+  arg.type = GRPC_ARG_INTEGER;
+  arg.key = const_cast<char*>(GRPC_ARG_HTTP2_WRITE_COALESCING_MAX_DELAY_US);
+  arg.value.integer = max_delay_us;
+  return grpc_channel_args_copy_and_add(nullptr, &arg, 1);
+}
+
+std::string ByteBufferString(grpc_byte_buffer* buffer) {
+  grpc_byte_buffer_reader reader;
+  GPR_ASSERT(grpc_byte_buffer_reader_init(&reader, buffer));
+  grpc_slice slice = grpc_byte_buffer_reader_readall(&reader);
+  std::string s(reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(slice)),
+                GRPC_SLICE_LENGTH(slice));
+  grpc_slice_unref(slice);
+  grpc_byte_buffer_reader_destroy(&reader);
+  return s;
+}
+
+// A client and a server, both with the write coalescing channel arg set to
+// the given maximum delay, exchanging rounds of concurrent unary calls on a
+// single connection.
+class WriteCoalescingTest : public ::testing::Test {
+ protected:
+  void StartServerAndClient(int max_delay_us) {
+    int port = grpc_pick_unused_port_or_die();
+    gpr_join_host_port(&address_, "localhost", port);
+    grpc_channel_args* args = CoalescingArgs(max_delay_us);
+    cq_ = grpc_completion_queue_create_for_next(nullptr);
+    server_ = grpc_server_create(args, nullptr);
+    grpc_server_register_completion_queue(server_, cq_, nullptr);
+    ASSERT_TRUE(grpc_server_add_insecure_http2_port(server_, address_));
+    grpc_server_start(server_);
+    channel_ = grpc_insecure_channel_create(address_, args, nullptr);
+    {
+      ExecCtx exec_ctx;
+      grpc_channel_args_destroy(args);
+    }
+  }
+
+  void TearDown() override {
+    if (channel_ != nullptr) grpc_channel_destroy(channel_);
+    if (server_ != nullptr) {
+      grpc_server_shutdown_and_notify(server_, cq_, nullptr);
+      grpc_event ev = grpc_completion_queue_next(
+          cq_, grpc_timeout_seconds_to_deadline(5), nullptr);
+      EXPECT_EQ(GRPC_OP_COMPLETE, ev.type);
+      grpc_server_destroy(server_);
+    }
+    if (cq_ != nullptr) {
+      grpc_completion_queue_shutdown(cq_);
+      while (grpc_completion_queue_next(
+                 cq_, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr)
+                 .type != GRPC_QUEUE_SHUTDOWN) {
+      }
+      grpc_completion_queue_destroy(cq_);
+    }
+    gpr_free(address_);
+  }
+
+  // Issues kCallsPerRound calls at once and serves them; fails the test if
+  // any of them does not get its response.
+  void RunRound(int round) {
+    ClientCall client_calls[kCallsPerRound];
+    ServerCall server_calls[kCallsPerRound];
+    memset(client_calls, 0, sizeof(client_calls));
+    memset(server_calls, 0, sizeof(server_calls));
+    grpc_slice request_slice = grpc_slice_from_static_string("request");
+    grpc_slice method = grpc_slice_from_static_string("/foo/bar");
+    for (int i = 0; i < kCallsPerRound; i++) {
+      ServerCall* sc = &server_calls[i];
+      grpc_call_details_init(&sc->details);
+      grpc_metadata_array_init(&sc->request_metadata);
+      ASSERT_EQ(GRPC_CALL_OK,
+                grpc_server_request_call(server_, &sc->call, &sc->details,
+                                         &sc->request_metadata, cq_, cq_,
+                                         Tag(kServerRequest, i)));
+    }
+    for (int i = 0; i < kCallsPerRound; i++) {
+      ClientCall* cc = &client_calls[i];
+      cc->call = grpc_channel_create_call(
+          channel_, nullptr, GRPC_PROPAGATE_DEFAULTS, cq_, method, nullptr,
+          grpc_timeout_seconds_to_deadline(10), nullptr);
+      grpc_metadata_array_init(&cc->initial_metadata);
+      grpc_metadata_array_init(&cc->trailing_metadata);
+      grpc_byte_buffer* request =
+          grpc_raw_byte_buffer_create(&request_slice, 1);
+      grpc_op ops[6];
+      memset(ops, 0, sizeof(ops));
+      ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+      ops[1].op = GRPC_OP_SEND_MESSAGE;
+      ops[1].data.send_message.send_message = request;
+      ops[2].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+      ops[3].op = GRPC_OP_RECV_INITIAL_METADATA;
+      ops[3].data.recv_initial_metadata.recv_initial_metadata =
+          &cc->initial_metadata;
+      ops[4].op = GRPC_OP_RECV_MESSAGE;
+      ops[4].data.recv_message.recv_message = &cc->response;
+      ops[5].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+      ops[5].data.recv_status_on_client.trailing_metadata =
+          &cc->trailing_metadata;
+      ops[5].data.recv_status_on_client.status = &cc->status;
+      ops[5].data.recv_status_on_client.status_details = &cc->details;
+      ASSERT_EQ(GRPC_CALL_OK,
+                grpc_call_start_batch(cc->call, ops, 6, Tag(kClientBatch, i),
+                                      nullptr));
+      grpc_byte_buffer_destroy(request);
+    }
+    grpc_slice response_slice = grpc_slice_from_static_string("response");
+    int pending = 3 * kCallsPerRound;
+    while (pending > 0) {
+      grpc_event ev = grpc_completion_queue_next(
+          cq_, grpc_timeout_seconds_to_deadline(10), nullptr);
+      ASSERT_EQ(GRPC_OP_COMPLETE, ev.type) << "round " << round;
+      ASSERT_TRUE(ev.success);
+      pending--;
+      intptr_t tag = reinterpret_cast<intptr_t>(ev.tag);
+      if ((tag >> 16) != kServerRequest) continue;
+      ServerCall* sc = &server_calls[tag & 0xffff];
+      grpc_byte_buffer* response =
+          grpc_raw_byte_buffer_create(&response_slice, 1);
+      grpc_op ops[5];
+      memset(ops, 0, sizeof(ops));
+      ops[0].op = GRPC_OP_RECV_MESSAGE;
+      ops[0].data.recv_message.recv_message = &sc->request;
+      ops[1].op = GRPC_OP_SEND_INITIAL_METADATA;
+      ops[2].op = GRPC_OP_SEND_MESSAGE;
+      ops[2].data.send_message.send_message = response;
+      ops[3].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+      ops[3].data.send_status_from_server.status = GRPC_STATUS_OK;
+      ops[4].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+      ops[4].data.recv_close_on_server.cancelled = &sc->cancelled;
+      ASSERT_EQ(GRPC_CALL_OK,
+                grpc_call_start_batch(sc->call, ops, 5,
+                                      Tag(kServerBatch, tag & 0xffff),
+                                      nullptr));
+      grpc_byte_buffer_destroy(response);
+    }
+    for (int i = 0; i < kCallsPerRound; i++) {
+      ClientCall* cc = &client_calls[i];
+      ServerCall* sc = &server_calls[i];
+      EXPECT_EQ(GRPC_STATUS_OK, cc->status);
+      EXPECT_EQ("response", ByteBufferString(cc->response));
+      EXPECT_EQ("request", ByteBufferString(sc->request));
+      EXPECT_EQ(0, sc->cancelled);
+      grpc_byte_buffer_destroy(cc->response);
+      grpc_byte_buffer_destroy(sc->request);
+      grpc_slice_unref(cc->details);
+      grpc_metadata_array_destroy(&cc->initial_metadata);
+      grpc_metadata_array_destroy(&cc->trailing_metadata);
+      grpc_metadata_array_destroy(&sc->request_metadata);
+      grpc_call_details_destroy(&sc->details);
+      grpc_call_unref(cc->call);
+      grpc_call_unref(sc->call);
+    }
+  }
+
+  // Runs all the rounds and returns how many writes were held back.
+  int64_t RunRoundsAndCountCoalescedWrites() {
+    grpc_stats_data before;
+    grpc_stats_collect(&before);
+    for (int round = 0; round < kRounds && !HasFatalFailure(); round++) {
+      RunRound(round);
+    }
+    grpc_stats_data after;
+    grpc_stats_collect(&after);
+    return after.counters[GRPC_STATS_COUNTER_HTTP2_WRITES_COALESCED] -
+           before.counters[GRPC_STATS_COUNTER_HTTP2_WRITES_COALESCED];
+  }
+
+  char* address_ = nullptr;
+  grpc_completion_queue* cq_ = nullptr;
+  grpc_server* server_ = nullptr;
+  grpc_channel* channel_ = nullptr;
+};
+
+TEST_F(WriteCoalescingTest, WritesAreNotHeldBackByDefault) {
+  StartServerAndClient(0);
+  int64_t coalesced = RunRoundsAndCountCoalescedWrites();
+  EXPECT_EQ(0, coalesced);
+}
+
+TEST_F(WriteCoalescingTest, WritesAreHeldBackWhenEnabled) {
+  StartServerAndClient(1000);
+  int64_t coalesced = RunRoundsAndCountCoalescedWrites();
+/* stats are only collected in debug builds, or with GRPC_COLLECT_STATS */
+#if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
+  EXPECT_GT(coalesced, 0);
+#else
+  (void)coalesced;
+#endif
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_test_init(argc, argv);
+  grpc_init();
+  int result = RUN_ALL_TESTS();
+  grpc_shutdown();
+  return result;
+}
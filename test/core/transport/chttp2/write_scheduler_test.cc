@@ -0,0 +1,150 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/core/ext/transport/chttp2/transport/write_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include "test/core/util/test_config.h"
+
+namespace grpc_core {
+namespace chttp2 {
+namespace {
+
+WriteSchedulerStreamState MakeStream(uint16_t weight) {
+  WriteSchedulerStreamState s;
+  s.weight = weight;
+  s.deficit = 0;
+  return s;
+}
+
+TEST(FifoWriteSchedulerTest, TurnsAreUnbounded) {
+  FifoWriteScheduler scheduler;
+  WriteSchedulerStreamState s = MakeStream(kDefaultStreamWeight);
+  EXPECT_EQ(scheduler.BeginTurn(&s), UINT32_MAX);
+  scheduler.EndTurn(&s, 1000, true);
+  EXPECT_EQ(scheduler.BeginTurn(&s), UINT32_MAX);
+  EXPECT_EQ(s.deficit, 0u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, DefaultWeightGetsQuantum) {
+  DeficitRoundRobinWriteScheduler scheduler(1000);
+  WriteSchedulerStreamState s = MakeStream(kDefaultStreamWeight);
+  EXPECT_EQ(scheduler.BeginTurn(&s), 1000u);
+  scheduler.EndTurn(&s, 1000, true);
+  EXPECT_EQ(s.deficit, 0u);
+  EXPECT_EQ(scheduler.BeginTurn(&s), 1000u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, QuantumScalesWithWeight) {
+  DeficitRoundRobinWriteScheduler scheduler(1600);
+  WriteSchedulerStreamState heavy = MakeStream(256);
+  WriteSchedulerStreamState doubled = MakeStream(32);
+  WriteSchedulerStreamState light = MakeStream(1);
+  EXPECT_EQ(scheduler.BeginTurn(&heavy), 25600u);
+  EXPECT_EQ(scheduler.BeginTurn(&doubled), 3200u);
+  EXPECT_EQ(scheduler.BeginTurn(&light), 100u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, QuantumIsAtLeastOneByte) {
+  DeficitRoundRobinWriteScheduler scheduler(4);
+  WriteSchedulerStreamState s = MakeStream(1);
+  EXPECT_EQ(scheduler.BeginTurn(&s), 1u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, UnusedCreditCarriesOver) {
+  DeficitRoundRobinWriteScheduler scheduler(1000);
+  WriteSchedulerStreamState s = MakeStream(kDefaultStreamWeight);
+  EXPECT_EQ(scheduler.BeginTurn(&s), 1000u);
+  // Flow control cut the turn short.
+  scheduler.EndTurn(&s, 300, true);
+  EXPECT_EQ(s.deficit, 700u);
+  EXPECT_EQ(scheduler.BeginTurn(&s), 1700u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, CarriedCreditIsCappedAtQuantum) {
+  DeficitRoundRobinWriteScheduler scheduler(1000);
+  WriteSchedulerStreamState s = MakeStream(kDefaultStreamWeight);
+  // A stream blocked by flow control for several turns does not pile up
+  // credit.
+  for (int i = 0; i < 5; i++) {
+    scheduler.BeginTurn(&s);
+    scheduler.EndTurn(&s, 0, true);
+    EXPECT_EQ(s.deficit, 1000u);
+  }
+  EXPECT_EQ(scheduler.BeginTurn(&s), 2000u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, CapFollowsWeight) {
+  DeficitRoundRobinWriteScheduler scheduler(1000);
+  WriteSchedulerStreamState s = MakeStream(8);
+  scheduler.BeginTurn(&s);
+  scheduler.EndTurn(&s, 0, true);
+  scheduler.BeginTurn(&s);
+  scheduler.EndTurn(&s, 0, true);
+  EXPECT_EQ(s.deficit, 500u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, CreditIsLostWhenStreamDrains) {
+  DeficitRoundRobinWriteScheduler scheduler(1000);
+  WriteSchedulerStreamState s = MakeStream(kDefaultStreamWeight);
+  scheduler.BeginTurn(&s);
+  scheduler.EndTurn(&s, 100, false);
+  EXPECT_EQ(s.deficit, 0u);
+  EXPECT_EQ(scheduler.BeginTurn(&s), 1000u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, SendingMoreThanOwedClampsToZero) {
+  DeficitRoundRobinWriteScheduler scheduler(1000);
+  WriteSchedulerStreamState s = MakeStream(kDefaultStreamWeight);
+  scheduler.BeginTurn(&s);
+  // A frame may overshoot the budget by the bytes that had to go together.
+  scheduler.EndTurn(&s, 1500, true);
+  EXPECT_EQ(s.deficit, 0u);
+}
+
+TEST(DeficitRoundRobinWriteSchedulerTest, SharesFollowWeights) {
+  DeficitRoundRobinWriteScheduler scheduler(1000);
+  WriteSchedulerStreamState a = MakeStream(48);
+  WriteSchedulerStreamState b = MakeStream(16);
+  uint64_t sent_a = 0;
+  uint64_t sent_b = 0;
+  for (int round = 0; round < 100; round++) {
+    // Both streams are backlogged and send whole frames of 700 bytes while
+    // they have the credit for them.
+    uint32_t budget = scheduler.BeginTurn(&a);
+    uint32_t sent = budget - budget % 700;
+    sent_a += sent;
+    scheduler.EndTurn(&a, sent, true);
+    budget = scheduler.BeginTurn(&b);
+    sent = budget - budget % 700;
+    sent_b += sent;
+    scheduler.EndTurn(&b, sent, true);
+  }
+  EXPECT_NEAR(static_cast<double>(sent_a) / sent_b, 3.0, 0.1);
+}
+
+}  // namespace
+}  // namespace chttp2
+}  // namespace grpc_core
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  grpc_test_init(argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -18,6 +18,7 @@
 
 #include "src/core/lib/transport/metadata.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -28,6 +29,7 @@
 
 #include "src/core/ext/transport/chttp2/transport/bin_encoder.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gprpp/thd.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/transport/static_metadata.h"
@@ -174,6 +176,69 @@ static void test_spin_creating_the_same_thing(bool intern_keys,
   grpc_shutdown();
 }
 
+#define NUM_SPIN_THREADS 8
+#define NUM_PINNED 64
+
+typedef struct {
+  grpc_mdelem* pinned;
+  size_t seed;
+} spin_thread_args;
+
+/* Look up elements that are kept alive (which must always resolve to the same
+   element), while creating and dropping others so that the tables grow,
+   collect and free entries underneath the lookups. */
+static void spin_interning(void* arg) {
+  spin_thread_args* a = static_cast<spin_thread_args*>(arg);
+  grpc_core::ExecCtx exec_ctx;
+  for (size_t i = 0; i < MANY; i++) {
+    size_t n = (a->seed + i) % NUM_PINNED;
+    char* v;
+    gpr_asprintf(&v, "%" PRIuPTR, n);
+    grpc_mdelem md = grpc_mdelem_from_slices(
+        grpc_slice_intern(grpc_slice_from_static_string("k")),
+        grpc_slice_intern(grpc_slice_from_static_string(v)));
+    GPR_ASSERT(md.payload == a->pinned[n].payload);
+    GRPC_MDELEM_UNREF(md);
+    gpr_free(v);
+    gpr_asprintf(&v, "%" PRIuPTR ":%" PRIuPTR, a->seed, i % 97);
+    GRPC_MDELEM_UNREF(grpc_mdelem_from_slices(
+        grpc_slice_intern(grpc_slice_from_static_string("k")),
+        grpc_slice_intern(grpc_slice_from_static_string(v))));
+    gpr_free(v);
+  }
+}
+
+static void test_concurrent_interning(void) {
+  gpr_log(GPR_INFO, "test_concurrent_interning");
+
+  grpc_init();
+  grpc_core::ExecCtx exec_ctx;
+  grpc_mdelem pinned[NUM_PINNED];
+  for (size_t i = 0; i < NUM_PINNED; i++) {
+    char* v;
+    gpr_asprintf(&v, "%" PRIuPTR, i);
+    pinned[i] = grpc_mdelem_from_slices(
+        grpc_slice_intern(grpc_slice_from_static_string("k")),
+        grpc_slice_intern(grpc_slice_from_static_string(v)));
+    gpr_free(v);
+  }
+  grpc_core::Thread thds[NUM_SPIN_THREADS];
+  spin_thread_args args[NUM_SPIN_THREADS];
+  for (size_t i = 0; i < NUM_SPIN_THREADS; i++) {
+    args[i].pinned = pinned;
+    args[i].seed = i;
+    thds[i] = grpc_core::Thread("spin_interning", spin_interning, &args[i]);
+    thds[i].Start();
+  }
+  for (size_t i = 0; i < NUM_SPIN_THREADS; i++) {
+    thds[i].Join();
+  }
+  for (size_t i = 0; i < NUM_PINNED; i++) {
+    GRPC_MDELEM_UNREF(pinned[i]);
+  }
+  grpc_shutdown();
+}
+
 static void test_identity_laws(bool intern_keys, bool intern_values) {
   gpr_log(GPR_INFO, "test_identity_laws: intern_keys=%d intern_values=%d",
           intern_keys, intern_values);
@@ -385,6 +450,7 @@ int main(int argc, char** argv) {
   test_create_many_persistant_metadata();
   test_things_stick_around();
   test_user_data_works();
+  test_concurrent_interning();
   grpc_shutdown();
   return 0;
 }
@@ -0,0 +1,275 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "test/core/util/recording_endpoint.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/iomgr/load_file.h"
+#include "src/core/lib/slice/slice_internal.h"
+
+#define RECORD_HEADER_SIZE 5
+
+typedef struct {
+  bool is_read;
+  grpc_slice bytes;
+} recorded_chunk;
+
+struct grpc_endpoint_recording {
+  gpr_mu mu;
+  recorded_chunk* chunks;
+  size_t count;
+  size_t capacity;
+};
+
+typedef struct {
+  grpc_endpoint base;
+  grpc_endpoint* wrapped;
+  grpc_endpoint_recording* recording;
+
+  grpc_closure on_read;
+  grpc_closure* read_cb;
+  grpc_slice_buffer* read_slices;
+} recording_endpoint;
+
+grpc_endpoint_recording* grpc_endpoint_recording_create() {
+  grpc_endpoint_recording* r =
+      static_cast<grpc_endpoint_recording*>(gpr_zalloc(sizeof(*r)));
+  gpr_mu_init(&r->mu);
+  return r;
+}
+
+void grpc_endpoint_recording_destroy(grpc_endpoint_recording* recording) {
+  for (size_t i = 0; i < recording->count; i++) {
+    grpc_slice_unref_internal(recording->chunks[i].bytes);
+  }
+  gpr_free(recording->chunks);
+  gpr_mu_destroy(&recording->mu);
+  gpr_free(recording);
+}
+
+/* Takes ownership of \a bytes */
+static void append_chunk(grpc_endpoint_recording* recording, bool is_read,
+                         grpc_slice bytes) {
+  gpr_mu_lock(&recording->mu);
+  if (recording->count == recording->capacity) {
+    recording->capacity = GPR_MAX(8, 2 * recording->capacity);
+    recording->chunks = static_cast<recorded_chunk*>(gpr_realloc(
+        recording->chunks, recording->capacity * sizeof(recorded_chunk)));
+  }
+  recording->chunks[recording->count].is_read = is_read;
+  recording->chunks[recording->count].bytes = bytes;
+  recording->count++;
+  gpr_mu_unlock(&recording->mu);
+}
+
+/* Copy the contents of \a slices into one slice, so that a chunk neither pins
+   the endpoint's buffers nor changes if they are reused */
+static grpc_slice flatten(grpc_slice_buffer* slices) {
+  grpc_slice out = GRPC_SLICE_MALLOC(slices->length);
+  uint8_t* p = GRPC_SLICE_START_PTR(out);
+  for (size_t i = 0; i < slices->count; i++) {
+    size_t len = GRPC_SLICE_LENGTH(slices->slices[i]);
+    memcpy(p, GRPC_SLICE_START_PTR(slices->slices[i]), len);
+    p += len;
+  }
+  return out;
+}
+
+grpc_endpoint_recording* grpc_endpoint_recording_load(const char* path) {
+  grpc_slice contents;
+  grpc_error* error = grpc_load_file(path, 0, &contents);
+  if (error != GRPC_ERROR_NONE) {
+    gpr_log(GPR_ERROR, "could not load recording %s: %s", path,
+            grpc_error_string(error));
+    GRPC_ERROR_UNREF(error);
+    return nullptr;
+  }
+  grpc_endpoint_recording* recording = grpc_endpoint_recording_create();
+  const uint8_t* beg = GRPC_SLICE_START_PTR(contents);
+  const uint8_t* p = beg;
+  const uint8_t* end = GRPC_SLICE_END_PTR(contents);
+  while (p != end) {
+    if (end - p < RECORD_HEADER_SIZE || (p[0] != 'R' && p[0] != 'W')) {
+      break;
+    }
+    size_t len = (static_cast<size_t>(p[1]) << 24) |
+                 (static_cast<size_t>(p[2]) << 16) |
+                 (static_cast<size_t>(p[3]) << 8) | static_cast<size_t>(p[4]);
+    if (static_cast<size_t>(end - p - RECORD_HEADER_SIZE) < len) {
+      break;
+    }
+    size_t offset = static_cast<size_t>(p - beg) + RECORD_HEADER_SIZE;
+    append_chunk(recording, p[0] == 'R',
+                 grpc_slice_sub(contents, offset, offset + len));
+    p += RECORD_HEADER_SIZE + len;
+  }
+  grpc_slice_unref_internal(contents);
+  if (p != end) {
+    gpr_log(GPR_ERROR, "malformed recording %s at offset %" PRIuPTR, path,
+            static_cast<uintptr_t>(p - beg));
+    grpc_endpoint_recording_destroy(recording);
+    return nullptr;
+  }
+  return recording;
+}
+
+bool grpc_endpoint_recording_save(grpc_endpoint_recording* recording,
+                                  const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (f == nullptr) {
+    gpr_log(GPR_ERROR, "could not open %s for writing", path);
+    return false;
+  }
+  bool ok = true;
+  gpr_mu_lock(&recording->mu);
+  for (size_t i = 0; ok && i < recording->count; i++) {
+    grpc_slice bytes = recording->chunks[i].bytes;
+    size_t len = GRPC_SLICE_LENGTH(bytes);
+    GPR_ASSERT(len <= UINT32_MAX);
+    uint8_t header[RECORD_HEADER_SIZE] = {
+        static_cast<uint8_t>(recording->chunks[i].is_read ? 'R' : 'W'),
+        static_cast<uint8_t>(len >> 24), static_cast<uint8_t>(len >> 16),
+        static_cast<uint8_t>(len >> 8), static_cast<uint8_t>(len)};
+    ok = fwrite(header, 1, sizeof(header), f) == sizeof(header) &&
+         fwrite(GRPC_SLICE_START_PTR(bytes), 1, len, f) == len;
+  }
+  gpr_mu_unlock(&recording->mu);
+  if (fclose(f) != 0) ok = false;
+  if (!ok) {
+    gpr_log(GPR_ERROR, "failed writing recording to %s", path);
+  }
+  return ok;
+}
+
+size_t grpc_endpoint_recording_count(grpc_endpoint_recording* recording) {
+  gpr_mu_lock(&recording->mu);
+  size_t count = recording->count;
+  gpr_mu_unlock(&recording->mu);
+  return count;
+}
+
+grpc_slice grpc_endpoint_recording_get(grpc_endpoint_recording* recording,
+                                       size_t i, bool* is_read) {
+  gpr_mu_lock(&recording->mu);
+  GPR_ASSERT(i < recording->count);
+  *is_read = recording->chunks[i].is_read;
+  grpc_slice bytes = recording->chunks[i].bytes;
+  gpr_mu_unlock(&recording->mu);
+  return bytes;
+}
+
+static void re_on_read(void* arg, grpc_error* error) {
+  recording_endpoint* re = static_cast<recording_endpoint*>(arg);
+  if (error == GRPC_ERROR_NONE && re->read_slices->length > 0) {
+    append_chunk(re->recording, true, flatten(re->read_slices));
+  }
+  grpc_closure* cb = re->read_cb;
+  re->read_cb = nullptr;
+  GRPC_CLOSURE_SCHED(cb, GRPC_ERROR_REF(error));
+}
+
+static void re_read(grpc_endpoint* ep, grpc_slice_buffer* slices,
+                    grpc_closure* cb) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  GPR_ASSERT(re->read_cb == nullptr);
+  re->read_cb = cb;
+  re->read_slices = slices;
+  grpc_endpoint_read(re->wrapped, slices, &re->on_read);
+}
+
+static void re_write(grpc_endpoint* ep, grpc_slice_buffer* slices,
+                     grpc_closure* cb) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  if (slices->length > 0) {
+    append_chunk(re->recording, false, flatten(slices));
+  }
+  grpc_endpoint_write(re->wrapped, slices, cb);
+}
+
+static void re_add_to_pollset(grpc_endpoint* ep, grpc_pollset* pollset) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  grpc_endpoint_add_to_pollset(re->wrapped, pollset);
+}
+
+static void re_add_to_pollset_set(grpc_endpoint* ep,
+                                  grpc_pollset_set* pollset_set) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  grpc_endpoint_add_to_pollset_set(re->wrapped, pollset_set);
+}
+
+static void re_delete_from_pollset_set(grpc_endpoint* ep,
+                                       grpc_pollset_set* pollset_set) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  grpc_endpoint_delete_from_pollset_set(re->wrapped, pollset_set);
+}
+
+static void re_shutdown(grpc_endpoint* ep, grpc_error* why) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  grpc_endpoint_shutdown(re->wrapped, why);
+}
+
+static void re_destroy(grpc_endpoint* ep) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  grpc_endpoint_destroy(re->wrapped);
+  gpr_free(re);
+}
+
+static grpc_resource_user* re_get_resource_user(grpc_endpoint* ep) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  return grpc_endpoint_get_resource_user(re->wrapped);
+}
+
+static char* re_get_peer(grpc_endpoint* ep) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  return grpc_endpoint_get_peer(re->wrapped);
+}
+
+static int re_get_fd(grpc_endpoint* ep) {
+  recording_endpoint* re = reinterpret_cast<recording_endpoint*>(ep);
+  return grpc_endpoint_get_fd(re->wrapped);
+}
+
+static const grpc_endpoint_vtable vtable = {re_read,
+                                            re_write,
+                                            re_add_to_pollset,
+                                            re_add_to_pollset_set,
+                                            re_delete_from_pollset_set,
+                                            re_shutdown,
+                                            re_destroy,
+                                            re_get_resource_user,
+                                            re_get_peer,
+                                            re_get_fd};
+
+grpc_endpoint* grpc_recording_endpoint_create(
+    grpc_endpoint* wrap, grpc_endpoint_recording* recording) {
+  recording_endpoint* re =
+      static_cast<recording_endpoint*>(gpr_zalloc(sizeof(*re)));
+  re->base.vtable = &vtable;
+  re->wrapped = wrap;
+  re->recording = recording;
+  GRPC_CLOSURE_INIT(&re->on_read, re_on_read, re, grpc_schedule_on_exec_ctx);
+  return &re->base;
+}
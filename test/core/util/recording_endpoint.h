@@ -0,0 +1,58 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef RECORDING_ENDPOINT_H
+#define RECORDING_ENDPOINT_H
+
+#include <stddef.h>
+
+#include <grpc/slice.h>
+
+#include "src/core/lib/iomgr/endpoint.h"
+
+/* An in order log of the chunks of bytes an endpoint read and was asked to
+   write: one chunk per completed read, and one per write call. */
+typedef struct grpc_endpoint_recording grpc_endpoint_recording;
+
+grpc_endpoint_recording* grpc_endpoint_recording_create();
+
+void grpc_endpoint_recording_destroy(grpc_endpoint_recording* recording);
+
+/* Load a recording saved by grpc_endpoint_recording_save. Returns NULL (and
+   logs why) if the file can't be read or is malformed. */
+grpc_endpoint_recording* grpc_endpoint_recording_load(const char* path);
+
+/* Save \a recording to \a path. The format is a sequence of records, each a
+   direction byte ('R' for a read, 'W' for a write), a 4 byte big endian length
+   and that many bytes. Returns false (and logs why) on failure. */
+bool grpc_endpoint_recording_save(grpc_endpoint_recording* recording,
+                                  const char* path);
+
+size_t grpc_endpoint_recording_count(grpc_endpoint_recording* recording);
+
+/* Returns chunk \a i of \a recording (owned by the recording), and sets
+   \a is_read to whether it was read or written */
+grpc_slice grpc_endpoint_recording_get(grpc_endpoint_recording* recording,
+                                       size_t i, bool* is_read);
+
+/* Wrap \a wrap so that everything read from and written to it is appended to
+   \a recording, which must outlive the returned endpoint. */
+grpc_endpoint* grpc_recording_endpoint_create(
+    grpc_endpoint* wrap, grpc_endpoint_recording* recording);
+
+#endif
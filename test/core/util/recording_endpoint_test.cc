@@ -0,0 +1,211 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "test/core/util/recording_endpoint.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/tmpfile.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/resource_quota.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "test/core/util/passthru_endpoint.h"
+#include "test/core/util/slice_splitter.h"
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST(x) gpr_log(GPR_INFO, "%s", x)
+
+static void done(void* arg, grpc_error* error) {
+  GPR_ASSERT(error == GRPC_ERROR_NONE);
+  *static_cast<bool*>(arg) = true;
+}
+
+static void write_string(grpc_endpoint* ep, const char* s) {
+  grpc_slice_buffer buf;
+  grpc_slice_buffer_init(&buf);
+  grpc_slice_buffer_add(&buf, grpc_slice_from_copied_string(s));
+  bool written = false;
+  grpc_closure on_write;
+  grpc_endpoint_write(
+      ep, &buf,
+      GRPC_CLOSURE_INIT(&on_write, done, &written, grpc_schedule_on_exec_ctx));
+  grpc_core::ExecCtx::Get()->Flush();
+  GPR_ASSERT(written);
+  grpc_slice_buffer_destroy_internal(&buf);
+}
+
+static void read_string(grpc_endpoint* ep, const char* expect) {
+  grpc_slice_buffer buf;
+  grpc_slice_buffer_init(&buf);
+  bool read = false;
+  grpc_closure on_read;
+  grpc_endpoint_read(
+      ep, &buf,
+      GRPC_CLOSURE_INIT(&on_read, done, &read, grpc_schedule_on_exec_ctx));
+  grpc_core::ExecCtx::Get()->Flush();
+  GPR_ASSERT(read);
+  grpc_slice got = grpc_slice_merge(buf.slices, buf.count);
+  GPR_ASSERT(0 == grpc_slice_str_cmp(got, expect));
+  grpc_slice_unref_internal(got);
+  grpc_slice_buffer_destroy_internal(&buf);
+}
+
+static void expect_chunk(grpc_endpoint_recording* recording, size_t i,
+                         bool is_read, const char* bytes) {
+  bool got_is_read;
+  grpc_slice got = grpc_endpoint_recording_get(recording, i, &got_is_read);
+  GPR_ASSERT(got_is_read == is_read);
+  GPR_ASSERT(0 == grpc_slice_str_cmp(got, bytes));
+}
+
+/* Record a conversation of the client half of a passthru endpoint pair: a
+   write, a read, a write of nothing (which is not recorded) and a read */
+static grpc_endpoint_recording* exchange_through_recording_endpoint(void) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_endpoint_recording* recording = grpc_endpoint_recording_create();
+  grpc_resource_quota* quota = grpc_resource_quota_create("recording_test");
+  grpc_passthru_endpoint_stats* stats = grpc_passthru_endpoint_stats_create();
+  grpc_endpoint* client;
+  grpc_endpoint* server;
+  grpc_passthru_endpoint_create(&client, &server, quota, stats);
+  client = grpc_recording_endpoint_create(client, recording);
+
+  write_string(client, "hello");
+  read_string(server, "hello");
+  write_string(server, "world");
+  read_string(client, "world");
+  GPR_ASSERT(grpc_endpoint_recording_count(recording) == 2);
+  write_string(client, "");
+  GPR_ASSERT(grpc_endpoint_recording_count(recording) == 2);
+  write_string(server, "goodbye");
+  read_string(client, "goodbye");
+
+  grpc_endpoint_destroy(client);
+  grpc_endpoint_destroy(server);
+  grpc_passthru_endpoint_stats_destroy(stats);
+  grpc_resource_quota_unref_internal(quota);
+  return recording;
+}
+
+static char* write_tmpfile(const void* bytes, size_t len) {
+  char* name;
+  FILE* f = gpr_tmpfile("recording_endpoint_test", &name);
+  GPR_ASSERT(f != nullptr);
+  GPR_ASSERT(fwrite(bytes, 1, len, f) == len);
+  fclose(f);
+  return name;
+}
+
+static void test_save_load_round_trip(void) {
+  LOG_TEST("test_save_load_round_trip");
+  grpc_endpoint_recording* recording = exchange_through_recording_endpoint();
+  GPR_ASSERT(grpc_endpoint_recording_count(recording) == 3);
+  expect_chunk(recording, 0, false, "hello");
+  expect_chunk(recording, 1, true, "world");
+  expect_chunk(recording, 2, true, "goodbye");
+
+  char* name = write_tmpfile("", 0);
+  GPR_ASSERT(grpc_endpoint_recording_save(recording, name));
+  grpc_endpoint_recording_destroy(recording);
+
+  /* append an empty write by hand */
+  FILE* f = fopen(name, "ab");
+  GPR_ASSERT(f != nullptr);
+  GPR_ASSERT(fwrite("W\0\0\0\0", 1, 5, f) == 5);
+  fclose(f);
+
+  recording = grpc_endpoint_recording_load(name);
+  GPR_ASSERT(recording != nullptr);
+  GPR_ASSERT(grpc_endpoint_recording_count(recording) == 4);
+  expect_chunk(recording, 0, false, "hello");
+  expect_chunk(recording, 1, true, "world");
+  expect_chunk(recording, 2, true, "goodbye");
+  expect_chunk(recording, 3, false, "");
+
+  /* saving what was loaded reproduces the file */
+  char* resaved = write_tmpfile("", 0);
+  GPR_ASSERT(grpc_endpoint_recording_save(recording, resaved));
+  grpc_endpoint_recording_destroy(recording);
+  recording = grpc_endpoint_recording_load(resaved);
+  GPR_ASSERT(recording != nullptr);
+  GPR_ASSERT(grpc_endpoint_recording_count(recording) == 4);
+  expect_chunk(recording, 3, false, "");
+  grpc_endpoint_recording_destroy(recording);
+
+  remove(name);
+  remove(resaved);
+  gpr_free(name);
+  gpr_free(resaved);
+}
+
+static void test_load_empty(void) {
+  LOG_TEST("test_load_empty");
+  char* name = write_tmpfile("", 0);
+  grpc_endpoint_recording* recording = grpc_endpoint_recording_load(name);
+  GPR_ASSERT(recording != nullptr);
+  GPR_ASSERT(grpc_endpoint_recording_count(recording) == 0);
+  grpc_endpoint_recording_destroy(recording);
+  remove(name);
+  gpr_free(name);
+}
+
+static void test_load_malformed(void) {
+  LOG_TEST("test_load_malformed");
+  static const struct {
+    const char* bytes;
+    size_t len;
+  } cases[] = {
+      /* unknown direction */
+      {"X\0\0\0\1a", 6},
+      /* truncated header */
+      {"R\0\0\0\5hello" "W\0\0", 13},
+      /* truncated bytes */
+      {"R\0\0\0\5hell", 9},
+  };
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(cases); i++) {
+    char* name = write_tmpfile(cases[i].bytes, cases[i].len);
+    GPR_ASSERT(grpc_endpoint_recording_load(name) == nullptr);
+    remove(name);
+    gpr_free(name);
+  }
+}
+
+static void test_load_missing_file(void) {
+  LOG_TEST("test_load_missing_file");
+  char* name = write_tmpfile("", 0);
+  remove(name);
+  GPR_ASSERT(grpc_endpoint_recording_load(name) == nullptr);
+  gpr_free(name);
+}
+
+int main(int argc, char** argv) {
+  grpc_test_init(argc, argv);
+  grpc_init();
+  test_save_load_round_trip();
+  test_load_empty();
+  test_load_malformed();
+  test_load_missing_file();
+  grpc_shutdown();
+  return 0;
+}
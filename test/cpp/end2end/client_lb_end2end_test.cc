@@ -17,6 +17,7 @@
  */
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <random>
@@ -38,8 +39,13 @@
 #include "src/core/ext/filters/client_channel/subchannel_index.h"
 #include "src/core/lib/backoff/backoff.h"
 #include "src/core/lib/gpr/env.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/debug_location.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/iomgr/port.h"
+#include "src/core/lib/iomgr/sockaddr.h"
+#include "src/core/lib/iomgr/sockaddr_utils.h"
+#include "src/core/lib/iomgr/socket_mutator.h"
 #include "src/core/lib/iomgr/tcp_client.h"
 
 #include "src/proto/grpc/testing/echo.grpc.pb.h"
@@ -79,6 +85,57 @@ void tcp_client_connect_with_delay(grpc_closure* closure, grpc_endpoint** ep,
 
 grpc_tcp_client_vtable delayed_connect = {tcp_client_connect_with_delay};
 
+#ifdef GRPC_POSIX_SOCKET_TCP
+// Socket mutator that remembers the fds of the client's connections, so that
+// a test can break one of them.
+class FdRecordingSocketMutator : public grpc_socket_mutator {
+ public:
+  FdRecordingSocketMutator() { grpc_socket_mutator_init(this, &kVtable); }
+
+  std::vector<int> fds() {
+    std::unique_lock<std::mutex> lock(mu_);
+    return fds_;
+  }
+
+ private:
+  static bool MutateFd(int fd, grpc_socket_mutator* mutator) {
+    auto* self = static_cast<FdRecordingSocketMutator*>(mutator);
+    std::unique_lock<std::mutex> lock(self->mu_);
+    self->fds_.push_back(fd);
+    return true;
+  }
+
+  static int Compare(grpc_socket_mutator* a, grpc_socket_mutator* b) {
+    return GPR_ICMP(a, b);
+  }
+
+  static void Destroy(grpc_socket_mutator* mutator) {
+    delete static_cast<FdRecordingSocketMutator*>(mutator);
+  }
+
+  static const grpc_socket_mutator_vtable kVtable;
+
+  std::mutex mu_;
+  std::vector<int> fds_;
+};
+
+const grpc_socket_mutator_vtable FdRecordingSocketMutator::kVtable = {
+    FdRecordingSocketMutator::MutateFd, FdRecordingSocketMutator::Compare,
+    FdRecordingSocketMutator::Destroy};
+
+// The peer the server sees for the connection of \a fd.
+grpc::string ServerSidePeer(int fd) {
+  grpc_resolved_address addr;
+  addr.len = sizeof(addr.addr);
+  GPR_ASSERT(getsockname(fd, reinterpret_cast<grpc_sockaddr*>(addr.addr),
+                         reinterpret_cast<socklen_t*>(&addr.len)) == 0);
+  char* uri = grpc_sockaddr_to_uri(&addr);
+  grpc::string peer(uri);
+  gpr_free(uri);
+  return peer;
+}
+#endif  // GRPC_POSIX_SOCKET_TCP
+
 // Subclass of TestServiceImpl that increments a request counter for
 // every call to the Echo RPC.
 class MyTestServiceImpl : public TestServiceImpl {
@@ -291,6 +348,50 @@ class ClientLbEnd2endTest : public ::testing::Test {
     ResetCounters();
   }
 
+  // Sends \a num_calls concurrent RPCs, each held by the server for \a
+  // server_sleep_ms, and returns how many of them arrived on each connection,
+  // by peer as seen by the server. All of them must succeed.
+  std::map<grpc::string, int> SendConcurrentRpcsAndCountPeers(
+      const std::unique_ptr<grpc::testing::EchoTestService::Stub>& stub,
+      int num_calls, int server_sleep_ms) {
+    struct Call {
+      ClientContext context;
+      EchoResponse response;
+      Status status;
+      std::unique_ptr<ClientAsyncResponseReader<EchoResponse>> reader;
+    };
+    CompletionQueue cq;
+    std::vector<std::unique_ptr<Call>> calls;
+    EchoRequest request;
+    request.set_message(kRequestMessage_);
+    request.mutable_param()->set_echo_peer(true);
+    request.mutable_param()->set_server_sleep_us(server_sleep_ms * 1000);
+    for (int i = 0; i < num_calls; ++i) {
+      calls.emplace_back(new Call);
+      Call* call = calls.back().get();
+      call->context.set_deadline(grpc_timeout_milliseconds_to_deadline(
+          server_sleep_ms + 5000));
+      call->reader = stub->AsyncEcho(&call->context, request, &cq);
+      call->reader->Finish(&call->response, &call->status, call);
+    }
+    std::map<grpc::string, int> peers;
+    for (int i = 0; i < num_calls; ++i) {
+      void* tag;
+      bool ok;
+      EXPECT_TRUE(cq.Next(&tag, &ok));
+      EXPECT_TRUE(ok);
+      Call* call = static_cast<Call*>(tag);
+      EXPECT_TRUE(call->status.ok()) << call->status.error_message();
+      if (call->status.ok()) ++peers[call->response.param().peer()];
+    }
+    cq.Shutdown();
+    void* tag;
+    bool ok;
+    while (cq.Next(&tag, &ok)) {
+    }
+    return peers;
+  }
+
   bool SeenAllServers() {
     for (const auto& server : servers_) {
       if (server->service_.request_count() == 0) return false;
@@ -827,6 +928,73 @@ TEST_F(ClientLbEnd2endTest, RoundRobinSingleReconnect) {
   WaitForServer(stub, 0, DEBUG_LOCATION);
 }
 
+#ifdef GRPC_POSIX_SOCKET_TCP
+TEST_F(ClientLbEnd2endTest, SubchannelMaxConnections) {
+  const size_t kMaxConnections = 3;
+  const int kCallsPerConnection = 4;
+  const int kCalls = static_cast<int>(kMaxConnections) * kCallsPerConnection;
+  const int kServerSleepMs = 200;
+  StartServers(1);
+  ChannelArguments args;
+  args.SetInt(GRPC_ARG_SUBCHANNEL_MAX_CONNECTIONS, kMaxConnections);
+  FdRecordingSocketMutator* mutator = new FdRecordingSocketMutator();
+  // Not SetSocketMutator(): BuildChannel copies the arguments, which can't
+  // copy a socket mutator set that way.
+  grpc_arg mutator_arg = grpc_socket_mutator_to_arg(mutator);
+  args.SetPointerWithVtable(mutator_arg.key, mutator_arg.value.pointer.p,
+                            mutator_arg.value.pointer.vtable);
+  auto channel = BuildChannel("pick_first", args);
+  auto stub = BuildStub(channel);
+  SetNextResolution(GetServersPorts());
+  ASSERT_TRUE(
+      channel->WaitForConnected(grpc_timeout_milliseconds_to_deadline(5000)));
+  // The subchannel goes on to open the rest of its connections once READY.
+  gpr_timespec deadline = grpc_timeout_milliseconds_to_deadline(5000);
+  while (mutator->fds().size() < kMaxConnections) {
+    ASSERT_LT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline), 0);
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(10));
+  }
+  // The connection attempts complete before the pool is full: send rounds of
+  // calls until all of the connections carry some.
+  std::map<grpc::string, int> peers;
+  do {
+    ASSERT_LT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline), 0);
+    peers = SendConcurrentRpcsAndCountPeers(
+        stub, kCalls, kServerSleepMs);
+  } while (peers.size() < kMaxConnections);
+  // No more connections than asked for, and calls spread evenly across them.
+  EXPECT_EQ(kMaxConnections, mutator->fds().size());
+  EXPECT_EQ(kMaxConnections, peers.size());
+  for (const auto& peer : peers) {
+    EXPECT_EQ(kCallsPerConnection, peer.second) << peer.first;
+  }
+
+  // Break one of the connections. The subchannel stays READY on the others,
+  // and reconnects to refill its pool.
+  const int broken_fd = mutator->fds()[0];
+  const grpc::string broken_peer = ServerSidePeer(broken_fd);
+  ASSERT_EQ(1u, peers.count(broken_peer));
+  ASSERT_EQ(0, shutdown(broken_fd, SHUT_RDWR));
+  deadline = grpc_timeout_milliseconds_to_deadline(5000);
+  while (mutator->fds().size() < kMaxConnections + 1) {
+    ASSERT_LT(gpr_time_cmp(gpr_now(GPR_CLOCK_MONOTONIC), deadline), 0);
+    EXPECT_EQ(GRPC_CHANNEL_READY, channel->GetState(false));
+    gpr_sleep_until(grpc_timeout_milliseconds_to_deadline(10));
+  }
+  EXPECT_EQ(GRPC_CHANNEL_READY, channel->GetState(false));
+  // Calls go to the remaining connections (and the replacement, once it is
+  // up), never to the broken one.
+  peers = SendConcurrentRpcsAndCountPeers(
+      stub, kCalls, kServerSleepMs);
+  EXPECT_EQ(0u, peers.count(broken_peer));
+  int calls = 0;
+  for (const auto& peer : peers) calls += peer.second;
+  EXPECT_EQ(kCalls, calls);
+  EXPECT_EQ(kMaxConnections + 1, mutator->fds().size());
+  grpc_socket_mutator_unref(mutator);
+}
+#endif  // GRPC_POSIX_SOCKET_TCP
+
 }  // namespace
 }  // namespace testing
 }  // namespace grpc
@@ -0,0 +1,302 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <grpc/byte_buffer.h>
+#include <grpc/byte_buffer_reader.h>
+#include <grpc/grpc.h>
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/channel_arguments.h>
+
+#include "src/proto/grpc/testing/echo.grpc.pb.h"
+#include "test/core/util/test_config.h"
+#include "test/cpp/util/byte_buffer_proto_helper.h"
+
+#include <gtest/gtest.h>
+
+using grpc::testing::EchoRequest;
+using grpc::testing::EchoResponse;
+
+namespace grpc {
+namespace internal {
+
+class GrpcByteBufferPeer {
+ public:
+  explicit GrpcByteBufferPeer(ByteBuffer* bb) : bb_(bb) {}
+  grpc_byte_buffer* c_buffer() { return bb_->c_buffer(); }
+
+ private:
+  ByteBuffer* bb_;
+};
+
+}  // namespace internal
+
+namespace testing {
+namespace {
+
+// Long enough for the string to live on the heap, and varied enough that a
+// byte lost or added on either side shows.
+grpc::string TestPayload() {
+  grpc::string payload;
+  for (int i = 0; i < 1024; i++) {
+    payload.push_back(static_cast<char>('!' + i % 94));
+  }
+  return payload;
+}
+
+// The message object the buffer carries, if any; the buffer keeps it.
+const EchoRequest* RequestObject(ByteBuffer* buffer, bool* exclusive) {
+  internal::GrpcByteBufferPeer peer(buffer);
+  int c_exclusive = 0;
+  void* object = grpc_byte_buffer_get_message_object(
+      peer.c_buffer(), &ProtoMessageObjectType<EchoRequest>::tag,
+      &c_exclusive);
+  *exclusive = c_exclusive != 0;
+  return static_cast<const EchoRequest*>(object);
+}
+
+TEST(MessageObjectTraitsTest, CreateCarriesACopy) {
+  EchoRequest request;
+  request.set_message(TestPayload());
+  ByteBuffer buffer;
+  ASSERT_TRUE(MessageObjectTraits<EchoRequest>::Create(request, &buffer).ok());
+  bool exclusive;
+  const EchoRequest* object = RequestObject(&buffer, &exclusive);
+  ASSERT_NE(nullptr, object);
+  EXPECT_TRUE(exclusive);
+  EXPECT_NE(&request, object);
+  EXPECT_EQ(request.message(), object->message());
+  // The sender's message is left alone.
+  EXPECT_EQ(TestPayload(), request.message());
+}
+
+TEST(MessageObjectTraitsTest, DeserializeSwapsInExclusiveObject) {
+  EchoRequest request;
+  request.set_message(TestPayload());
+  ByteBuffer buffer;
+  ASSERT_TRUE(MessageObjectTraits<EchoRequest>::Create(request, &buffer).ok());
+  bool exclusive;
+  const EchoRequest* object = RequestObject(&buffer, &exclusive);
+  ASSERT_NE(nullptr, object);
+  ASSERT_TRUE(exclusive);
+  const char* object_bytes = object->message().data();
+
+  EchoRequest received;
+  ASSERT_TRUE(
+      SerializationTraits<EchoRequest>::Deserialize(&buffer, &received).ok());
+  EXPECT_EQ(TestPayload(), received.message());
+  // Swapped in: the receiver took over the object's string rather than
+  // copying it.
+  EXPECT_EQ(object_bytes, received.message().data());
+  EXPECT_FALSE(buffer.Valid());
+}
+
+TEST(MessageObjectTraitsTest, DeserializeCopiesSharedObject) {
+  EchoRequest request;
+  request.set_message(TestPayload());
+  ByteBuffer buffer;
+  ASSERT_TRUE(MessageObjectTraits<EchoRequest>::Create(request, &buffer).ok());
+  ByteBuffer other(buffer);
+  bool exclusive;
+  const EchoRequest* object = RequestObject(&buffer, &exclusive);
+  ASSERT_NE(nullptr, object);
+  ASSERT_FALSE(exclusive);
+
+  EchoRequest received;
+  ASSERT_TRUE(
+      SerializationTraits<EchoRequest>::Deserialize(&buffer, &received).ok());
+  EXPECT_EQ(TestPayload(), received.message());
+  EXPECT_NE(object->message().data(), received.message().data());
+  // The other buffer still carries the object, intact.
+  EXPECT_EQ(object, RequestObject(&other, &exclusive));
+  EXPECT_TRUE(exclusive);
+  EXPECT_EQ(TestPayload(), object->message());
+}
+
+TEST(MessageObjectTraitsTest, ReaderSeesSerializedBytes) {
+  EchoRequest request;
+  request.set_message(TestPayload());
+  request.mutable_param()->set_response_message_length(42);
+  ByteBuffer buffer;
+  ASSERT_TRUE(MessageObjectTraits<EchoRequest>::Create(request, &buffer).ok());
+  internal::GrpcByteBufferPeer peer(&buffer);
+  grpc_byte_buffer_reader reader;
+  ASSERT_TRUE(grpc_byte_buffer_reader_init(&reader, peer.c_buffer()));
+  grpc_slice bytes = grpc_byte_buffer_reader_readall(&reader);
+  grpc_byte_buffer_reader_destroy(&reader);
+  EXPECT_EQ(request.SerializeAsString(),
+            grpc::string(reinterpret_cast<const char*>(
+                             GRPC_SLICE_START_PTR(bytes)),
+                         GRPC_SLICE_LENGTH(bytes)));
+  grpc_slice_unref(bytes);
+  // Reading serialized a copy; the buffer still carries the object.
+  bool exclusive;
+  EXPECT_NE(nullptr, RequestObject(&buffer, &exclusive));
+}
+
+// Echoes requests, remembering the last one it got.
+class RecordingEchoService : public EchoTestService::Service {
+ public:
+  Status Echo(ServerContext* context, const EchoRequest* request,
+              EchoResponse* response) override {
+    std::lock_guard<std::mutex> lock(mu_);
+    last_request_ = *request;
+    response->set_message(request->message());
+    response->mutable_param()->set_host("server");
+    return Status::OK;
+  }
+
+  EchoRequest last_request() {
+    std::lock_guard<std::mutex> lock(mu_);
+    return last_request_;
+  }
+
+ private:
+  std::mutex mu_;
+  EchoRequest last_request_;
+};
+
+// An in-process channel and server, both with GRPC_ARG_INPROC_MESSAGE_OBJECTS
+// set as the test parameter says.
+class MessageObjectEnd2endTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void TearDown() override {
+    if (server_ != nullptr) server_->Shutdown();
+    if (generic_cq_ != nullptr) {
+      void* tag;
+      bool ok;
+      generic_cq_->Shutdown();
+      while (generic_cq_->Next(&tag, &ok)) {
+      }
+    }
+  }
+
+  void StartServer(bool generic) {
+    ServerBuilder builder;
+    if (GetParam()) {
+      builder.AddChannelArgument(GRPC_ARG_INPROC_MESSAGE_OBJECTS, 1);
+    }
+    if (generic) {
+      builder.RegisterAsyncGenericService(&generic_service_);
+      generic_cq_ = builder.AddCompletionQueue();
+    } else {
+      builder.RegisterService(&service_);
+    }
+    server_ = builder.BuildAndStart();
+    ChannelArguments args;
+    if (GetParam()) args.SetInt(GRPC_ARG_INPROC_MESSAGE_OBJECTS, 1);
+    stub_ = EchoTestService::NewStub(server_->InProcessChannel(args));
+  }
+
+  RecordingEchoService service_;
+  AsyncGenericService generic_service_;
+  std::unique_ptr<ServerCompletionQueue> generic_cq_;
+  std::unique_ptr<Server> server_;
+  std::unique_ptr<EchoTestService::Stub> stub_;
+};
+
+TEST_P(MessageObjectEnd2endTest, EchoRoundTripsIntact) {
+  StartServer(false);
+  EchoRequest request;
+  request.set_message(TestPayload());
+  request.mutable_param()->set_response_message_length(42);
+  request.mutable_param()->set_echo_peer(true);
+  const grpc::string sent = request.SerializeAsString();
+  for (int i = 0; i < 3; i++) {
+    EchoResponse response;
+    ClientContext context;
+    Status status = stub_->Echo(&context, request, &response);
+    ASSERT_TRUE(status.ok()) << status.error_message();
+    EXPECT_EQ(sent, service_.last_request().SerializeAsString());
+    EXPECT_EQ(TestPayload(), response.message());
+    EXPECT_EQ("server", response.param().host());
+    // The client's request is only ever copied.
+    EXPECT_EQ(sent, request.SerializeAsString());
+  }
+}
+
+TEST_P(MessageObjectEnd2endTest, GenericServerGetsSerializedBytes) {
+  StartServer(true);
+  EchoRequest request;
+  request.set_message(TestPayload());
+  EchoResponse response;
+  Status status;
+  std::thread client([&]() {
+    ClientContext context;
+    status = stub_->Echo(&context, request, &response);
+  });
+
+  GenericServerContext server_context;
+  GenericServerAsyncReaderWriter stream(&server_context);
+  void* tag;
+  bool ok;
+  generic_service_.RequestCall(&server_context, &stream, generic_cq_.get(),
+                               generic_cq_.get(), reinterpret_cast<void*>(1));
+  ASSERT_TRUE(generic_cq_->Next(&tag, &ok));
+  ASSERT_TRUE(ok);
+  ByteBuffer received;
+  stream.Read(&received, reinterpret_cast<void*>(2));
+  ASSERT_TRUE(generic_cq_->Next(&tag, &ok));
+  ASSERT_TRUE(ok);
+
+  // The buffer carries the message object only when both sides opted in, and
+  // reads as the serialized request either way.
+  bool exclusive;
+  EXPECT_EQ(GetParam(), RequestObject(&received, &exclusive) != nullptr);
+  std::vector<Slice> slices;
+  ASSERT_TRUE(received.Dump(&slices).ok());
+  grpc::string bytes;
+  for (const Slice& slice : slices) {
+    bytes.append(reinterpret_cast<const char*>(slice.begin()), slice.size());
+  }
+  EXPECT_EQ(request.SerializeAsString(), bytes);
+
+  EchoResponse reply;
+  reply.set_message(TestPayload());
+  std::unique_ptr<ByteBuffer> reply_buffer = SerializeToByteBuffer(&reply);
+  stream.WriteAndFinish(*reply_buffer, WriteOptions(), Status::OK,
+                        reinterpret_cast<void*>(3));
+  ASSERT_TRUE(generic_cq_->Next(&tag, &ok));
+  EXPECT_TRUE(ok);
+  client.join();
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  EXPECT_EQ(TestPayload(), response.message());
+}
+
+INSTANTIATE_TEST_CASE_P(MessageObjectEnd2end, MessageObjectEnd2endTest,
+                        ::testing::Bool());
+
+}  // namespace
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  grpc_test_init(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -30,6 +30,14 @@ static void BM_Arena_NoOp(benchmark::State& state) {
 }
 BENCHMARK(BM_Arena_NoOp)->Range(1, 1024 * 1024);
 
+static void BM_Arena_PooledNoOp(benchmark::State& state) {
+  bool pool_hit;
+  while (state.KeepRunning()) {
+    gpr_arena_destroy(gpr_arena_create_pooled(state.range(0), &pool_hit));
+  }
+}
+BENCHMARK(BM_Arena_PooledNoOp)->Range(1, 1024 * 1024);
+
 static void BM_Arena_ManyAlloc(benchmark::State& state) {
   gpr_arena* a = gpr_arena_create(state.range(0));
   const size_t realloc_after =
@@ -57,6 +65,19 @@ static void BM_Arena_Batch(benchmark::State& state) {
 }
 BENCHMARK(BM_Arena_Batch)->Ranges({{1, 64 * 1024}, {1, 64}, {1, 1024}});
 
+static void BM_Arena_PooledBatch(benchmark::State& state) {
+  bool pool_hit;
+  while (state.KeepRunning()) {
+    gpr_arena* a = gpr_arena_create_pooled(state.range(0), &pool_hit);
+    for (int i = 0; i < state.range(1); i++) {
+      gpr_arena_alloc(a, state.range(2));
+    }
+    gpr_arena_destroy(a);
+  }
+}
+BENCHMARK(BM_Arena_PooledBatch)
+    ->Ranges({{1, 64 * 1024}, {1, 64}, {1, 1024}});
+
 // Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
 // and others do not. This allows us to support both modes.
 namespace benchmark {
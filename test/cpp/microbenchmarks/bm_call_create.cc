@@ -38,8 +38,10 @@
 #include "src/core/ext/filters/message_size/message_size_filter.h"
 #include "src/core/lib/channel/channel_stack.h"
 #include "src/core/lib/channel/connected_channel.h"
+#include "src/core/lib/gpr/arena.h"
 #include "src/core/lib/iomgr/call_combiner.h"
 #include "src/core/lib/profiling/timers.h"
+#include "src/core/lib/surface/call.h"
 #include "src/core/lib/surface/channel.h"
 #include "src/core/lib/transport/transport_impl.h"
 
@@ -122,6 +124,34 @@ static void BM_CallCreateDestroy(benchmark::State& state) {
 BENCHMARK_TEMPLATE(BM_CallCreateDestroy, InsecureChannel);
 BENCHMARK_TEMPLATE(BM_CallCreateDestroy, LameChannel);
 
+struct UnpooledArena {
+  static gpr_arena* Create(size_t size) { return gpr_arena_create(size); }
+};
+
+struct PooledArena {
+  static gpr_arena* Create(size_t size) {
+    bool pool_hit;
+    return gpr_arena_create_pooled(size, &pool_hit);
+  }
+};
+
+// Isolates the arena part of call creation: create an arena of the size a
+// fresh channel estimates for its calls, allocate from it and destroy it again
+template <class Arena>
+static void BM_CallArenaCreateDestroy(benchmark::State& state) {
+  TrackCounters track_counters;
+  const size_t initial_size = grpc_call_get_initial_size_estimate();
+  while (state.KeepRunning()) {
+    gpr_arena* arena = Arena::Create(initial_size);
+    benchmark::DoNotOptimize(gpr_arena_alloc(arena, initial_size / 2));
+    gpr_arena_destroy(arena);
+  }
+  track_counters.Finish(state);
+}
+
+BENCHMARK_TEMPLATE(BM_CallArenaCreateDestroy, UnpooledArena);
+BENCHMARK_TEMPLATE(BM_CallArenaCreateDestroy, PooledArena);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Benchmarks isolating individual filters
 
@@ -22,11 +22,19 @@
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <string.h>
+#include <algorithm>
 #include <memory>
 #include <sstream>
+#include <utility>
+#include <vector>
 
+#include "src/core/ext/transport/chttp2/transport/base64_simd.h"
+#include "src/core/ext/transport/chttp2/transport/bin_decoder.h"
+#include "src/core/ext/transport/chttp2/transport/bin_encoder.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_parser.h"
+#include "src/core/ext/transport/chttp2/transport/huffman_decoder.h"
+#include "src/core/ext/transport/chttp2/transport/huffsyms.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/slice/slice_string_helpers.h"
 #include "src/core/lib/transport/static_metadata.h"
@@ -278,6 +286,28 @@ class RepresentativeClientInitialMetadata {
   }
 };
 
+// Initial metadata of a client that adds the same application headers to every
+// call
+class CustomHeadersClientInitialMetadata {
+ public:
+  static constexpr bool kEnableTrueBinary = true;
+  static std::vector<grpc_mdelem> GetElems() {
+    std::vector<grpc_mdelem> elems =
+        RepresentativeClientInitialMetadata::GetElems();
+    static const std::pair<const char*, const char*> kHeaders[] = {
+        {"x-client-route", "us-central1-b/frontend"},
+        {"x-api-version", "2018-07-01"},
+        {"x-tenant", "example-tenant-0042"},
+        {"x-feature-flags", "canary,fast-path"}};
+    for (const auto& header : kHeaders) {
+      elems.push_back(grpc_mdelem_from_slices(
+          grpc_slice_intern(grpc_slice_from_static_string(header.first)),
+          grpc_slice_intern(grpc_slice_from_static_string(header.second))));
+    }
+    return elems;
+  }
+};
+
 // This fixture reflects how initial metadata are sent by a production client,
 // with non-indexed :path and binary headers. The metadata here are the same as
 // the corresponding parser benchmark below.
@@ -392,6 +422,15 @@ BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
                    SingleNonInternedBinaryElem<100, false>)
     ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   SingleNonInternedBinaryElem<64, false>)
+    ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   SingleNonInternedBinaryElem<1024, false>)
+    ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   SingleNonInternedBinaryElem<16384, false>)
+    ->Args({0, 16384});
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
                    SingleNonInternedBinaryElem<1, true>)
     ->Args({0, 16384});
@@ -414,6 +453,9 @@ BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader, SingleNonInternedElem)
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
                    RepresentativeClientInitialMetadata)
     ->Args({0, 16384});
+BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
+                   CustomHeadersClientInitialMetadata)
+    ->Args({0, 16384});
 BENCHMARK_TEMPLATE(BM_HpackEncoderEncodeHeader,
                    MoreRepresentativeClientInitialMetadata)
     ->Args({0, 16384});
@@ -474,6 +516,209 @@ static void BM_HpackParserParseHeader(benchmark::State& state) {
   track_counters.Finish(state);
 }
 
+// Huffman encode \a s and append it to \a out as an HPACK string literal
+static void AppendHuffmanString(const char* s, std::vector<uint8_t>* out) {
+  std::vector<uint8_t> encoded;
+  uint64_t bits = 0;
+  int nbits = 0;
+  for (const char* c = s; *c != '\0'; c++) {
+    const grpc_chttp2_huffsym* sym =
+        &grpc_chttp2_huffsyms[static_cast<uint8_t>(*c)];
+    bits = (bits << sym->length) | sym->bits;
+    nbits += static_cast<int>(sym->length);
+    while (nbits >= 8) {
+      nbits -= 8;
+      encoded.push_back(static_cast<uint8_t>(bits >> nbits));
+    }
+  }
+  if (nbits > 0) {
+    encoded.push_back(
+        static_cast<uint8_t>((bits << (8 - nbits)) | (0xff >> nbits)));
+  }
+  GPR_ASSERT(encoded.size() < 0x7f);
+  out->push_back(static_cast<uint8_t>(0x80 | encoded.size()));
+  out->insert(out->end(), encoded.begin(), encoded.end());
+}
+
+typedef std::vector<std::pair<const char*, const char*>> HeaderList;
+
+// Encode \a headers as literals with literal names, without indexing and with
+// huffman encoded strings, so that parsing them decodes every string anew
+static std::vector<uint8_t> HuffmanLiteralHeaders(const HeaderList& headers) {
+  std::vector<uint8_t> out;
+  for (const auto& header : headers) {
+    out.push_back(0x00);
+    AppendHuffmanString(header.first, &out);
+    AppendHuffmanString(header.second, &out);
+  }
+  return out;
+}
+
+// Client initial metadata with a long :path, a realistic user-agent and
+// application headers
+static const HeaderList& HuffmanClientInitialMetadataHeaders() {
+  static const HeaderList* headers = new HeaderList{
+      {":path", "/grpc.testing.EchoTestService/ResponseStreamingEcho"},
+      {":scheme", "http"},
+      {":method", "POST"},
+      {":authority", "echo-service.prod.example.com:443"},
+      {"content-type", "application/grpc"},
+      {"grpc-accept-encoding", "identity,deflate,gzip"},
+      {"te", "trailers"},
+      {"user-agent", "grpc-c++/1.15.0-dev grpc-c/6.0.0-dev (linux; chttp2)"},
+      {"x-request-id", "6f1d2c9a-4b3e-4d7f-8a61-0c5e9b2d7f43"},
+      {"x-client-route", "us-central1-b/frontend-canary/shard-0042"},
+  };
+  return *headers;
+}
+
+// Same headers as test/cpp/microbenchmarks/
+// representative_server_initial_metadata.headers
+static const HeaderList& HuffmanServerInitialMetadataHeaders() {
+  static const HeaderList* headers = new HeaderList{
+      {":status", "200"},
+      {"content-type", "application/grpc"},
+      {"grpc-accept-encoding", "identity,deflate,gzip"},
+  };
+  return *headers;
+}
+
+struct ByteHuffmanDecoder {
+  static size_t Decode(uint8_t* state, const uint8_t* cur, const uint8_t* end,
+                       uint8_t* out) {
+    return grpc_chttp2_huffman_decode(state, cur, end, out);
+  }
+};
+
+struct NibbleHuffmanDecoder {
+  static size_t Decode(uint8_t* state, const uint8_t* cur, const uint8_t* end,
+                       uint8_t* out) {
+    return grpc_chttp2_huffman_decode_by_nibble(state, cur, end, out);
+  }
+};
+
+// Decode the huffman encoded keys and values of
+// HuffmanClientInitialMetadataHeaders() directly with a decoder
+template <class Decoder>
+static void BM_HpackHuffmanDecode(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_chttp2_huffman_decoder_init();
+  std::vector<std::vector<uint8_t>> strings;
+  size_t max_length = 0;
+  for (const auto& header : HuffmanClientInitialMetadataHeaders()) {
+    for (const char* s : {header.first, header.second}) {
+      std::vector<uint8_t> literal;
+      AppendHuffmanString(s, &literal);
+      // drop the length prefix
+      strings.emplace_back(literal.begin() + 1, literal.end());
+      max_length = std::max(max_length, strings.back().size());
+    }
+  }
+  std::vector<uint8_t> out(GRPC_CHTTP2_HUFFMAN_MAX_DECODED_LENGTH(max_length));
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    for (const auto& s : strings) {
+      uint8_t huff_state = 0;
+      benchmark::DoNotOptimize(Decoder::Decode(
+          &huff_state, s.data(), s.data() + s.size(), out.data()));
+      bytes += s.size();
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  track_counters.Finish(state);
+}
+BENCHMARK_TEMPLATE(BM_HpackHuffmanDecode, NibbleHuffmanDecoder);
+BENCHMARK_TEMPLATE(BM_HpackHuffmanDecode, ByteHuffmanDecoder);
+
+static grpc_slice RandomBytes(size_t length) {
+  grpc_slice slice = GRPC_SLICE_MALLOC(length);
+  for (size_t i = 0; i < length; i++) {
+    GRPC_SLICE_START_PTR(slice)[i] = static_cast<uint8_t>(rand());
+  }
+  return slice;
+}
+
+// -bin metadata encoding and decoding with each base64 implementation, on
+// values of state.range(0) bytes
+template <grpc_chttp2_base64_impl kImpl>
+static void BM_Base64Encode(benchmark::State& state) {
+  TrackCounters track_counters;
+  if (!grpc_chttp2_base64_impl_supported(kImpl)) {
+    state.SkipWithError("base64 implementation not supported");
+    return;
+  }
+  grpc_chttp2_base64_set_impl(kImpl);
+  grpc_slice input = RandomBytes(static_cast<size_t>(state.range(0)));
+  while (state.KeepRunning()) {
+    grpc_slice_unref(grpc_chttp2_base64_encode(input));
+  }
+  grpc_slice_unref(input);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  track_counters.Finish(state);
+}
+
+template <grpc_chttp2_base64_impl kImpl>
+static void BM_Base64EncodeAndHuffmanCompress(benchmark::State& state) {
+  TrackCounters track_counters;
+  if (!grpc_chttp2_base64_impl_supported(kImpl)) {
+    state.SkipWithError("base64 implementation not supported");
+    return;
+  }
+  grpc_chttp2_base64_set_impl(kImpl);
+  grpc_slice input = RandomBytes(static_cast<size_t>(state.range(0)));
+  while (state.KeepRunning()) {
+    grpc_slice_unref(grpc_chttp2_base64_encode_and_huffman_compress(input));
+  }
+  grpc_slice_unref(input);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  track_counters.Finish(state);
+}
+
+template <grpc_chttp2_base64_impl kImpl>
+static void BM_Base64Decode(benchmark::State& state) {
+  TrackCounters track_counters;
+  if (!grpc_chttp2_base64_impl_supported(kImpl)) {
+    state.SkipWithError("base64 implementation not supported");
+    return;
+  }
+  grpc_chttp2_base64_set_impl(kImpl);
+  const size_t length = static_cast<size_t>(state.range(0));
+  grpc_slice input = RandomBytes(length);
+  grpc_slice encoded = grpc_chttp2_base64_encode(input);
+  while (state.KeepRunning()) {
+    grpc_slice_unref(grpc_chttp2_base64_decode_with_length(encoded, length));
+  }
+  grpc_slice_unref(input);
+  grpc_slice_unref(encoded);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  track_counters.Finish(state);
+}
+
+static void Base64Sizes(benchmark::internal::Benchmark* b) {
+  b->Arg(64)->Arg(1024)->Arg(16384);
+}
+BENCHMARK_TEMPLATE(BM_Base64Encode, GRPC_CHTTP2_BASE64_SCALAR)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64Encode, GRPC_CHTTP2_BASE64_SSE4)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64Encode, GRPC_CHTTP2_BASE64_AVX2)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64EncodeAndHuffmanCompress,
+                   GRPC_CHTTP2_BASE64_SCALAR)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64EncodeAndHuffmanCompress,
+                   GRPC_CHTTP2_BASE64_SSE4)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64EncodeAndHuffmanCompress,
+                   GRPC_CHTTP2_BASE64_AVX2)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64Decode, GRPC_CHTTP2_BASE64_SCALAR)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64Decode, GRPC_CHTTP2_BASE64_SSE4)
+    ->Apply(Base64Sizes);
+BENCHMARK_TEMPLATE(BM_Base64Decode, GRPC_CHTTP2_BASE64_AVX2)
+    ->Apply(Base64Sizes);
+
 namespace hpack_parser_fixtures {
 
 class EmptyBatch {
@@ -764,6 +1009,61 @@ class RepresentativeServerTrailingMetadata {
   }
 };
 
+// Append an HPACK integer with a \a prefix_bits bit prefix, whose other bits
+// are \a first_byte_flags
+static void AppendHpackInt(uint8_t first_byte_flags, int prefix_bits,
+                           size_t value, std::vector<uint8_t>* out) {
+  const size_t max_prefix = (1u << prefix_bits) - 1;
+  if (value < max_prefix) {
+    out->push_back(static_cast<uint8_t>(first_byte_flags | value));
+    return;
+  }
+  out->push_back(static_cast<uint8_t>(first_byte_flags | max_prefix));
+  value -= max_prefix;
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(0x80 | (value & 0x7f)));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+// A -bin value of kLength random bytes sent base64 and huffman encoded, as a
+// peer without true-binary support does
+template <int kLength>
+class NonIndexedBase64BinaryElem {
+ public:
+  static std::vector<grpc_slice> GetInitSlices() { return {}; }
+  static std::vector<grpc_slice> GetBenchmarkSlices() {
+    std::vector<uint8_t> v = {0x00, 0x07, 'a', 'b', 'c', '-', 'b', 'i', 'n'};
+    grpc_slice value = RandomBytes(kLength);
+    grpc_slice encoded = grpc_chttp2_base64_encode_and_huffman_compress(value);
+    AppendHpackInt(0x80, 7, GRPC_SLICE_LENGTH(encoded), &v);
+    v.insert(v.end(), GRPC_SLICE_START_PTR(encoded),
+             GRPC_SLICE_END_PTR(encoded));
+    grpc_slice_unref(value);
+    grpc_slice_unref(encoded);
+    return {MakeSlice(v)};
+  }
+};
+
+class HuffmanClientInitialMetadata {
+ public:
+  static std::vector<grpc_slice> GetInitSlices() { return {}; }
+  static std::vector<grpc_slice> GetBenchmarkSlices() {
+    return {MakeSlice(
+        HuffmanLiteralHeaders(HuffmanClientInitialMetadataHeaders()))};
+  }
+};
+
+class HuffmanServerInitialMetadata {
+ public:
+  static std::vector<grpc_slice> GetInitSlices() { return {}; }
+  static std::vector<grpc_slice> GetBenchmarkSlices() {
+    return {MakeSlice(
+        HuffmanLiteralHeaders(HuffmanServerInitialMetadataHeaders()))};
+  }
+};
+
 static void free_timeout(void* p) { gpr_free(p); }
 
 // New implementation.
@@ -845,6 +1145,12 @@ BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedBinaryElem<31, true>,
                    UnrefHeader);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedBinaryElem<100, true>,
                    UnrefHeader);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, NonIndexedBase64BinaryElem<64>,
+                   UnrefHeader);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   NonIndexedBase64BinaryElem<1024>, UnrefHeader);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
+                   NonIndexedBase64BinaryElem<16384>, UnrefHeader);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeClientInitialMetadata, UnrefHeader);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
@@ -853,6 +1159,10 @@ BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeServerInitialMetadata, UnrefHeader);
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader,
                    RepresentativeServerTrailingMetadata, UnrefHeader);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, HuffmanClientInitialMetadata,
+                   UnrefHeader);
+BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, HuffmanServerInitialMetadata,
+                   UnrefHeader);
 
 BENCHMARK_TEMPLATE(BM_HpackParserParseHeader, SameDeadline, OnHeaderNew);
 
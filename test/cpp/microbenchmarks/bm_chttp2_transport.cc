@@ -19,20 +19,26 @@
 /* Microbenchmarks around CHTTP2 transport operations */
 
 #include <benchmark/benchmark.h>
+#include <gflags/gflags.h>
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpcpp/support/channel_arguments.h>
 #include <string.h>
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <queue>
 #include <sstream>
+#include <vector>
 #include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
 #include "src/core/ext/transport/chttp2/transport/internal.h"
 #include "src/core/lib/iomgr/closure.h"
 #include "src/core/lib/iomgr/resource_quota.h"
 #include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/transport/static_metadata.h"
+#include "test/core/util/recording_endpoint.h"
+#include "test/core/util/slice_splitter.h"
 #include "test/cpp/microbenchmarks/helpers.h"
 #include "test/cpp/util/test_config.h"
 
@@ -57,16 +63,25 @@ class DummyEndpoint : public grpc_endpoint {
                                                    get_fd};
     grpc_endpoint::vtable = &my_vtable;
     ru_ = grpc_resource_user_create(Library::get().rq(), "dummy_endpoint");
+    grpc_slice_buffer_init(&buffered_slices_);
   }
 
   void PushInput(grpc_slice slice) {
+    grpc_slice_buffer slices;
+    grpc_slice_buffer_init(&slices);
+    grpc_slice_buffer_add(&slices, slice);
+    PushInput(&slices);
+    grpc_slice_buffer_destroy(&slices);
+  }
+
+  // Deliver all of slices in one read, as tcp does with its read slices
+  void PushInput(grpc_slice_buffer* slices) {
     if (read_cb_ == nullptr) {
-      GPR_ASSERT(!have_slice_);
-      buffered_slice_ = slice;
-      have_slice_ = true;
+      GPR_ASSERT(buffered_slices_.count == 0);
+      grpc_slice_buffer_move_into(slices, &buffered_slices_);
       return;
     }
-    grpc_slice_buffer_add(slices_, slice);
+    grpc_slice_buffer_move_into(slices, slices_);
     GRPC_CLOSURE_SCHED(read_cb_, GRPC_ERROR_NONE);
     read_cb_ = nullptr;
   }
@@ -75,14 +90,12 @@ class DummyEndpoint : public grpc_endpoint {
   grpc_resource_user* ru_;
   grpc_closure* read_cb_ = nullptr;
   grpc_slice_buffer* slices_ = nullptr;
-  bool have_slice_ = false;
-  grpc_slice buffered_slice_;
+  grpc_slice_buffer buffered_slices_;
 
   void QueueRead(grpc_slice_buffer* slices, grpc_closure* cb) {
     GPR_ASSERT(read_cb_ == nullptr);
-    if (have_slice_) {
-      have_slice_ = false;
-      grpc_slice_buffer_add(slices, buffered_slice_);
+    if (buffered_slices_.count > 0) {
+      grpc_slice_buffer_move_into(&buffered_slices_, slices);
       GRPC_CLOSURE_SCHED(cb, GRPC_ERROR_NONE);
       return;
     }
@@ -116,8 +129,10 @@ class DummyEndpoint : public grpc_endpoint {
   }
 
   static void destroy(grpc_endpoint* ep) {
-    grpc_resource_user_unref(static_cast<DummyEndpoint*>(ep)->ru_);
-    delete static_cast<DummyEndpoint*>(ep);
+    DummyEndpoint* self = static_cast<DummyEndpoint*>(ep);
+    grpc_slice_buffer_destroy(&self->buffered_slices_);
+    grpc_resource_user_unref(self->ru_);
+    delete self;
   }
 
   static grpc_resource_user* get_resource_user(grpc_endpoint* ep) {
@@ -129,10 +144,17 @@ class DummyEndpoint : public grpc_endpoint {
 
 class Fixture {
  public:
-  Fixture(const grpc::ChannelArguments& args, bool client) {
+  // If \a recording is given, everything the transport reads and writes is
+  // appended to it
+  Fixture(const grpc::ChannelArguments& args, bool client,
+          grpc_endpoint_recording* recording = nullptr) {
     grpc_channel_args c_args = args.c_channel_args();
     ep_ = new DummyEndpoint;
-    t_ = grpc_create_chttp2_transport(&c_args, ep_, client);
+    grpc_endpoint* ep = ep_;
+    if (recording != nullptr) {
+      ep = grpc_recording_endpoint_create(ep, recording);
+    }
+    t_ = grpc_create_chttp2_transport(&c_args, ep, client);
     grpc_chttp2_transport_start_reading(t_, nullptr, nullptr);
     FlushExecCtx();
   }
@@ -147,6 +169,7 @@ class Fixture {
   grpc_transport* transport() { return t_; }
 
   void PushInput(grpc_slice slice) { ep_->PushInput(slice); }
+  void PushInput(grpc_slice_buffer* slices) { ep_->PushInput(slices); }
 
  private:
   DummyEndpoint* ep_;
@@ -202,7 +225,7 @@ class Stream {
     gpr_arena_destroy(arena_);
   }
 
-  void Init(benchmark::State& state) {
+  void Init(benchmark::State& state, const void* server_data = nullptr) {
     GRPC_STREAM_REF_INIT(&refcount_, 1, &Stream::FinishDestroy, this,
                          "test_stream");
     gpr_event_init(&done_);
@@ -213,7 +236,7 @@ class Stream {
     }
     grpc_transport_init_stream(f_->transport(),
                                static_cast<grpc_stream*>(stream_), &refcount_,
-                               nullptr, arena_);
+                               server_data, arena_);
   }
 
   void DestroyThen(grpc_closure* closure) {
@@ -639,6 +662,515 @@ static void BM_TransportStreamRecv(benchmark::State& state) {
 }
 BENCHMARK(BM_TransportStreamRecv)->Range(0, 128 * 1024 * 1024);
 
+// Receive state.range(0) byte messages, each delivered in reads of
+// state.range(1) bytes, and label the run with the fraction of the message
+// bytes handed out by the transport that were copied instead of referenced
+// out of the read slices
+static void BM_TransportStreamRecvPump(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  Fixture f(grpc::ChannelArguments(), true);
+  Stream s(&f);
+  s.Init(state);
+  grpc_transport_stream_op_batch_payload op_payload;
+  memset(&op_payload, 0, sizeof(op_payload));
+  grpc_transport_stream_op_batch op;
+  grpc_core::OrphanablePtr<grpc_core::ByteStream> recv_stream;
+  grpc_slice incoming_data = CreateIncomingDataSlice(state.range(0), 16384);
+  const size_t read_size = static_cast<size_t>(state.range(1));
+  const uint8_t* incoming_begin = GRPC_SLICE_START_PTR(incoming_data);
+  const uint8_t* incoming_end = GRPC_SLICE_END_PTR(incoming_data);
+
+  auto reset_op = [&]() {
+    memset(&op, 0, sizeof(op));
+    op.payload = &op_payload;
+  };
+
+  grpc_metadata_batch b;
+  grpc_metadata_batch_init(&b);
+  grpc_metadata_batch b_recv;
+  grpc_metadata_batch_init(&b_recv);
+  b.deadline = GRPC_MILLIS_INF_FUTURE;
+  std::vector<grpc_mdelem> elems =
+      RepresentativeClientInitialMetadata::GetElems();
+  std::vector<grpc_linked_mdelem> storage(elems.size());
+  for (size_t i = 0; i < elems.size(); i++) {
+    GPR_ASSERT(GRPC_LOG_IF_ERROR(
+        "addmd", grpc_metadata_batch_add_tail(&b, &storage[i], elems[i])));
+  }
+
+  std::unique_ptr<Closure> do_nothing = MakeClosure([](grpc_error* error) {});
+
+  uint32_t received;
+  uint64_t total_received = 0;
+  uint64_t total_copied = 0;
+
+  std::unique_ptr<Closure> drain_start;
+  std::unique_ptr<Closure> drain;
+  std::unique_ptr<Closure> drain_continue;
+  grpc_slice recv_slice;
+
+  auto account = [&]() {
+    size_t length = GRPC_SLICE_LENGTH(recv_slice);
+    const uint8_t* start = GRPC_SLICE_START_PTR(recv_slice);
+    if (start < incoming_begin || start + length > incoming_end) {
+      total_copied += length;
+    }
+    received += length;
+    total_received += length;
+    grpc_slice_unref_internal(recv_slice);
+  };
+
+  std::unique_ptr<Closure> c = MakeClosure([&](grpc_error* error) {
+    if (!state.KeepRunning()) return;
+    // force outgoing window to be yuge
+    s.chttp2_stream()->flow_control->TestOnlyForceHugeWindow();
+    f.chttp2_transport()->flow_control->TestOnlyForceHugeWindow();
+    received = 0;
+    reset_op();
+    op.on_complete = do_nothing.get();
+    op.recv_message = true;
+    op.payload->recv_message.recv_message = &recv_stream;
+    op.payload->recv_message.recv_message_ready = drain_start.get();
+    s.Op(&op);
+    // refcounted sub-slices, as grpc_slice_sub() would inline a short tail
+    grpc_slice_buffer reads;
+    grpc_slice_buffer_init(&reads);
+    for (size_t i = 0; i < GRPC_SLICE_LENGTH(incoming_data); i += read_size) {
+      grpc_slice_buffer_add(
+          &reads, grpc_slice_ref_internal(grpc_slice_sub_no_ref(
+                      incoming_data, i,
+                      std::min(i + read_size,
+                               GRPC_SLICE_LENGTH(incoming_data)))));
+    }
+    f.PushInput(&reads);
+    grpc_slice_buffer_destroy_internal(&reads);
+  });
+
+  drain_start = MakeClosure([&](grpc_error* error) {
+    if (recv_stream == nullptr) {
+      GPR_ASSERT(!state.KeepRunning());
+      return;
+    }
+    GRPC_CLOSURE_RUN(drain.get(), GRPC_ERROR_NONE);
+  });
+
+  drain = MakeClosure([&](grpc_error* error) {
+    do {
+      if (received == recv_stream->length()) {
+        recv_stream.reset();
+        GRPC_CLOSURE_SCHED(c.get(), GRPC_ERROR_NONE);
+        return;
+      }
+    } while (recv_stream->Next(recv_stream->length() - received,
+                               drain_continue.get()) &&
+             GRPC_ERROR_NONE == recv_stream->Pull(&recv_slice) &&
+             (account(), true));
+  });
+
+  drain_continue = MakeClosure([&](grpc_error* error) {
+    recv_stream->Pull(&recv_slice);
+    account();
+    GRPC_CLOSURE_RUN(drain.get(), GRPC_ERROR_NONE);
+  });
+
+  reset_op();
+  op.send_initial_metadata = true;
+  op.payload->send_initial_metadata.send_initial_metadata = &b;
+  op.recv_initial_metadata = true;
+  op.payload->recv_initial_metadata.recv_initial_metadata = &b_recv;
+  op.payload->recv_initial_metadata.recv_initial_metadata_ready =
+      do_nothing.get();
+  op.on_complete = c.get();
+  s.Op(&op);
+  f.PushInput(SLICE_FROM_BUFFER(
+      "\x00\x00\x00\x04\x00\x00\x00\x00\x00"
+      // Generated using:
+      // tools/codegen/core/gen_header_frame.py <
+      // test/cpp/microbenchmarks/representative_server_initial_metadata.headers
+      "\x00\x00X\x01\x04\x00\x00\x00\x01"
+      "\x10\x07:status\x03"
+      "200"
+      "\x10\x0c"
+      "content-type\x10"
+      "application/grpc"
+      "\x10\x14grpc-accept-encoding\x15identity,deflate,gzip"));
+
+  f.FlushExecCtx();
+  reset_op();
+  op.cancel_stream = true;
+  op.payload->cancel_stream.cancel_error = GRPC_ERROR_CANCELLED;
+  s.Op(&op);
+  s.DestroyThen(MakeOnceClosure([](grpc_error* error) {}));
+  f.FlushExecCtx();
+  std::ostringstream label;
+  label << "copied_bytes/byte:"
+        << (total_received == 0 ? 0.0
+                                : static_cast<double>(total_copied) /
+                                      static_cast<double>(total_received));
+  track_counters.AddLabel(label.str());
+  state.SetBytesProcessed(total_received);
+  track_counters.Finish(state);
+  grpc_metadata_batch_destroy(&b);
+  grpc_metadata_batch_destroy(&b_recv);
+  grpc_slice_unref(incoming_data);
+}
+static void RecvPumpArgs(benchmark::internal::Benchmark* b) {
+  for (int message_size : {1024, 64 * 1024, 1024 * 1024}) {
+    for (int read_size : {1000, 8192, 65536}) {
+      b->Args({message_size, read_size});
+    }
+  }
+}
+BENCHMARK(BM_TransportStreamRecvPump)->Apply(RecvPumpArgs);
+
+////////////////////////////////////////////////////////////////////////////////
+// Stream map benchmarks
+//
+
+// Fills map with n streams with the ids a client would use, and returns the
+// ids in random order
+static std::vector<uint32_t> FillStreamMap(grpc_chttp2_stream_map* map,
+                                           size_t n) {
+  std::vector<uint32_t> ids;
+  for (size_t i = 0; i < n; i++) {
+    uint32_t id = static_cast<uint32_t>(2 * i + 1);
+    grpc_chttp2_stream_map_add(
+        map, id, reinterpret_cast<void*>(static_cast<uintptr_t>(id)));
+    ids.push_back(id);
+  }
+  std::random_shuffle(ids.begin(), ids.end());
+  return ids;
+}
+
+// Every incoming frame looks its stream up: find one of state.range(0) live
+// streams per iteration
+static void BM_StreamMapFind(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_chttp2_stream_map map;
+  grpc_chttp2_stream_map_init(&map, 8);
+  std::vector<uint32_t> ids =
+      FillStreamMap(&map, static_cast<size_t>(state.range(0)));
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(grpc_chttp2_stream_map_find(&map, ids[i]));
+    if (++i == ids.size()) i = 0;
+  }
+  grpc_chttp2_stream_map_destroy(&map);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_StreamMapFind)->Arg(10)->Arg(1000)->Arg(100000);
+
+// A short call next to state.range(0) long lived streams: add it, find it
+// for its headers, data and trailers, then delete it
+static void BM_StreamMapShortLivedStream(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_chttp2_stream_map map;
+  grpc_chttp2_stream_map_init(&map, 8);
+  size_t n = static_cast<size_t>(state.range(0));
+  FillStreamMap(&map, n);
+  uint32_t id = static_cast<uint32_t>(2 * n + 1);
+  while (state.KeepRunning()) {
+    grpc_chttp2_stream_map_add(&map, id, &map);
+    for (int j = 0; j < 3; j++) {
+      benchmark::DoNotOptimize(grpc_chttp2_stream_map_find(&map, id));
+    }
+    grpc_chttp2_stream_map_delete(&map, id);
+    id += 2;
+  }
+  grpc_chttp2_stream_map_destroy(&map);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_StreamMapShortLivedStream)->Arg(10)->Arg(1000)->Arg(100000);
+
+////////////////////////////////////////////////////////////////////////////////
+// Replay of recorded traffic
+//
+
+DEFINE_string(chttp2_replay_file, "",
+              "Recording (see test/core/util/recording_endpoint.h) for "
+              "BM_TransportReplay to feed to a server transport; by default "
+              "the recorded writes of a representative client are replayed");
+DEFINE_bool(chttp2_replay_writes, false,
+            "Replay the chunks written in --chttp2_replay_file rather than "
+            "those read, i.e. replay a recording taken at a client");
+
+// Run a mix of unary shaped calls through a client transport, recording what
+// it writes
+static void RecordRepresentativeClient(benchmark::State& state,
+                                       grpc_endpoint_recording* recording) {
+  static const char* kPaths[] = {"/foo/bar", "/foo/baz", "/foo/qux"};
+  static const size_t kMessageSizes[] = {10, 100, 1000, 40000};
+  const size_t kCalls = 64;
+  Fixture f(grpc::ChannelArguments(), true, recording);
+  grpc_transport_stream_op_batch op;
+  grpc_transport_stream_op_batch_payload op_payload;
+  grpc_core::ManualConstructor<grpc_core::SliceBufferByteStream> send_stream;
+  std::unique_ptr<Closure> do_nothing = MakeClosure([](grpc_error* error) {});
+
+  auto reset_op = [&]() {
+    memset(&op, 0, sizeof(op));
+    memset(&op_payload, 0, sizeof(op_payload));
+    op.payload = &op_payload;
+  };
+
+  // The server's settings, and enough connection window for all the calls:
+  // the client must not send window updates the server would have to reject
+  f.PushInput(SLICE_FROM_BUFFER(
+      "\x00\x00\x00\x04\x00\x00\x00\x00\x00"
+      "\x00\x00\x04\x08\x00\x00\x00\x00\x00\x7f\x00\x00\x00"));
+  f.FlushExecCtx();
+
+  for (size_t i = 0; i < kCalls; i++) {
+    grpc_metadata_batch b;
+    grpc_metadata_batch_init(&b);
+    grpc_metadata_batch b_trailing;
+    grpc_metadata_batch_init(&b_trailing);
+    b.deadline = GRPC_MILLIS_INF_FUTURE;
+    std::vector<grpc_mdelem> elems =
+        RepresentativeClientInitialMetadata::GetElems();
+    GRPC_MDELEM_UNREF(elems[2]);
+    elems[2] = grpc_mdelem_from_slices(
+        GRPC_MDSTR_PATH, grpc_slice_intern(grpc_slice_from_static_string(
+                             kPaths[i % GPR_ARRAY_SIZE(kPaths)])));
+    std::vector<grpc_linked_mdelem> storage(elems.size());
+    for (size_t j = 0; j < elems.size(); j++) {
+      GPR_ASSERT(GRPC_LOG_IF_ERROR(
+          "addmd", grpc_metadata_batch_add_tail(&b, &storage[j], elems[j])));
+    }
+    grpc_slice_buffer send_buffer;
+    grpc_slice_buffer_init(&send_buffer);
+    grpc_slice send_slice =
+        GRPC_SLICE_MALLOC(kMessageSizes[i % GPR_ARRAY_SIZE(kMessageSizes)]);
+    memset(GRPC_SLICE_START_PTR(send_slice), 'x',
+           GRPC_SLICE_LENGTH(send_slice));
+    grpc_slice_buffer_add(&send_buffer, send_slice);
+    send_stream.Init(&send_buffer, 0);
+    grpc_slice_buffer_destroy(&send_buffer);
+
+    Stream s(&f);
+    s.Init(state);
+    reset_op();
+    op.on_complete = do_nothing.get();
+    op.send_initial_metadata = true;
+    op.payload->send_initial_metadata.send_initial_metadata = &b;
+    op.send_message = true;
+    op.payload->send_message.send_message.reset(send_stream.get());
+    op.send_trailing_metadata = true;
+    op.payload->send_trailing_metadata.send_trailing_metadata = &b_trailing;
+    s.Op(&op);
+    f.FlushExecCtx();
+
+    reset_op();
+    op.cancel_stream = true;
+    op.payload->cancel_stream.cancel_error = GRPC_ERROR_CANCELLED;
+    s.Op(&op);
+    s.DestroyThen(MakeOnceClosure([](grpc_error* error) {}));
+    f.FlushExecCtx();
+    grpc_metadata_batch_destroy(&b);
+    grpc_metadata_batch_destroy(&b_trailing);
+  }
+}
+
+// The bytes a replay feeds to a transport: as the recorded chunks, and split
+// at frame boundaries with the type of each frame (-1 for the connection
+// preface)
+struct ReplayInput {
+  ~ReplayInput() {
+    for (grpc_slice chunk : chunks) grpc_slice_unref(chunk);
+    for (grpc_slice frame : frames) grpc_slice_unref(frame);
+  }
+
+  std::vector<grpc_slice> chunks;
+  std::vector<grpc_slice> frames;
+  std::vector<int> frame_types;
+  size_t bytes = 0;
+};
+
+static bool LoadReplayInput(benchmark::State& state, ReplayInput* input) {
+  grpc_endpoint_recording* recording;
+  bool replay_writes = FLAGS_chttp2_replay_writes;
+  if (FLAGS_chttp2_replay_file.empty()) {
+    recording = grpc_endpoint_recording_create();
+    RecordRepresentativeClient(state, recording);
+    replay_writes = true;
+  } else {
+    recording = grpc_endpoint_recording_load(FLAGS_chttp2_replay_file.c_str());
+    if (recording == nullptr) return false;
+  }
+  grpc_slice_buffer all;
+  grpc_slice_buffer_init(&all);
+  for (size_t i = 0; i < grpc_endpoint_recording_count(recording); i++) {
+    bool is_read;
+    grpc_slice chunk = grpc_endpoint_recording_get(recording, i, &is_read);
+    if (is_read == replay_writes) continue;
+    input->chunks.push_back(grpc_slice_ref(chunk));
+    grpc_slice_buffer_add(&all, grpc_slice_ref(chunk));
+  }
+  grpc_endpoint_recording_destroy(recording);
+  input->bytes = all.length;
+
+  grpc_slice flat = grpc_slice_merge(all.slices, all.count);
+  grpc_slice_buffer_destroy(&all);
+  const uint8_t* p = GRPC_SLICE_START_PTR(flat);
+  const size_t length = GRPC_SLICE_LENGTH(flat);
+  size_t offset = 0;
+  if (length >= GRPC_CHTTP2_CLIENT_CONNECT_STRLEN &&
+      0 == memcmp(p, GRPC_CHTTP2_CLIENT_CONNECT_STRING,
+                  GRPC_CHTTP2_CLIENT_CONNECT_STRLEN)) {
+    offset = GRPC_CHTTP2_CLIENT_CONNECT_STRLEN;
+    input->frames.push_back(grpc_slice_sub(flat, 0, offset));
+    input->frame_types.push_back(-1);
+  }
+  // A frame cut short by the end of the recording is left out
+  while (length - offset >= 9) {
+    size_t frame_length = 9 + ((static_cast<size_t>(p[offset]) << 16) |
+                               (static_cast<size_t>(p[offset + 1]) << 8) |
+                               static_cast<size_t>(p[offset + 2]));
+    if (length - offset < frame_length) break;
+    input->frames.push_back(
+        grpc_slice_sub(flat, offset, offset + frame_length));
+    input->frame_types.push_back(p[offset + 3]);
+    offset += frame_length;
+  }
+  grpc_slice_unref(flat);
+  return true;
+}
+
+static const char* FrameTypeName(int type) {
+  switch (type) {
+    case -1:
+      return "PREFACE";
+    case GRPC_CHTTP2_FRAME_DATA:
+      return "DATA";
+    case GRPC_CHTTP2_FRAME_HEADER:
+      return "HEADERS";
+    case GRPC_CHTTP2_FRAME_CONTINUATION:
+      return "CONTINUATION";
+    case GRPC_CHTTP2_FRAME_RST_STREAM:
+      return "RST_STREAM";
+    case GRPC_CHTTP2_FRAME_SETTINGS:
+      return "SETTINGS";
+    case GRPC_CHTTP2_FRAME_PING:
+      return "PING";
+    case GRPC_CHTTP2_FRAME_GOAWAY:
+      return "GOAWAY";
+    case GRPC_CHTTP2_FRAME_WINDOW_UPDATE:
+      return "WINDOW_UPDATE";
+  }
+  return "OTHER";
+}
+
+// Accepts the streams a replay opens on a server transport, and cancels and
+// destroys them when it goes out of scope
+class AcceptedStreams {
+ public:
+  AcceptedStreams(Fixture* f, benchmark::State& state) : f_(f), state_(state) {
+    grpc_transport_op* op = grpc_make_transport_op(nullptr);
+    op->set_accept_stream = true;
+    op->set_accept_stream_fn = Accept;
+    op->set_accept_stream_user_data = this;
+    grpc_transport_perform_op(f->transport(), op);
+    f->FlushExecCtx();
+  }
+
+  ~AcceptedStreams() {
+    for (auto& s : streams_) {
+      grpc_transport_stream_op_batch op;
+      grpc_transport_stream_op_batch_payload op_payload;
+      memset(&op, 0, sizeof(op));
+      op.payload = &op_payload;
+      op.cancel_stream = true;
+      op_payload.cancel_stream.cancel_error = GRPC_ERROR_CANCELLED;
+      s->Op(&op);
+      s->DestroyThen(MakeOnceClosure([](grpc_error* error) {}));
+      f_->FlushExecCtx();
+    }
+  }
+
+ private:
+  static void Accept(void* arg, grpc_transport* transport,
+                     const void* server_data) {
+    AcceptedStreams* self = static_cast<AcceptedStreams*>(arg);
+    self->streams_.emplace_back(new Stream(self->f_));
+    self->streams_.back()->Init(self->state_, server_data);
+  }
+
+  Fixture* f_;
+  benchmark::State& state_;
+  std::vector<std::unique_ptr<Stream>> streams_;
+};
+
+// Replay a recording into a fresh server transport each iteration. With
+// state.range(0) == 0 the bytes arrive in the recorded reads; otherwise each
+// frame arrives in a read of its own, and the label breaks the time spent
+// parsing it and running what it scheduled down per frame type.
+static void BM_TransportReplay(benchmark::State& state) {
+  grpc_core::ExecCtx exec_ctx;
+  ReplayInput input;
+  if (!LoadReplayInput(state, &input)) {
+    state.SkipWithError("Failed to load the recording");
+    return;
+  }
+  TrackCounters track_counters;
+  const bool per_frame = state.range(0) != 0;
+  const std::vector<grpc_slice>& reads =
+      per_frame ? input.frames : input.chunks;
+  struct FrameCost {
+    int64_t frames = 0;
+    int64_t nanos = 0;
+  };
+  std::map<grpc::string, FrameCost> costs;
+  bool failed = false;
+
+  while (!failed && state.KeepRunning()) {
+    state.PauseTiming();
+    {
+      Fixture f(grpc::ChannelArguments(), false);
+      AcceptedStreams streams(&f, state);
+      state.ResumeTiming();
+      for (size_t i = 0; !failed && i < reads.size(); i++) {
+        gpr_timespec start = per_frame ? gpr_now(GPR_CLOCK_MONOTONIC)
+                                       : gpr_time_0(GPR_CLOCK_MONOTONIC);
+        f.PushInput(grpc_slice_ref(reads[i]));
+        f.FlushExecCtx();
+        if (per_frame) {
+          gpr_timespec elapsed =
+              gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start);
+          FrameCost& cost = costs[FrameTypeName(input.frame_types[i])];
+          cost.frames++;
+          cost.nanos += elapsed.tv_sec * GPR_NS_PER_SEC + elapsed.tv_nsec;
+        }
+        // A closed transport stops reading
+        failed = f.chttp2_transport()->closed_with_error != GRPC_ERROR_NONE;
+      }
+      state.PauseTiming();
+      if (failed) {
+        gpr_log(GPR_ERROR, "replay failed: %s",
+                grpc_error_string(f.chttp2_transport()->closed_with_error));
+      }
+    }
+    exec_ctx.Flush();
+    state.ResumeTiming();
+  }
+  if (failed) {
+    state.SkipWithError("The transport closed during the replay");
+    return;
+  }
+
+  std::ostringstream label;
+  for (const auto& cost : costs) {
+    label << " " << cost.first << ":"
+          << cost.second.frames / state.iterations() << "x"
+          << cost.second.nanos / cost.second.frames << "ns";
+  }
+  if (!costs.empty()) track_counters.AddLabel(label.str().substr(1));
+  state.SetBytesProcessed(state.iterations() * input.bytes);
+  state.SetItemsProcessed(state.iterations() * input.frames.size());
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_TransportReplay)->Arg(0)->Arg(1);
+
 // Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
 // and others do not. This allows us to support both modes.
 namespace benchmark {
@@ -133,6 +133,73 @@ static void BM_Pluck1Core(benchmark::State& state) {
 }
 BENCHMARK(BM_Pluck1Core);
 
+/* Counts the events of a callback cq; run inline, so every event has been
+   handled once the ExecCtx that ended its operation is destroyed */
+struct CountingFunctor : public grpc_completion_queue_functor {
+  CountingFunctor() : events(0), shutdown(false) {
+    run = &CountingFunctor::Run;
+    inlineable = 1;
+  }
+  static void Run(grpc_completion_queue_functor* functor, grpc_event ev) {
+    CountingFunctor* self = static_cast<CountingFunctor*>(functor);
+    if (ev.type == GRPC_QUEUE_SHUTDOWN) {
+      self->shutdown = true;
+    } else {
+      self->events++;
+    }
+  }
+  size_t events;
+  bool shutdown;
+};
+
+static void BM_Callback1Core(benchmark::State& state) {
+  TrackCounters track_counters;
+  CountingFunctor functor;
+  grpc_completion_queue* cq =
+      grpc_completion_queue_create_for_callback(&functor, nullptr);
+  while (state.KeepRunning()) {
+    grpc_cq_completion completion;
+    grpc_core::ExecCtx exec_ctx;
+    GPR_ASSERT(grpc_cq_begin_op(cq, nullptr));
+    grpc_cq_end_op(cq, nullptr, GRPC_ERROR_NONE, DoneWithCompletionOnStack,
+                   nullptr, &completion);
+  }
+  GPR_ASSERT(functor.events == static_cast<size_t>(state.iterations()));
+  grpc_completion_queue_shutdown(cq);
+  GPR_ASSERT(functor.shutdown);
+  grpc_completion_queue_destroy(cq);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_Callback1Core);
+
+class CountingHandler final : public experimental::CompletionQueueHandler {
+ public:
+  CountingHandler() : events(0) {}
+  void OnEvent(void* tag, bool ok) override { events++; }
+  size_t events;
+};
+
+static void BM_Callback1Cpp(benchmark::State& state) {
+  TrackCounters track_counters;
+  CountingHandler handler;
+  {
+    CompletionQueue cq(&handler, true);
+    grpc_completion_queue* c_cq = cq.cq();
+    while (state.KeepRunning()) {
+      grpc_cq_completion completion;
+      DummyTag dummy_tag;
+      grpc_core::ExecCtx exec_ctx;
+      GPR_ASSERT(grpc_cq_begin_op(c_cq, &dummy_tag));
+      grpc_cq_end_op(c_cq, &dummy_tag, GRPC_ERROR_NONE,
+                     DoneWithCompletionOnStack, nullptr, &completion);
+    }
+    cq.Shutdown();
+  }
+  GPR_ASSERT(handler.events == static_cast<size_t>(state.iterations()));
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_Callback1Cpp);
+
 static void BM_EmptyCore(benchmark::State& state) {
   TrackCounters track_counters;
   // TODO: sreek Templatize this benchmark and pass polling_type as a param
@@ -0,0 +1,169 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark the latency of cheap closures scheduled on the executor next to
+   closures that block for a while, which should not hold the cheap ones up */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/executor.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+auto& force_library_initialization = Library::get();
+
+static const size_t kBatchSize = 100;
+
+struct Batch;
+
+struct Job {
+  grpc_closure closure;
+  Batch* batch;
+  bool slow;
+  gpr_timespec scheduled;
+  double latency_us;
+};
+
+struct Batch {
+  gpr_mu mu;
+  gpr_cv cv;
+  size_t remaining;
+  int slow_us;
+  std::vector<Job> jobs;
+  grpc_closure fan_out;
+};
+
+static void RunJob(void* arg, grpc_error* error) {
+  Job* job = static_cast<Job*>(arg);
+  job->latency_us = gpr_timespec_to_micros(
+      gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), job->scheduled));
+  if (job->slow) {
+    gpr_sleep_until(gpr_time_add(
+        gpr_now(GPR_CLOCK_MONOTONIC),
+        gpr_time_from_micros(job->batch->slow_us, GPR_TIMESPAN)));
+  }
+  gpr_mu_lock(&job->batch->mu);
+  if (--job->batch->remaining == 0) {
+    gpr_cv_signal(&job->batch->cv);
+  }
+  gpr_mu_unlock(&job->batch->mu);
+}
+
+static void ScheduleJobs(void* arg, grpc_error* error) {
+  Batch* batch = static_cast<Batch*>(arg);
+  for (Job& job : batch->jobs) {
+    job.scheduled = gpr_now(GPR_CLOCK_MONOTONIC);
+    GRPC_CLOSURE_SCHED(
+        GRPC_CLOSURE_INIT(&job.closure, RunJob, &job,
+                          grpc_executor_scheduler(GRPC_EXECUTOR_SHORT)),
+        GRPC_ERROR_NONE);
+  }
+}
+
+/* Every iteration schedules a batch of closures, one in state.range(0) of
+   which blocks for state.range(1) microseconds, and waits for them all. The
+   batch is scheduled from the benchmark thread, or, with kFanOut, from a
+   closure running on the executor. The label reports the percentiles of the
+   time the other closures waited to run */
+template <bool kFanOut>
+static void BM_SkewedClosures(benchmark::State& state) {
+  TrackCounters track_counters;
+  const size_t slow_every = static_cast<size_t>(state.range(0));
+  std::vector<double> latencies;
+  while (state.KeepRunning()) {
+    Batch batch;
+    gpr_mu_init(&batch.mu);
+    gpr_cv_init(&batch.cv);
+    batch.remaining = kBatchSize;
+    batch.slow_us = static_cast<int>(state.range(1));
+    batch.jobs.resize(kBatchSize);
+    for (size_t i = 0; i < kBatchSize; i++) {
+      batch.jobs[i].batch = &batch;
+      batch.jobs[i].slow = i % slow_every == 0;
+    }
+    {
+      grpc_core::ExecCtx exec_ctx;
+      if (kFanOut) {
+        GRPC_CLOSURE_SCHED(
+            GRPC_CLOSURE_INIT(&batch.fan_out, ScheduleJobs, &batch,
+                              grpc_executor_scheduler(GRPC_EXECUTOR_SHORT)),
+            GRPC_ERROR_NONE);
+      } else {
+        ScheduleJobs(&batch, GRPC_ERROR_NONE);
+      }
+    }
+    gpr_mu_lock(&batch.mu);
+    while (batch.remaining != 0) {
+      gpr_cv_wait(&batch.cv, &batch.mu, gpr_inf_future(GPR_CLOCK_MONOTONIC));
+    }
+    gpr_mu_unlock(&batch.mu);
+    gpr_mu_destroy(&batch.mu);
+    gpr_cv_destroy(&batch.cv);
+    for (const Job& job : batch.jobs) {
+      if (!job.slow) latencies.push_back(job.latency_us);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+
+  std::sort(latencies.begin(), latencies.end());
+  std::ostringstream label;
+  for (double percentile : {50.0, 99.0, 99.9}) {
+    size_t rank = static_cast<size_t>(percentile / 100.0 *
+                                      static_cast<double>(latencies.size()));
+    label << "wait-" << percentile
+          << "p:" << latencies[std::min(rank, latencies.size() - 1)] << "us ";
+  }
+  track_counters.AddLabel(label.str());
+  track_counters.Finish(state);
+}
+BENCHMARK_TEMPLATE(BM_SkewedClosures, false)
+    ->Args({100, 1000})
+    ->Args({10, 200})
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SkewedClosures, true)
+    ->Args({100, 1000})
+    ->Args({10, 200})
+    ->UseRealTime();
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
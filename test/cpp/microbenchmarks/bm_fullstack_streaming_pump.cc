@@ -51,6 +51,12 @@ BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, SockPair)
     ->Range(0, 128 * 1024 * 1024);
 BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, InProcessCHTTP2)
     ->Range(0, 128 * 1024 * 1024);
+// Copying vs MSG_ZEROCOPY sends for payloads above the zero-copy threshold;
+// compare against the TCP rows over the same sizes.
+BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, TCPZeroCopy)
+    ->Range(16 * 1024, 128 * 1024 * 1024);
+BENCHMARK_TEMPLATE(BM_PumpStreamServerToClient, TCPZeroCopy)
+    ->Range(16 * 1024, 128 * 1024 * 1024);
 BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, MinTCP)->Arg(0);
 BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, MinUDS)->Arg(0);
 BENCHMARK_TEMPLATE(BM_PumpStreamClientToServer, MinInProcess)->Arg(0);
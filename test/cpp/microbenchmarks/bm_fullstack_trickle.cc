@@ -20,7 +20,9 @@
 
 #include <benchmark/benchmark.h>
 #include <gflags/gflags.h>
+#include <algorithm>
 #include <fstream>
+#include <vector>
 
 #include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
 #include "src/core/ext/transport/chttp2/transport/internal.h"
@@ -76,13 +78,35 @@ static void write_csv(std::ostream* out, A0&& a0, Arg&&... arg) {
   write_csv(out, std::forward<Arg>(arg)...);
 }
 
+// Selects the http2 write scheduler on both ends of the connection
+class WriteSchedulerConfiguration : public FixtureConfiguration {
+ public:
+  explicit WriteSchedulerConfiguration(const grpc::string& scheduler)
+      : scheduler_(scheduler) {}
+
+  void ApplyCommonChannelArguments(ChannelArguments* c) const override {
+    FixtureConfiguration::ApplyCommonChannelArguments(c);
+    c->SetString(GRPC_ARG_HTTP2_WRITE_SCHEDULER, scheduler_);
+  }
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+    b->AddChannelArgument(GRPC_ARG_HTTP2_WRITE_SCHEDULER, scheduler_);
+  }
+
+ private:
+  const grpc::string scheduler_;
+};
+
 class TrickledCHTTP2 : public EndpointPairFixture {
  public:
   TrickledCHTTP2(Service* service, bool streaming, size_t req_size,
                  size_t resp_size, size_t kilobits_per_second,
-                 grpc_passthru_endpoint_stats* stats)
+                 grpc_passthru_endpoint_stats* stats,
+                 const FixtureConfiguration& fixture_configuration =
+                     FixtureConfiguration())
       : EndpointPairFixture(service, MakeEndpoints(kilobits_per_second, stats),
-                            FixtureConfiguration()),
+                            fixture_configuration),
         stats_(stats) {
     if (FLAGS_log) {
       std::ostringstream fn;
@@ -126,6 +150,13 @@ class TrickledCHTTP2 : public EndpointPairFixture {
         << " svr_stream_stalls/iter:"
         << ((double)server_stats_.streams_stalled_due_to_stream_flow_control /
             (double)state.iterations());
+    for (const auto& label : labels_) {
+      out << " " << label;
+    }
+  }
+
+  void AddLabel(const grpc::string& label) override {
+    labels_.push_back(label);
   }
 
   void Log(int64_t iteration) GPR_ATTRIBUTE_NO_TSAN {
@@ -209,6 +240,7 @@ class TrickledCHTTP2 : public EndpointPairFixture {
   Stats client_stats_;
   Stats server_stats_;
   std::unique_ptr<std::ofstream> log_;
+  std::vector<grpc::string> labels_;
   gpr_timespec start_ = gpr_now(GPR_CLOCK_MONOTONIC);
 
   static grpc_endpoint_pair MakeEndpoints(size_t kilobits,
@@ -453,6 +485,176 @@ static void UnaryTrickleArgs(benchmark::internal::Benchmark* b) {
   }
 }
 BENCHMARK(BM_PumpUnbalancedUnary_Trickle)->Apply(UnaryTrickleArgs);
+
+static const char* kWriteSchedulers[] = {"fifo", "drr"};
+
+// Small unary calls sharing the connection with state.range(0) streams that
+// download messages of state.range(1) bytes back to back, at state.range(2)
+// kbit/s, with the write scheduler kWriteSchedulers[state.range(3)]. Reports
+// the latency of the unary calls in simulated time.
+static void BM_PumpBulkAndUnary_Trickle(benchmark::State& state) {
+  static const intptr_t kBulkWriteTag = 1000;
+  static const intptr_t kBulkReadTag = 2000;
+  static const intptr_t kBulkDoneTag = 3000;
+  const int num_bulk_streams = static_cast<int>(state.range(0));
+  EchoTestService::AsyncService service;
+  std::unique_ptr<TrickledCHTTP2> fixture(new TrickledCHTTP2(
+      &service, true, 1 /* req_size */, state.range(1) /* resp_size */,
+      state.range(2) /* bw in kbit/s */, grpc_passthru_endpoint_stats_create(),
+      WriteSchedulerConfiguration(kWriteSchedulers[state.range(3)])));
+  std::unique_ptr<EchoTestService::Stub> stub(
+      EchoTestService::NewStub(fixture->channel()));
+  void* t;
+  bool ok;
+
+  struct BulkStream {
+    ServerContext svr_ctx;
+    ServerAsyncReaderWriter<EchoResponse, EchoRequest> response_rw;
+    ClientContext cli_ctx;
+    std::unique_ptr<ClientAsyncReaderWriter<EchoRequest, EchoResponse>>
+        request_rw;
+    EchoResponse recv_response;
+    Status recv_status;
+    BulkStream() : response_rw(&svr_ctx) {}
+  };
+  EchoResponse bulk_response;
+  bulk_response.set_message(std::string(state.range(1), 'a'));
+  std::vector<std::unique_ptr<BulkStream>> bulk_streams;
+  for (int i = 0; i < num_bulk_streams; i++) {
+    bulk_streams.emplace_back(new BulkStream);
+    BulkStream* b = bulk_streams.back().get();
+    service.RequestBidiStream(&b->svr_ctx, &b->response_rw, fixture->cq(),
+                              fixture->cq(), tag(0));
+    b->request_rw = stub->AsyncBidiStream(&b->cli_ctx, fixture->cq(), tag(1));
+    int need_tags = (1 << 0) | (1 << 1);
+    while (need_tags) {
+      TrickleCQNext(fixture.get(), &t, &ok, -1);
+      GPR_ASSERT(ok);
+      int tagnum = (int)(intptr_t)t;
+      GPR_ASSERT(need_tags & (1 << tagnum));
+      need_tags &= ~(1 << tagnum);
+    }
+    b->request_rw->Read(&b->recv_response, tag(kBulkReadTag + i));
+    b->response_rw.Write(bulk_response, tag(kBulkWriteTag + i));
+  }
+  // Keeps the bulk streams busy until draining is set, then closes them.
+  // Returns false for events that are not theirs.
+  bool draining = false;
+  int bulk_ops_pending = 2 * num_bulk_streams;
+  auto pump_bulk_streams = [&](void* event_tag, bool event_ok) {
+    intptr_t tagnum = reinterpret_cast<intptr_t>(event_tag);
+    if (tagnum >= kBulkReadTag && tagnum < kBulkReadTag + num_bulk_streams) {
+      BulkStream* b = bulk_streams[tagnum - kBulkReadTag].get();
+      if (event_ok) {
+        b->request_rw->Read(&b->recv_response, event_tag);
+      } else {
+        b->request_rw->Finish(&b->recv_status, tag(kBulkDoneTag));
+      }
+    } else if (tagnum >= kBulkWriteTag &&
+               tagnum < kBulkWriteTag + num_bulk_streams) {
+      GPR_ASSERT(event_ok);
+      BulkStream* b = bulk_streams[tagnum - kBulkWriteTag].get();
+      if (draining) {
+        b->response_rw.Finish(Status::OK, tag(kBulkDoneTag));
+      } else {
+        b->response_rw.Write(bulk_response, event_tag);
+      }
+    } else if (tagnum == kBulkDoneTag) {
+      bulk_ops_pending--;
+    } else {
+      return false;
+    }
+    return true;
+  };
+
+  struct ServerEnv {
+    ServerContext ctx;
+    EchoRequest recv_request;
+    grpc::ServerAsyncResponseWriter<EchoResponse> response_writer;
+    ServerEnv() : response_writer(&ctx) {}
+  };
+  std::unique_ptr<ServerEnv> server_env(new ServerEnv);
+  service.RequestEcho(&server_env->ctx, &server_env->recv_request,
+                      &server_env->response_writer, fixture->cq(),
+                      fixture->cq(), tag(0));
+  EchoRequest send_request;
+  EchoResponse send_response;
+  EchoResponse recv_response;
+  send_request.set_message("a");
+  send_response.set_message("a");
+  Status recv_status;
+  std::vector<int64_t> latencies_us;
+  auto inner_loop = [&](bool in_warmup) {
+    GPR_TIMER_SCOPE("BenchmarkCycle", 0);
+    const int64_t start_us = gpr_atm_no_barrier_load(&g_now_us);
+    recv_response.Clear();
+    ClientContext cli_ctx;
+    std::unique_ptr<ClientAsyncResponseReader<EchoResponse>> response_reader(
+        stub->AsyncEcho(&cli_ctx, send_request, fixture->cq()));
+    response_reader->Finish(&recv_response, &recv_status, tag(2));
+    for (int need_tags = (1 << 0) | (1 << 1) | (1 << 2); need_tags != 0;) {
+      TrickleCQNext(fixture.get(), &t, &ok,
+                    in_warmup ? -1 : state.iterations());
+      if (pump_bulk_streams(t, ok)) continue;
+      GPR_ASSERT(ok);
+      int tagnum = (int)(intptr_t)t;
+      GPR_ASSERT(need_tags & (1 << tagnum));
+      need_tags &= ~(1 << tagnum);
+      if (tagnum == 0) {
+        server_env->response_writer.Finish(send_response, Status::OK, tag(1));
+      } else if (tagnum == 2 && !in_warmup) {
+        latencies_us.push_back(gpr_atm_no_barrier_load(&g_now_us) - start_us);
+      }
+    }
+    GPR_ASSERT(recv_status.ok());
+    server_env.reset(new ServerEnv);
+    service.RequestEcho(&server_env->ctx, &server_env->recv_request,
+                        &server_env->response_writer, fixture->cq(),
+                        fixture->cq(), tag(0));
+  };
+  gpr_timespec warmup_start = gpr_now(GPR_CLOCK_MONOTONIC);
+  for (int i = 0; i < FLAGS_warmup_iterations; i++) {
+    inner_loop(true);
+    if (gpr_time_cmp(gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), warmup_start),
+                     gpr_time_from_seconds(FLAGS_warmup_max_time_seconds,
+                                           GPR_TIMESPAN)) > 0) {
+      break;
+    }
+  }
+  while (state.KeepRunning()) {
+    inner_loop(false);
+  }
+  draining = true;
+  while (bulk_ops_pending > 0) {
+    TrickleCQNext(fixture.get(), &t, &ok, -1);
+    GPR_ASSERT(pump_bulk_streams(t, ok));
+  }
+  if (!latencies_us.empty()) {
+    std::sort(latencies_us.begin(), latencies_us.end());
+    std::ostringstream label;
+    label << "unary_p50_us:" << latencies_us[latencies_us.size() / 2]
+          << " unary_p99_us:"
+          << latencies_us[latencies_us.size() * 99 / 100];
+    fixture->AddLabel(label.str());
+  }
+  fixture->Finish(state);
+  fixture.reset();
+  bulk_streams.clear();
+  server_env.reset();
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BulkAndUnaryTrickleArgs(benchmark::internal::Benchmark* b) {
+  for (int streams = 1; streams <= 4; streams *= 4) {
+    for (int size = 64 * 1024; size <= 1024 * 1024; size *= 16) {
+      for (size_t scheduler = 0; scheduler < GPR_ARRAY_SIZE(kWriteSchedulers);
+           scheduler++) {
+        b->Args({streams, size, 16 * 1024, static_cast<int>(scheduler)});
+      }
+    }
+  }
+}
+BENCHMARK(BM_PumpBulkAndUnary_Trickle)->Apply(BulkAndUnaryTrickleArgs);
 }  // namespace testing
 }  // namespace grpc
 
@@ -18,9 +18,17 @@
 
 /* Benchmark gRPC end2end in various configurations */
 
+#include <gflags/gflags.h>
+
 #include "test/cpp/microbenchmarks/fullstack_unary_ping_pong.h"
 #include "test/cpp/util/test_config.h"
 
+DEFINE_string(chttp2_record_file, "",
+              "Save what the server transport of the last "
+              "RecordingInProcessCHTTP2 fixture read and wrote to this file "
+              "(pick one benchmark with --benchmark_filter), as input for "
+              "bm_chttp2_transport --chttp2_replay_file");
+
 namespace grpc {
 namespace testing {
 
@@ -61,6 +69,9 @@ BENCHMARK_TEMPLATE(BM_UnaryPingPong, InProcessCHTTP2, NoOpMutator, NoOpMutator)
 BENCHMARK_TEMPLATE(BM_UnaryPingPong, MinInProcessCHTTP2, NoOpMutator,
                    NoOpMutator)
     ->Apply(SweepSizesArgs);
+BENCHMARK_TEMPLATE(BM_UnaryPingPong, RecordingInProcessCHTTP2, NoOpMutator,
+                   NoOpMutator)
+    ->Apply(SweepSizesArgs);
 BENCHMARK_TEMPLATE(BM_UnaryPingPong, InProcessCHTTP2,
                    Client_AddMetadata<RandomBinaryMetadata<10>, 1>, NoOpMutator)
     ->Args({0, 0});
@@ -174,6 +185,8 @@ void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
 int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
   ::grpc::testing::InitTest(&argc, &argv, false);
+  ::grpc::testing::ServerEndpointRecordingHolder::RecordFile() =
+      FLAGS_chttp2_record_file;
   benchmark::RunTheBenchmarksNamespaced();
   return 0;
 }
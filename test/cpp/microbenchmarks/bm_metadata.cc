@@ -22,6 +22,7 @@
 #include <grpc/grpc.h>
 
 #include "src/core/lib/transport/metadata.h"
+#include "src/core/lib/transport/metadata_batch.h"
 #include "src/core/lib/transport/static_metadata.h"
 
 #include "test/cpp/microbenchmarks/helpers.h"
@@ -68,6 +69,19 @@ static void BM_SliceReIntern(benchmark::State& state) {
 }
 BENCHMARK(BM_SliceReIntern);
 
+// Interning hits from several threads at once: each thread keeps the interned
+// copy alive, so every lookup finds it.
+static void BM_SliceReInternThreads(benchmark::State& state) {
+  TrackCounters track_counters;
+  gpr_slice slice = grpc_slice_intern(grpc_slice_from_static_string("abc"));
+  while (state.KeepRunning()) {
+    grpc_slice_unref(grpc_slice_intern(slice));
+  }
+  grpc_slice_unref(slice);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_SliceReInternThreads)->ThreadRange(1, 16)->UseRealTime();
+
 static void BM_SliceInternStaticMetadata(benchmark::State& state) {
   TrackCounters track_counters;
   while (state.KeepRunning()) {
@@ -133,6 +147,27 @@ static void BM_MetadataFromInternedSlicesAlreadyInIndex(
 }
 BENCHMARK(BM_MetadataFromInternedSlicesAlreadyInIndex);
 
+// As above, from several threads at once.
+static void BM_MetadataFromInternedSlicesAlreadyInIndexThreads(
+    benchmark::State& state) {
+  TrackCounters track_counters;
+  gpr_slice k = grpc_slice_intern(grpc_slice_from_static_string("key"));
+  gpr_slice v = grpc_slice_intern(grpc_slice_from_static_string("value"));
+  grpc_core::ExecCtx exec_ctx;
+  grpc_mdelem seed = grpc_mdelem_create(k, v, nullptr);
+  while (state.KeepRunning()) {
+    GRPC_MDELEM_UNREF(grpc_mdelem_create(k, v, nullptr));
+  }
+  GRPC_MDELEM_UNREF(seed);
+
+  grpc_slice_unref(k);
+  grpc_slice_unref(v);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MetadataFromInternedSlicesAlreadyInIndexThreads)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
 static void BM_MetadataFromInternedKey(benchmark::State& state) {
   TrackCounters track_counters;
   gpr_slice k = grpc_slice_intern(grpc_slice_from_static_string("key"));
@@ -291,6 +326,83 @@ static void BM_MetadataRefUnrefStatic(benchmark::State& state) {
 }
 BENCHMARK(BM_MetadataRefUnrefStatic);
 
+// Interned elements with distinct keys, none of which are callouts.
+static std::vector<grpc_mdelem> MakeBatchElems(size_t n) {
+  std::vector<grpc_mdelem> elems;
+  for (size_t i = 0; i < n; i++) {
+    char key[32];
+    snprintf(key, sizeof(key), "x-key-%d", static_cast<int>(i));
+    elems.push_back(grpc_mdelem_from_slices(
+        grpc_slice_intern(grpc_slice_from_copied_string(key)),
+        grpc_slice_intern(grpc_slice_from_static_string("value"))));
+  }
+  return elems;
+}
+
+// Build a batch of state.range(0) elements, walk it, and tear it down: what
+// every call does with each of its metadata batches.
+static void BM_MetadataBatchBuildIterate(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  std::vector<grpc_mdelem> elems = MakeBatchElems(state.range(0));
+  std::vector<grpc_linked_mdelem> storage(elems.size());
+  while (state.KeepRunning()) {
+    grpc_metadata_batch batch;
+    grpc_metadata_batch_init(&batch);
+    for (size_t i = 0; i < elems.size(); i++) {
+      GPR_ASSERT(grpc_metadata_batch_add_tail(&batch, &storage[i],
+                                              GRPC_MDELEM_REF(elems[i])) ==
+                 GRPC_ERROR_NONE);
+    }
+    benchmark::DoNotOptimize(grpc_metadata_batch_size(&batch));
+    grpc_metadata_batch_destroy(&batch);
+  }
+  for (grpc_mdelem md : elems) GRPC_MDELEM_UNREF(md);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MetadataBatchBuildIterate)->Range(1, 64);
+
+static void BM_MetadataBatchIterate(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  std::vector<grpc_mdelem> elems = MakeBatchElems(state.range(0));
+  std::vector<grpc_linked_mdelem> storage(elems.size());
+  grpc_metadata_batch batch;
+  grpc_metadata_batch_init(&batch);
+  for (size_t i = 0; i < elems.size(); i++) {
+    GPR_ASSERT(grpc_metadata_batch_add_tail(&batch, &storage[i], elems[i]) ==
+               GRPC_ERROR_NONE);
+  }
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(grpc_metadata_batch_size(&batch));
+  }
+  grpc_metadata_batch_destroy(&batch);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MetadataBatchIterate)->Range(1, 64);
+
+static void BM_MetadataBatchCopy(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  std::vector<grpc_mdelem> elems = MakeBatchElems(state.range(0));
+  std::vector<grpc_linked_mdelem> storage(elems.size());
+  std::vector<grpc_linked_mdelem> copy_storage(elems.size());
+  grpc_metadata_batch batch;
+  grpc_metadata_batch_init(&batch);
+  for (size_t i = 0; i < elems.size(); i++) {
+    GPR_ASSERT(grpc_metadata_batch_add_tail(&batch, &storage[i], elems[i]) ==
+               GRPC_ERROR_NONE);
+  }
+  while (state.KeepRunning()) {
+    grpc_metadata_batch copy;
+    grpc_metadata_batch_copy(&batch, &copy, copy_storage.data());
+    grpc_metadata_batch_destroy(&copy);
+  }
+  grpc_metadata_batch_destroy(&batch);
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_MetadataBatchCopy)->Range(1, 64);
+
 // Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
 // and others do not. This allows us to support both modes.
 namespace benchmark {
@@ -0,0 +1,240 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark how the server finds the request matcher of an incoming call and
+   matches the call with a requested call: lookup cost against the number of
+   registered methods, and scaling with the number of server completion queues
+   and concurrent streams */
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <grpc/grpc.h>
+#include <grpc/support/log.h>
+
+#include "src/core/ext/transport/inproc/inproc_transport.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+namespace grpc {
+namespace testing {
+
+auto& force_library_initialization = Library::get();
+
+static grpc_server* g_server;
+static std::vector<std::string> g_method_names;
+static std::vector<void*> g_methods;
+static grpc_channel* g_channel;
+static std::vector<grpc_completion_queue*> g_server_cqs;
+
+static void* tag(intptr_t x) { return reinterpret_cast<void*>(x); }
+
+static void setup(size_t num_cqs, size_t num_methods) {
+  g_server = grpc_server_create(nullptr, nullptr);
+  g_method_names.clear();
+  g_methods.clear();
+  for (size_t i = 0; i < num_methods; i++) {
+    char name[32];
+    snprintf(name, sizeof(name), "/bm/Method%zu", i);
+    g_method_names.push_back(name);
+  }
+  for (const std::string& name : g_method_names) {
+    g_methods.push_back(grpc_server_register_method(
+        g_server, name.c_str(), nullptr, GRPC_SRM_PAYLOAD_NONE, 0));
+  }
+  g_server_cqs.clear();
+  for (size_t i = 0; i < num_cqs; i++) {
+    g_server_cqs.push_back(grpc_completion_queue_create_for_next(nullptr));
+    grpc_server_register_completion_queue(g_server, g_server_cqs.back(),
+                                          nullptr);
+  }
+  grpc_server_start(g_server);
+  g_channel = grpc_inproc_channel_create(g_server, nullptr, nullptr);
+}
+
+static void next_op(grpc_completion_queue* cq, void* expected) {
+  grpc_event ev = grpc_completion_queue_next(
+      cq, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr);
+  GPR_ASSERT(ev.type == GRPC_OP_COMPLETE);
+  GPR_ASSERT(ev.success);
+  GPR_ASSERT(ev.tag == expected);
+}
+
+static void teardown() {
+  grpc_channel_destroy(g_channel);
+  grpc_server_shutdown_and_notify(g_server, g_server_cqs[0], tag(0));
+  next_op(g_server_cqs[0], tag(0));
+  grpc_server_destroy(g_server);
+  for (grpc_completion_queue* cq : g_server_cqs) {
+    grpc_completion_queue_shutdown(cq);
+    while (grpc_completion_queue_next(cq, gpr_inf_future(GPR_CLOCK_REALTIME),
+                                      nullptr)
+               .type != GRPC_QUEUE_SHUTDOWN) {
+    }
+    grpc_completion_queue_destroy(cq);
+  }
+}
+
+/* Runs one call on \a method (an index into g_methods, or -1 for an
+   unregistered method): requests it on \a server_cq, starts it from
+   \a client_cq and serves whichever call the request is matched with */
+static void do_call(grpc_completion_queue* server_cq,
+                    grpc_completion_queue* client_cq, int method) {
+  grpc_call* server_call = nullptr;
+  grpc_call_details details;
+  grpc_metadata_array request_metadata;
+  grpc_call_details_init(&details);
+  grpc_metadata_array_init(&request_metadata);
+  gpr_timespec server_deadline;
+  if (method >= 0) {
+    GPR_ASSERT(GRPC_CALL_OK == grpc_server_request_registered_call(
+                                   g_server, g_methods[method], &server_call,
+                                   &server_deadline, &request_metadata,
+                                   nullptr, server_cq, server_cq, tag(1)));
+  } else {
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_call(g_server, &server_call, &details,
+                                        &request_metadata, server_cq,
+                                        server_cq, tag(1)));
+  }
+
+  grpc_call* client_call = grpc_channel_create_call(
+      g_channel, nullptr, GRPC_PROPAGATE_DEFAULTS, client_cq,
+      grpc_slice_from_static_string(method >= 0
+                                        ? g_method_names[method].c_str()
+                                        : "/bm/Unregistered"),
+      nullptr, gpr_inf_future(GPR_CLOCK_REALTIME), nullptr);
+  grpc_metadata_array response_metadata;
+  grpc_metadata_array trailing_metadata;
+  grpc_metadata_array_init(&response_metadata);
+  grpc_metadata_array_init(&trailing_metadata);
+  grpc_status_code status;
+  grpc_slice status_details;
+  grpc_op ops[4];
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+  ops[1].op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  ops[2].op = GRPC_OP_RECV_INITIAL_METADATA;
+  ops[2].data.recv_initial_metadata.recv_initial_metadata = &response_metadata;
+  ops[3].op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  ops[3].data.recv_status_on_client.trailing_metadata = &trailing_metadata;
+  ops[3].data.recv_status_on_client.status = &status;
+  ops[3].data.recv_status_on_client.status_details = &status_details;
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_call_start_batch(client_call, ops, 4, tag(2), nullptr));
+
+  next_op(server_cq, tag(1));
+  int cancelled;
+  memset(ops, 0, sizeof(ops));
+  ops[0].op = GRPC_OP_SEND_INITIAL_METADATA;
+  ops[1].op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  ops[1].data.send_status_from_server.status = GRPC_STATUS_OK;
+  ops[2].op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  ops[2].data.recv_close_on_server.cancelled = &cancelled;
+  GPR_ASSERT(GRPC_CALL_OK ==
+             grpc_call_start_batch(server_call, ops, 3, tag(3), nullptr));
+  next_op(server_cq, tag(3));
+  next_op(client_cq, tag(2));
+  GPR_ASSERT(status == GRPC_STATUS_OK);
+
+  grpc_call_unref(client_call);
+  grpc_call_unref(server_call);
+  grpc_slice_unref(status_details);
+  grpc_metadata_array_destroy(&response_metadata);
+  grpc_metadata_array_destroy(&trailing_metadata);
+  grpc_metadata_array_destroy(&request_metadata);
+  grpc_call_details_destroy(&details);
+}
+
+/* Every thread owns one server cq, on which it keeps one call requested, and
+   drives one client stream at a time. Which request a call is matched with is
+   up to the server, so a thread may serve another thread's call; each thread
+   serves exactly one call per iteration, so they all finish. See
+   bm_cq_multiple_threads.cc for why setup and teardown in thread 0 are safe */
+template <bool kRegistered>
+static void BM_RequestMatcher(benchmark::State& state) {
+  TrackCounters track_counters;
+  if (state.thread_index == 0) {
+    setup(static_cast<size_t>(state.threads), 1);
+  }
+
+  grpc_completion_queue* client_cq =
+      grpc_completion_queue_create_for_next(nullptr);
+  while (state.KeepRunning()) {
+    do_call(g_server_cqs[state.thread_index], client_cq,
+            kRegistered ? 0 : -1);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  grpc_completion_queue_shutdown(client_cq);
+  while (grpc_completion_queue_next(client_cq,
+                                    gpr_inf_future(GPR_CLOCK_REALTIME), nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(client_cq);
+  if (state.thread_index == 0) {
+    teardown();
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK_TEMPLATE(BM_RequestMatcher, false)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RequestMatcher, true)->ThreadRange(1, 64)->UseRealTime();
+
+/* Calls cycle through state.range(0) registered methods, with every tenth
+   call going to an unregistered method, which has to miss the lookup */
+static void BM_RegisteredMethodLookup(benchmark::State& state) {
+  TrackCounters track_counters;
+  const int num_methods = static_cast<int>(state.range(0));
+  setup(1, static_cast<size_t>(num_methods));
+  grpc_completion_queue* client_cq =
+      grpc_completion_queue_create_for_next(nullptr);
+  int n = 0;
+  while (state.KeepRunning()) {
+    do_call(g_server_cqs[0], client_cq, n % 10 == 9 ? -1 : n % num_methods);
+    n++;
+  }
+  state.SetItemsProcessed(state.iterations());
+  grpc_completion_queue_shutdown(client_cq);
+  while (grpc_completion_queue_next(client_cq,
+                                    gpr_inf_future(GPR_CLOCK_REALTIME), nullptr)
+             .type != GRPC_QUEUE_SHUTDOWN) {
+  }
+  grpc_completion_queue_destroy(client_cq);
+  teardown();
+  track_counters.Finish(state);
+}
+BENCHMARK(BM_RegisteredMethodLookup)->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ *
+ * Copyright 2018 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark timer arm/cancel throughput of the timer implementations */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include <grpc/grpc.h>
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/timer.h"
+#include "src/core/lib/iomgr/timer_manager.h"
+#include "test/cpp/microbenchmarks/helpers.h"
+#include "test/cpp/util/test_config.h"
+
+extern grpc_timer_vtable grpc_generic_timer_vtable;
+extern grpc_timer_vtable grpc_timer_wheel_vtable;
+
+namespace grpc {
+namespace testing {
+
+auto& force_library_initialization = Library::get();
+
+struct HeapTimer {
+  static grpc_timer_vtable* vtable() { return &grpc_generic_timer_vtable; }
+};
+
+struct WheelTimer {
+  static grpc_timer_vtable* vtable() { return &grpc_timer_wheel_vtable; }
+};
+
+/* Swaps the process wide timer implementation. The timer manager threads are
+   stopped meanwhile so that nothing runs grpc_timer_check() on a list that is
+   being torn down. */
+static void switch_timer_impl(grpc_timer_vtable* vtable) {
+  grpc_timer_manager_set_threading(false);
+  grpc_timer_list_shutdown();
+  grpc_set_timer_impl(vtable);
+  grpc_timer_list_init();
+  grpc_timer_manager_set_threading(true);
+}
+
+static void DoNothing(void* arg, grpc_error* error) {}
+
+/* Each iteration arms a batch of state.range(0) timers with deadlines spread
+   over the next few seconds and then cancels them all, which is what per-call
+   deadline timers do for RPCs that complete in time. See
+   bm_cq_multiple_threads.cc for why setup and teardown in thread 0 are safe */
+template <class Impl>
+static void BM_TimerArmCancel(benchmark::State& state) {
+  TrackCounters track_counters;
+  grpc_core::ExecCtx exec_ctx;
+  if (state.thread_index == 0) {
+    switch_timer_impl(Impl::vtable());
+  }
+
+  const size_t batch = static_cast<size_t>(state.range(0));
+  std::vector<grpc_timer> timers(batch);
+  std::vector<grpc_closure> closures(batch);
+  for (size_t i = 0; i < batch; i++) {
+    GRPC_CLOSURE_INIT(&closures[i], DoNothing, nullptr,
+                      grpc_schedule_on_exec_ctx);
+  }
+  size_t spread = 0;
+  while (state.KeepRunning()) {
+    grpc_millis now = grpc_core::ExecCtx::Get()->Now();
+    for (size_t i = 0; i < batch; i++) {
+      spread = (spread + 997) % 5000;
+      grpc_timer_init(&timers[i],
+                      now + 1000 + static_cast<grpc_millis>(spread),
+                      &closures[i]);
+    }
+    for (size_t i = 0; i < batch; i++) {
+      grpc_timer_cancel(&timers[i]);
+    }
+    grpc_core::ExecCtx::Get()->Flush();
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+
+  if (state.thread_index == 0) {
+    switch_timer_impl(grpc_generic_timer_impl_from_env());
+  }
+  track_counters.Finish(state);
+}
+BENCHMARK_TEMPLATE(BM_TimerArmCancel, HeapTimer)
+    ->Arg(1)
+    ->Arg(1024)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_TimerArmCancel, WheelTimer)
+    ->Arg(1)
+    ->Arg(1024)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(64)
+    ->UseRealTime();
+
+}  // namespace testing
+}  // namespace grpc
+
+// Some distros have RunSpecifiedBenchmarks under the benchmark namespace,
+// and others do not. This allows us to support both modes.
+namespace benchmark {
+void RunTheBenchmarksNamespaced() { RunSpecifiedBenchmarks(); }
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::grpc::testing::InitTest(&argc, &argv, false);
+  benchmark::RunTheBenchmarksNamespaced();
+  return 0;
+}
@@ -39,6 +39,7 @@
 #include "src/core/lib/surface/server.h"
 #include "test/core/util/passthru_endpoint.h"
 #include "test/core/util/port.h"
+#include "test/core/util/recording_endpoint.h"
 
 #include "src/cpp/client/create_channel_internal.h"
 #include "test/cpp/microbenchmarks/helpers.h"
@@ -311,6 +312,64 @@ class InProcessCHTTP2 : public InProcessCHTTP2WithExplicitStats {
                                          fixture_configuration) {}
 };
 
+/* Owns the recording of a RecordingInProcessCHTTP2. It is a base class of the
+   fixture so that it is constructed before the endpoints it records, and
+   destroyed after them. */
+class ServerEndpointRecordingHolder {
+ public:
+  /* Where RecordingInProcessCHTTP2 fixtures save their recordings; nothing is
+     recorded while this is empty */
+  static std::string& RecordFile() {
+    static std::string* record_file = new std::string();
+    return *record_file;
+  }
+
+ protected:
+  ServerEndpointRecordingHolder()
+      : path_(RecordFile()),
+        recording_(path_.empty() ? nullptr
+                                 : grpc_endpoint_recording_create()) {}
+
+  ~ServerEndpointRecordingHolder() {
+    if (recording_ == nullptr) return;
+    grpc_endpoint_recording_save(recording_, path_.c_str());
+    grpc_endpoint_recording_destroy(recording_);
+  }
+
+  const std::string path_;
+  grpc_endpoint_recording* const recording_;
+};
+
+/* InProcessCHTTP2, recording everything its server transport reads and writes
+   and saving it when the fixture is destroyed, to
+   ServerEndpointRecordingHolder::RecordFile() (see
+   test/core/util/recording_endpoint.h). The reads are what
+   bm_chttp2_transport's --chttp2_replay_file replays. */
+class RecordingInProcessCHTTP2 : private ServerEndpointRecordingHolder,
+                                 public EndpointPairFixture {
+ public:
+  RecordingInProcessCHTTP2(Service* service,
+                           const FixtureConfiguration& fixture_configuration =
+                               FixtureConfiguration())
+      : ServerEndpointRecordingHolder(),
+        EndpointPairFixture(service, MakeEndpoints(recording_),
+                            fixture_configuration) {}
+
+ private:
+  static grpc_endpoint_pair MakeEndpoints(grpc_endpoint_recording* recording) {
+    grpc_passthru_endpoint_stats* stats =
+        grpc_passthru_endpoint_stats_create();
+    grpc_endpoint_pair p;
+    grpc_passthru_endpoint_create(&p.client, &p.server, Library::get().rq(),
+                                  stats);
+    grpc_passthru_endpoint_stats_destroy(stats);
+    if (recording != nullptr) {
+      p.server = grpc_recording_endpoint_create(p.server, recording);
+    }
+    return p;
+  }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Minimal stack fixtures
 
@@ -338,6 +397,30 @@ typedef MinStackize<InProcess> MinInProcess;
 typedef MinStackize<SockPair> MinSockPair;
 typedef MinStackize<InProcessCHTTP2> MinInProcessCHTTP2;
 
+////////////////////////////////////////////////////////////////////////////////
+// Zero-copy send fixtures
+
+class ZeroCopyConfiguration : public FixtureConfiguration {
+ public:
+  // sendmsg batches at least this large use MSG_ZEROCOPY
+  static const int kThreshold = 16 * 1024;
+
+  void ApplyCommonChannelArguments(ChannelArguments* a) const override {
+    a->SetInt(GRPC_ARG_TCP_TX_ZEROCOPY_THRESHOLD, kThreshold);
+    FixtureConfiguration::ApplyCommonChannelArguments(a);
+  }
+
+  void ApplyCommonServerBuilderConfig(ServerBuilder* b) const override {
+    b->AddChannelArgument(GRPC_ARG_TCP_TX_ZEROCOPY_THRESHOLD, kThreshold);
+    FixtureConfiguration::ApplyCommonServerBuilderConfig(b);
+  }
+};
+
+class TCPZeroCopy : public TCP {
+ public:
+  TCPZeroCopy(Service* service) : TCP(service, ZeroCopyConfiguration()) {}
+};
+
 }  // namespace testing
 }  // namespace grpc
 
@@ -18,6 +18,7 @@
 
 #include <set>
 
+#include <grpc/grpc.h>
 #include <grpc/support/log.h>
 
 #include "test/cpp/qps/benchmark_config.h"
@@ -54,6 +55,42 @@ static void RunSynchronousUnaryPingPong() {
   GetReporter()->ReportLatency(*result);
 }
 
+// Messages of \a size bytes each way, handed over either serialized or as
+// message objects
+static void RunSynchronousUnaryPingPongWithPayload(int size,
+                                                   bool message_objects) {
+  gpr_log(GPR_INFO,
+          "Running Synchronous Unary Ping Pong with %d byte messages%s", size,
+          message_objects ? " passed as message objects" : "");
+
+  ClientConfig client_config;
+  client_config.set_client_type(SYNC_CLIENT);
+  client_config.set_outstanding_rpcs_per_channel(1);
+  client_config.set_client_channels(1);
+  client_config.set_rpc_type(UNARY);
+  client_config.mutable_load_params()->mutable_closed_loop();
+  SimpleProtoParams* params =
+      client_config.mutable_payload_config()->mutable_simple_params();
+  params->set_req_size(size);
+  params->set_resp_size(size);
+  if (message_objects) {
+    ChannelArg* arg = client_config.add_channel_args();
+    arg->set_name(GRPC_ARG_INPROC_MESSAGE_OBJECTS);
+    arg->set_int_value(1);
+  }
+
+  ServerConfig server_config;
+  server_config.set_server_type(SYNC_SERVER);
+
+  const auto result =
+      RunScenario(client_config, 1, server_config, 1, WARMUP, BENCHMARK, -2, "",
+                  kInsecureCredentialsType, true);
+
+  GetReporter()->ReportQPS(*result);
+  GetReporter()->ReportLatency(*result);
+  GetReporter()->ReportCpuUsage(*result);
+}
+
 }  // namespace testing
 }  // namespace grpc
 
@@ -61,6 +98,10 @@ int main(int argc, char** argv) {
   grpc::testing::InitTest(&argc, &argv, true);
 
   grpc::testing::RunSynchronousUnaryPingPong();
+  for (int size : {1024, 1024 * 1024}) {
+    grpc::testing::RunSynchronousUnaryPingPongWithPayload(size, false);
+    grpc::testing::RunSynchronousUnaryPingPongWithPayload(size, true);
+  }
 
   return 0;
 }
@@ -120,9 +120,16 @@ class Server {
  protected:
   static void ApplyConfigToBuilder(const ServerConfig& config,
                                    ServerBuilder* builder) {
-    if (config.resource_quota_size() > 0) {
-      builder->SetResourceQuota(ResourceQuota("AsyncQpsServerTest")
-                                    .Resize(config.resource_quota_size()));
+    if (config.resource_quota_size() > 0 ||
+        config.sync_server_max_threads() > 0) {
+      ResourceQuota quota("AsyncQpsServerTest");
+      if (config.resource_quota_size() > 0) {
+        quota.Resize(config.resource_quota_size());
+      }
+      if (config.sync_server_max_threads() > 0) {
+        quota.SetMaxThreads(config.sync_server_max_threads());
+      }
+      builder->SetResourceQuota(quota);
     }
     for (const auto& channel_arg : config.channel_args()) {
       switch (channel_arg.value_case()) {
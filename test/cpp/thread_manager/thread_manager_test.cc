@@ -17,6 +17,7 @@
  */
 
 #include <inttypes.h>
+#include <climits>
 #include <ctime>
 #include <memory>
 #include <string>
@@ -32,11 +33,18 @@
 namespace grpc {
 class ThreadManagerTest final : public grpc::ThreadManager {
  public:
-  ThreadManagerTest()
-      : ThreadManager(kMinPollers, kMaxPollers),
+  // At most \a max_threads threads are allocated from \a resource_quota
+  ThreadManagerTest(grpc_resource_quota* resource_quota, int max_threads)
+      : ThreadManager(resource_quota, kMinPollers, kMaxPollers),
         num_do_work_(0),
         num_poll_for_work_(0),
-        num_work_found_(0) {}
+        num_work_found_(0),
+        num_active_(0),
+        max_active_(0),
+        max_threads_(max_threads) {}
+
+  static const int kMinPollers = 2;
+  static const int kMaxPollers = 10;
 
   grpc::ThreadManager::WorkStatus PollForWork(void** tag, bool* ok) override;
   void DoWork(void* tag, bool ok) override;
@@ -44,9 +52,9 @@ class ThreadManagerTest final : public grpc::ThreadManager {
 
  private:
   void SleepForMs(int sleep_time_ms);
-
-  static const int kMinPollers = 2;
-  static const int kMaxPollers = 10;
+  // Track how many threads are in PollForWork() or DoWork() at once
+  void Enter();
+  void Exit();
 
   static const int kPollingTimeoutMsec = 10;
   static const int kDoWorkDurationMsec = 1;
@@ -57,6 +65,10 @@ class ThreadManagerTest final : public grpc::ThreadManager {
   gpr_atm num_do_work_;        // Number of calls to DoWork
   gpr_atm num_poll_for_work_;  // Number of calls to PollForWork
   gpr_atm num_work_found_;     // Number of times WORK_FOUND was returned
+  gpr_atm num_active_;         // Threads in PollForWork or DoWork right now
+  gpr_atm max_active_;         // Largest value of num_active_ seen
+
+  const int max_threads_;
 };
 
 void ThreadManagerTest::SleepForMs(int duration_ms) {
@@ -66,6 +78,19 @@ void ThreadManagerTest::SleepForMs(int duration_ms) {
   gpr_sleep_until(sleep_time);
 }
 
+void ThreadManagerTest::Enter() {
+  gpr_atm active = gpr_atm_no_barrier_fetch_add(&num_active_, 1) + 1;
+  gpr_atm max_active;
+  do {
+    max_active = gpr_atm_no_barrier_load(&max_active_);
+  } while (active > max_active &&
+           !gpr_atm_no_barrier_cas(&max_active_, max_active, active));
+}
+
+void ThreadManagerTest::Exit() {
+  gpr_atm_no_barrier_fetch_add(&num_active_, -1);
+}
+
 grpc::ThreadManager::WorkStatus ThreadManagerTest::PollForWork(void** tag,
                                                                bool* ok) {
   int call_num = gpr_atm_no_barrier_fetch_add(&num_poll_for_work_, 1);
@@ -76,7 +101,9 @@ grpc::ThreadManager::WorkStatus ThreadManagerTest::PollForWork(void** tag,
   }
 
   // Simulate "polling for work" by sleeping for sometime
+  Enter();
   SleepForMs(kPollingTimeoutMsec);
+  Exit();
 
   *tag = nullptr;
   *ok = true;
@@ -92,7 +119,9 @@ grpc::ThreadManager::WorkStatus ThreadManagerTest::PollForWork(void** tag,
 
 void ThreadManagerTest::DoWork(void* tag, bool ok) {
   gpr_atm_no_barrier_fetch_add(&num_do_work_, 1);
+  Enter();
   SleepForMs(kDoWorkDurationMsec);  // Simulate doing work by sleeping
+  Exit();
 }
 
 void ThreadManagerTest::PerformTest() {
@@ -108,6 +137,11 @@ void ThreadManagerTest::PerformTest() {
           gpr_atm_no_barrier_load(&num_do_work_));
   GPR_ASSERT(gpr_atm_no_barrier_load(&num_do_work_) ==
              gpr_atm_no_barrier_load(&num_work_found_));
+
+  // The threads never outnumbered what the resource quota allowed
+  gpr_log(GPR_DEBUG, "At most %" PRIdPTR " threads were active at once",
+          gpr_atm_no_barrier_load(&max_active_));
+  GPR_ASSERT(gpr_atm_no_barrier_load(&max_active_) <= max_threads_);
 }
 }  // namespace grpc
 
@@ -115,8 +149,25 @@ int main(int argc, char** argv) {
   std::srand(std::time(nullptr));
 
   grpc::testing::InitTest(&argc, &argv, true);
-  grpc::ThreadManagerTest test_rpc_manager;
-  test_rpc_manager.PerformTest();
+  grpc_init();
+
+  grpc_resource_quota* rq = grpc_resource_quota_create("thread_manager_test");
+  {
+    grpc::ThreadManagerTest test_rpc_manager(rq, INT_MAX);
+    test_rpc_manager.PerformTest();
+  }
+
+  // With a thread limit, work that no thread is free to take gets queued
+  // instead of causing more threads to be created. It must still all be done.
+  const int max_threads = grpc::ThreadManagerTest::kMinPollers + 1;
+  grpc_resource_quota_set_max_threads(rq, max_threads);
+  {
+    grpc::ThreadManagerTest test_rpc_manager(rq, max_threads);
+    test_rpc_manager.PerformTest();
+  }
+  grpc_resource_quota_unref(rq);
+
+  grpc_shutdown();
 
   return 0;
 }
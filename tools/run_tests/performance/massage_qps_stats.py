@@ -30,6 +30,18 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_server_calls_created"] = massage_qps_stats_helpers.counter(
                     core_stats, "server_calls_created")
+            stats[
+                "core_call_arena_pool_hits"] = massage_qps_stats_helpers.counter(
+                    core_stats, "call_arena_pool_hits")
+            stats[
+                "core_call_arena_pool_misses"] = massage_qps_stats_helpers.counter(
+                    core_stats, "call_arena_pool_misses")
+            stats[
+                "core_zlib_context_pool_hits"] = massage_qps_stats_helpers.counter(
+                    core_stats, "zlib_context_pool_hits")
+            stats[
+                "core_zlib_context_pool_misses"] = massage_qps_stats_helpers.counter(
+                    core_stats, "zlib_context_pool_misses")
             stats["core_cqs_created"] = massage_qps_stats_helpers.counter(
                 core_stats, "cqs_created")
             stats[
@@ -62,6 +74,9 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_pollset_kick_own_thread"] = massage_qps_stats_helpers.counter(
                     core_stats, "pollset_kick_own_thread")
+            stats[
+                "core_pollset_batched_events"] = massage_qps_stats_helpers.counter(
+                    core_stats, "pollset_batched_events")
             stats["core_syscall_epoll_ctl"] = massage_qps_stats_helpers.counter(
                 core_stats, "syscall_epoll_ctl")
             stats[
@@ -80,6 +95,12 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_tcp_backup_poller_polls"] = massage_qps_stats_helpers.counter(
                     core_stats, "tcp_backup_poller_polls")
+            stats[
+                "core_tcp_zerocopy_writes"] = massage_qps_stats_helpers.counter(
+                    core_stats, "tcp_zerocopy_writes")
+            stats[
+                "core_tcp_zerocopy_copied"] = massage_qps_stats_helpers.counter(
+                    core_stats, "tcp_zerocopy_copied")
             stats["core_http2_op_batches"] = massage_qps_stats_helpers.counter(
                 core_stats, "http2_op_batches")
             stats["core_http2_op_cancel"] = massage_qps_stats_helpers.counter(
@@ -119,6 +140,9 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_http2_partial_writes"] = massage_qps_stats_helpers.counter(
                     core_stats, "http2_partial_writes")
+            stats[
+                "core_http2_writes_coalesced"] = massage_qps_stats_helpers.counter(
+                    core_stats, "http2_writes_coalesced")
             stats[
                 "core_http2_initiate_write_due_to_initial_write"] = massage_qps_stats_helpers.counter(
                     core_stats, "http2_initiate_write_due_to_initial_write")
@@ -260,6 +284,9 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_hpack_send_binary_base64"] = massage_qps_stats_helpers.counter(
                     core_stats, "hpack_send_binary_base64")
+            stats[
+                "core_hpack_send_cached_block"] = massage_qps_stats_helpers.counter(
+                    core_stats, "hpack_send_cached_block")
             stats[
                 "core_combiner_locks_initiated"] = massage_qps_stats_helpers.counter(
                     core_stats, "combiner_locks_initiated")
@@ -302,6 +329,9 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_executor_push_retries"] = massage_qps_stats_helpers.counter(
                     core_stats, "executor_push_retries")
+            stats[
+                "core_executor_stolen_items"] = massage_qps_stats_helpers.counter(
+                    core_stats, "executor_stolen_items")
             stats[
                 "core_server_requested_calls"] = massage_qps_stats_helpers.counter(
                     core_stats, "server_requested_calls")
@@ -317,6 +347,27 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_cq_ev_queue_transient_pop_failures"] = massage_qps_stats_helpers.counter(
                     core_stats, "cq_ev_queue_transient_pop_failures")
+            stats[
+                "core_sync_server_threads_created"] = massage_qps_stats_helpers.counter(
+                    core_stats, "sync_server_threads_created")
+            stats[
+                "core_sync_server_threads_reused"] = massage_qps_stats_helpers.counter(
+                    core_stats, "sync_server_threads_reused")
+            stats[
+                "core_sync_server_work_queued"] = massage_qps_stats_helpers.counter(
+                    core_stats, "sync_server_work_queued")
+            stats[
+                "core_adaptive_compression_attempts"] = massage_qps_stats_helpers.counter(
+                    core_stats, "adaptive_compression_attempts")
+            stats[
+                "core_adaptive_compression_skipped"] = massage_qps_stats_helpers.counter(
+                    core_stats, "adaptive_compression_skipped")
+            stats[
+                "core_adaptive_compression_stopped"] = massage_qps_stats_helpers.counter(
+                    core_stats, "adaptive_compression_stopped")
+            stats[
+                "core_adaptive_compression_resumed"] = massage_qps_stats_helpers.counter(
+                    core_stats, "adaptive_compression_resumed")
             h = massage_qps_stats_helpers.histogram(core_stats,
                                                     "call_initial_size")
             stats["core_call_initial_size"] = ",".join(
@@ -494,6 +545,21 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_http2_send_flowctl_per_write_99p"] = massage_qps_stats_helpers.percentile(
                     h.buckets, 99, h.boundaries)
+            h = massage_qps_stats_helpers.histogram(core_stats,
+                                                    "http2_frames_per_write")
+            stats["core_http2_frames_per_write"] = ",".join(
+                "%f" % x for x in h.buckets)
+            stats["core_http2_frames_per_write_bkts"] = ",".join(
+                "%f" % x for x in h.boundaries)
+            stats[
+                "core_http2_frames_per_write_50p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 50, h.boundaries)
+            stats[
+                "core_http2_frames_per_write_95p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 95, h.boundaries)
+            stats[
+                "core_http2_frames_per_write_99p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 99, h.boundaries)
             h = massage_qps_stats_helpers.histogram(core_stats,
                                                     "server_cqs_checked")
             stats["core_server_cqs_checked"] = ",".join(
@@ -509,3 +575,33 @@ def massage_qps_stats(scenario_result):
             stats[
                 "core_server_cqs_checked_99p"] = massage_qps_stats_helpers.percentile(
                     h.buckets, 99, h.boundaries)
+            h = massage_qps_stats_helpers.histogram(core_stats,
+                                                    "sync_server_queueing_delay")
+            stats["core_sync_server_queueing_delay"] = ",".join(
+                "%f" % x for x in h.buckets)
+            stats["core_sync_server_queueing_delay_bkts"] = ",".join(
+                "%f" % x for x in h.boundaries)
+            stats[
+                "core_sync_server_queueing_delay_50p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 50, h.boundaries)
+            stats[
+                "core_sync_server_queueing_delay_95p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 95, h.boundaries)
+            stats[
+                "core_sync_server_queueing_delay_99p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 99, h.boundaries)
+            h = massage_qps_stats_helpers.histogram(
+                core_stats, "adaptive_compression_savings")
+            stats["core_adaptive_compression_savings"] = ",".join(
+                "%f" % x for x in h.buckets)
+            stats["core_adaptive_compression_savings_bkts"] = ",".join(
+                "%f" % x for x in h.boundaries)
+            stats[
+                "core_adaptive_compression_savings_50p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 50, h.boundaries)
+            stats[
+                "core_adaptive_compression_savings_95p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 95, h.boundaries)
+            stats[
+                "core_adaptive_compression_savings_99p"] = massage_qps_stats_helpers.percentile(
+                    h.buckets, 99, h.boundaries)
@@ -127,6 +127,7 @@ def _ping_pong_scenario(name,
                         outstanding=None,
                         num_clients=None,
                         resource_quota_size=None,
+                        sync_server_max_threads=None,
                         messages_per_stream=None,
                         excluded_poll_engines=[],
                         minimal_stack=False,
@@ -159,6 +160,9 @@ def _ping_pong_scenario(name,
     }
     if resource_quota_size:
         scenario['server_config']['resource_quota_size'] = resource_quota_size
+    if sync_server_max_threads:
+        scenario['server_config'][
+            'sync_server_max_threads'] = sync_server_max_threads
     if use_generic_payload:
         if server_type != 'ASYNC_GENERIC_SERVER':
             raise Exception('Use ASYNC_GENERIC_SERVER for generic payload.')
@@ -460,6 +464,20 @@ class CXXLanguage:
                 categories=smoketest_categories + [SCALABLE],
                 excluded_poll_engines=['poll-cv'])
 
+            for max_threads in [4, 16]:
+                yield _ping_pong_scenario(
+                    'cpp_protobuf_async_client_sync_server_unary_qps_unconstrained_%dmax_threads_%s'
+                    % (max_threads, secstr),
+                    rpc_type='UNARY',
+                    client_type='ASYNC_CLIENT',
+                    server_type='SYNC_SERVER',
+                    unconstrained_client='async',
+                    secure=secure,
+                    minimal_stack=not secure,
+                    sync_server_max_threads=max_threads,
+                    categories=[SCALABLE],
+                    excluded_poll_engines=['poll-cv'])
+
             yield _ping_pong_scenario(
                 'cpp_protobuf_async_client_unary_1channel_64wide_128Breq_8MBresp_%s'
                 % (secstr),